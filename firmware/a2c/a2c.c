@@ -42,10 +42,23 @@ SOFTWARE.
 #include "menu/menu.h"
 #include "debug/debug.h"
 #include "dvi/a2dvi.h"
-
-
+#include "dvi/tmds_mono.h"
+#include "render/render_bench.h"
+#include "a2c_delta.h"
+#include "a2c_lut.h"
+#include "a2c_record.h"
+#include "a2c_screenshot.h"
+#include "a2c_stream.h"
+#include "a2c_text.h"
+#include "a2c_osd.h"
+#include "a2c.h"
+
+
+//  The NTSC LUT (11 bit, 24KB in RAM by default) is always built in, the A2C build doesn't shadow the Apple II memory
+//  (see MAX_ADDRESS), the RAM budget is shown on the debug monitor.
 // #define NO_NTSC_LUT     1    //  If we need extra memory for testing
 
+//  Generated by tools/hgr_ntsc_lut.py at build time, see A2C_LUT_CLAMP and A2C_LUT_NTSC in CMakeLists.txt
 #include "hgrdecode_LUT.h"
 
 
@@ -75,6 +88,8 @@ bool s_sync_found = false;                      //  We set this true in the WNDW
 //  PIO data structures
 PIO s_pio;                                          //  The A2C PIO program
 uint s_a2c_sm;                                      //  PIO state machine for SEROUT
+uint s_a2c_d7_sm;                                   //  PIO state machine for VIDD7, the SEROUT program in lock-step
+uint s_a2c_mode_sm;                                 //  PIO state machine for TEXT and GR, once per SEROUT word
 uint s_a2c_snd_sm;                                  //  PIO state machine for SND
 
 static uint32_t s_a2c_data = 0;
@@ -86,15 +101,32 @@ static uint32_t s_a2c_snd_data_count = 0;
 #define A2C_DATA_RX 0x00000001
 #define A2C_SND_RX 0x00000002
 
-uint32_t s_screen_buffer[192][19];                  //  Our buffer of the A2C screen, we don't use the A2 memory
-bool s_screen_GR_buffer[192];                       //  See table below
+//  Frame buffers of the A2C screen, we don't use the A2 memory.  a2c_loop captures into s_capture_frame and
+//  publishes it as s_ready_frame when the last line is complete, render_a2c takes the latest ready frame
+//  when it starts a frame.  SEROUT and DVI are not in sync, so a third buffer is needed for capturing
+//  while one frame waits and another one is rendered (a frame is never shown before it is complete).
+#define A2C_FRAME_BUFFERS   3
+
+uint32_t s_screen_buffer[A2C_FRAME_BUFFERS][192][19];     //  18 words of SEROUT per line, plus a blank one
+uint32_t s_screen_GR_mask[A2C_FRAME_BUFFERS][192];        //  GR pin for each SEROUT word of a line, bit n is word n
+uint32_t s_screen_TEXT_mask[A2C_FRAME_BUFFERS][192];      //  TEXT pin for each SEROUT word, see table below
                                                     //  TEXT and GR Pins
                                                     //  Mode:   TEXT    GR      HGR     DGR     DHGR
                                                     //  TEXT:   HIGH    LOW     LOW     HIGH    HIGH
                                                     //  GR:     LOW     HIGH    HIGH    HIGH    HIGH
+#define A2C_WORDS_MASK      ((1u << 18) - 1)        //  All 18 words of a line
+uint64_t s_screen_D7_buffer[A2C_FRAME_BUFFERS][192];      //  VIDD7 of the 40 video bytes of a line, bit n is byte n
+
+static uint8_t s_vidd7_first_byte[19];              //  First video byte sampled in each SEROUT word, see a2c_loop
+static uint32_t s_line_mode = 0;                    //  TEXT and GR of the first 16 words of the line being captured
+
+static uint s_capture_frame = 0;                   //  Frame buffer being captured (core 1)
+static volatile uint s_ready_frame = 0;             //  Latest complete frame
+static volatile uint s_display_frame = 0;           //  Frame buffer being rendered (core 0)
 
 bool s_menu_screen_init = false;                    //  We lazy init the menu screen once
 bool s_show_menu_screen = false;                    //  Is the menu screen up
+static bool s_menu_redraw = true;                   //  The menu changed, draw it into the text page and update the OSD
 
 bool s_button_state = false;                        //  State of the button
 uint64_t s_last_BUTTON = 0;                         //  Last state of the button to track transitions
@@ -108,6 +140,25 @@ uint64_t s_render_time = 1;
 uint32_t s_debug_value_1 = 0;
 uint32_t s_debug_value_2 = 0;
 
+//  Capture-to-display latency statistics
+#define LATENCY_TOP_ROWS            16                  //  Rows rendered above the screen area by render_a2c_debug
+#define LATENCY_BUCKETS             16                  //  Histogram buckets
+#define LATENCY_BUCKET_SHIFT        11                  //  2048 microseconds per bucket, 0 - 32ms
+
+uint32_t s_line_capture_time[A2C_FRAME_BUFFERS][192];  //  time_us_32() when a2c_loop received the 18th word of a line
+uint32_t s_line_render_capture_time[192];           //  Capture time of the data that was rendered into the TMDS line, 0 if not captured video
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t histogram[LATENCY_BUCKETS];
+} a2c_latency_t;
+
+a2c_latency_t s_latency = { 0, 0xFFFFFFFF, 0, 0, { 0 } };          //  Updated in the DVI DMA IRQ
+a2c_latency_t s_latency_shown = { 0, 0xFFFFFFFF, 0, 0, { 0 } };    //  Snapshot for the debug monitor
+
 
 //  We repurpose cfg_color_style, default is 2
 //  We do this so that the config stored in flash doesn't change between firmware (A2DVI and A2C_DVI)
@@ -184,6 +235,33 @@ bool __time_critical_func(repeating_timer_callback)(__unused struct repeating_ti
     return true;
 }
 
+//  Called from the DVI DMA IRQ when the TMDS buffer of a row has been loaded for output
+void __time_critical_func(a2c_latency_scanline_loaded)(uint row)
+{
+    uint32_t line = row - LATENCY_TOP_ROWS;
+
+    if (line >= 192)
+        return;                                                     //  Debug rows above or below the screen area
+
+    uint32_t capture_time = s_line_render_capture_time[line];
+    if (capture_time == 0)
+        return;                                                     //  Menu or error screen, not captured video
+
+    uint32_t latency = time_us_32() - capture_time;
+
+    s_latency.count++;
+    s_latency.sum += latency;
+    if (latency < s_latency.min)
+        s_latency.min = latency;
+    if (latency > s_latency.max)
+        s_latency.max = latency;
+
+    uint32_t bucket = latency >> LATENCY_BUCKET_SHIFT;
+    if (bucket >= LATENCY_BUCKETS)
+        bucket = LATENCY_BUCKETS - 1;
+    s_latency.histogram[bucket]++;
+}
+
 //  Reboot the machine
 bool s_needs_reboot = false;
 bool s_save_required = false;
@@ -266,6 +344,80 @@ static bool DELAYED_COPY_CODE(color_command)(char * command_name, int index, boo
     return result;
 }
 
+//  Color LUT adjustments: "-", the value (selecting it goes back to 0) and "+", see a2c_lut.h
+static char s_hue_text[4];
+static char s_saturation_text[4];
+static char s_brightness_text[4];
+static char s_sharpness_text[4];
+
+static bool DELAYED_COPY_CODE(adjust_command)(int8_t* value, int min, int max, char * command_name, int index, bool update)
+{
+    bool result = false;
+
+    if (update == true)
+    {
+        if ((index == 0) && (*value > min))
+            (*value)--;
+        else if (index == 1)
+            *value = 0;
+        else if ((index == 2) && (*value < max))
+            (*value)++;
+
+        s_save_required = true;
+    }
+    else if (index == 1)
+    {
+        //  Show the value, padded to clear a longer one
+        int number = (*value < 0) ? -*value : *value;
+        uint i = 0;
+        if (*value != 0)
+            command_name[i++] = (*value < 0) ? '-' : '+';
+        if (number >= 10)
+            command_name[i++] = '0' + number / 10;
+        command_name[i++] = '0' + number % 10;
+        while (i < 3)
+            command_name[i++] = ' ';
+        command_name[i] = 0;
+
+        result = (*value == 0);
+    }
+
+    return result;
+}
+
+static bool DELAYED_COPY_CODE(hue_command)(char * command_name, int index, bool update, bool selected)
+{
+    return adjust_command(&cfg_ntsc_hue, A2C_LUT_HUE_MIN, A2C_LUT_HUE_MAX, command_name, index, update);
+}
+
+static bool DELAYED_COPY_CODE(saturation_command)(char * command_name, int index, bool update, bool selected)
+{
+    return adjust_command(&cfg_ntsc_saturation, A2C_LUT_SATURATION_MIN, A2C_LUT_SATURATION_MAX, command_name, index, update);
+}
+
+static bool DELAYED_COPY_CODE(brightness_command)(char * command_name, int index, bool update, bool selected)
+{
+    return adjust_command(&cfg_ntsc_brightness, A2C_LUT_BRIGHTNESS_MIN, A2C_LUT_BRIGHTNESS_MAX, command_name, index, update);
+}
+
+static bool DELAYED_COPY_CODE(sharpness_command)(char * command_name, int index, bool update, bool selected)
+{
+    return adjust_command(&cfg_ntsc_sharpness, A2C_LUT_SHARPNESS_MIN, A2C_LUT_SHARPNESS_MAX, command_name, index, update);
+}
+
+//  Menu over the video with a shaded or a solid background, see a2c_osd.h
+static bool DELAYED_COPY_CODE(osd_command)(char * command_name, int index, bool update, bool selected)
+{
+    bool result = false;
+
+    if (update == true)
+        a2c_osd_shade = (index == 0);
+    else
+        result = (a2c_osd_shade == (index == 0));
+
+    return result;
+}
+
 //  Scanlines on / off
 static bool DELAYED_COPY_CODE(scanline_command)(char * command_name, int index, bool update, bool selected)
 {
@@ -340,21 +492,20 @@ static bool DELAYED_COPY_CODE(video_command)(char * command_name, int index, boo
 
     if (update == true)
     {
+        //  The resolution is switched by the render loop, at the end of the frame
         if (index == 0)
         {
-            if (cfg_video_mode != Dvi720x480)
+            if ((cfg_video_mode & 1) != Dvi720x480)
             {
-                cfg_video_mode = Dvi720x480;
-                s_needs_reboot = true;
+                cfg_video_mode = Dvi720x480 | 0x10;
                 s_save_required = true;
             }
         }
         else if (index == 1)
         {
-            if (cfg_video_mode != Dvi640x480)
+            if ((cfg_video_mode & 1) != Dvi640x480)
             {
-                cfg_video_mode = Dvi640x480;
-                s_needs_reboot = true;
+                cfg_video_mode = Dvi640x480 | 0x10;
                 s_save_required = true;
             }
         }
@@ -363,15 +514,39 @@ static bool DELAYED_COPY_CODE(video_command)(char * command_name, int index, boo
     {
         mono_rendering = (internal_flags & IFLAGS_FORCED_MONO);
 
-        if ((index == 0) && (cfg_video_mode == Dvi720x480))
+        if ((index == 0) && ((cfg_video_mode & 1) == Dvi720x480))
             result = true;
-        else if ((index == 1) && (cfg_video_mode == Dvi640x480))
+        else if ((index == 1) && ((cfg_video_mode & 1) == Dvi640x480))
             result = true;
     }
 
     return result;
 }
 
+//  HDMI AVI InfoFrame content type, TVs switch to their low latency mode for GAME
+static bool DELAYED_COPY_CODE(hdmi_command)(char * command_name, int index, bool update, bool selected)
+{
+    const HdmiContent_t content[3] = { HdmiContentNone, HdmiContentGame, HdmiContentGraphics };
+    bool result = false;
+
+    if (update == true)
+    {
+        //  The DVI output is restarted by the render loop, at the end of the frame
+        if (cfg_hdmi_content != content[index])
+        {
+            cfg_hdmi_content = content[index];
+            cfg_video_mode |= 0x10;
+            s_save_required = true;
+        }
+    }
+    else
+    {
+        result = (cfg_hdmi_content == content[index]);
+    }
+
+    return result;
+}
+
 //  Save / Load defaults
 static bool DELAYED_COPY_CODE(config_command)(char * command_name, int index, bool update, bool selected)
 {
@@ -431,6 +606,80 @@ static bool DELAYED_COPY_CODE(debug_command)(char * command_name, int index, boo
     return result;
 }
 
+#ifdef FEATURE_A2C_RECORD
+//  Record Start / Stop, see a2c_record.h
+static bool DELAYED_COPY_CODE(record_command)(char * command_name, int index, bool update, bool selected)
+{
+    bool result = false;
+
+    if (update == true)
+    {
+        if ((index == 0) && (a2c_record_start()))
+        {
+            //  Leave the screen, the recording starts with the next frame
+            s_show_menu_screen = false;
+
+            while (gpio_get(PIN_BUTTON))
+            {
+            }
+        }
+        if (index == 1)
+            a2c_record_stop();
+    }
+    else
+    {
+        if (index == 0)
+            result = (a2c_record_state != A2cRecordIdle);   //  Recording
+        if (index == 1)
+            result = (a2c_record_state == A2cRecordIdle);
+    }
+
+    return result;
+}
+#endif
+
+#ifdef FEATURE_A2C_SCREENSHOT
+//  Take a screenshot, see a2c_screenshot.h
+static bool DELAYED_COPY_CODE(screenshot_command)(char * command_name, int index, bool update, bool selected)
+{
+    bool result = false;
+
+    if (update == true)
+    {
+        if (a2c_screenshot_start())
+        {
+            //  Leave the screen, the screenshot is taken from the next frame
+            s_show_menu_screen = false;
+
+            while (gpio_get(PIN_BUTTON))
+            {
+            }
+        }
+    }
+    else
+    {
+        result = (a2c_screenshot_state != A2cScreenshotIdle);   //  Being taken
+    }
+
+    return result;
+}
+#endif
+
+#ifdef FEATURE_A2C_TEXT
+//  Text rows from the dots or with the charset, see a2c_text.h
+static bool DELAYED_COPY_CODE(text_command)(char * command_name, int index, bool update, bool selected)
+{
+    bool result = false;
+
+    if (update == true)
+        a2c_text_render = (index == 1);
+    else
+        result = (a2c_text_render == (index == 1));
+
+    return result;
+}
+#endif
+
 #ifdef FEATURE_A2_AUDIO
 //  Sound Off / On
 static bool DELAYED_COPY_CODE(audio_command)(char * command_name, int index, bool update, bool selected)
@@ -594,6 +843,10 @@ struct menu_commands DELAYED_COPY_DATA(a2c_menu_items_main)[] =
     { "", { {"", NULL }, {"", NULL }, {"", NULL } } },
     { "VIDEO:", { {"720X480", video_command }, {"640X480", video_command }, {"", NULL } } },
     { "", { {"", NULL }, {"", NULL }, {"", NULL } } },
+#ifdef FEATURE_A2C_SCREENSHOT
+    { "SHOT:", { {"TAKE", screenshot_command }, {"", NULL }, {"", NULL } } },
+    { "", { {"", NULL }, {"", NULL }, {"", NULL } } },
+#endif
     { "SET:", { {"SAVE", config_command }, {"DEFAULT", config_command }, {"MORE", config_command } } },
     { "", { {"", NULL }, {"", NULL }, {"", NULL } } },
     { "EXIT", { {"", exit_command }, {"", NULL }, {"", NULL } } }
@@ -611,17 +864,47 @@ struct menu_commands DELAYED_COPY_DATA(a2c_menu_items_aux)[] =
     { "TONE:", { {"OFF", tone_command }, {"ON", tone_command }, {"", NULL } } },
     { "", { {"", NULL }, {"", NULL }, {"", NULL } } },
 #endif
+    { "HDMI:", { {"OFF", hdmi_command }, {"GAME", hdmi_command }, {"GRAPHICS", hdmi_command } } },
+    { "", { {"", NULL }, {"", NULL }, {"", NULL } } },
     { "TYPE:", { {"IIC", machine_command }, {"LASER", machine_command }, {"", NULL } } },
     { "", { {"", NULL }, {"", NULL }, {"", NULL } } },
     { "DEBUG:", { {"OFF", debug_command }, {"ON", debug_command }, {"", NULL } } },
     { "", { {"", NULL }, {"", NULL }, {"", NULL } } },
-    { "SET:", { {"SAVE", config_command }, {"DEFAULT", config_command }, {"BACK", config_command } } },
+#ifdef FEATURE_A2C_RECORD
+    { "RECORD:", { {"START", record_command }, {"STOP", record_command }, {"", NULL } } },
+    { "", { {"", NULL }, {"", NULL }, {"", NULL } } },
+#endif
+#ifdef FEATURE_A2C_TEXT
+    { "TEXT:", { {"DOTS", text_command }, {"FONT", text_command }, {"", NULL } } },
+    { "", { {"", NULL }, {"", NULL }, {"", NULL } } },
+#endif
+    { "SET:", { {"SAVE", config_command }, {"DEFAULT", config_command }, {"MORE", config_command } } },
     { "", { {"", NULL }, {"", NULL }, {"", NULL } } },
     { "EXIT", { {"", exit_command }, {"", NULL }, {"", NULL } } }
 };
 
 uint32_t a2c_menu_items_aux_size = sizeof(a2c_menu_items_aux) / sizeof(a2c_menu_items_aux[0]);
 
+//  Adjustments of the NTSC and CLAMP colors
+struct menu_commands DELAYED_COPY_DATA(a2c_menu_items_color)[] = 
+{
+    { "HUE:", { {"-", hue_command }, {s_hue_text, hue_command }, {"+", hue_command } } },
+    { "", { {"", NULL }, {"", NULL }, {"", NULL } } },
+    { "SAT:", { {"-", saturation_command }, {s_saturation_text, saturation_command }, {"+", saturation_command } } },
+    { "", { {"", NULL }, {"", NULL }, {"", NULL } } },
+    { "BRIGHT:", { {"-", brightness_command }, {s_brightness_text, brightness_command }, {"+", brightness_command } } },
+    { "", { {"", NULL }, {"", NULL }, {"", NULL } } },
+    { "SHARP:", { {"-", sharpness_command }, {s_sharpness_text, sharpness_command }, {"+", sharpness_command } } },
+    { "", { {"", NULL }, {"", NULL }, {"", NULL } } },
+    { "OSD:", { {"SHADE", osd_command }, {"SOLID", osd_command }, {"", NULL } } },
+    { "", { {"", NULL }, {"", NULL }, {"", NULL } } },
+    { "SET:", { {"SAVE", config_command }, {"DEFAULT", config_command }, {"BACK", config_command } } },
+    { "", { {"", NULL }, {"", NULL }, {"", NULL } } },
+    { "EXIT", { {"", exit_command }, {"", NULL }, {"", NULL } } }
+};
+
+uint32_t a2c_menu_items_color_size = sizeof(a2c_menu_items_color) / sizeof(a2c_menu_items_color[0]);
+
 struct menu_commands* s_current_menu_screen = a2c_menu_items_main;
 uint32_t s_current_menu_screen_size = sizeof(a2c_menu_items_main) / sizeof(a2c_menu_items_main[0]);
 
@@ -630,6 +913,8 @@ const uint8_t s_init_menu_text[24] =   { 0x20, 0x1F, 0x20, 0x20, 0x5C, 0x20, 0x1
 const uint8_t s_init_menu_colors[24] = { 0x30, 0x30, 0x70, 0x70, 0x70, 0x70, 0x70, 0x10, 0x10, 0x90, 0x90, 0xB0, 0xB0, 0xE0, 0xE0, 0x60, 0x60, 0x30, 0x30, 0xF0, 0xF0, 0x70, 0x70, 0x70 };
 
 #define BGCOLOR (2)
+#define MENU_HEADER_ROWS    6                               //  Rendered with ALTCHAR, the rules are mouse text
+#define MENU_ALTCHAR_ROWS   ((1u << MENU_HEADER_ROWS) - 1)
 #define TEXT_OFFSET(line) ((((line) & 0x7) << 7) + ((((line) >> 3) & 0x3) * 40))
 
 static void DELAYED_COPY_CODE(init_menu_screen)(void)
@@ -713,6 +998,7 @@ static void DELAYED_COPY_CODE(show_menu)(void)
     s_menu_cursor_X = 0;
     s_menu_cursor_Y = 0;
     s_menu_cursor_vertical_direction = true;
+    s_menu_redraw = true;
 }
 
 static void DELAYED_COPY_CODE(menu_short_press)(void)
@@ -751,6 +1037,8 @@ static void DELAYED_COPY_CODE(menu_short_press)(void)
     //  Bounds checks
     s_menu_cursor_X = s_menu_cursor_X % 4;
     s_menu_cursor_Y = s_menu_cursor_Y % (s_current_menu_screen_size);
+
+    s_menu_redraw = true;
 }
 
 static void DELAYED_COPY_CODE(menu_long_press)(void)
@@ -792,6 +1080,8 @@ static void DELAYED_COPY_CODE(menu_long_press)(void)
             s_menu_cursor_vertical_direction = true;
         }
     }
+
+    s_menu_redraw = true;
 }
 
 static void DELAYED_COPY_CODE(toggle_menu_screen)(void)
@@ -801,6 +1091,11 @@ static void DELAYED_COPY_CODE(toggle_menu_screen)(void)
         s_current_menu_screen = a2c_menu_items_aux;
         s_current_menu_screen_size = a2c_menu_items_aux_size;
     }
+    else if (s_current_menu_screen == a2c_menu_items_aux)
+    {
+        s_current_menu_screen = a2c_menu_items_color;
+        s_current_menu_screen_size = a2c_menu_items_color_size;
+    }
     else
     {
         s_current_menu_screen = a2c_menu_items_main;
@@ -1012,6 +1307,11 @@ void DELAYED_COPY_CODE(update_a2c_debug_monitor)(void)
         int2str(frame_counter, s_temp_line_buffer, 8);
         copy_str(&line2[0+8], s_temp_line_buffer);
 
+        //  DVI blackout of the last resolution change, in microseconds
+        copy_str(&line2[16], "SW:");
+        int2str((a2dvi_switch_time < 99999) ? a2dvi_switch_time : 99999, s_temp_line_buffer, 5);
+        copy_str(&line2[16+3], s_temp_line_buffer);
+
 #ifdef FEATURE_A2_AUDIO
         copy_str(&line2[7+4+1+7+4+1], "SND: ");
         float time_f = s_total_PIO_time / 1000000.0;
@@ -1023,27 +1323,94 @@ void DELAYED_COPY_CODE(update_a2c_debug_monitor)(void)
         copy_str(&line2[7+4+1+7+4+1+6], s_temp_line_buffer);
 #endif
 
-        if (cfg_video_mode == Dvi720x480)
+        if ((cfg_video_mode & 1) == Dvi720x480)
         {
             copy_str(&line3[0], "720x480");
-        } else if (cfg_video_mode == Dvi640x480)
+        } else if ((cfg_video_mode & 1) == Dvi640x480)
         {
             copy_str(&line3[0], "640x480");
         }
 
-        int2hex(&line3[18], s_debug_value_1, 8);
-        int2hex(&line3[18+9], s_debug_value_2, 8);
+        //  Time to the first frame, in milliseconds
+        copy_str(&line3[8], "BT:");
+        int2str(boot_time / 1000, s_temp_line_buffer, 5);
+        copy_str(&line3[8+3], s_temp_line_buffer);
+
+#ifdef FEATURE_RENDER_BENCH
+        //  Instead: CPU cycles per scanline, worst and average of the last 64 frames
+        copy_str(&line3[0], "LC:");
+        int2str(render_bench_worst, s_temp_line_buffer, 7);
+        copy_str(&line3[3], s_temp_line_buffer);
+        int2str(render_bench_average, s_temp_line_buffer, 7);
+        copy_str(&line3[3+7], s_temp_line_buffer);
+#endif
+
     }
 
+    if ((frame_counter & 0x3F) == 0)        //  About once a second, show the next two boot milestones (name, ms since boot)
+    {                                       //  followed by the RAM budget (name, KB)
+        static uint32_t milestone_index = 0;
+        boot_milestone_t milestone;
+        ram_budget_t budget;
+
+        if (milestone_index >= boot_milestone_count() + ram_budget_count())
+            milestone_index = 0;
 
-    if ((frame_counter & 0x0F) == 0)         // do not update too fast, so data remains readable
+        for (uint i = 0; i < 2; i++)
+        {
+            copy_str(&line3[18+i*11], "           ");
+            if (boot_milestone_get(milestone_index, &milestone))
+            {
+                copy_str(&line3[18+i*11], milestone.name);
+                int2str(milestone.time_us / 1000, s_temp_line_buffer, 5);
+                copy_str(&line3[18+i*11+5], s_temp_line_buffer);
+                milestone_index++;
+            }
+            else if (ram_budget_get(milestone_index - boot_milestone_count(), &budget))
+            {
+                copy_str(&line3[18+i*11], budget.name);
+                int2str((budget.bytes + 1023) / 1024, s_temp_line_buffer, 4);
+                copy_str(&line3[18+i*11+5], s_temp_line_buffer);
+                copy_str(&line3[18+i*11+9], "K");
+                milestone_index++;
+            }
+        }
+    }
+
+    if ((frame_counter & 0x3F) == 0)        //  About once a second, take a snapshot of the latency statistics and start over
     {
-        //  Display a bit of screen data
-        int y = 0;
-        int2hex(&line4[0], s_screen_buffer[y][0], 8);
-        int2hex(&line4[9], s_screen_buffer[y][1], 8);
-        int2hex(&line4[18], s_screen_buffer[y][2], 8);
-        int2hex(&line4[18+9], s_screen_buffer[y][3], 8);
+        uint32_t flags = save_and_disable_interrupts();
+        s_latency_shown = s_latency;
+        memset(&s_latency, 0, sizeof(s_latency));
+        s_latency.min = 0xFFFFFFFF;
+        restore_interrupts(flags);
+
+        //  LAT: min/avg/max in microseconds
+        uint32_t average = (s_latency_shown.count != 0) ? (uint32_t)(s_latency_shown.sum / s_latency_shown.count) : 0;
+        uint32_t minimum = (s_latency_shown.count != 0) ? s_latency_shown.min : 0;
+
+        copy_str(&line4[0], "LAT:");
+        int2str(minimum, s_temp_line_buffer, 5);
+        copy_str(&line4[4], s_temp_line_buffer);
+        int2str(average, s_temp_line_buffer, 5);
+        copy_str(&line4[4+6], s_temp_line_buffer);
+        int2str(s_latency_shown.max, s_temp_line_buffer, 5);
+        copy_str(&line4[4+6+6], s_temp_line_buffer);
+
+        //  Histogram, one digit (0-F) per 2ms bucket, scaled to the largest bucket
+        uint32_t largest = 0;
+        for (uint i = 0; i < LATENCY_BUCKETS; i++)
+        {
+            if (s_latency_shown.histogram[i] > largest)
+                largest = s_latency_shown.histogram[i];
+        }
+
+        copy_str(&line4[4+6+6+6], "H:");
+        for (uint i = 0; i < LATENCY_BUCKETS; i++)
+        {
+            uint32_t level = (largest != 0) ? (s_latency_shown.histogram[i] * 15 + largest - 1) / largest : 0;
+            int2hex(&line4[4+6+6+6+2+i], level, 1);
+        }
     }
 #endif
 }
@@ -1114,23 +1481,380 @@ void DELAYED_COPY_CODE(render_a2c_debug)(bool IsVidexMode, bool top)
     }
 }
 
+//  Only the hires color LUT of the active color style is kept in RAM, the others stay in flash.
+//  It is loaded with DMA in the background, while the splash screen (or the previous frame) is shown.
+//  Lines are rendered in B&W until the LUT is ready.
+#define LUT_ENTRIES(taps)   (2 << (taps))              //  a window of taps dots plus the phase bit
+#define LUT_PAD_PAIRS(taps) (((taps) / 2 - 1) / 2)     //  black pixel pairs in front, the LUT returns the middle of the window
+
+#if !defined(NO_NTSC_LUT) && (LUT_ENTRIES(HGRDECODE_NTSC_TAPS) > LUT_ENTRIES(HGRDECODE_CLAMP_TAPS))
+#define HIRES_LUT_MAX       LUT_ENTRIES(HGRDECODE_NTSC_TAPS)
+#else
+#define HIRES_LUT_MAX       LUT_ENTRIES(HGRDECODE_CLAMP_TAPS)
+#endif
+
+#if HIRES_LUT_MAX > 512
+#define HIRES_LUT_SIZE      HIRES_LUT_MAX
+#else
+#define HIRES_LUT_SIZE      512                         //  A2DVI
+#endif
+
+uint32_t RENDER_LUT_BSS(s_hires_lut_red)[HIRES_LUT_SIZE];
+uint32_t RENDER_LUT_BSS(s_hires_lut_green)[HIRES_LUT_SIZE];
+uint32_t RENDER_LUT_BSS(s_hires_lut_blue)[HIRES_LUT_SIZE];
+
+static int      s_lut_dma_channel = -1;
+static int      s_lut_style = -1;                   //  Color style of the LUT in RAM (or being loaded)
+static uint     s_lut_part = 0;                     //  Number of LUT parts (red, green, blue) started
+static bool     s_first_frame_shown = false;
+static uint32_t s_lut_adjustments = 0;              //  Color adjustments of the LUT in RAM, 0 for the one in flash
+static bool     s_lut_synthesized = false;          //  The LUT in RAM is built by the capture core (a2c_lut.c)
+
+//  Build time parameters of the LUTs, for the synthesis with the color adjustments
+static const a2c_lut_params_t s_lut_params_clamp = { HGRDECODE_CLAMP_TAPS, HGRDECODE_CLAMP_PHASE, HGRDECODE_CLAMP_LUMA, HGRDECODE_CLAMP_CHROMA,
+                                                     HGRDECODE_CLAMP_SATURATION, HGRDECODE_CLAMP_HUE_COS, HGRDECODE_CLAMP_HUE_SIN };
+#ifndef NO_NTSC_LUT
+static const a2c_lut_params_t s_lut_params_ntsc  = { HGRDECODE_NTSC_TAPS, HGRDECODE_NTSC_PHASE, HGRDECODE_NTSC_LUMA, HGRDECODE_NTSC_CHROMA,
+                                                     HGRDECODE_NTSC_SATURATION, HGRDECODE_NTSC_HUE_COS, HGRDECODE_NTSC_HUE_SIN };
+#endif
+
+//  Load the LUT for the active color style, returns true when it is ready to use
+bool DELAYED_COPY_CODE(a2c_lut_update)(void)
+{
+    bool synthesize = (cfg_color_style != CS_A2DVI) && a2c_lut_adjusted();
+    uint32_t adjustments = synthesize ? a2c_lut_adjustments() : 0;
+
+    if ((s_lut_style != cfg_color_style) || (s_lut_adjustments != adjustments))
+    {
+        //  Color style or adjustments changed (or first call), start over
+        if ((s_lut_dma_channel >= 0) && (s_lut_part != 0))
+            dma_channel_abort(s_lut_dma_channel);
+
+        s_lut_style = cfg_color_style;
+        s_lut_adjustments = adjustments;
+        s_lut_part = 0;
+
+        if (synthesize)
+        {
+            const a2c_lut_params_t* params = &s_lut_params_clamp;
+#ifndef NO_NTSC_LUT
+            if (s_lut_style == CS_NTSC)
+                params = &s_lut_params_ntsc;
+#endif
+            a2c_lut_synth_request(params, s_hires_lut_red, s_hires_lut_green, s_hires_lut_blue);
+        }
+        else if (s_lut_synthesized)
+        {
+            //  Stop the capture core writing to the LUT before it is loaded from flash
+            a2c_lut_synth_request(NULL, NULL, NULL, NULL);
+        }
+        s_lut_synthesized = synthesize;
+    }
+
+    //  Wait for the capture core to complete (or cancel) the synthesis
+    if (a2c_lut_synth_done() == false)
+        return false;
+
+    if (s_lut_synthesized)
+    {
+        s_lut_part = 3;
+        return true;
+    }
+
+    if ((s_lut_dma_channel >= 0) && (dma_channel_is_busy(s_lut_dma_channel)))
+        return false;
+
+    if (s_lut_part == 3)
+        return true;
+
+    const uint32_t* source[3] = { tmds_hgrdecode_clamp_LUT_red, tmds_hgrdecode_clamp_LUT_green, tmds_hgrdecode_clamp_LUT_blue };
+    uint32_t size = sizeof(tmds_hgrdecode_clamp_LUT_red);
+
+    if (s_lut_style == CS_A2DVI)
+    {
+        source[0] = tmds_hires_color_patterns_red;
+        source[1] = tmds_hires_color_patterns_green;
+        source[2] = tmds_hires_color_patterns_blue;
+        size = sizeof(tmds_hires_color_patterns_red);
+    }
+#ifndef NO_NTSC_LUT
+    else if (s_lut_style == CS_NTSC)
+    {
+        source[0] = tmds_hgrdecode_ntsc_LUT_red;
+        source[1] = tmds_hgrdecode_ntsc_LUT_green;
+        source[2] = tmds_hgrdecode_ntsc_LUT_blue;
+        size = sizeof(tmds_hgrdecode_ntsc_LUT_red);
+    }
+#endif
+
+    uint32_t* destination[3] = { s_hires_lut_red, s_hires_lut_green, s_hires_lut_blue };
+
+    if (s_lut_dma_channel < 0)
+    {
+        s_lut_dma_channel = dma_claim_unused_channel(false);
+        if (s_lut_dma_channel < 0)
+        {
+            //  No DMA channel left, just copy it
+            for (; s_lut_part < 3; s_lut_part++)
+                memcpy(destination[s_lut_part], source[s_lut_part], size);
+        }
+    }
+
+    if (s_lut_part < 3)
+    {
+        //  Default (low) priority, so the DVI DMA always wins.  No DREQ, transfers as fast as it can
+        dma_channel_config config = dma_channel_get_default_config(s_lut_dma_channel);
+        channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+        channel_config_set_read_increment(&config, true);
+        channel_config_set_write_increment(&config, true);
+        dma_channel_configure(s_lut_dma_channel, &config, destination[s_lut_part], source[s_lut_part], size / 4, true);
+        s_lut_part++;
+        return false;
+    }
+
+    s_lut_part = 3;
+
+    return true;
+}
+
+//  RAM of the A2C buffers, for the RAM budget on the debug monitor
+void DELAYED_COPY_CODE(a2c_ram_budget)(void)
+{
+    ram_budget_add("FRM", sizeof(s_screen_buffer) + sizeof(s_screen_GR_mask) + sizeof(s_screen_TEXT_mask) +
+                          sizeof(s_screen_D7_buffer) + sizeof(s_line_capture_time));
+    ram_budget_add("LUT", sizeof(s_hires_lut_red) + sizeof(s_hires_lut_green) + sizeof(s_hires_lut_blue));
+#if defined(FEATURE_A2C_RECORD) || defined(FEATURE_A2C_STREAM)
+    a2c_delta_ram_budget();
+#endif
+#ifdef FEATURE_A2C_RECORD
+    a2c_record_ram_budget();
+#endif
+#ifdef FEATURE_A2C_SCREENSHOT
+    a2c_screenshot_ram_budget();
+#endif
+#ifdef FEATURE_A2C_STREAM
+    a2c_stream_ram_budget();
+#endif
+#ifdef FEATURE_A2C_TEXT
+    a2c_text_ram_budget();
+#endif
+}
+
+//  Bit reversal of a byte, the SEROUT dots are MSB first and the video bytes LSB first
+#define REVERSE2(n) n, n + 2*64, n + 1*64, n + 3*64
+#define REVERSE4(n) REVERSE2(n), REVERSE2(n + 2*16), REVERSE2(n + 1*16), REVERSE2(n + 3*16)
+#define REVERSE6(n) REVERSE4(n), REVERSE4(n + 2*4), REVERSE4(n + 1*4), REVERSE4(n + 3*4)
+static uint8_t DELAYED_COPY_DATA(s_reverse_bits)[256] = { REVERSE6(0), REVERSE6(2), REVERSE6(1), REVERSE6(3) };
+
+//  Rebuild the video bytes of a captured line from the SEROUT dots, for the byte based renderers.
+//  Hires: each byte is 14 dots, the second dot of each pair is the bit whether the byte is delayed by
+//  a dot or not. The delay (bit 7) is VIDD7, or seen in the dots if VIDD7 isn't connected: a delayed
+//  byte only shows the same dots as an undelayed one when all its dots are the same anyway.
+//  Double hires: 7 dots of the aux byte, then 7 dots of the main byte.
+//  Text and lores can't be rebuilt, the character and the colour nibble aren't in the dots. Lores has
+//  the pin states of hires though: returns false when the hires bytes don't give the captured dots
+//  again (the dots of a delayed byte are pairs after the stretched dot, of an undelayed one pairs).
+bool DELAYED_COPY_CODE(a2c_line_bytes)(uint frame, uint line, bool dhgr, uint8_t* main, uint8_t* aux)
+{
+    const uint32_t* screen_line = s_screen_buffer[frame][line];
+    uint64_t d7 = s_screen_D7_buffer[frame][line];
+    bool same = true;
+
+    for (uint i = 0; i < 40; i++)
+    {
+        //  14 dots of the byte, the first one in bit 13, and the dot before it in bit 14,
+        //  the blank word 19 ends the line
+        uint pos = A2C_FIRST_BYTE_DOT + (14 * i) - 1;
+        uint shift = pos & 31;
+        uint32_t dots = screen_line[pos >> 5] << shift;
+        if (shift > 17)
+            dots |= screen_line[(pos >> 5) + 1] >> (32 - shift);
+        uint32_t previous = dots >> 31;
+        dots = (dots >> 17) & 0x3fff;
+
+        if (dhgr)
+        {
+            aux[i]  = s_reverse_bits[dots >> 7] >> 1;
+            main[i] = s_reverse_bits[dots & 0x7f] >> 1;
+        }
+        else
+        {
+            //  The second dot of each pair (the even bits), packed into 7 bits
+            uint32_t bits = dots & 0x1555;
+            bits = (bits | (bits >> 1)) & 0x3333;
+            bits = (bits | (bits >> 2)) & 0x0f0f;
+            bits = (bits | (bits >> 4)) & 0x00ff;
+
+            uint8_t value = s_reverse_bits[bits] >> 1;
+            if ((((d7 >> i) & 1) != 0) || (((dots ^ (dots >> 1)) & 0x1555) != 0))
+                value |= 0x80;
+            main[i] = value;
+
+            if (value & 0x80)
+                same &= (((dots ^ (dots >> 1)) & 0x0aaa) == 0) && ((dots >> 13) == previous);
+            else
+                same &= (((dots ^ (dots >> 1)) & 0x1555) == 0);
+        }
+    }
+    return same;
+}
+
 //  These are the render modes that are supported.
 typedef enum {
     RM_BW          = 0,
     RM_A2DVI       = 1,
     RM_NTSC        = 2,
-    RM_CLAMP       = 3
+    RM_CLAMP       = 3,
+    RM_HGR         = 4,     //  Video bytes rebuilt from SEROUT, rendered like the slotted firmware
+    RM_DHGR        = 5
 } a2c_render_mode_mode_t;
 
-static void DELAYED_COPY_CODE(render_a2c_full_line)(a2c_render_mode_mode_t render_mode, uint line)        //  volatile uint32_t screen_buffer[192][18]
+//  Sends a rendered line to libdvi
+static inline void a2c_send_scanline(uint32_t* tmdsbuf, uint line)
+{
+#ifdef FEATURE_A2C_SCREENSHOT
+    a2c_screenshot_line(line, tmdsbuf);
+#endif
+    //  The menu over the video
+    if (s_show_menu_screen)
+        a2c_osd_line(tmdsbuf, line);
+    dvi_send_scanline(tmdsbuf);
+}
+
+//  A B&W line the PIO is still encoding (tmds_mono.h), sent before the next scanline
+static uint32_t* s_mono_scanline;
+static uint s_mono_line;
+
+static void DELAYED_COPY_CODE(a2c_send_mono_scanline)(void)
+{
+    if (s_mono_scanline)
+    {
+        tmds_mono_wait();
+        a2c_send_scanline(s_mono_scanline, s_mono_line);
+        s_mono_scanline = NULL;
+    }
+}
+
+//  Render a graphics line with the hires or double hires renderer of the slotted firmware, from the
+//  video bytes rebuilt by a2c_line_bytes
+static void DELAYED_COPY_CODE(render_a2c_byte_line)(a2c_render_mode_mode_t render_mode, uint line, const uint8_t* line_main, const uint8_t* line_aux)
+{
+    dvi_get_scanline(tmdsbuf);
+    dvi_scanline_rgb(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
+
+    uint64_t start_time = to_us_since_boot (get_absolute_time());
+
+    //  Remember which capture we are about to render, for the latency statistics
+    s_line_render_capture_time[line] = s_line_capture_time[s_display_frame][line];
+
+    //  Line the 280 pixel pairs of the bytes up with the SEROUT dots of the other lines
+    uint32_t left_margin = ((dvi_x_resolution - (32 * 18)) / 8) * 2 + ((A2C_FIRST_BYTE_DOT + 1) / 2);
+    uint32_t right_margin = (dvi_x_resolution / 2) - left_margin - 280;
+
+    for(uint i = 0; i < left_margin; i++)
+    {
+        *(tmdsbuf_red++)   = TMDS_SYMBOL_0_0;
+        *(tmdsbuf_green++) = TMDS_SYMBOL_0_0;
+        *(tmdsbuf_blue++)  = TMDS_SYMBOL_0_0;
+    }
+
+    if (render_mode == RM_DHGR)
+        render_dhgr_bytes(line_main, line_aux, false, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
+    else
+        render_hires_bytes(line_main, false, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
+
+    for(uint i = 280; i < 280 + right_margin; i++)
+    {
+        *(tmdsbuf_red+i)   = TMDS_SYMBOL_0_0;
+        *(tmdsbuf_green+i) = TMDS_SYMBOL_0_0;
+        *(tmdsbuf_blue+i)  = TMDS_SYMBOL_0_0;
+    }
+
+    uint64_t end_time = to_us_since_boot (get_absolute_time());
+    s_total_render_time = end_time - s_a2c_boot_time;
+    s_render_time = s_render_time + (end_time - start_time);
+
+    a2c_send_mono_scanline();
+    a2c_send_scanline(tmdsbuf, line);
+}
+
+#ifdef FEATURE_A2C_TEXT
+//  Render a text row recognized by a2c_text.c with the text renderer of the slotted firmware (charset
+//  and mono color), the 8 lines starting at "line". Returns false when the row is rendered from the dots.
+static bool DELAYED_COPY_CODE(render_a2c_text_row)(uint line)
+{
+    //  The text renderer sends its lines to libdvi itself, the OSD and the screenshot would miss them
+    if (((line & 7) != 0) || (a2c_text_render == false) || (s_show_menu_screen))
+        return false;
+#ifdef FEATURE_A2C_SCREENSHOT
+    if (a2c_screenshot_state != A2cScreenshotIdle)
+        return false;
+#endif
+
+    //  The codes go to the text page 2 of the Apple II memory, which the A2C doesn't use
+    uint row = line / 8;
+    uint offset = ((row & 0x7) << 7) + (((row >> 3) & 0x3) * 40);
+    bool altchar;
+    uint32_t columns = a2c_text_row(s_display_frame, row, (uint8_t*)(text_p2 + offset), (uint8_t*)(text_p4 + offset), &altchar);
+    if (columns == 0)
+        return false;
+
+    for (uint i = 0; i < 8; i++)
+        s_line_render_capture_time[line + i] = s_line_capture_time[s_display_frame][line + i];
+
+    a2c_send_mono_scanline();
+
+    //  The codes are character ROM indices shown with ALTCHAR, or inverse characters the ROM lacks without it
+    uint32_t softsw = soft_switches;
+    if (altchar)
+        soft_switches |= SOFTSW_ALTCHAR;
+    else
+        soft_switches &= ~SOFTSW_ALTCHAR;
+    if (columns == 80)
+        render_text80_line((const uint8_t*)text_p2, (const uint8_t*)text_p4, row, color_mode);
+    else
+        render_text40_line((const uint8_t*)text_p2, row, color_mode);
+    soft_switches = softsw;
+
+    return true;
+}
+#endif
+
+//  A text word (GR low) of a color line, 16 pixel pairs with the B&W kernel. The color kernels are
+//  "pad" pixel pairs behind the dots, so are the B&W pairs, to line them up with the B&W lines
+#define RENDER_A2C_MONO_WORD(tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue, dots, next_dots, dot_count, pad) \
+    for(uint j = 0; j < 16; j++) \
+    { \
+        if (dot_count < (32 * 18)) \
+        { \
+            uint32_t dot = ((dots >> (29 - (2 * (pad)))) & 0x02) | ((dots >> (31 - (2 * (pad)))) & 0x01); \
+            uint32_t coffset = color_offset + dot; \
+            *(tmdsbuf_red++)   = tmds_mono_pixel_pair[coffset + 0]; \
+            *(tmdsbuf_green++) = tmds_mono_pixel_pair[coffset + 4]; \
+            *(tmdsbuf_blue++)  = tmds_mono_pixel_pair[coffset + 8]; \
+            dots <<= 2; \
+            dot_count = dot_count + 2; \
+        } \
+        if (j == 7) \
+            dots = (dots & 0xFFFF0000) | (next_dots >> 16); \
+    }
+
+//  Render a line from the SEROUT dots, the words set in mono_words are rendered B&W in the color modes
+static void DELAYED_COPY_CODE(render_a2c_full_line)(a2c_render_mode_mode_t render_mode, uint line, uint32_t mono_words)        //  volatile uint32_t screen_buffer[192][18]
 {
     dvi_get_scanline(tmdsbuf);                                              //  We only spend about 0.2% of the tim,e blocking
     dvi_scanline_rgb(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
 
     uint64_t start_time = to_us_since_boot (get_absolute_time());
 
+    //  Remember which capture we are about to render, for the latency statistics
+    s_line_render_capture_time[line] = s_line_capture_time[s_display_frame][line];
+
+    const uint32_t* screen_line = s_screen_buffer[s_display_frame][line];
+
     uint32_t left_margin = ((dvi_x_resolution - (32 * 18)) / 8) * 2;        //  We want this to always be even.  18 32-bit samples of SEROUT
     uint32_t right_margin = ((32 * 18) / 2) + left_margin;
+    uint8_t color_offset = color_mode * 12;                                 //  BW, Green, Amber, etc
 
     //  Fill in the left and right margins, this needs to be done first for timing reasons
     for(uint i = 0; i < left_margin; i++)
@@ -1143,16 +1867,22 @@ static void DELAYED_COPY_CODE(render_a2c_full_line)(a2c_render_mode_mode_t rende
         *(tmdsbuf_blue++)  = TMDS_SYMBOL_0_0;
     }
 
-    if (render_mode == RM_BW) //  mono_rendering
-    {
-        uint8_t color_offset = color_mode * 12;                 //  BW, Green, Amber, etc
-
+    //  The previous line was encoded on the PIO while this one waited for its TMDS buffer
+    a2c_send_mono_scanline();
 
+    if ((render_mode == RM_BW) && (tmds_mono_encode(screen_line, 18, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue, color_mode)))
+    {
+        //  The PIO encodes the dots while the next line is prepared
+        s_mono_scanline = tmdsbuf;
+        s_mono_line = line;
+    }
+    else if (render_mode == RM_BW) //  mono_rendering (amber, or no state machine left for the PIO encoder)
+    {
         for(uint i = 0; i < 18; i++)
         {
             // Load in the first 32 dots
-            uint32_t dots = s_screen_buffer[line][i];
-            uint32_t next_dots = (i < 17) ? s_screen_buffer[line][i+1] : 0;
+            uint32_t dots = screen_line[i];
+            uint32_t next_dots = (i < 17) ? screen_line[i+1] : 0;
             
             // Consume 32 dots, two at a time
             for(uint j = 0; j < 16; j++)
@@ -1201,7 +1931,7 @@ static void DELAYED_COPY_CODE(render_a2c_full_line)(a2c_render_mode_mode_t rende
         //  This is a timing bug.  I can't seem to do this fix in 640 mode without the video breaking up
         //  I think reformating the LUTs might help
 
-        if (cfg_video_mode == Dvi720x480)
+        if ((cfg_video_mode & 1) == Dvi720x480)
         {
             dot_count = 2;
 
@@ -1209,12 +1939,19 @@ static void DELAYED_COPY_CODE(render_a2c_full_line)(a2c_render_mode_mode_t rende
             *(tmdsbuf_green++) = TMDS_SYMBOL_0_0;
             *(tmdsbuf_blue++)  = TMDS_SYMBOL_0_0;
         }
+        uint pad = dot_count / 2;
 
         for(uint i = 0; i < 18; i++)
         {
             // Load in the first 32 dots
-            uint32_t dots = s_screen_buffer[line][i];
-            uint32_t next_dots = s_screen_buffer[line][i+1];
+            uint32_t dots = screen_line[i];
+            uint32_t next_dots = screen_line[i+1];
+
+            if ((mono_words >> i) & 1)
+            {
+                RENDER_A2C_MONO_WORD(tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue, dots, next_dots, dot_count, pad);
+                continue;
+            }
 
             // Consume 32 dots, two at a time
             for(uint j = 0; j < 16; j++)
@@ -1224,9 +1961,9 @@ static void DELAYED_COPY_CODE(render_a2c_full_line)(a2c_render_mode_mode_t rende
                     //  Render HGR
                     uint dot_pattern = oddness | ((dots >> 24) & 0xff);                                 //  Total of 9 bits, oddness is phase mod 2 due to dual pixels
 
-                    *(tmdsbuf_red++)   = tmds_hires_color_patterns_red[dot_pattern];                       
-                    *(tmdsbuf_green++) = tmds_hires_color_patterns_green[dot_pattern];
-                    *(tmdsbuf_blue++)  = tmds_hires_color_patterns_blue[dot_pattern];
+                    *(tmdsbuf_red++)   = s_hires_lut_red[dot_pattern];                       
+                    *(tmdsbuf_green++) = s_hires_lut_green[dot_pattern];
+                    *(tmdsbuf_blue++)  = s_hires_lut_blue[dot_pattern];
 
                     dots <<= 2;
                     dot_count = dot_count + 2;
@@ -1242,25 +1979,30 @@ static void DELAYED_COPY_CODE(render_a2c_full_line)(a2c_render_mode_mode_t rende
 #ifndef NO_NTSC_LUT
     else if (render_mode == RM_NTSC)
     {
-        //  We are rendering using a 11 bit (NUM_CAP 8 to 4) NTSC style color LUT
+        //  We are rendering using a HGRDECODE_NTSC_TAPS + 1 bit (11 bit by default) NTSC style color LUT
         uint oddness = 0;       //  oddness is real just phase, but only 0 or 2 due to douple pixels
 
         //  Due to the NTSC encoding, we shift the color part of the screen to the right to align with the B&W text
-        uint dot_count = 4;
+        uint dot_count = LUT_PAD_PAIRS(HGRDECODE_NTSC_TAPS) * 2;
 
-        *(tmdsbuf_red++)   = TMDS_SYMBOL_0_0;
-        *(tmdsbuf_green++) = TMDS_SYMBOL_0_0;
-        *(tmdsbuf_blue++)  = TMDS_SYMBOL_0_0;
-
-        *(tmdsbuf_red++)   = TMDS_SYMBOL_0_0;
-        *(tmdsbuf_green++) = TMDS_SYMBOL_0_0;
-        *(tmdsbuf_blue++)  = TMDS_SYMBOL_0_0;
+        for (uint pad = 0; pad < LUT_PAD_PAIRS(HGRDECODE_NTSC_TAPS); pad++)
+        {
+            *(tmdsbuf_red++)   = TMDS_SYMBOL_0_0;
+            *(tmdsbuf_green++) = TMDS_SYMBOL_0_0;
+            *(tmdsbuf_blue++)  = TMDS_SYMBOL_0_0;
+        }
 
         for(uint i = 0; i < 18; i++)
         {
             // Load in the first 32 dots
-            uint32_t dots = s_screen_buffer[line][i];
-            uint32_t next_dots = s_screen_buffer[line][i+1];
+            uint32_t dots = screen_line[i];
+            uint32_t next_dots = screen_line[i+1];
+
+            if ((mono_words >> i) & 1)
+            {
+                RENDER_A2C_MONO_WORD(tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue, dots, next_dots, dot_count, LUT_PAD_PAIRS(HGRDECODE_NTSC_TAPS));
+                continue;
+            }
             
             // Consume 32 dots, two at a time
             for(uint j = 0; j < 16; j++)
@@ -1268,15 +2010,15 @@ static void DELAYED_COPY_CODE(render_a2c_full_line)(a2c_render_mode_mode_t rende
                 if (dot_count < (32 * 18))      //  buffer is 18 32-bit dots
                 {
                     //  Render DHGR, this inner loop is very timing dependant, too slow and hdmi breaks up
-                    uint dot_pattern = (oddness) | ((dots >> 22) & 0x3ff);                                 //  Total of 11 bits
+                    uint dot_pattern = (oddness) | (dots >> (32 - HGRDECODE_NTSC_TAPS));                   //  Total of 11 bits by default
                     
-                    *(tmdsbuf_red++)   = tmds_hgrdecode_NTSC_8to4_LUT_color_patterns_red[dot_pattern];
-                    *(tmdsbuf_green++) = tmds_hgrdecode_NTSC_8to4_LUT_color_patterns_green[dot_pattern];
-                    *(tmdsbuf_blue++)  = tmds_hgrdecode_NTSC_8to4_LUT_color_patterns_blue[dot_pattern];
+                    *(tmdsbuf_red++)   = s_hires_lut_red[dot_pattern];
+                    *(tmdsbuf_green++) = s_hires_lut_green[dot_pattern];
+                    *(tmdsbuf_blue++)  = s_hires_lut_blue[dot_pattern];
                     
                     dots <<= 2;
                     dot_count = dot_count + 2;
-                    oddness ^= 0x400;
+                    oddness ^= (1 << HGRDECODE_NTSC_TAPS);
                 }
 
                 //  Consume 16 more dots
@@ -1288,20 +2030,29 @@ static void DELAYED_COPY_CODE(render_a2c_full_line)(a2c_render_mode_mode_t rende
 #endif      //  NO_NTSC_LUT
     else if ((render_mode == RM_CLAMP) || (render_mode == RM_NTSC))
     {
-        //  We are rendering using a 9 bit (NUM_CAP 8 to 3, Clamped) NTSC style color LUT
+        //  We are rendering using a HGRDECODE_CLAMP_TAPS + 1 bit (9 bit by default, Clamped) NTSC style color LUT
         uint oddness = 0;
-        uint dot_count = 2;
+        uint dot_count = LUT_PAD_PAIRS(HGRDECODE_CLAMP_TAPS) * 2;
 
         //  Due to the NTSC encoding, we shift the color part of the screen to the right to align with the B&W text
-        *(tmdsbuf_red++)   = TMDS_SYMBOL_0_0;
-        *(tmdsbuf_green++) = TMDS_SYMBOL_0_0;
-        *(tmdsbuf_blue++)  = TMDS_SYMBOL_0_0;
+        for (uint pad = 0; pad < LUT_PAD_PAIRS(HGRDECODE_CLAMP_TAPS); pad++)
+        {
+            *(tmdsbuf_red++)   = TMDS_SYMBOL_0_0;
+            *(tmdsbuf_green++) = TMDS_SYMBOL_0_0;
+            *(tmdsbuf_blue++)  = TMDS_SYMBOL_0_0;
+        }
 
         for(uint i = 0; i < 18; i++)
         {
             // Load in the first 32 dots
-            uint32_t dots = s_screen_buffer[line][i];
-            uint32_t next_dots = s_screen_buffer[line][i+1];
+            uint32_t dots = screen_line[i];
+            uint32_t next_dots = screen_line[i+1];
+
+            if ((mono_words >> i) & 1)
+            {
+                RENDER_A2C_MONO_WORD(tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue, dots, next_dots, dot_count, LUT_PAD_PAIRS(HGRDECODE_CLAMP_TAPS));
+                continue;
+            }
 
             // Consume 32 dots, two at a time, we run over by 2 pixels, but doing the tests are too slow and video breaks up at 640x480
             for(uint j = 0; j < 16; j++)
@@ -1309,15 +2060,15 @@ static void DELAYED_COPY_CODE(render_a2c_full_line)(a2c_render_mode_mode_t rende
                 if (dot_count < (32 * 18))      //  buffer is 18 32-bit dots
                 {
                     //  Render DHGR, this inner loop is very timing dependant, too slow and hdmi breaks up
-                    uint dot_pattern = oddness | ((dots >> 24) & 0xff);                                 //  Total of 9 bits
+                    uint dot_pattern = oddness | (dots >> (32 - HGRDECODE_CLAMP_TAPS));                 //  Total of 9 bits by default
 
-                    *(tmdsbuf_red++)   = tmds_hgrdecode8to3_LUT_color_patterns_red[dot_pattern];
-                    *(tmdsbuf_green++) = tmds_hgrdecode8to3_LUT_color_patterns_green[dot_pattern];
-                    *(tmdsbuf_blue++)  = tmds_hgrdecode8to3_LUT_color_patterns_blue[dot_pattern];
+                    *(tmdsbuf_red++)   = s_hires_lut_red[dot_pattern];
+                    *(tmdsbuf_green++) = s_hires_lut_green[dot_pattern];
+                    *(tmdsbuf_blue++)  = s_hires_lut_blue[dot_pattern];
                     
                     dots <<= 2;
                     dot_count = dot_count + 2;
-                    oddness ^= 0x100;
+                    oddness ^= (1 << HGRDECODE_CLAMP_TAPS);
                 }
 
                 //  Consume 16 more dots
@@ -1331,7 +2082,8 @@ static void DELAYED_COPY_CODE(render_a2c_full_line)(a2c_render_mode_mode_t rende
     s_total_render_time = end_time - s_a2c_boot_time;
     s_render_time = s_render_time + (end_time - start_time);
 
-    dvi_send_scanline(tmdsbuf);             //  We spend about 0.4% waiting on the queu
+    if (s_mono_scanline != tmdsbuf)
+        a2c_send_scanline(tmdsbuf, line);       //  We spend about 0.4% waiting on the queu
 }
 
 
@@ -1344,6 +2096,20 @@ void DELAYED_COPY_CODE(render_a2c)()
     // set flag when monochrome rendering is requested
     mono_rendering = (internal_flags & IFLAGS_FORCED_MONO);
 
+    //  Make sure the LUT for the color style is loaded (or being loaded)
+    bool lut_ready = a2c_lut_update();
+
+#ifdef FEATURE_A2C_TEXT
+    //  The glyph index of the charset
+    a2c_text_update();
+#endif
+
+    if (!s_sync_found)
+    {
+        //  Not showing captured video, exclude these lines from the latency statistics
+        memset(s_line_render_capture_time, 0, sizeof(s_line_render_capture_time));
+    }
+
     if (s_show_menu_screen)
     {
         if (s_menu_screen_init == false)
@@ -1352,15 +2118,37 @@ void DELAYED_COPY_CODE(render_a2c)()
             init_menu_screen();
 
             s_menu_screen_init = true;
+            s_menu_redraw = true;
         }
 
-        draw_menu_screen();
+#ifdef FEATURE_A2C_RECORD
+        //  The recorder stops on its own (flash full, saved)
+        static a2c_record_state_t s_menu_record_state;
+        if (a2c_record_state != s_menu_record_state)
+        {
+            s_menu_record_state = a2c_record_state;
+            s_menu_redraw = true;
+        }
+#endif
+
+        if (s_menu_redraw)
+        {
+            //  Only when the menu changed, the OSD spans follow the text (mouse text in the header)
+            draw_menu_screen();
+            a2c_osd_update(MENU_ALTCHAR_ROWS);
+            s_menu_redraw = false;
+        }
+    }
+
+    if ((s_show_menu_screen) && (!s_sync_found))
+    {
+        //  No video to show the menu over, render it as a text screen
 
         //  We need mouse text for the header
         soft_switches |= SOFTSW_ALTCHAR;
 
         //  Render the rest as text
-        for (uint line = 0; line < 6; line++)                   //  0-7
+        for (uint line = 0; line < MENU_HEADER_ROWS; line++)    //  0-7
         {
             render_color_text40_line(line);
         }
@@ -1369,21 +2157,42 @@ void DELAYED_COPY_CODE(render_a2c)()
         soft_switches &= ~SOFTSW_ALTCHAR;
 
         //  Render the rest as text                             // 48 (6) - 191
-        for (uint line = 6; line < 24; line++)
+        for (uint line = MENU_HEADER_ROWS; line < 24; line++)
         {
             render_color_text40_line(line);
         }
     }
     else if (s_sync_found)
     {
+#ifdef FEATURE_A2C_SCREENSHOT
+        //  A screenshot holds its frame until each line has been decoded
+        if (a2c_screenshot_hold() == false)
+#endif
+        {
+            //  Take the latest complete frame (again if a2c_loop published another one meanwhile)
+            uint frame;
+            do
+            {
+                frame = s_ready_frame;
+                s_display_frame = frame;
+            } while (frame != s_ready_frame);
+        }
+
         //  Normal rendering, either mono or color
 
         if (mono_rendering == true)
         {
             for(uint line = 0; line < 192; line++)
             {
+#ifdef FEATURE_A2C_TEXT
+                if (render_a2c_text_row(line))
+                {
+                    line += 7;
+                    continue;
+                }
+#endif
                 //  Force mono mode
-                render_a2c_full_line(RM_BW, line);
+                render_a2c_full_line(RM_BW, line, 0);
             }
         }
         else
@@ -1397,17 +2206,62 @@ void DELAYED_COPY_CODE(render_a2c)()
             else if (cfg_color_style == CS_CLAMP)
                 render_mode = RM_CLAMP;
 
+            if (lut_ready == false)
+                render_mode = RM_BW;
+
             for(uint line = 0; line < 192; line++)
             {
+#ifdef FEATURE_A2C_TEXT
+                if (render_a2c_text_row(line))
+                {
+                    line += 7;
+                    continue;
+                }
+#endif
+                a2c_render_mode_mode_t line_mode = render_mode;
+                uint32_t gr = s_screen_GR_mask[s_display_frame][line];
+                uint32_t text = s_screen_TEXT_mask[s_display_frame][line];
+                uint32_t mono_words = 0;
+                uint8_t line_main[40];
+                uint8_t line_aux[40];
+
                 if (cfg_rendering_fx == FX_ENABLED)                 //  Mixed text and graphics, B&W for Text, Color for graphics
+                    mono_words = ~gr & A2C_WORDS_MASK;
+
+                if (mono_words == A2C_WORDS_MASK)
+                {
+                    line_mode = RM_BW;
+                }
+                else if ((render_mode == RM_A2DVI) && (gr == A2C_WORDS_MASK) && ((text == 0) || (text == A2C_WORDS_MASK)))
                 {
-                    if (s_screen_GR_buffer[line] == false)
-                        render_mode = RM_BW;
+                    //  Graphics lines are rendered from the video bytes, like the slotted firmware does, when the
+                    //  bytes give the same dots: a lores line (same pins as hires) stays on the LUT
+                    if (a2c_line_bytes(s_display_frame, line, (text != 0), line_main, line_aux))
+                        line_mode = (text != 0) ? RM_DHGR : RM_HGR;
                 }
 
-                render_a2c_full_line(render_mode, line);
+                if ((line_mode == RM_HGR) || (line_mode == RM_DHGR))
+                    render_a2c_byte_line(line_mode, line, line_main, line_aux);
+                else
+                    render_a2c_full_line(line_mode, line, mono_words);
             }
         }
+
+        //  The last line may still be on the PIO
+        a2c_send_mono_scanline();
+
+#ifdef FEATURE_A2C_TEXT
+        //  The text on the screen to USB serial
+        a2c_text_send(s_display_frame);
+#endif
+
+        if ((s_first_frame_shown == false) && ((lut_ready) || (mono_rendering)))
+        {
+            //  Time to the first frame of Apple IIc video, shown on the debug monitor
+            boot_time = to_us_since_boot(get_absolute_time());
+            boot_milestone("1ST");
+            s_first_frame_shown = true;
+        }
     }
     else
     {
@@ -1435,9 +2289,7 @@ bool s_adc_initalized = false;
 void __time_critical_func(a2c_init)()
 {
     //  Clear the screen
-    for (int x = 0; x < 19; x++)
-        for (int y = 0; y < 192; y++)
-            s_screen_buffer[y][x] = 0;
+    memset(s_screen_buffer, 0, sizeof(s_screen_buffer));
     
 #ifdef FEATURE_A2_AUDIO
     adc_init();
@@ -1458,18 +2310,29 @@ void __time_critical_func(a2c_init)()
     gpio_init(PIN_BUTTON);
     gpio_set_dir(PIN_BUTTON, GPIO_IN);
 
-    //  Setup the GR pin
+    //  Setup the GR and TEXT pins, they are sampled by the PIO with SEROUT
     gpio_init(PIN_GR);
     gpio_set_dir(PIN_GR, GPIO_IN);
+    gpio_init(PIN_TEXT);
+    gpio_set_dir(PIN_TEXT, GPIO_IN);
     
     //  Interrupt on each scan line     11500 per second
     gpio_init(PIN_WNDW);
     gpio_set_dir(PIN_WNDW, GPIO_IN);
 
-    //  Setup PIN_VIDD7 as input for future use
+    //  VIDD7 is sampled by the PIO with SEROUT, it is the high bit of the video byte (the hires delay)
     gpio_init(PIN_VIDD7);
     gpio_set_dir(PIN_VIDD7, GPIO_IN);
 
+    //  VIDD7 is kept from the middle dot of each video byte, find the bytes of each SEROUT word
+    uint byte = 0;
+    for (uint x = 0; x < 19; x++)
+    {
+        while ((byte < 40) && (A2C_FIRST_BYTE_DOT + (14 * byte) + 7 < (32 * x)))
+            byte++;
+        s_vidd7_first_byte[x] = byte;
+    }
+
     //  Pull the enable pin low so we can data throught the 245
     gpio_init(PIN_ENABLE);
     gpio_set_dir(PIN_ENABLE, GPIO_OUT);
@@ -1497,6 +2360,7 @@ void __time_critical_func(a2c_init)()
     // Load the a2c_input program, and configure a free state machine to run the program.
     s_pio = pio0;
     int a2c_offset;
+    int a2c_mode_offset = pio_add_program(s_pio, &a2c_mode_program);
     
     if (cfg_laser_enabled == true)
     {
@@ -1509,13 +2373,18 @@ void __time_critical_func(a2c_init)()
     }
 
     s_a2c_sm = pio_claim_unused_sm(s_pio, true);
+    s_a2c_d7_sm = pio_claim_unused_sm(s_pio, true);
+    s_a2c_mode_sm = pio_claim_unused_sm(s_pio, true);
 
     //  Setup a repeating timer to keep an eye on WNDW an see if it has stopped
     add_repeating_timer_ms(500, repeating_timer_callback, NULL, &s_repeating_timer);
 
+    boot_milestone("PIO");
+
     //  Wait for the start frame, the splash screen will be up until then
     wait_frame_start();
     s_last_WNDW = to_us_since_boot (get_absolute_time());
+    boot_milestone("SYNC");
 
     //  Enable rendering once we see the first frame
     soft_switches = SOFTSW_HIRES_MODE | SOFTSW_V7_MODE3;
@@ -1523,15 +2392,20 @@ void __time_critical_func(a2c_init)()
     //  Enable the interupt
     gpio_set_irq_enabled_with_callback(PIN_WNDW, GPIO_IRQ_EDGE_FALL, true, WNDW_irq_callback);      //  Interrupt on WNDW going low
 
-    //  Start the PIO program, Laser has different PIO program
+    //  Start the PIO program, Laser has different PIO program.  The VIDD7 state machine runs the same program,
+    //  all start together so they wait for the same WNDW and sample the same dots
     if (cfg_laser_enabled == true)
     {
         a2c_input_laser_program_init(s_pio, s_a2c_sm, a2c_offset, PIO_INPUT_PIN_BASE);
+        a2c_input_laser_program_init(s_pio, s_a2c_d7_sm, a2c_offset, PIN_VIDD7);
     }
     else
     {
         a2c_input_program_init(s_pio, s_a2c_sm, a2c_offset, PIO_INPUT_PIN_BASE);
+        a2c_input_program_init(s_pio, s_a2c_d7_sm, a2c_offset, PIN_VIDD7);
     }
+    a2c_mode_program_init(s_pio, s_a2c_mode_sm, a2c_mode_offset, PIN_TEXT);
+    pio_enable_sm_mask_in_sync(s_pio, (1u << s_a2c_sm) | (1u << s_a2c_d7_sm) | (1u << s_a2c_mode_sm));
 }
 
 #ifdef FEATURE_A2_AUDIO
@@ -1644,6 +2518,20 @@ uint32_t __time_critical_func(pio_get_multiple)(bool block)
     return result;
 }
 
+//  Work of the capture core while it waits for SEROUT data
+static inline bool __time_critical_func(a2c_idle_work_pending)(void)
+{
+#if defined(FEATURE_A2C_RECORD) || defined(FEATURE_A2C_STREAM)
+    if (a2c_delta_pending())
+        return true;
+#endif
+#ifdef FEATURE_A2C_TEXT
+    if (a2c_text_pending())
+        return true;
+#endif
+    return a2c_lut_synth_pending();
+}
+
 void __time_critical_func(a2c_loop)()
 {
     // initialize the Apple IIc interface
@@ -1660,7 +2548,23 @@ void __time_critical_func(a2c_loop)()
     //  Loop forever reading from the PIO RX queue
     while (true) 
     {
-        uint32_t rxflags = pio_get_multiple(true);
+        //  While a color LUT is requested (or a frame is recorded, streamed or recognized), poll between the lines and work on it when there is no data
+        uint32_t rxflags = pio_get_multiple((x != 0) || (a2c_idle_work_pending() == false));
+        if (rxflags == 0)
+        {
+#if defined(FEATURE_A2C_RECORD) || defined(FEATURE_A2C_STREAM)
+            if (a2c_delta_pending())
+                a2c_delta_step();
+            else
+#endif
+#ifdef FEATURE_A2C_TEXT
+            if (a2c_text_pending())
+                a2c_text_step();
+            else
+#endif
+            a2c_lut_synth_step();
+            continue;
+        }
         
         if ((rxflags & A2C_DATA_RX) != 0)
         {
@@ -1672,13 +2576,69 @@ void __time_critical_func(a2c_loop)()
                 //  Delay reading s_scanline until we have the first bytes, this is updated in the WNDW interrupt handler
                 y = s_scanline % 192;
                 s_scanline++;
-                
-                //  record the state of the GR pin to know if this is a color or B&W line
-                s_screen_GR_buffer[y] = gpio_get(PIN_GR);
             }
             
             //  SEROUT is inverted from memory bits
-            s_screen_buffer[y][x] = ~rxdata;
+            s_screen_buffer[s_capture_frame][y][x] = ~rxdata;
+
+            //  The VIDD7 word has the same dots, keep VIDD7 of the video bytes whose middle dot is in this word
+            uint32_t vidd7 = pio_sm_get_blocking(s_pio, s_a2c_d7_sm);
+            uint64_t d7 = (x == 0) ? 0 : s_screen_D7_buffer[s_capture_frame][y];
+            for (uint byte = s_vidd7_first_byte[x]; byte < s_vidd7_first_byte[x + 1]; byte++)
+            {
+                uint dot = A2C_FIRST_BYTE_DOT + (14 * byte) + 7 - (32 * x);
+                d7 |= (uint64_t)((vidd7 >> (31 - dot)) & 1) << byte;
+            }
+            s_screen_D7_buffer[s_capture_frame][y] = d7;
+
+            //  TEXT and GR of each word, to know which words are color or B&W and which graphics mode.
+            //  The PIO pushes words 0-15 (2 bits each, TEXT in the low bit) and then words 16-17
+            if (x == 15)
+            {
+                s_line_mode = pio_sm_get_blocking(s_pio, s_a2c_mode_sm);
+            }
+            else if (x == 17)
+            {
+                uint64_t mode = ((uint64_t)s_line_mode << 4) | pio_sm_get_blocking(s_pio, s_a2c_mode_sm);
+                uint32_t gr = 0;
+                uint32_t text = 0;
+                for (uint word = 0; word < 18; word++)
+                {
+                    uint32_t pins = (mode >> (2 * (17 - word))) & 0x3;
+                    text |= (pins & 1) << word;
+                    gr |= (pins >> 1) << word;
+                }
+                s_screen_GR_mask[s_capture_frame][y] = gr;
+                s_screen_TEXT_mask[s_capture_frame][y] = text;
+            }
+
+            //  The line is complete with the 18th word, timestamp it for the latency statistics
+            if (x == 17)
+            {
+                s_line_capture_time[s_capture_frame][y] = time_us_32();
+
+                if (y == 191)
+                {
+                    //  Frame complete, publish it and continue with the buffer that is neither ready nor being rendered
+                    s_ready_frame = s_capture_frame;
+                    uint next = 0;
+                    while ((next == s_capture_frame) || (next == s_display_frame))
+                        next++;
+                    s_capture_frame = next;
+#ifdef FEATURE_A2C_RECORD
+                    a2c_record_frame(s_ready_frame);
+#endif
+#ifdef FEATURE_A2C_STREAM
+                    a2c_stream_frame(s_ready_frame);
+#endif
+#if defined(FEATURE_A2C_RECORD) || defined(FEATURE_A2C_STREAM)
+                    a2c_delta_frame(s_ready_frame);
+#endif
+#ifdef FEATURE_A2C_TEXT
+                    a2c_text_frame(s_ready_frame, s_capture_frame);
+#endif
+                }
+            }
 
             //  We read 18 *32 = 576 bits per line
             x = (x + 1) % 18;
@@ -26,5 +26,17 @@ SOFTWARE.
 
 // #include "abus_pin_config.h"
 
+//  The first video byte of a line starts this many dots into the captured SEROUT words (hires bytes are 14 dots)
+#define A2C_FIRST_BYTE_DOT  7
+
 void a2c_loop(void);
 void a2c_audio_enable(bool enable);
+void a2c_latency_scanline_loaded(uint row);
+bool a2c_lut_update(void);
+void a2c_ram_budget(void);
+bool a2c_line_bytes(uint frame, uint line, bool dhgr, uint8_t* main, uint8_t* aux);
+
+//  The hires LUT of the active color style in RAM (a2c_lut_update), tmds_hires_color_patterns for CS_A2DVI
+extern uint32_t s_hires_lut_red[];
+extern uint32_t s_hires_lut_green[];
+extern uint32_t s_hires_lut_blue[];
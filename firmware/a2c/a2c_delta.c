@@ -0,0 +1,434 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <string.h>
+#include <pico/stdlib.h>
+#include <hardware/sync.h>
+#include <hardware/structs/systick.h>
+#include "config/config.h"
+#include "debug/debug.h"
+#include "a2c_delta.h"
+
+#if defined(FEATURE_A2C) && (defined(FEATURE_A2C_RECORD) || defined(FEATURE_A2C_STREAM))
+
+//  Frame buffers of a2c.c
+extern uint32_t s_screen_buffer[][192][19];
+extern uint32_t s_line_capture_time[][192];
+#ifdef FEATURE_A2C_RECORD
+extern uint32_t s_screen_GR_mask[][192];
+extern uint32_t s_screen_TEXT_mask[][192];
+extern uint64_t s_screen_D7_buffer[][192];
+#endif
+
+//  Largest encoding of "words" words (every word changed and starting a run)
+#define DELTA_WORDS_MAX(words)  ((words) * 5)
+
+static uint32_t             s_reference[A2C_DELTA_FRAME_WORDS];    //  Image of the last encoded frame
+static a2c_delta_output_t*  s_outputs[A2C_DELTA_OUTPUTS];          //  Outputs of the frame being encoded
+static uint32_t             s_output_count;
+static bool                 s_skip;                 //  An output skips the next frame, so do the others
+
+//  Encoder of the capture core
+static volatile int32_t     s_frame = -1;           //  Frame buffer being encoded, -1 when there is none
+static uint32_t             s_published;            //  Frames published by a2c_loop since s_frame
+static bool                 s_applying;             //  Encoded, the frame is applied to s_reference
+static uint32_t             s_line;                 //  Next line to encode
+static uint32_t             s_time;                 //  Capture time of the last line of the frame
+static uint32_t             s_cycles;               //  Spent encoding the frame
+
+//  Applying the frame to s_reference, from the ring of one output
+static a2c_delta_output_t*  s_apply;
+static bool                 s_apply_key;            //  The frame was encoded against an empty image
+static uint32_t             s_apply_index;
+static uint32_t             s_apply_bytes;          //  Bytes of frame data left
+static uint32_t             s_apply_line;
+static uint32_t             s_apply_word;           //  Word of the line, of the line times after the last line
+static uint32_t             s_apply_left;           //  Words left of the current run
+static bool                 s_apply_literal;
+
+static inline void __time_critical_func(delta_put)(a2c_delta_output_t* output, uint8_t value)
+{
+    output->ring[output->index] = value;
+    if (++output->index == output->ring_size)
+        output->index = 0;
+    output->pos++;
+}
+
+static inline void __time_critical_func(delta_close_run)(a2c_delta_output_t* output)
+{
+    if (output->count)
+    {
+        output->ring[output->tag_index] = (output->literal ? A2C_DELTA_LITERAL : A2C_DELTA_RUN) | (output->count - 1);
+        output->count = 0;
+    }
+}
+
+static inline void __time_critical_func(delta_word)(a2c_delta_output_t* output, uint32_t delta)
+{
+    bool literal = (delta != 0);
+
+    if ((output->count == 0) || (output->literal != literal) || (output->count == A2C_DELTA_MAX_RUN))
+    {
+        delta_close_run(output);
+        output->tag_index = output->index;
+        output->literal = literal;
+        delta_put(output, 0);
+    }
+    output->count++;
+
+    if (literal)
+    {
+        delta_put(output, delta);
+        delta_put(output, delta >> 8);
+        delta_put(output, delta >> 16);
+        delta_put(output, delta >> 24);
+    }
+}
+
+//  Word "word" of a line to every output that takes it
+static inline void __time_critical_func(delta_line_word)(uint32_t word, uint32_t value, uint32_t reference)
+{
+    for (uint n = 0; n < s_output_count; n++)
+    {
+        a2c_delta_output_t* output = s_outputs[n];
+        if (word < output->line_words)
+            delta_word(output, output->key ? value : value ^ reference);
+    }
+}
+
+//  There is room for "bytes" more in the ring and in the capacity of the output
+static inline bool __time_critical_func(delta_room)(a2c_delta_output_t* output, uint32_t bytes)
+{
+    if ((output->capacity != 0) && (output->pos + bytes > output->capacity))
+    {
+        output->full = true;
+        return false;
+    }
+    return output->pos + bytes - output->done <= output->ring_size;
+}
+
+//  There is room for "words" more words of the line (or the line times) in every output
+static bool __time_critical_func(delta_room_all)(uint32_t words, bool times)
+{
+    for (uint n = 0; n < s_output_count; n++)
+    {
+        a2c_delta_output_t* output = s_outputs[n];
+        uint32_t bytes = times ? (output->times ? DELTA_WORDS_MAX(words) : 0) : DELTA_WORDS_MAX(MIN(words, output->line_words));
+        if (!delta_room(output, bytes))
+            return false;
+    }
+    return true;
+}
+
+static void __time_critical_func(delta_end)(void)
+{
+    s_output_count = 0;
+    __dmb();
+    s_frame = -1;
+}
+
+//  Drop the frame being encoded, the outputs continue after their last complete frame
+static void __time_critical_func(delta_drop)(void)
+{
+    for (uint n = 0; n < s_output_count; n++)
+    {
+        a2c_delta_output_t* output = s_outputs[n];
+        output->pos     = output->committed;
+        output->index   = output->frame_index;
+        output->count   = 0;
+        output->skipped += output->frame_skipped + 1;
+    }
+    delta_end();
+}
+
+void DELAYED_COPY_CODE(a2c_delta_reset)(a2c_delta_output_t* output, uint32_t capacity)
+{
+    output->capacity      = capacity;
+    output->key           = true;
+    output->full          = false;
+    output->frames        = 0;
+    output->skipped       = 0;
+    output->frame_skipped = 0;
+    output->skipped_total = 0;
+    output->pos           = 0;
+    output->index         = 0;
+    output->count         = 0;
+    output->committed     = 0;
+    output->done          = 0;
+}
+
+//  Appends "size" bytes to the output and publishes them, between its frames
+void __time_critical_func(a2c_delta_write)(a2c_delta_output_t* output, const void* data, uint32_t size)
+{
+    const uint8_t* bytes = (const uint8_t*) data;
+    for (uint i = 0; i < size; i++)
+        delta_put(output, bytes[i]);
+    __dmb();
+    output->committed = output->pos;
+}
+
+//  The output takes the next complete frame, false when it is skipped (the encoder is busy, or
+//  there is no room for the frame header)
+bool __time_critical_func(a2c_delta_add)(a2c_delta_output_t* output)
+{
+    if ((s_frame >= 0) || (s_output_count == A2C_DELTA_OUTPUTS) || (!delta_room(output, output->frame_header)))
+    {
+        a2c_delta_skip(output);
+        return false;
+    }
+
+    //  Frame header, filled in when the frame is complete
+    output->frame_index = output->index;
+    for (uint i = 0; i < output->frame_header; i++)
+        delta_put(output, 0);
+    output->count = 0;
+    output->frame_skipped = output->skipped;
+    output->skipped = 0;
+    s_outputs[s_output_count++] = output;
+    return true;
+}
+
+//  The output skips the next complete frame. The outputs share the reference, the others skip
+//  it as well unless the encoder is busy anyway
+void __time_critical_func(a2c_delta_skip)(a2c_delta_output_t* output)
+{
+    output->skipped++;
+    if (s_frame < 0)
+        s_skip = true;
+}
+
+//  Called by a2c_loop when a frame is complete, after the outputs took it
+void __time_critical_func(a2c_delta_frame)(uint32_t frame)
+{
+    bool skip = s_skip;
+    s_skip = false;
+
+    if (s_frame >= 0)
+    {
+        //  Still busy with an earlier frame, its buffer is captured into after the next one
+        if ((++s_published >= 2) && (!s_applying))
+            delta_drop();
+        return;
+    }
+    if (skip)
+        delta_drop();
+    if (s_output_count == 0)
+        return;
+
+    //  The SysTick of this core counts the cycles of the encoder
+    systick_hw->csr = 0x5;
+    systick_hw->rvr = 0x00FFFFFF;
+
+    s_time      = s_line_capture_time[frame][191];
+    s_line      = 0;
+    s_cycles    = 0;
+    s_published = 0;
+    s_applying  = false;
+    s_frame     = frame;
+}
+
+bool __time_critical_func(a2c_delta_pending)(void)
+{
+    return s_frame >= 0;
+}
+
+static inline uint8_t __time_critical_func(delta_get)(void)
+{
+    uint8_t value = s_apply->ring[s_apply_index];
+    if (++s_apply_index == s_apply->ring_size)
+        s_apply_index = 0;
+    s_apply_bytes--;
+    return value;
+}
+
+//  Moves the apply position on by "words" words of the output
+static inline void __time_critical_func(delta_apply_skip)(uint32_t words)
+{
+    s_apply_word += words;
+    while ((s_apply_line < 192) && (s_apply_word >= s_apply->line_words))
+    {
+        s_apply_word -= s_apply->line_words;
+        s_apply_line++;
+    }
+}
+
+//  Applies A2C_DELTA_STEP_LINES lines worth of words of the complete frame to s_reference
+static void __time_critical_func(delta_apply)(void)
+{
+    uint32_t budget = A2C_DELTA_STEP_LINES * A2C_DELTA_LINE_WORDS;
+
+    while (budget && (s_apply_bytes || s_apply_left))
+    {
+        budget--;
+        if (s_apply_left == 0)
+        {
+            uint8_t tag = delta_get();
+            s_apply_literal = (tag & A2C_DELTA_LITERAL) != 0;
+            s_apply_left = (tag & 0x7f) + 1;
+            if ((!s_apply_literal) && (!s_apply_key))
+            {
+                //  Unchanged words
+                delta_apply_skip(s_apply_left);
+                s_apply_left = 0;
+                continue;
+            }
+        }
+
+        uint32_t index = (s_apply_line < 192) ? s_apply_line * A2C_DELTA_LINE_WORDS + s_apply_word
+                                              : 192 * A2C_DELTA_LINE_WORDS + s_apply_word;
+        uint32_t value = 0;
+        if (s_apply_literal)
+        {
+            value  = delta_get();
+            value |= delta_get() << 8;
+            value |= delta_get() << 16;
+            value |= (uint32_t) delta_get() << 24;
+        }
+        s_reference[index] = s_apply_key ? value : s_reference[index] ^ value;
+        delta_apply_skip(1);
+        s_apply_left--;
+    }
+
+    if ((s_apply_bytes == 0) && (s_apply_left == 0))
+        delta_end();
+}
+
+//  Fills in the frame header of the output and publishes the frame to the render core
+static void __time_critical_func(delta_commit)(a2c_delta_output_t* output)
+{
+    delta_close_run(output);
+    uint32_t bytes = output->pos - output->committed - output->frame_header;
+    uint32_t skipped = output->frame_skipped;
+    uint8_t header[12] = { s_time, s_time >> 8, s_time >> 16, s_time >> 24,
+                           skipped, skipped >> 8, bytes, bytes >> 8,
+                           s_cycles, s_cycles >> 8, s_cycles >> 16, s_cycles >> 24 };
+
+    uint32_t index = output->frame_index;
+    for (uint i = 0; i < output->frame_header; i++)
+    {
+        output->ring[index] = header[i];
+        if (++index == output->ring_size)
+            index = 0;
+    }
+
+    //  The reference follows the output with the most words
+    if ((s_apply == NULL) || (output->line_words > s_apply->line_words) ||
+        ((output->line_words == s_apply->line_words) && output->times && !s_apply->times))
+    {
+        s_apply       = output;
+        s_apply_key   = output->key;
+        s_apply_index = index;
+        s_apply_bytes = bytes;
+    }
+
+    __dmb();
+    output->committed = output->pos;
+    output->frames++;
+    output->skipped_total += skipped;
+    output->frame_skipped = 0;
+    output->key = false;
+}
+
+//  Encodes A2C_DELTA_STEP_LINES lines of the frame, or applies them to s_reference once it is complete
+void __time_critical_func(a2c_delta_step)(void)
+{
+    if (s_applying)
+    {
+        delta_apply();
+        return;
+    }
+
+    uint32_t start = systick_hw->cvr;
+    uint32_t frame = s_frame;
+
+    if (s_line < 192)
+    {
+        for (uint n = 0; (n < A2C_DELTA_STEP_LINES) && (s_line < 192); n++, s_line++)
+        {
+            if (!delta_room_all(A2C_DELTA_LINE_WORDS, false))
+            {
+                delta_drop();
+                return;
+            }
+
+            uint32_t line = s_line;
+            const uint32_t* reference = &s_reference[line * A2C_DELTA_LINE_WORDS];
+            const uint32_t* dots = s_screen_buffer[frame][line];
+            for (uint word = 0; word < A2C_DELTA_DOT_WORDS; word++)
+                delta_line_word(word, dots[word], reference[word]);
+#ifdef FEATURE_A2C_RECORD
+            uint64_t d7 = s_screen_D7_buffer[frame][line];
+            delta_line_word(18, s_screen_GR_mask[frame][line], reference[18]);
+            delta_line_word(19, s_screen_TEXT_mask[frame][line], reference[19]);
+            delta_line_word(20, (uint32_t) d7, reference[20]);
+            delta_line_word(21, (uint32_t)(d7 >> 32), reference[21]);
+#endif
+        }
+        s_cycles += (start - systick_hw->cvr) & 0x00FFFFFF;
+        return;
+    }
+
+#ifdef FEATURE_A2C_RECORD
+    //  The line times, the time between the last lines of the frames is in the frame header
+    if (!delta_room_all(A2C_DELTA_TIME_WORDS, true))
+    {
+        delta_drop();
+        return;
+    }
+    const uint32_t* times = s_line_capture_time[frame];
+    const uint32_t* reference = &s_reference[192 * A2C_DELTA_LINE_WORDS];
+    for (uint line = 0; line < 192; line += 4)
+    {
+        uint32_t packed = 0;
+        for (uint i = 0; i < 4; i++)
+        {
+            uint32_t delta = ((line + i) == 0) ? 0 : times[line + i] - times[line + i - 1];
+            packed |= ((delta > 255) ? 255 : delta) << (8 * i);
+        }
+        for (uint n = 0; n < s_output_count; n++)
+        {
+            a2c_delta_output_t* output = s_outputs[n];
+            if (output->times)
+                delta_word(output, output->key ? packed : packed ^ reference[line / 4]);
+        }
+    }
+#endif
+    s_cycles += (start - systick_hw->cvr) & 0x00FFFFFF;
+
+    //  Complete: publish it to the render core, then apply it to s_reference
+    s_apply = NULL;
+    for (uint n = 0; n < s_output_count; n++)
+        delta_commit(s_outputs[n]);
+    s_apply_line = 0;
+    s_apply_word = 0;
+    s_apply_left = 0;
+    s_applying   = true;
+}
+
+void DELAYED_COPY_CODE(a2c_delta_ram_budget)(void)
+{
+    ram_budget_add("DLT", sizeof(s_reference));
+}
+
+#endif
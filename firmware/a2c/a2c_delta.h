@@ -0,0 +1,117 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*  A2C frame delta encoder (FEATURE_A2C_RECORD and FEATURE_A2C_STREAM builds)
+
+    The recorder (a2c_record.h) and the live stream (a2c_stream.h) send the captured frames as
+    the XOR with the previous frame they sent, as runs of 32 bit words:
+      0x00-0x7f  (tag + 1) words are unchanged
+      0x80-0xff  (tag & 0x7f) + 1 changed words follow, the XOR value little endian
+
+    They share the encoder and its reference image, the last frame encoded. a2c_loop offers
+    each complete frame to the outputs, each one that takes it reserves its frame header
+    (a2c_delta_add), then the capture core encodes the frame once for all of them while it
+    waits for SEROUT data, A2C_DELTA_STEP_LINES lines per step, each output into its RAM ring.
+    An output that just started is sent the frame against an empty image (key). The running
+    outputs take the same frames, a frame is dropped by all of them when one skips it
+    (a2c_delta_skip), when it does not fit into the free part of one of the rings, or when its
+    buffer is captured into again while it is encoded, the next frame counts it. Once the frame
+    is complete it is applied to the reference from the ring of the output with most words,
+    the frame as it was encoded even when the buffer changed meanwhile.
+
+    Frame image, A2C_DELTA_FRAME_WORDS 32 bit words: per line the 18 SEROUT words (first dot in
+    bit 31) and with the recorder the GR and the TEXT mask (bit n is word n) and VIDD7 of the
+    40 video bytes (2 words, bit n is byte n), then with the recorder the microseconds between
+    the capture of a line and the one before it (saturated at 255, 0 for line 0), 4 lines per
+    word, line 0 in bits 0-7. An output takes the first "line_words" of each line, and the line
+    times or not.
+
+    Frame header: uint32_t time_us_32() when the last line of the frame was captured, uint16_t
+    frames skipped since the previous frame of the output, uint16_t bytes of frame data
+    following, and with a 12 byte header the capture core cycles spent encoding the frame
+    (SysTick of core 1).
+*/
+
+#define A2C_DELTA_STEP_LINES    4               //  lines encoded per step of the capture core
+#define A2C_DELTA_DOT_WORDS     18              //  SEROUT words of a line
+#ifdef FEATURE_A2C_RECORD
+#define A2C_DELTA_LINE_WORDS    22              //  with GR, TEXT and VIDD7
+#define A2C_DELTA_TIME_WORDS    (192 / 4)
+#else
+#define A2C_DELTA_LINE_WORDS    A2C_DELTA_DOT_WORDS
+#define A2C_DELTA_TIME_WORDS    0
+#endif
+#define A2C_DELTA_FRAME_WORDS   (192 * A2C_DELTA_LINE_WORDS + A2C_DELTA_TIME_WORDS)
+#define A2C_DELTA_RUN           0x00
+#define A2C_DELTA_LITERAL       0x80
+#define A2C_DELTA_MAX_RUN       128
+#define A2C_DELTA_OUTPUTS       2
+
+//  Worst case of a frame of "words" words: every word changed, one tag per A2C_DELTA_MAX_RUN words
+#define A2C_DELTA_DATA_MAX(words)   ((words) * 4 + ((words) + A2C_DELTA_MAX_RUN - 1) / A2C_DELTA_MAX_RUN)
+
+typedef struct
+{
+    //  Set by the output
+    uint8_t*            ring;
+    uint32_t            ring_size;          //  a power of 2 when "pos" may wrap around
+    uint32_t            line_words;         //  words of each line, A2C_DELTA_DOT_WORDS or A2C_DELTA_LINE_WORDS
+    bool                times;              //  the line times follow the lines
+    uint32_t            frame_header;       //  8, or 12 with the encoder cycles
+    uint32_t            capacity;           //  bytes the output takes in all, 0 for no limit
+    volatile uint32_t   done;               //  bytes taken out of the ring (render core)
+
+    //  Encoder (capture core)
+    bool                key;                //  the next frame is encoded against an empty image
+    bool                full;               //  a frame did not fit into the capacity
+    uint32_t            frames;             //  frames complete
+    uint32_t            skipped;            //  frames skipped since the current one was taken
+    uint32_t            frame_skipped;      //  skipped before the current one, in its frame header
+    uint32_t            skipped_total;      //  before the last complete frame, with its frame_skipped
+    uint32_t            pos;                //  bytes of the output, including the current frame
+    volatile uint32_t   committed;          //  bytes of complete frames
+    uint32_t            index;              //  ring index of pos
+    uint32_t            frame_index;        //  ring index of the frame header
+    uint32_t            tag_index;          //  ring index of the open run
+    uint32_t            count;              //  words of the open run, 0 when there is none
+    bool                literal;
+} a2c_delta_output_t;
+
+//  render core, while the output takes no frames
+void a2c_delta_reset    (a2c_delta_output_t* output, uint32_t capacity);
+void a2c_delta_ram_budget(void);
+
+//  capture core
+void a2c_delta_write    (a2c_delta_output_t* output, const void* data, uint32_t size);
+bool a2c_delta_add      (a2c_delta_output_t* output);
+void a2c_delta_skip     (a2c_delta_output_t* output);
+void a2c_delta_frame    (uint32_t frame);
+bool a2c_delta_pending  (void);
+void a2c_delta_step     (void);
@@ -0,0 +1,357 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <pico/stdlib.h>
+#include <hardware/sync.h>
+#include "config/config.h"
+#include "a2c_lut.h"
+
+#ifdef FEATURE_A2C
+
+//  Request of the render core, the capture core starts over when the generation changes
+static a2c_lut_params_t     s_request_params;
+static bool                 s_request_valid = false;        //  false cancels the synthesis
+static int8_t               s_request_adjust[4];            //  hue, saturation, brightness, sharpness
+static uint32_t*            s_request_lut[3];
+static volatile uint32_t    s_request_generation = 0;
+static volatile uint32_t    s_done_generation = 0;          //  Set by the capture core when the LUT is complete
+
+//  Synthesis state of the capture core
+static uint32_t             s_work_generation = 0;
+static uint32_t*            s_lut[3];
+static uint                 s_entries;
+static uint                 s_index;                        //  Next entry
+static uint                 s_channel;                      //  Next color channel of the entry
+static uint8_t              s_pixels[2][3];                 //  RGB of both pixels of the entry
+
+//  Decoder, the dots of the window (bit taps-1 is the first one) that are summed with a full
+//  and half weight for each pixel, the chroma ones by color carrier phase
+static uint32_t             s_odd_bit;
+static uint32_t             s_luma_full[2];
+static uint32_t             s_luma_half[2];
+static uint32_t             s_chroma_full[2][4];
+static uint32_t             s_chroma_half[2][4];
+static int32_t              s_luma_scale;                   //  16.16, per half weight dot
+static int32_t              s_brightness;                   //  16.16
+static int32_t              s_coef_u[3];                    //  16.16 RGB per half weight dot of the color carrier
+static int32_t              s_coef_v[3];
+
+//  TMDS symbols (plain, inverted) of every value and their disparity (ones minus zeros)
+static bool                 s_symbols_ready = false;
+static uint8_t              s_popcount[256];
+static uint16_t             s_symbol[256][2];
+static int8_t               s_disparity[256][2];
+
+//  YIQ to RGB, 6.10 fixed point (I, Q columns)
+static const int32_t s_yiq_rgb[3][2] = { { 979, 636 }, { -279, -663 }, { -1133, 1744 } };
+
+#define HUE_STEP_COS        16135       //  cos(A2C_LUT_HUE_STEP), 1.14 fixed point
+#define HUE_STEP_SIN        2845
+
+static inline int clamp_int(int value, int min, int max)
+{
+    return (value < min) ? min : ((value > max) ? max : value);
+}
+
+static inline uint popcount(uint32_t value)
+{
+    return s_popcount[value & 0xff] + s_popcount[(value >> 8) & 0xff];
+}
+
+//  The color adjustments, 0 for the build time LUTs
+bool DELAYED_COPY_CODE(a2c_lut_adjusted)(void)
+{
+    return (cfg_ntsc_hue != 0) || (cfg_ntsc_saturation != 0) || (cfg_ntsc_brightness != 0) || (cfg_ntsc_sharpness != 0);
+}
+
+uint32_t DELAYED_COPY_CODE(a2c_lut_adjustments)(void)
+{
+    return ((uint8_t)cfg_ntsc_hue) | ((uint8_t)cfg_ntsc_saturation << 8) | ((uint8_t)cfg_ntsc_brightness << 16) | ((uint32_t)(uint8_t)cfg_ntsc_sharpness << 24);
+}
+
+//  Render core: build the LUT for the parameters and the current adjustments into red, green
+//  and blue (NULL params cancels), a2c_lut_synth_done() tells when the capture core is done
+void DELAYED_COPY_CODE(a2c_lut_synth_request)(const a2c_lut_params_t* params, uint32_t* red, uint32_t* green, uint32_t* blue)
+{
+    s_request_valid = (params != NULL);
+    if (params != NULL)
+        s_request_params = *params;
+    s_request_adjust[0] = clamp_int(cfg_ntsc_hue,        A2C_LUT_HUE_MIN,        A2C_LUT_HUE_MAX);
+    s_request_adjust[1] = clamp_int(cfg_ntsc_saturation, A2C_LUT_SATURATION_MIN, A2C_LUT_SATURATION_MAX);
+    s_request_adjust[2] = clamp_int(cfg_ntsc_brightness, A2C_LUT_BRIGHTNESS_MIN, A2C_LUT_BRIGHTNESS_MAX);
+    s_request_adjust[3] = clamp_int(cfg_ntsc_sharpness,  A2C_LUT_SHARPNESS_MIN,  A2C_LUT_SHARPNESS_MAX);
+    s_request_lut[0] = red;
+    s_request_lut[1] = green;
+    s_request_lut[2] = blue;
+
+    //  Publish the request after its parameters
+    __dmb();
+    s_request_generation++;
+}
+
+bool DELAYED_COPY_CODE(a2c_lut_synth_done)(void)
+{
+    return s_done_generation == s_request_generation;
+}
+
+bool __time_critical_func(a2c_lut_synth_pending)(void)
+{
+    return s_done_generation != s_request_generation;
+}
+
+//  q_m of the DVI encoder for a value (DVI 1.0, figure 3-5)
+static uint DELAYED_COPY_CODE(transition_minimize)(uint value)
+{
+    uint ones = s_popcount[value];
+    bool xnor = (ones > 4) || ((ones == 4) && ((value & 1) == 0));
+    uint q = value & 1;
+
+    for (uint i = 1; i < 8; i++)
+    {
+        uint bit = ((q >> (i - 1)) ^ (value >> i)) & 1;
+        if (xnor)
+            bit ^= 1;
+        q |= bit << i;
+    }
+    return xnor ? q : (q | 0x100);
+}
+
+static void DELAYED_COPY_CODE(init_symbols)(void)
+{
+    for (uint value = 0; value < 256; value++)
+    {
+        uint ones = 0;
+        for (uint bit = 0; bit < 8; bit++)
+            ones += (value >> bit) & 1;
+        s_popcount[value] = ones;
+    }
+
+    for (uint value = 0; value < 256; value++)
+    {
+        uint q_m = transition_minimize(value);
+        s_symbol[value][0] = q_m;
+        s_symbol[value][1] = (q_m ^ 0xff) | 0x200;
+        for (uint inverted = 0; inverted < 2; inverted++)
+        {
+            s_disparity[value][inverted] = 2 * popcount(s_symbol[value][inverted]) - 10;
+        }
+    }
+    s_symbols_ready = true;
+}
+
+//  Adds the dots of a box filter of "width" dots around "center" to the masks (by color carrier
+//  phase), returns the sum of the weights in halves.  The dots outside of the window are black.
+static int DELAYED_COPY_CODE(filter_masks)(uint taps, int center, int width, uint phase, uint32_t full[4], uint32_t half[4])
+{
+    int reach = width / 2;
+    int weight = 0;
+
+    for (int offset = -reach; offset <= reach; offset++)
+    {
+        //  Even widths have half weight dots at both ends
+        bool edge = ((width & 1) == 0) && ((offset == -reach) || (offset == reach));
+        weight += edge ? 1 : 2;
+
+        int dot = center + offset;
+        if ((dot < 0) || (dot >= (int)taps))
+            continue;
+
+        uint32_t bit = 1u << (taps - 1 - dot);
+        if (edge)
+            half[(dot + phase) & 3] |= bit;
+        else
+            full[(dot + phase) & 3] |= bit;
+    }
+    return weight;
+}
+
+//  Capture core: the decoder for the request, see tools/hgr_ntsc_lut.py
+static void DELAYED_COPY_CODE(synth_setup)(void)
+{
+    const a2c_lut_params_t* params = &s_request_params;
+    uint taps = params->taps;
+
+    if (s_symbols_ready == false)
+        init_symbols();
+
+    s_entries = 2u << taps;
+    s_odd_bit = 1u << taps;
+    s_index = 0;
+    s_channel = 0;
+    for (uint c = 0; c < 3; c++)
+        s_lut[c] = s_request_lut[c];
+
+    //  Filters, more sharpness is a narrower luma filter
+    int luma = params->luma - s_request_adjust[3];
+    if (luma < 1)
+        luma = 1;
+
+    int luma_weight = 0;
+    int chroma_weight = 0;
+    for (uint pixel = 0; pixel < 2; pixel++)
+    {
+        int center = taps / 2 - 1 + pixel;
+        uint32_t full[4] = { 0 };
+        uint32_t half[4] = { 0 };
+
+        luma_weight = filter_masks(taps, center, luma, 0, full, half);
+        s_luma_full[pixel] = full[0] | full[1] | full[2] | full[3];
+        s_luma_half[pixel] = half[0] | half[1] | half[2] | half[3];
+
+        for (uint m = 0; m < 4; m++)
+        {
+            s_chroma_full[pixel][m] = 0;
+            s_chroma_half[pixel][m] = 0;
+        }
+        chroma_weight = filter_masks(taps, center, params->chroma, params->phase, s_chroma_full[pixel], s_chroma_half[pixel]);
+    }
+
+    s_luma_scale = (255 << 16) / luma_weight;
+    s_brightness = (s_request_adjust[2] * A2C_LUT_BRIGHTNESS_STEP) << 16;
+
+    //  Hue, rotate the build time one by the steps
+    int32_t hue_cos = params->hue_cos;
+    int32_t hue_sin = params->hue_sin;
+    int steps = s_request_adjust[0];
+    int32_t step_sin = (steps < 0) ? -HUE_STEP_SIN : HUE_STEP_SIN;
+    for (int i = 0; i < ((steps < 0) ? -steps : steps); i++)
+    {
+        int32_t c = (hue_cos * HUE_STEP_COS - hue_sin * step_sin + 8192) >> 14;
+        int32_t s = (hue_sin * HUE_STEP_COS + hue_cos * step_sin + 8192) >> 14;
+        hue_cos = c;
+        hue_sin = s;
+    }
+
+    //  I = u cos - v sin, Q = u sin + v cos, scaled by 2 * saturation / chroma weight
+    int64_t saturation = (int64_t)params->saturation * (100 + s_request_adjust[1] * A2C_LUT_SATURATION_STEP);
+    for (uint c = 0; c < 3; c++)
+    {
+        int64_t u = s_yiq_rgb[c][0] * hue_cos + s_yiq_rgb[c][1] * hue_sin;
+        int64_t v = s_yiq_rgb[c][1] * hue_cos - s_yiq_rgb[c][0] * hue_sin;
+        int64_t divisor = (int64_t)100 * 100 * chroma_weight * 256;
+        s_coef_u[c] = (int32_t)(2 * 255 * saturation * u / divisor);
+        s_coef_v[c] = (int32_t)(2 * 255 * saturation * v / divisor);
+    }
+}
+
+//  RGB of both pixels of an entry
+static void __time_critical_func(decode_entry)(uint32_t index)
+{
+    bool odd = (index & s_odd_bit) != 0;
+
+    for (uint pixel = 0; pixel < 2; pixel++)
+    {
+        int32_t y = s_luma_scale * (int32_t)(2 * popcount(index & s_luma_full[pixel]) + popcount(index & s_luma_half[pixel]));
+        int32_t carrier[4];
+        for (uint m = 0; m < 4; m++)
+            carrier[m] = 2 * popcount(index & s_chroma_full[pixel][m]) + popcount(index & s_chroma_half[pixel][m]);
+
+        //  Odd pairs start two dots later on the color carrier
+        int32_t u = carrier[0] - carrier[2];
+        int32_t v = carrier[1] - carrier[3];
+        if (odd)
+        {
+            u = -u;
+            v = -v;
+        }
+
+        y += s_brightness + 0x8000;
+        for (uint c = 0; c < 3; c++)
+            s_pixels[pixel][c] = clamp_int((y + s_coef_u[c] * u + s_coef_v[c] * v) >> 16, 0, 255);
+    }
+}
+
+//  Symbol pair (first pixel in bits 0-9) of the values closest to (first, second) with a
+//  disparity of 0, the first value at most 3 away, like balanced_pair() of the generator
+static uint32_t __time_critical_func(balanced_pair)(int first, int second)
+{
+    int best = 0x7fffffff;
+    uint32_t pair = 0;
+
+    for (int a = (first > 3) ? first - 3 : 0; (a <= first + 3) && (a < 256); a++)
+    {
+        int error_a = (a - first) * (a - first);
+        for (uint inverted = 0; inverted < 2; inverted++)
+        {
+            int disparity = -s_disparity[a][inverted];
+
+            //  The nearest second value with a symbol of the opposite disparity, the lower one first
+            for (int distance = 0; error_a + distance * distance < best; distance++)
+            {
+                int b = second - distance;
+                uint symbol = 0x400;
+                if (b >= 0)
+                    symbol = (s_disparity[b][0] == disparity) ? s_symbol[b][0] : ((s_disparity[b][1] == disparity) ? s_symbol[b][1] : 0x400);
+                if ((symbol == 0x400) && (distance != 0))
+                {
+                    b = second + distance;
+                    if (b < 256)
+                        symbol = (s_disparity[b][0] == disparity) ? s_symbol[b][0] : ((s_disparity[b][1] == disparity) ? s_symbol[b][1] : 0x400);
+                }
+                if (symbol != 0x400)
+                {
+                    best = error_a + distance * distance;
+                    pair = s_symbol[a][inverted] | (symbol << 10);
+                    break;
+                }
+            }
+        }
+    }
+    return pair;
+}
+
+//  Capture core: one color channel of one LUT entry, called when there is no SEROUT data
+void __time_critical_func(a2c_lut_synth_step)(void)
+{
+    uint32_t generation = s_request_generation;
+
+    if (generation != s_work_generation)
+    {
+        //  New request, read it after the generation
+        __dmb();
+        s_work_generation = generation;
+        if (s_request_valid)
+            synth_setup();
+        else
+            s_done_generation = generation;
+        return;
+    }
+
+    if (generation == s_done_generation)
+        return;
+
+    if (s_channel == 0)
+        decode_entry(s_index);
+
+    s_lut[s_channel][s_index] = balanced_pair(s_pixels[0][s_channel], s_pixels[1][s_channel]);
+
+    if (++s_channel == 3)
+    {
+        s_channel = 0;
+        if (++s_index == s_entries)
+            s_done_generation = generation;
+    }
+}
+
+#endif      //  FEATURE_A2C
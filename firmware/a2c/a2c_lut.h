@@ -0,0 +1,78 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*  A2C color LUT synthesis
+
+    The NTSC and CLAMP hires LUTs are generated at build time by tools/hgr_ntsc_lut.py, by
+    default the hand tuned tables. When the color adjustments of the A2C menu are not all 0,
+    the LUT of the active color style is rebuilt in RAM from the model parameters (HGRDECODE_*
+    in hgrdecode_LUT.h) and the adjustments, with the decoder of the model in fixed point:
+      hue         rotates the color carrier by A2C_LUT_HUE_STEP degrees per step
+      saturation  scales the chroma by A2C_LUT_SATURATION_STEP percent per step
+      brightness  adds A2C_LUT_BRIGHTNESS_STEP to the luma (0-255) per step
+      sharpness   narrows (or widens) the luma filter by one dot per step
+    Both pixels of an entry are then moved to the nearest values with a DC balanced TMDS
+    symbol pair, like the generator does.
+
+    The render core requests a LUT (a2c_lut_update in a2c.c) and renders B&W until it is
+    complete.  The capture core builds it one color channel of one entry at a time
+    (a2c_lut_synth_step) while it waits for SEROUT data between the lines, a step is a few
+    microseconds, well below what the SEROUT RX FIFO holds.
+*/
+
+#define A2C_LUT_HUE_STEP            10      //  degrees
+#define A2C_LUT_HUE_MIN             -9
+#define A2C_LUT_HUE_MAX             9
+#define A2C_LUT_SATURATION_STEP     10      //  percent of the build time saturation
+#define A2C_LUT_SATURATION_MIN      -10
+#define A2C_LUT_SATURATION_MAX      10
+#define A2C_LUT_BRIGHTNESS_STEP     8
+#define A2C_LUT_BRIGHTNESS_MIN      -8
+#define A2C_LUT_BRIGHTNESS_MAX      8
+#define A2C_LUT_SHARPNESS_MIN       -3
+#define A2C_LUT_SHARPNESS_MAX       3
+
+//  Build time parameters of a LUT, see the HGRDECODE_* macros
+typedef struct
+{
+    uint8_t  taps;
+    uint8_t  phase;
+    uint8_t  luma;
+    uint8_t  chroma;
+    int16_t  saturation;                //  percent
+    int16_t  hue_cos;                   //  1.14 fixed point
+    int16_t  hue_sin;
+} a2c_lut_params_t;
+
+bool     a2c_lut_adjusted       (void);
+uint32_t a2c_lut_adjustments    (void);
+void     a2c_lut_synth_request  (const a2c_lut_params_t* params, uint32_t* red, uint32_t* green, uint32_t* blue);
+bool     a2c_lut_synth_done     (void);
+bool     a2c_lut_synth_pending  (void);
+void     a2c_lut_synth_step     (void);
@@ -0,0 +1,105 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <pico/stdlib.h>
+#include "config/config.h"
+#include "applebus/buffers.h"
+#include "render/render.h"
+#include "a2c_osd.h"
+
+#ifdef FEATURE_A2C
+
+bool a2c_osd_shade = true;
+
+static a2c_osd_span_t   s_spans[A2C_OSD_ROWS][A2C_OSD_SPANS];
+static uint8_t          s_span_count[A2C_OSD_ROWS];
+static uint32_t         s_altchar_rows;             //  Rows rendered with ALTCHAR (mousetext)
+
+#define TEXT_OFFSET(line) ((((line) & 0x7) << 7) + ((((line) >> 3) & 0x3) * 40))
+
+//  A column without OSD, a space on black
+static inline bool osd_blank(uint row, uint column)
+{
+    return (text_p1[TEXT_OFFSET(row) + column] == 0xA0) && ((text_p3[TEXT_OFFSET(row) + column] & 0x0f) == 0);
+}
+
+//  Builds the span list from the text page, called after the menu was drawn. Rows in "altchar_rows" use mousetext.
+void DELAYED_COPY_CODE(a2c_osd_update)(uint32_t altchar_rows)
+{
+    for (uint row = 0; row < A2C_OSD_ROWS; row++)
+    {
+        uint count = 0;
+        uint column = 0;
+        while (column < 40)
+        {
+            if (osd_blank(row, column))
+            {
+                column++;
+                continue;
+            }
+
+            //  A run of glyphs, with a column of background around it
+            uint first = (column > 0) ? column - 1 : 0;
+            while ((column < 40) && (osd_blank(row, column) == false))
+                column++;
+            uint last = (column < 40) ? column + 1 : 40;
+
+            if ((count > 0) && ((first < s_spans[row][count - 1].last + A2C_OSD_MIN_GAP) || (count == A2C_OSD_SPANS)))
+            {
+                //  Close to the previous span, or no span left
+                s_spans[row][count - 1].last = last;
+            }
+            else
+            {
+                s_spans[row][count].first = first;
+                s_spans[row][count].last  = last;
+                count++;
+            }
+        }
+        s_span_count[row] = count;
+    }
+    s_altchar_rows = altchar_rows;
+}
+
+//  Renders the OSD spans of a line over the encoded video, before it is sent
+void DELAYED_COPY_CODE(a2c_osd_line)(uint32_t* tmdsbuf, uint32_t line)
+{
+    uint row = line / 8;
+    if ((row >= A2C_OSD_ROWS) || (s_span_count[row] == 0))
+        return;
+    uint count = s_span_count[row];
+
+    uint32_t softsw = soft_switches;
+    if (s_altchar_rows & (1u << row))
+        soft_switches |= SOFTSW_ALTCHAR;
+    else
+        soft_switches &= ~SOFTSW_ALTCHAR;
+
+    for (uint i = 0; i < count; i++)
+        render_color_text40_span(tmdsbuf, row, line & 7, s_spans[row][i].first, s_spans[row][i].last, a2c_osd_shade);
+
+    soft_switches = softsw;
+}
+
+#endif
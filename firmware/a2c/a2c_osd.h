@@ -0,0 +1,58 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*  A2C on screen display
+
+    The menu is drawn into the text page (text_p1 glyphs, text_p3 lores colors) like before,
+    but composited over the live video instead of replacing it, so the effect of the color
+    and scanline choices shows while they are made.
+
+    a2c_osd_update builds a span list from the text page after the menu was drawn: for each
+    text row up to A2C_OSD_SPANS columns ranges of glyphs that aren't a black space, one
+    column wider on each side, gaps of less than A2C_OSD_MIN_GAP columns closed. The lines
+    of the video go through a2c_osd_line before they are sent: it renders only these spans
+    of the glyph line over the encoded video (render_color_text40_span), so the cost grows
+    with the area of the OSD. The background is solid or, with a2c_osd_shade, every other
+    pixel pair in a checkerboard.
+*/
+
+#define A2C_OSD_ROWS        24
+#define A2C_OSD_SPANS       4                   //  spans per text row
+#define A2C_OSD_MIN_GAP     3                   //  columns between two spans
+
+typedef struct
+{
+    uint8_t first;                              //  columns [first, last)
+    uint8_t last;
+} a2c_osd_span_t;
+
+extern bool a2c_osd_shade;                      //  semi-transparent background (menu)
+
+void a2c_osd_update (uint32_t altchar_rows);
+void a2c_osd_line   (uint32_t* tmdsbuf, uint32_t line);
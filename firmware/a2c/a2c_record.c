@@ -0,0 +1,177 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <string.h>
+#include <pico/stdlib.h>
+#include <hardware/flash.h>
+#include <hardware/sync.h>
+#include "applebus/buffers.h"
+#include "config/config.h"
+#include "debug/debug.h"
+#include "a2c_record.h"
+
+#if defined(FEATURE_A2C) && defined(FEATURE_A2C_RECORD)
+
+extern uint8_t __record_data_start[];
+extern uint8_t __FLASH_RECORD_LEN[];
+
+//  Capture times of the frame buffers of a2c.c
+extern uint32_t s_line_capture_time[][192];
+
+volatile a2c_record_state_t a2c_record_state = A2cRecordIdle;
+
+static uint8_t              s_ring[A2C_RECORD_RING_SIZE];
+static a2c_delta_output_t   s_output =
+{
+    .ring           = s_ring,
+    .ring_size      = A2C_RECORD_RING_SIZE,
+    .line_words     = A2C_RECORD_LINE_WORDS,
+    .times          = true,
+    .frame_header   = A2C_RECORD_FRAME_HEADER,
+};
+static a2c_record_header_t  s_header;               //  Settings when the recording was started
+static uint32_t             s_start_time;
+
+//  Called by a2c_loop when a frame is complete, before a2c_delta_frame
+void __time_critical_func(a2c_record_frame)(uint32_t frame)
+{
+    a2c_record_state_t state = a2c_record_state;
+    uint32_t time = s_line_capture_time[frame][191];
+
+    if (state == A2cRecordStart)
+    {
+        s_start_time = time;
+        a2c_record_state = state = A2cRecordRun;
+    }
+    if ((state != A2cRecordRun) && (state != A2cRecordStop))
+        return;
+
+    if (a2c_delta_pending())
+    {
+        //  Still busy with an earlier frame
+        s_output.skipped++;
+        return;
+    }
+
+    //  The encoder is done with the output: it ends when it is stopped, full or out of time
+    if ((state == A2cRecordStop) || (s_output.full) || (time - s_start_time >= A2C_RECORD_SECONDS * 1000000u))
+    {
+        a2c_record_state = A2cRecordFlush;
+        return;
+    }
+
+    a2c_delta_add(&s_output);
+}
+
+//  Erases the FLASH_RECORD area and starts a recording with the next frame, the screen stands
+//  still while the flash is erased
+bool DELAYED_COPY_CODE(a2c_record_start)(void)
+{
+    if (a2c_record_state != A2cRecordIdle)
+        return false;
+
+    flash_range_erase(((uint32_t) __record_data_start) - XIP_BASE, (uint32_t) __FLASH_RECORD_LEN);
+
+    memset(&s_header, 0, sizeof(s_header));
+    s_header.magic          = A2C_RECORD_MAGIC;
+    s_header.version        = A2C_RECORD_VERSION;
+    s_header.page_size      = A2C_RECORD_PAGE_SIZE;
+    s_header.internal_flags = internal_flags;
+    s_header.color_style    = cfg_color_style;
+    s_header.rendering_fx   = cfg_rendering_fx;
+    s_header.color_mode     = color_mode;
+    s_header.laser          = cfg_laser_enabled;
+    s_header.adjust[0]      = cfg_ntsc_hue;
+    s_header.adjust[1]      = cfg_ntsc_saturation;
+    s_header.adjust[2]      = cfg_ntsc_brightness;
+    s_header.adjust[3]      = cfg_ntsc_sharpness;
+
+    a2c_delta_reset(&s_output, ((uint32_t) __FLASH_RECORD_LEN) - A2C_RECORD_PAGE_SIZE);
+    __dmb();
+    a2c_record_state = A2cRecordStart;
+    return true;
+}
+
+//  The capture core ends the recording with the next complete frame
+void DELAYED_COPY_CODE(a2c_record_stop)(void)
+{
+    if ((a2c_record_state == A2cRecordStart) || (a2c_record_state == A2cRecordRun))
+        a2c_record_state = A2cRecordStop;
+}
+
+//  Writes complete pages of the ring to flash, called by the render core once per frame
+void DELAYED_COPY_CODE(a2c_record_write)(void)
+{
+    a2c_record_state_t state = a2c_record_state;
+    if (state == A2cRecordIdle)
+        return;
+
+    const uint32_t flash_offset = ((uint32_t) __record_data_start) - XIP_BASE + A2C_RECORD_PAGE_SIZE;
+    uint32_t committed = s_output.committed;
+    uint32_t written = s_output.done;
+    uint pages = (state == A2cRecordFlush) ? UINT32_MAX : A2C_RECORD_PAGES;
+
+    while ((pages > 0) && (committed - written >= A2C_RECORD_PAGE_SIZE))
+    {
+        flash_range_program(flash_offset + written, &s_ring[written % A2C_RECORD_RING_SIZE], A2C_RECORD_PAGE_SIZE);
+        written += A2C_RECORD_PAGE_SIZE;
+        s_output.done = written;
+        pages--;
+    }
+
+    if (state != A2cRecordFlush)
+        return;
+
+    //  The last part of a page, then the header
+    uint32_t page[A2C_RECORD_PAGE_SIZE / 4];
+    if (committed > written)
+    {
+        memset(page, 0xff, sizeof(page));
+        memcpy(page, &s_ring[written % A2C_RECORD_RING_SIZE], committed - written);
+        flash_range_program(flash_offset + written, (uint8_t*) page, A2C_RECORD_PAGE_SIZE);
+        s_output.done = committed;
+    }
+
+    s_header.frame_count = s_output.frames;
+    s_header.data_bytes  = committed;
+    s_header.skipped     = s_output.skipped_total + s_output.skipped;
+    memset(page, 0xff, sizeof(page));
+    memcpy(page, &s_header, sizeof(s_header));
+    flash_range_program(flash_offset - A2C_RECORD_PAGE_SIZE, (uint8_t*) page, A2C_RECORD_PAGE_SIZE);
+
+    a2c_record_state = A2cRecordIdle;
+}
+
+bool DELAYED_COPY_CODE(a2c_record_saved)(void)
+{
+    const a2c_record_header_t* header = (const a2c_record_header_t*) __record_data_start;
+    return (header->magic == A2C_RECORD_MAGIC) && (header->version == A2C_RECORD_VERSION);
+}
+
+void DELAYED_COPY_CODE(a2c_record_ram_budget)(void)
+{
+    ram_budget_add("REC", sizeof(s_ring));
+}
+
+#endif
@@ -0,0 +1,113 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "a2c_delta.h"
+
+/*  A2C video recorder (FEATURE_A2C_RECORD builds only)
+
+    Records the captured frames (SEROUT dots, GR and TEXT of every word, VIDD7 of the video
+    bytes and the capture time of every line) for up to A2C_RECORD_SECONDS into the
+    FLASH_RECORD area, to reproduce a problem offline with tools/a2c_record.py. Started and
+    stopped from the A2C menu (RECORD: START/STOP). Read it back with
+    "picotool save -r 0x10160000 0x101e0000 record.bin".
+
+    The capture core encodes each complete frame against the previous recorded one with the
+    delta encoder it shares with the live stream (a2c_delta.h), into a RAM ring. The render
+    core writes the ring to flash, a few pages per frame. A frame that does not fit into the
+    free part of the ring is skipped, the next frame counts it, the recording stops when the
+    flash area is full.
+
+    Frame image, A2C_RECORD_FRAME_WORDS 32 bit words: per line the 18 SEROUT words (first dot
+    in bit 31), the GR and the TEXT mask (bit n is word n) and VIDD7 of the 40 video bytes
+    (2 words, bit n is byte n), then the microseconds between the capture of a line and the
+    one before it (saturated at 255, 0 for line 0), 4 lines per word, line 0 in bits 0-7.
+
+    Flash layout: one a2c_record_header_t page, followed by the frames:
+      uint32_t time_us_32() when the last line of the frame was captured
+      uint16_t frames skipped since the previous recorded frame
+      uint16_t bytes of frame data following
+      frame data, the image XOR the previous recorded image (all 0 before the first one),
+      as the runs of 32 bit words of a2c_delta.h
+*/
+
+#define A2C_RECORD_MAGIC        0x52433241      //  "A2CR"
+#define A2C_RECORD_VERSION      1
+#define A2C_RECORD_PAGE_SIZE    256             //  one flash page
+
+#ifndef A2C_RECORD_SECONDS
+#define A2C_RECORD_SECONDS      10
+#endif
+#ifndef A2C_RECORD_PAGES
+#define A2C_RECORD_PAGES        4               //  flash pages written per frame by the render core
+#endif
+
+#define A2C_RECORD_LINE_WORDS   22
+#define A2C_RECORD_FRAME_WORDS  (192 * A2C_RECORD_LINE_WORDS + 192 / 4)
+#define A2C_RECORD_FRAME_HEADER 8
+
+//  Worst case of a frame
+#define A2C_RECORD_FRAME_MAX    (A2C_RECORD_FRAME_HEADER + A2C_DELTA_DATA_MAX(A2C_RECORD_FRAME_WORDS))
+//  RAM ring, holds the largest frame
+#define A2C_RECORD_RING_SIZE    (((A2C_RECORD_FRAME_MAX + A2C_RECORD_PAGE_SIZE - 1) / A2C_RECORD_PAGE_SIZE) * A2C_RECORD_PAGE_SIZE)
+
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t page_size;
+    uint32_t frame_count;       //  frames recorded
+    uint32_t data_bytes;        //  bytes of frames following the header page
+    uint32_t skipped;           //  frames that did not fit into the ring
+    uint32_t internal_flags;    //  when the recording was started
+    uint8_t  color_style;       //  cfg_color_style
+    uint8_t  rendering_fx;      //  cfg_rendering_fx
+    uint8_t  color_mode;        //  monochrome color
+    uint8_t  laser;             //  cfg_laser_enabled
+    int8_t   adjust[4];         //  hue, saturation, brightness, sharpness
+} a2c_record_header_t;
+
+typedef enum
+{
+    A2cRecordIdle    = 0,
+    A2cRecordStart   = 1,       //  erased, the capture core starts with the next complete frame
+    A2cRecordRun     = 2,
+    A2cRecordStop    = 3,       //  stop requested, the capture core ends after the frame it encodes
+    A2cRecordFlush   = 4        //  stopped, the render core writes the rest and the header
+} a2c_record_state_t;
+
+extern volatile a2c_record_state_t a2c_record_state;
+
+//  render core
+bool a2c_record_start   (void);
+void a2c_record_stop    (void);
+void a2c_record_write   (void);
+bool a2c_record_saved   (void);
+void a2c_record_ram_budget(void);
+
+//  capture core
+void a2c_record_frame   (uint32_t frame);
@@ -0,0 +1,252 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <string.h>
+#include <pico/stdlib.h>
+#include <hardware/flash.h>
+#include <hardware/sync.h>
+#include "dvi/tmds.h"
+#include "debug/debug.h"
+#include "util/qoi.h"
+#include "a2c_screenshot.h"
+
+#if defined(FEATURE_A2C) && defined(FEATURE_A2C_SCREENSHOT)
+
+extern uint8_t __screenshot_data_start[];
+extern uint8_t __FLASH_SCREENSHOT_LEN[];
+
+volatile a2c_screenshot_state_t a2c_screenshot_state = A2cScreenshotIdle;
+
+static uint8_t                  s_tmds_decode[1024];    //  8 bit value of every TMDS data symbol
+static uint8_t                  s_rgb[A2C_SCREENSHOT_MAX_WIDTH * 3];    //  The decoded line
+static uint8_t                  s_ring[A2C_SCREENSHOT_RING_SIZE];
+static uint8_t                  s_part[QOI_PIXELS_MAX(A2C_SCREENSHOT_PART)];
+static qoi_encoder_t            s_encoder;
+static a2c_screenshot_header_t  s_header;
+static uint32_t                 s_line;                 //  Line to decode and encode
+static bool                     s_line_ready;           //  s_rgb holds s_line
+static uint32_t                 s_pixel;                //  Next pixel of the two image rows of s_line
+static uint32_t                 s_pos;                  //  Bytes of the image
+static uint32_t                 s_written;              //  Bytes written to flash
+static uint32_t                 s_capacity;             //  Bytes of the image that fit into FLASH_SCREENSHOT
+
+//  Erases the FLASH_SCREENSHOT area and takes the next rendered frame, the screen stands still
+//  while the flash is erased
+bool DELAYED_COPY_CODE(a2c_screenshot_start)(void)
+{
+    if ((a2c_screenshot_state != A2cScreenshotIdle) || (dvi_x_resolution > A2C_SCREENSHOT_MAX_WIDTH))
+        return false;
+
+    flash_range_erase(((uint32_t) __screenshot_data_start) - XIP_BASE, (uint32_t) __FLASH_SCREENSHOT_LEN);
+
+    //  Bit 9 inverts the data bits, bit 8 selects XOR (else XNOR) of the neighbouring bits
+    for (uint32_t symbol = 0; symbol < 1024; symbol++)
+    {
+        uint32_t bits = (symbol & 0x200) ? ~symbol : symbol;
+        uint32_t value = bits ^ (bits << 1);
+        if ((symbol & 0x100) == 0)
+            value ^= 0xfe;
+        s_tmds_decode[symbol] = value;
+    }
+
+    memset(&s_header, 0, sizeof(s_header));
+    s_header.magic      = A2C_SCREENSHOT_MAGIC;
+    s_header.version    = A2C_SCREENSHOT_VERSION;
+    s_header.page_size  = A2C_SCREENSHOT_PAGE_SIZE;
+    s_header.width      = dvi_x_resolution;
+    s_header.height     = 192 * 2;
+
+    s_pos        = qoi_encode_begin(&s_encoder, s_header.width, s_header.height, s_ring);
+    s_written    = 0;
+    s_capacity   = ((uint32_t) __FLASH_SCREENSHOT_LEN) - A2C_SCREENSHOT_PAGE_SIZE;
+    s_line       = 0;
+    s_line_ready = false;
+    s_pixel      = 0;
+    __dmb();
+    a2c_screenshot_state = A2cScreenshotStart;
+    return true;
+}
+
+//  Called before render_a2c picks the frame to render, true while the frame of the screenshot
+//  has to stand still
+bool DELAYED_COPY_CODE(a2c_screenshot_hold)(void)
+{
+    if (a2c_screenshot_state == A2cScreenshotStart)
+    {
+        //  The frame picked now is the screenshot
+        s_header.time = time_us_32();
+        a2c_screenshot_state = A2cScreenshotCapture;
+        return false;
+    }
+
+    return (a2c_screenshot_state == A2cScreenshotCapture);
+}
+
+//  Decodes the next line of the screenshot from its TMDS buffer, called by render_a2c for
+//  every line just before it is sent
+void DELAYED_COPY_CODE(a2c_screenshot_line)(uint32_t line, const uint32_t* tmdsbuf)
+{
+    if ((a2c_screenshot_state != A2cScreenshotCapture) || (line != s_line) || (s_line_ready))
+        return;
+
+    if (dvi_x_resolution != s_header.width)
+    {
+        //  The video mode changed, give up
+        a2c_screenshot_state = A2cScreenshotIdle;
+        return;
+    }
+
+    //  Two pixels per word, the first one in bits 0-9
+    const uint32_t* blue  = tmdsbuf;
+    const uint32_t* green = blue  + DVI_WORDS_PER_CHANNEL;
+    const uint32_t* red   = green + DVI_WORDS_PER_CHANNEL;
+    uint8_t* rgb = s_rgb;
+
+    for (uint32_t i = 0; i < s_header.width / 2; i++)
+    {
+        uint32_t r = red[i];
+        uint32_t g = green[i];
+        uint32_t b = blue[i];
+
+        rgb[0] = s_tmds_decode[r & 0x3ff];
+        rgb[1] = s_tmds_decode[g & 0x3ff];
+        rgb[2] = s_tmds_decode[b & 0x3ff];
+        rgb[3] = s_tmds_decode[(r >> 10) & 0x3ff];
+        rgb[4] = s_tmds_decode[(g >> 10) & 0x3ff];
+        rgb[5] = s_tmds_decode[(b >> 10) & 0x3ff];
+        rgb += 6;
+    }
+
+    s_line_ready = true;
+}
+
+//  Appends encoded bytes to the ring, false when the image does not fit into the flash area
+static bool DELAYED_COPY_CODE(screenshot_put)(const uint8_t* data, uint32_t size)
+{
+    if (s_pos + size > s_capacity)
+        return false;
+
+    for (uint32_t i = 0; i < size; i++)
+        s_ring[(s_pos + i) % A2C_SCREENSHOT_RING_SIZE] = data[i];
+    s_pos += size;
+    return true;
+}
+
+//  Encodes the decoded line and writes complete pages of the ring to flash, called by the
+//  render core once per frame
+void DELAYED_COPY_CODE(a2c_screenshot_write)(void)
+{
+    a2c_screenshot_state_t state = a2c_screenshot_state;
+    if ((state == A2cScreenshotIdle) || (state == A2cScreenshotStart))
+        return;
+
+    const uint32_t flash_offset = ((uint32_t) __screenshot_data_start) - XIP_BASE + A2C_SCREENSHOT_PAGE_SIZE;
+    uint pages = A2C_SCREENSHOT_PAGES;
+
+    while ((pages > 0) && (s_pos - s_written >= A2C_SCREENSHOT_PAGE_SIZE))
+    {
+        flash_range_program(flash_offset + s_written, &s_ring[s_written % A2C_SCREENSHOT_RING_SIZE], A2C_SCREENSHOT_PAGE_SIZE);
+        s_written += A2C_SCREENSHOT_PAGE_SIZE;
+        pages--;
+    }
+
+    if ((state == A2cScreenshotCapture) && (s_line_ready))
+    {
+        //  The line is two rows of the image, encoded while the ring has room for a part
+        uint32_t width = s_header.width;
+        while (s_pixel < 2 * width)
+        {
+            if (s_pos - s_written + sizeof(s_part) > A2C_SCREENSHOT_RING_SIZE)
+                return;
+
+            uint32_t x = (s_pixel < width) ? s_pixel : s_pixel - width;
+            uint32_t count = MIN(A2C_SCREENSHOT_PART, width - x);
+            uint32_t size = qoi_encode_pixels(&s_encoder, &s_rgb[x * 3], count, s_part);
+            if (!screenshot_put(s_part, size))
+            {
+                a2c_screenshot_state = A2cScreenshotIdle;
+                return;
+            }
+            s_pixel += count;
+        }
+
+        s_pixel = 0;
+        s_line++;
+        __dmb();
+        s_line_ready = false;
+    }
+
+    if ((state == A2cScreenshotCapture) && (s_line == 192))
+    {
+        if (s_pos - s_written + QOI_END_MAX > A2C_SCREENSHOT_RING_SIZE)
+            return;
+
+        uint32_t size = qoi_encode_end(&s_encoder, s_part);
+        if (!screenshot_put(s_part, size))
+        {
+            a2c_screenshot_state = A2cScreenshotIdle;
+            return;
+        }
+
+        //  The screen moves on, the rest is written with the next frames
+        a2c_screenshot_state = state = A2cScreenshotFlush;
+    }
+
+    if ((state != A2cScreenshotFlush) || (s_pos - s_written >= A2C_SCREENSHOT_PAGE_SIZE))
+        return;
+
+    //  The last part of a page, then the header
+    uint32_t page[A2C_SCREENSHOT_PAGE_SIZE / 4];
+    if (s_pos > s_written)
+    {
+        memset(page, 0xff, sizeof(page));
+        memcpy(page, &s_ring[s_written % A2C_SCREENSHOT_RING_SIZE], s_pos - s_written);
+        flash_range_program(flash_offset + s_written, (uint8_t*) page, A2C_SCREENSHOT_PAGE_SIZE);
+        s_written = s_pos;
+    }
+
+    s_header.data_bytes = s_pos;
+    memset(page, 0xff, sizeof(page));
+    memcpy(page, &s_header, sizeof(s_header));
+    flash_range_program(flash_offset - A2C_SCREENSHOT_PAGE_SIZE, (uint8_t*) page, A2C_SCREENSHOT_PAGE_SIZE);
+
+    a2c_screenshot_state = A2cScreenshotIdle;
+}
+
+//  The header of the saved screenshot, NULL when there is none (or it is being taken)
+const a2c_screenshot_header_t* DELAYED_COPY_CODE(a2c_screenshot_saved)(void)
+{
+    const a2c_screenshot_header_t* header = (const a2c_screenshot_header_t*) __screenshot_data_start;
+    if ((a2c_screenshot_state != A2cScreenshotIdle) || (header->magic != A2C_SCREENSHOT_MAGIC) ||
+        (header->version != A2C_SCREENSHOT_VERSION))
+        return NULL;
+    return header;
+}
+
+void DELAYED_COPY_CODE(a2c_screenshot_ram_budget)(void)
+{
+    ram_budget_add("SCR", sizeof(s_tmds_decode) + sizeof(s_rgb) + sizeof(s_ring) + sizeof(s_part) + sizeof(s_encoder));
+}
+
+#endif
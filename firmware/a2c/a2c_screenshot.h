@@ -0,0 +1,85 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*  A2C screenshots (FEATURE_A2C_SCREENSHOT builds only)
+
+    Taken from the A2C menu (SCREENSHOT: TAKE). The flash area is erased when the menu is
+    left, then the next frame stands still on the screen until each of its 192 lines has
+    been rendered once more: the TMDS symbols of the line are decoded back to RGB just
+    before the line is sent to libdvi, so the image has the colors of the render mode
+    on the screen (A2DVI, NTSC, CLAMP, mixed, B&W, green or amber). During the
+    vertical blank the render core encodes the line as two image rows with the streaming
+    QOI encoder (util/qoi.h) into a RAM ring, and writes the ring to the FLASH_SCREENSHOT
+    area, a few pages per frame. The screen moves on after about 3 seconds, the image is
+    complete when the last page and the header are written.
+
+    The image (dvi_x_resolution x 384, the letter box of the DVI output) is the file
+    SCREEN.QOI of the USB mass storage disk (usb/usb_msc.c), or read it back with
+    "picotool save -r 0x10120000 0x10160000 screenshot.bin" and skip the header page.
+
+    Flash layout: one a2c_screenshot_header_t page, followed by the QOI image.
+*/
+
+#define A2C_SCREENSHOT_MAGIC        0x53533241      //  "A2SS"
+#define A2C_SCREENSHOT_VERSION      1
+#define A2C_SCREENSHOT_PAGE_SIZE    256             //  one flash page
+
+#define A2C_SCREENSHOT_PAGES        4               //  flash pages written per frame by the render core
+#define A2C_SCREENSHOT_PART         64              //  pixels encoded at a time
+#define A2C_SCREENSHOT_RING_SIZE    2048            //  RAM ring of the QOI image, a multiple of the page size
+#define A2C_SCREENSHOT_MAX_WIDTH    720
+
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t page_size;
+    uint32_t data_bytes;        //  bytes of the QOI image following the header page
+    uint16_t width;
+    uint16_t height;
+    uint32_t time;              //  time_us_32() when the frame was taken
+} a2c_screenshot_header_t;
+
+typedef enum
+{
+    A2cScreenshotIdle    = 0,
+    A2cScreenshotStart   = 1,   //  erased, the next rendered frame is taken
+    A2cScreenshotCapture = 2,   //  the frame stands still, its lines are decoded and encoded
+    A2cScreenshotFlush   = 3    //  encoded, the render core writes the rest and the header
+} a2c_screenshot_state_t;
+
+extern volatile a2c_screenshot_state_t a2c_screenshot_state;
+
+//  render core
+bool a2c_screenshot_start   (void);
+bool a2c_screenshot_hold    (void);
+void a2c_screenshot_line    (uint32_t line, const uint32_t* tmdsbuf);
+void a2c_screenshot_write   (void);
+const a2c_screenshot_header_t* a2c_screenshot_saved(void);
+void a2c_screenshot_ram_budget(void);
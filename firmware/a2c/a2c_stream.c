@@ -0,0 +1,134 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <string.h>
+#include <pico/stdlib.h>
+#include <hardware/clocks.h>
+#include <hardware/sync.h>
+#include "config/config.h"
+#include "debug/debug.h"
+#include "a2c_stream.h"
+
+#if defined(FEATURE_A2C) && defined(FEATURE_A2C_STREAM)
+
+#include "tusb.h"
+
+#define STREAM_INDEX(pos)   ((pos) & (A2C_STREAM_RING_SIZE - 1))
+
+volatile a2c_stream_state_t a2c_stream_state = A2cStreamIdle;
+
+static uint8_t              s_ring[A2C_STREAM_RING_SIZE];
+static a2c_delta_output_t   s_output =
+{
+    .ring           = s_ring,
+    .ring_size      = A2C_STREAM_RING_SIZE,
+    .line_words     = A2C_STREAM_LINE_WORDS,
+    .times          = false,
+    .frame_header   = A2C_STREAM_FRAME_HEADER,
+};
+
+//  Called by a2c_loop when a frame is complete, before a2c_delta_frame
+void __time_critical_func(a2c_stream_frame)(uint32_t frame)
+{
+    a2c_stream_state_t state = a2c_stream_state;
+    if (state == A2cStreamIdle)
+        return;
+
+    if (a2c_delta_pending())
+    {
+        //  Still busy with an earlier frame
+        s_output.skipped++;
+        return;
+    }
+
+    if (state == A2cStreamStart)
+    {
+        a2c_stream_header_t header;
+        memset(&header, 0, sizeof(header));
+        header.magic         = A2C_STREAM_MAGIC;
+        header.version       = A2C_STREAM_VERSION;
+        header.line_words    = A2C_STREAM_LINE_WORDS;
+        header.lines         = 192;
+        header.frame_header  = A2C_STREAM_FRAME_HEADER;
+        header.sys_clock_khz = clock_get_hz(clk_sys) / 1000;
+        a2c_delta_write(&s_output, &header, sizeof(header));
+
+        //  The first frame after the header is sent against an empty image
+        s_output.key     = true;
+        s_output.skipped = 0;
+        a2c_stream_state = A2cStreamRun;
+    }
+
+    //  Room for the worst case, for a slow host the frame is skipped rather than dropped half way
+    if (A2C_STREAM_RING_SIZE - (s_output.pos - s_output.done) < A2C_STREAM_FRAME_MAX)
+    {
+        a2c_delta_skip(&s_output);
+        return;
+    }
+    a2c_delta_add(&s_output);
+}
+
+//  Follows the host opening and closing the port, and hands the complete frames to the CDC
+//  interface, called by the render core once per frame after tud_task
+void DELAYED_COPY_CODE(a2c_stream_send)(void)
+{
+    bool connected = tud_cdc_connected();
+
+    if (connected != (a2c_stream_state != A2cStreamIdle))
+    {
+        if (connected)
+        {
+            //  Drop what was not sent, the receiver waits for the stream header
+            tud_cdc_write_clear();
+            s_output.done = s_output.committed;
+            __dmb();
+            a2c_stream_state = A2cStreamStart;
+        }
+        else
+            a2c_stream_state = A2cStreamIdle;
+    }
+    if (connected == false)
+        return;
+
+    uint32_t committed = s_output.committed;
+    uint32_t sent = s_output.done;
+    while (committed != sent)
+    {
+        uint32_t available = tud_cdc_write_available();
+        if (available == 0)
+            break;
+        uint32_t index = STREAM_INDEX(sent);
+        uint32_t size = MIN(MIN(committed - sent, A2C_STREAM_RING_SIZE - index), available);
+        sent += tud_cdc_write(&s_ring[index], size);
+        s_output.done = sent;
+    }
+    tud_cdc_write_flush();
+}
+
+void DELAYED_COPY_CODE(a2c_stream_ram_budget)(void)
+{
+    ram_budget_add("STR", sizeof(s_ring));
+}
+
+#endif
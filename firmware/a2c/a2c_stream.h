@@ -0,0 +1,92 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "a2c_delta.h"
+
+/*  A2C live stream (FEATURE_A2C_STREAM builds only)
+
+    Sends the captured frames over the USB CDC interface (/dev/ttyACM0 on Linux), to watch
+    the Apple IIc from a computer with tools/a2c_stream.py. The stream starts when the host
+    opens the port and stops when it closes it.
+
+    Only the SEROUT dots are sent, 18 words per line (13824 bytes per frame), the receiver
+    shows them like a monochrome monitor. The capture core encodes each complete frame against
+    the last one it sent with the delta encoder it shares with the recorder (a2c_delta.h), into
+    a RAM ring. The render core hands the ring to the CDC interface once per frame, after
+    tud_task, up to CFG_TUD_CDC_EP_BUFSIZE bytes (about 120KB/s). A frame is only taken when
+    the ring has room for its worst case, otherwise it is skipped and the next frame counts it:
+    the frame rate follows what the host reads, and a slow host never stalls the capture core.
+    Frames the encoder drops (see a2c_delta.h) are counted the same way, a frame is never sent
+    torn.
+
+    Stream: an a2c_stream_header_t when the stream starts, the first frame after it is XORed
+    with an empty image. Then the frames:
+      uint32_t time_us_32() when the last line of the frame was captured
+      uint16_t frames skipped since the previous frame
+      uint16_t bytes of frame data following
+      uint32_t capture core cycles spent encoding the frame (SysTick of core 1)
+      frame data, the image XOR the previous frame as the runs of 32 bit words of a2c_delta.h
+*/
+
+#define A2C_STREAM_MAGIC        0x53433241      //  "A2CS"
+#define A2C_STREAM_VERSION      1
+
+#define A2C_STREAM_LINE_WORDS   A2C_DELTA_DOT_WORDS
+#define A2C_STREAM_FRAME_WORDS  (192 * A2C_STREAM_LINE_WORDS)
+#define A2C_STREAM_FRAME_HEADER 12
+
+//  Worst case of a frame
+#define A2C_STREAM_FRAME_MAX    (A2C_STREAM_FRAME_HEADER + A2C_DELTA_DATA_MAX(A2C_STREAM_FRAME_WORDS))
+//  RAM ring, holds the largest frame, a power of 2
+#define A2C_STREAM_RING_SIZE    (16*1024)
+
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t line_words;        //  32 bit words per line
+    uint16_t lines;
+    uint16_t frame_header;      //  bytes of a frame header
+    uint32_t sys_clock_khz;     //  clock of the cycle counts
+} a2c_stream_header_t;
+
+typedef enum
+{
+    A2cStreamIdle    = 0,       //  the host has not opened the port
+    A2cStreamStart   = 1,       //  opened, the capture core starts with the next complete frame
+    A2cStreamRun     = 2
+} a2c_stream_state_t;
+
+extern volatile a2c_stream_state_t a2c_stream_state;
+
+//  render core
+void a2c_stream_send    (void);
+void a2c_stream_ram_budget(void);
+
+//  capture core
+void a2c_stream_frame   (uint32_t frame);
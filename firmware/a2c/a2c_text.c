@@ -0,0 +1,398 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <string.h>
+#include <pico/stdlib.h>
+#include <hardware/sync.h>
+#include "config/config.h"
+#include "applebus/buffers.h"
+#include "debug/debug.h"
+#include "a2c_text.h"
+#include "a2c.h"
+
+#if defined(FEATURE_A2C) && defined(FEATURE_A2C_TEXT)
+
+#include "tusb.h"
+
+//  Frame buffers of a2c.c
+extern uint32_t s_screen_buffer[][192][19];
+extern uint32_t s_screen_GR_mask[][192];
+
+bool a2c_text_render = true;
+
+static a2c_text_frame_t     s_text[3];              //  One for each frame buffer of a2c.c
+
+//  The index, glyph rows are 7 bits with the first dot in bit 6 (like the SEROUT dots), row n in bits 7n-7n+6
+static uint64_t             s_glyphs[A2C_TEXT_GLYPHS];
+static uint16_t             s_index[A2C_TEXT_HASH_SIZE];    //  code + 1, 0 for an empty slot
+static uint8_t              s_inverse_code[0x80];   //  Code without ALTCHAR of the glyphs 0x00-0x7f, 0xff when there is none
+static volatile bool        s_index_ready = false;
+static volatile uint32_t    s_index_generation = 0; //  Incremented when the index is rebuilt
+static int                  s_index_offset = -1;    //  Half of character_rom in the index
+
+//  Recognizer of the capture core
+static volatile int32_t     s_frame = -1;           //  Frame buffer being recognized, -1 when there is none
+static uint32_t             s_row;
+static uint32_t             s_column;               //  Next column to extract
+static uint32_t             s_cell;                 //  Next cell to look up
+static uint32_t             s_cells;                //  40 or 80 cells to look up, 0 while extracting
+static bool                 s_paired;               //  Every dot of the row so far is doubled
+static bool                 s_altchar;              //  The row so far has a glyph that is only shown with ALTCHAR
+static bool                 s_inverse;              //  The row so far has a glyph that is only shown without ALTCHAR
+static uint32_t             s_row_generation;       //  Of the index the cells of the row are looked up with
+static uint16_t             s_codes[2 * A2C_TEXT_COLUMNS];  //  Index codes of the row
+static uint16_t             s_dots[8][A2C_TEXT_COLUMNS];    //  14 dots of each column, the first one in bit 13
+
+static inline uint32_t text_hash(uint64_t glyph)
+{
+    uint32_t h = (uint32_t)glyph ^ ((uint32_t)(glyph >> 28) * 0x85ebca6bu);
+    return (h * 0x9e3779b1u) >> (32 - A2C_TEXT_HASH_BITS);
+}
+
+//  The index code of a glyph, -1 when there is none
+static inline int32_t __time_critical_func(text_lookup)(uint64_t glyph)
+{
+    uint32_t slot = text_hash(glyph);
+    uint32_t entry;
+
+    while ((entry = s_index[slot]) != 0)
+    {
+        if (s_glyphs[entry - 1] == glyph)
+            return entry - 1;
+        slot = (slot + 1) & (A2C_TEXT_HASH_SIZE - 1);
+    }
+    return -1;
+}
+
+//  Builds the index of the active half of character_rom, called by the render core once per frame
+void DELAYED_COPY_CODE(a2c_text_update)(void)
+{
+    int offset = (language_switch) ? 0x800 : 0x0;
+    if (offset == s_index_offset)
+        return;
+
+    //  The capture core drops the frame it works on, lookups meanwhile are still compared with the whole glyph
+    s_index_generation++;
+    s_index_ready = false;
+    __dmb();
+
+    memset(s_index, 0, sizeof(s_index));
+    memset(s_inverse_code, 0xff, sizeof(s_inverse_code));
+    for (uint n = 0; n < A2C_TEXT_GLYPHS; n++)
+    {
+        //  Normal characters first, they get the glyphs that are in the ROM twice, the inverse characters
+        //  of render_text.c last, they are only needed when the ROM doesn't have them
+        uint code = (n < 256) ? ((n + 0x80) & 0xff) : n;
+        uint rom_code = (code < 256) ? code : (0x80 | (code & 0x3f));
+        uint64_t glyph = 0;
+        for (uint line = 0; line < 8; line++)
+        {
+            uint8_t bits = character_rom[offset | (rom_code << 3) | line] ^ ((code < 256) ? 0x00 : 0x7f);
+            uint8_t reversed = 0;
+            for (uint dot = 0; dot < 7; dot++)
+                reversed |= ((bits >> dot) & 1) << (6 - dot);
+            glyph |= (uint64_t)reversed << (7 * line);
+        }
+        s_glyphs[code] = glyph;
+
+        uint32_t slot = text_hash(glyph);
+        while ((s_index[slot] != 0) && (s_glyphs[s_index[slot] - 1] != glyph))
+            slot = (slot + 1) & (A2C_TEXT_HASH_SIZE - 1);
+        if (s_index[slot] == 0)
+            s_index[slot] = code + 1;
+        else if ((code >= 256) && (s_index[slot] - 1 < 0x80) && (s_inverse_code[s_index[slot] - 1] == 0xff))
+            s_inverse_code[s_index[slot] - 1] = code & 0x3f;     //  The ROM has the inverse character as well
+    }
+    s_index_offset = offset;
+
+    __dmb();
+    s_index_ready = true;
+}
+
+//  Copies a recognized row of a frame buffer, returns its columns (40 or 80), 0 when it isn't recognized
+uint32_t DELAYED_COPY_CODE(a2c_text_row)(uint32_t frame, uint32_t row, uint8_t* main, uint8_t* aux, bool* altchar)
+{
+    a2c_text_frame_t* text = &s_text[frame];
+    if ((text->rows & (1u << row)) == 0)
+        return 0;
+
+    *altchar = ((text->rows_inverse & (1u << row)) == 0);
+    memcpy(main, text->main[row], A2C_TEXT_COLUMNS);
+    if ((text->rows80 & (1u << row)) == 0)
+        return 40;
+
+    memcpy(aux, text->aux[row], A2C_TEXT_COLUMNS);
+    return 80;
+}
+
+//  Called by a2c_loop when a frame is complete, "capture" is the buffer it captures into next
+void __time_critical_func(a2c_text_frame)(uint32_t frame, uint32_t capture)
+{
+    s_text[capture].rows = 0;
+
+    if (s_index_ready == false)
+        return;
+
+    s_frame  = frame;
+    s_row    = 0;
+    s_column = 0;
+    s_cells  = 0;
+}
+
+bool __time_critical_func(a2c_text_pending)(void)
+{
+    return s_frame >= 0;
+}
+
+static inline void __time_critical_func(text_next_row)(void)
+{
+    s_column = 0;
+    s_cells  = 0;
+    if (++s_row == A2C_TEXT_ROWS)
+        s_frame = -1;
+}
+
+//  Extracts A2C_TEXT_STEP_COLUMNS columns of a row, or looks up A2C_TEXT_STEP_CELLS cells of it
+void __time_critical_func(a2c_text_step)(void)
+{
+    uint32_t generation = s_index_generation;
+    __dmb();
+    if (s_index_ready == false)
+    {
+        s_frame = -1;
+        return;
+    }
+
+    uint32_t frame = s_frame;
+    uint32_t row = s_row;
+
+    if (s_cells == 0)
+    {
+        if (s_column == 0)
+        {
+            //  Text on all 8 lines
+            for (uint line = 0; line < 8; line++)
+            {
+                if (s_screen_GR_mask[frame][row * 8 + line] != 0)
+                {
+                    text_next_row();
+                    return;
+                }
+            }
+            s_paired = true;
+        }
+
+        uint32_t paired = 0;
+        for (uint line = 0; line < 8; line++)
+        {
+            const uint32_t* screen_line = s_screen_buffer[frame][row * 8 + line];
+            for (uint column = s_column; column < s_column + A2C_TEXT_STEP_COLUMNS; column++)
+            {
+                //  14 dots of the column, like a2c_line_bytes
+                uint pos = A2C_FIRST_BYTE_DOT + (14 * column);
+                uint shift = pos & 31;
+                uint32_t dots = screen_line[pos >> 5] << shift;
+                if (shift > 18)
+                    dots |= screen_line[(pos >> 5) + 1] >> (32 - shift);
+                dots = dots >> 18;
+
+                s_dots[line][column] = dots;
+                paired |= (dots ^ (dots >> 1)) & 0x1555;
+            }
+        }
+        if (paired != 0)
+            s_paired = false;
+
+        s_column += A2C_TEXT_STEP_COLUMNS;
+        if (s_column == A2C_TEXT_COLUMNS)
+        {
+            s_cells   = s_paired ? 40 : 80;
+            s_cell    = 0;
+            s_altchar = false;
+            s_inverse = false;
+        }
+        return;
+    }
+
+    a2c_text_frame_t* text = &s_text[frame];
+    if (s_cell == 0)
+        s_row_generation = generation;
+    uint32_t last = MIN(s_cell + A2C_TEXT_STEP_CELLS, s_cells);
+    for (uint cell = s_cell; cell < last; cell++)
+    {
+        uint64_t glyph = 0;
+        for (uint line = 0; line < 8; line++)
+        {
+            uint32_t bits;
+            if (s_cells == 40)
+            {
+                //  The second dot of each pair (the even bits), packed into 7 bits
+                bits = s_dots[line][cell] & 0x1555;
+                bits = (bits | (bits >> 1)) & 0x3333;
+                bits = (bits | (bits >> 2)) & 0x0f0f;
+                bits = (bits | (bits >> 4)) & 0x00ff;
+            }
+            else
+            {
+                //  Aux cell (the first 7 dots), then main
+                bits = s_dots[line][cell >> 1];
+                bits = (cell & 1) ? (bits & 0x7f) : (bits >> 7);
+            }
+            glyph |= (uint64_t)bits << (7 * line);
+        }
+
+        int32_t code = text_lookup(glyph);
+        if (code >= 0x100)
+            s_inverse = true;
+        else if ((code >= 0) && (code < 0x80) && (s_inverse_code[code] == 0xff))
+            s_altchar = true;
+
+        if ((code < 0) || ((s_altchar) && (s_inverse)))
+        {
+            //  Not text, another character ROM, or mousetext and inverse characters that aren't in the ROM
+            text_next_row();
+            return;
+        }
+        s_codes[cell] = code;
+    }
+    s_cell = last;
+
+    if (s_cell == s_cells)
+    {
+        //  The codes of the row with or without ALTCHAR
+        for (uint cell = 0; cell < s_cells; cell++)
+        {
+            uint32_t code = s_codes[cell];
+            if ((s_inverse) && (code < 0x80))
+                code = s_inverse_code[code];
+
+            if (s_cells == 40)
+                text->main[row][cell] = code;
+            else if (cell & 1)
+                text->main[row][cell >> 1] = code;
+            else
+                text->aux[row][cell >> 1] = code;
+        }
+
+        //  Publish the row, unless the render core rebuilt the index while it was looked up
+        __dmb();
+        if (s_index_generation != s_row_generation)
+        {
+            text_next_row();
+            return;
+        }
+        if (s_cells == 80)
+            text->rows80 |= 1u << row;
+        else
+            text->rows80 &= ~(1u << row);
+        if (s_inverse)
+            text->rows_inverse |= 1u << row;
+        else
+            text->rows_inverse &= ~(1u << row);
+        __dmb();
+        text->rows |= 1u << row;
+        text_next_row();
+    }
+}
+
+#define TEXT_LINE_MAX   (80 + 2)
+
+static char     s_export[1 + A2C_TEXT_ROWS * TEXT_LINE_MAX];
+static uint32_t s_export_size;                      //  Bytes of the snapshot being sent
+static uint32_t s_export_sent;
+static uint32_t s_export_hash;                      //  Of the last snapshot, it is only sent when the text changed
+static bool     s_export_connected = false;
+
+static inline char text_ascii(uint8_t code)
+{
+    if ((code >= 0x40) && (code < 0x60))
+        return A2C_TEXT_MOUSETEXT;
+    code &= 0x7f;
+    return (code < 0x20) ? (code + 0x40) : code;
+}
+
+//  Sends the recognized text of the frame being shown when it changed, called by the render core once per frame
+void DELAYED_COPY_CODE(a2c_text_send)(uint32_t frame)
+{
+    bool connected = tud_cdc_connected();
+    if (connected != s_export_connected)
+    {
+        //  Start with a complete snapshot
+        s_export_connected = connected;
+        s_export_size = 0;
+        s_export_sent = 0;
+        s_export_hash = 0;
+    }
+    if (connected == false)
+        return;
+
+    if (s_export_sent == s_export_size)
+    {
+        //  The previous snapshot is sent, take the next one
+        a2c_text_frame_t* text = &s_text[frame];
+        uint32_t rows = text->rows;
+        char* out = s_export;
+        *out++ = '\f';
+        for (uint row = 0; row < A2C_TEXT_ROWS; row++)
+        {
+            char* line = out;
+            if (rows & (1u << row))
+            {
+                for (uint column = 0; column < A2C_TEXT_COLUMNS; column++)
+                {
+                    if (text->rows80 & (1u << row))
+                        *out++ = text_ascii(text->aux[row][column]);
+                    *out++ = text_ascii(text->main[row][column]);
+                }
+                while ((out > line) && (out[-1] == ' '))
+                    out--;
+            }
+            *out++ = '\r';
+            *out++ = '\n';
+        }
+
+        //  FNV-1a, a new snapshot is a change of the text
+        uint32_t size = out - s_export;
+        uint32_t hash = 0x811c9dc5;
+        for (uint i = 0; i < size; i++)
+            hash = (hash ^ (uint8_t)s_export[i]) * 0x01000193;
+        s_export_sent = 0;
+        s_export_size = (hash != s_export_hash) ? size : 0;
+        s_export_hash = hash;
+    }
+
+    if (s_export_sent != s_export_size)
+    {
+        s_export_sent += tud_cdc_write(&s_export[s_export_sent], MIN(s_export_size - s_export_sent, tud_cdc_write_available()));
+        tud_cdc_write_flush();
+    }
+}
+
+void DELAYED_COPY_CODE(a2c_text_ram_budget)(void)
+{
+    ram_budget_add("TXT", sizeof(s_text) + sizeof(s_glyphs) + sizeof(s_index) + sizeof(s_inverse_code) +
+                          sizeof(s_dots) + sizeof(s_codes) + sizeof(s_export));
+}
+
+#endif
@@ -0,0 +1,96 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*  A2C text recognition (FEATURE_A2C_TEXT builds only)
+
+    In the text modes the IIc only sends the dots of the glyphs. The capture core looks
+    each 7x8 cell of a complete frame up in an index of the character ROM of the firmware
+    (character_rom, the charset selected in the config, language_switch selects the half),
+    to get the characters back. render_a2c then renders the recognized rows with
+    render_text40_line/render_text80_line, like the slotted firmware, instead of the dots.
+
+    A text row is one with GR low on all 8 lines. It is 40 columns when every dot is doubled,
+    80 columns (aux glyph first) otherwise. A row is recognized when every cell is the glyph
+    of a character, otherwise it is rendered from the dots, so a IIc with another character
+    ROM (or a program drawing its own glyphs) still looks like it did.
+
+    The codes are indices into the character ROM, rendered with ALTCHAR: 0x00-0x3f and
+    0x60-0x7f inverse, 0x40-0x5f mousetext, 0x80-0xff normal. Glyphs that are the same
+    bitmap get the first code of 0x80-0xff, 0x00-0x7f. Charsets whose inverse characters
+    aren't in the ROM (the II+ ones) get them from the normal ones inverted, like
+    render_text.c does without ALTCHAR, index codes 0x100-0x13f: a row with these is
+    rendered without ALTCHAR, and isn't recognized when it also has glyphs that are only
+    shown with ALTCHAR (mousetext). Flashing characters are seen as normal and inverse
+    ones in turn, like the IIc shows them.
+
+    The index: the 8 rows of 7 dots of the A2C_TEXT_GLYPHS glyphs, hashed into
+    A2C_TEXT_HASH_SIZE slots (linear probing), built by the render core whenever
+    language_switch changes. A hit is compared with the whole glyph. The capture core works on the latest complete frame while
+    it waits for SEROUT data (between the lines and in the vertical blank), in steps of
+    A2C_TEXT_STEP_COLUMNS columns of a row or A2C_TEXT_STEP_CELLS lookups, which are short
+    enough not to let the PIO FIFOs overflow. A frame takes at most 24 * 10 steps, it is done
+    long before the next one is complete.
+
+    The text on the screen is also sent over USB serial (/dev/ttyACM0 on Linux) whenever it
+    changes: a form feed, then the 24 rows as ASCII lines ending with CR LF (trailing spaces
+    dropped). Unrecognized rows are empty lines, inverse characters are sent as normal ones
+    and mousetext as A2C_TEXT_MOUSETEXT.
+*/
+
+#define A2C_TEXT_ROWS           24
+#define A2C_TEXT_COLUMNS        40              //  video byte positions, 80 columns are two cells each
+#define A2C_TEXT_GLYPHS         (256 + 64)      //  character ROM, inverse characters 0x00-0x3f of render_text.c
+#define A2C_TEXT_HASH_BITS      9
+#define A2C_TEXT_HASH_SIZE      (1 << A2C_TEXT_HASH_BITS)   //  slots of the index
+#define A2C_TEXT_STEP_COLUMNS   8               //  columns extracted per step of the capture core
+#define A2C_TEXT_STEP_CELLS     16              //  cells looked up per step
+#define A2C_TEXT_MOUSETEXT      '*'
+
+//  Recognized text of a frame buffer, written by the capture core
+typedef struct
+{
+    volatile uint32_t rows;                     //  bit n: row n is recognized
+    uint32_t rows80;                            //  bit n: row n is 80 columns
+    uint32_t rows_inverse;                      //  bit n: row n is rendered without ALTCHAR
+    uint8_t  main[A2C_TEXT_ROWS][A2C_TEXT_COLUMNS];
+    uint8_t  aux[A2C_TEXT_ROWS][A2C_TEXT_COLUMNS];
+} a2c_text_frame_t;
+
+extern bool a2c_text_render;                    //  render the recognized rows with the text renderer (menu)
+
+//  render core
+void a2c_text_update    (void);
+uint32_t a2c_text_row   (uint32_t frame, uint32_t row, uint8_t* main, uint8_t* aux, bool* altchar);
+void a2c_text_send      (uint32_t frame);
+void a2c_text_ram_budget(void);
+
+//  capture core
+void a2c_text_frame     (uint32_t frame, uint32_t capture);
+bool a2c_text_pending   (void);
+void a2c_text_step      (void);
@@ -34,6 +34,8 @@ SOFTWARE.
 #include "fonts/textfont.h"
 #include "dvi/a2dvi.h"
 #include "pico/time.h"
+#include "abus_trace.h"
+#include "render/render_cache.h"
 
 
 #define VIDEX_ABUS
@@ -406,6 +408,16 @@ static inline void __time_critical_func(apple2_softswitches)(bool is_write, uint
             soft_switches = (soft_switches & ~(SOFTSW_SHADOW_MASK << SOFTSW_SHADOW_SHIFT)) | ((data & SOFTSW_SHADOW_MASK) << SOFTSW_SHADOW_SHIFT);
         }
         break;
+#endif
+#ifdef FEATURE_SHR
+    case 0x29: // IIgs NEWVIDEO: bit 7 super hires, bit 6 linearize
+        if (is_write)
+        {
+            uint_fast8_t data = DATA_BUS(value);
+            soft_switches = (soft_switches & ~(SOFTSW_SHR | SOFTSW_LINEARIZE)) |
+                            ((data & 0x80) ? SOFTSW_SHR : 0) | ((data & 0x40) ? SOFTSW_LINEARIZE : 0);
+        }
+        break;
 #endif
     case 0x50: // TEXTOFF
         soft_switches &= ~SOFTSW_TEXT_MODE;
@@ -516,6 +528,27 @@ void __time_critical_func(bus_func_ignore)(uint32_t value)
 }
 
 // Shadow screen area of the Apple's memory by observing the bus write cycles
+#ifdef FEATURE_SHR
+// IIgs super hires memory ($E1/2000-$9FFF). The slot bus has no bank address, so writes are
+// captured while super hires is shown, or while RAMWRT selects bank 1 (which the IIgs shadows to $E1).
+static inline void __time_critical_func(shr_write)(uint_fast16_t address, uint_fast8_t data)
+{
+    if (soft_switches & (SOFTSW_SHR | SOFTSW_AUX_WRITE))
+    {
+        shr_memory[address - 0x2000] = data;
+        if (address >= 0x2000 + SHR_PALETTES)
+        {
+            shr_palette_dirty[(address >> 5) & 0xf] = 1;
+        }
+    }
+}
+
+void __time_critical_func(bus_func_shr_write)(uint32_t value)
+{
+    shr_write(ADDRESS_BUS(value), DATA_BUS(value));
+}
+#endif
+
 void __time_critical_func(bus_func_screen_write)(uint32_t value)
 {
     uint_fast16_t address = ADDRESS_BUS(value);
@@ -558,6 +591,16 @@ void __time_critical_func(bus_func_screen_write)(uint32_t value)
                 }
             }
         }
+
+        // the renderers re-encode this line
+        render_mark_dirty(address);
+
+#ifdef FEATURE_SHR
+        if (address >= 0x2000)
+        {
+            shr_write(address, data);
+        }
+#endif
     }
 }
 
@@ -674,10 +717,17 @@ a2busfunc bus_functions[16*2] =
     /*$3xxx WRITE*/ bus_func_screen_write,
     /*$4xxx WRITE*/ bus_func_screen_write,
     /*$5xxx WRITE*/ bus_func_screen_write,
+#ifdef FEATURE_SHR
+    /*$6xxx WRITE*/ bus_func_shr_write,
+    /*$7xxx WRITE*/ bus_func_shr_write,
+    /*$8xxx WRITE*/ bus_func_shr_write,
+    /*$9xxx WRITE*/ bus_func_shr_write,
+#else
     /*$6xxx WRITE*/ bus_func_ignore,
     /*$7xxx WRITE*/ bus_func_ignore,
     /*$8xxx WRITE*/ bus_func_ignore,
     /*$9xxx WRITE*/ bus_func_ignore,
+#endif
     /*$Axxx WRITE*/ bus_func_ignore,
     /*$Bxxx WRITE*/ bus_func_ignore,
     /*$Cxxx WRITE*/ bus_func_cxxx_write,
@@ -686,7 +736,7 @@ a2busfunc bus_functions[16*2] =
     /*$Fxxx WRITE*/ bus_func_ignore
 };
 
-#ifdef FEATURE_TEST
+#if defined(FEATURE_TEST) || defined(FEATURE_ABUS_TRACE)
 void __time_critical_func(abus_interface)(uint32_t value)
 #else
 static inline void abus_interface(uint32_t value)
@@ -728,12 +778,24 @@ static inline void abus_interface(uint32_t value)
     }
 }
 
+//  Ring buffer read position, the DMA write position is read from the DMA channel (abus_ring_write_index)
+static uint32_t s_abus_ring_read_index = 0;
+static uint32_t s_abus_ring_write_index = 0;
+
+//  Warn (count an overflow) when the backlog gets close to the ring size, before cycles are overwritten
+#define ABUS_RING_WARN_LEVEL    (ABUS_RING_SIZE - ABUS_RING_SIZE / 8)
+static bool s_abus_ring_warned = false;
+
+uint32_t s_abus_ring_high_water = 0;
+
 void __time_critical_func(abus_clear_fifo)(void)
 {
-    while (abus_pio_fifo_level())
-    {
-        (void) abus_pio_blocking_read();
-    }
+    //  Skip all bus cycles received so far
+    if (abus_dma_channel < 0)
+        return;
+
+    s_abus_ring_write_index = abus_ring_write_index();
+    s_abus_ring_read_index = s_abus_ring_write_index;
 }
 
 void __time_critical_func(abus_init)()
@@ -877,37 +939,6 @@ void __time_critical_func(abus_calibrate)(void)
 }
 #endif			//	FEATURE_A2_AUDIO
 
-#define ABUS_RING_SIZE 4096         //  8192 byte, 1024 was too small
-
-volatile uint32_t s_abus_ring[ABUS_RING_SIZE];
-volatile uint32_t s_abus_ring_write_index = 0;
-volatile uint32_t s_abus_ring_read_index = 0;
-
-uint32_t s_abus_irq_count = 0;
-
-void __time_critical_func(abus_pio_rx_irq_handler)(void) 
-{
-    //  This is useful for debugging perf issues, but not needed normally
-//    if (abus_pio_is_full())
-//        bus_overflow_counter++;
-    
-    while (!abus_pio_is_empty()) 
-    {
-        s_abus_ring[s_abus_ring_write_index] = abus_pio_read();
-        s_abus_ring_write_index = (s_abus_ring_write_index + 1) & (ABUS_RING_SIZE - 1);
-
-        if (s_abus_ring_write_index == s_abus_ring_read_index)
-            bus_overflow_counter++;
-    }
-
-    //  Stats for debugging
-    s_abus_irq_count++;
-
-    // Clear interrupt
-    pio_interrupt_clear(CONFIG_ABUS_PIO, 0);
-}
-
-
 void __time_critical_func(abus_loop)()
 {
     uint32_t value = 0;
@@ -932,14 +963,38 @@ void __time_critical_func(abus_loop)()
     s_abus_boot_time = to_us_since_boot(get_absolute_time());
 #endif 
 
+#ifdef FEATURE_ABUS_TRACE
+    //  Trace the boot until the RAM ring is full, unless an earlier trace is still in flash
+    if (!abus_trace_saved())
+        abus_trace_start(AbusTraceOneShot);
+#endif
+
     while(1)
     {
-        while (s_abus_ring_read_index != s_abus_ring_write_index)
+        s_abus_ring_write_index = abus_ring_write_index();
+
+        uint32_t backlog = (s_abus_ring_write_index - s_abus_ring_read_index) & (ABUS_RING_SIZE - 1);
+        if (backlog > s_abus_ring_high_water)
+            s_abus_ring_high_water = backlog;
+
+        if (backlog >= ABUS_RING_WARN_LEVEL)
         {
+            if (!s_abus_ring_warned)
+                bus_overflow_counter++;
+            s_abus_ring_warned = true;
+        }
+        else
+            s_abus_ring_warned = false;
 
-            value = s_abus_ring[s_abus_ring_read_index];
+        while (s_abus_ring_read_index != s_abus_ring_write_index)
+        {
+            value = abus_ring[s_abus_ring_read_index];
             s_abus_ring_read_index = (s_abus_ring_read_index + 1) & (ABUS_RING_SIZE - 1);
 
+#ifdef FEATURE_ABUS_TRACE
+            if ((abus_trace_state == AbusTraceRing)||(abus_trace_state == AbusTraceOneShot))
+                abus_trace_record(value);
+#endif
             abus_interface(value);
 
             bus_cycle_counter++;
@@ -955,6 +1010,29 @@ void __time_critical_func(abus_loop)()
 #endif 
         }
 
+        //  The DMA did not keep up and the PIO had to stall, bus cycles were lost
+        if (abus_pio_rx_stalled())
+        {
+            bus_overflow_counter++;
+            abus_pio_clear_rx_stall();
+        }
+
+#ifdef FEATURE_ABUS_TRACE
+        //  The capture was stopped, write it to flash and skip the bus cycles missed meanwhile
+        if (abus_trace_state == AbusTraceSave)
+        {
+            abus_trace_save();
+            abus_clear_fifo();
+        }
+        else
+        if (abus_trace_state == AbusTraceReplay)
+        {
+            //  Same for the replay, which runs through abus_interface instead of the live bus cycles
+            abus_trace_replay();
+            abus_clear_fifo();
+        }
+#endif
+
 #ifdef FEATURE_A2_AUDIO
         if (s_bus_rate_calibrated == false)
             abus_calibrate();
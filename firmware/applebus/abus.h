@@ -30,7 +30,7 @@ SOFTWARE.
 void abus_init      (void);
 void abus_loop      (void);
 void abus_clear_fifo(void);
-#ifdef FEATURE_TEST
+#if defined(FEATURE_TEST) || defined(FEATURE_ABUS_TRACE)
 void abus_interface (uint32_t value);
 #endif
 
@@ -47,4 +47,4 @@ extern uint32_t s_abus_snd_data_count;
 extern uint64_t s_abus_boot_time;
 #endif
 
-extern uint32_t s_abus_irq_count;
\ No newline at end of file
+extern uint32_t s_abus_ring_high_water;
\ No newline at end of file
@@ -25,6 +25,7 @@ SOFTWARE.
 
 #include <string.h>
 #include <hardware/pio.h>
+#include <hardware/dma.h>
 #include "abus_pin_config.h"
 #include "abus_setup.h"
 #include "abus.pio.h"
@@ -35,6 +36,16 @@ SOFTWARE.
 #error CONFIG_PIN_APPLEBUS_PHI0 and PHI0_GPIO must be set to the same pin
 #endif
 
+// the transfer count is limited (and the upper bits select the mode on RP2350),
+// the reload channel restarts the capture every 2^28 bus cycles (about 4 minutes)
+#define ABUS_DMA_TRANSFER_COUNT 0x0fffffff
+
+volatile uint32_t abus_ring[ABUS_RING_SIZE] __attribute__((aligned(ABUS_RING_SIZE * sizeof(uint32_t))));
+int      abus_dma_channel = -1;
+
+static int      abus_dma_reload_channel = -1;
+static uint32_t abus_dma_transfer_count = ABUS_DMA_TRANSFER_COUNT;
+
 void a2dvi_check_hardware(void)
 {
     // initialize transceiver GPIOs
@@ -116,12 +127,26 @@ void abus_pio_setup(void)
         gpio_set_pulls(pin, false, false);
     }
 
-    // Enable SM0 RX FIFO not empty interrupt
-    pio_set_irq0_source_enabled(pio, pis_interrupt0, true);
-
-    // Set handler
-    irq_set_exclusive_handler(PIO0_IRQ_0, abus_pio_rx_irq_handler);
-    irq_set_enabled(PIO0_IRQ_0, true);
+    // DMA the bus cycles from the RX FIFO into the ring buffer, abus_loop follows the DMA write address
+    abus_dma_channel = dma_claim_unused_channel(true);
+    abus_dma_reload_channel = dma_claim_unused_channel(true);
+
+    dma_channel_config dma_cfg = dma_channel_get_default_config(abus_dma_channel);
+    channel_config_set_transfer_data_size(&dma_cfg, DMA_SIZE_32);
+    channel_config_set_read_increment(&dma_cfg, false);
+    channel_config_set_write_increment(&dma_cfg, true);
+    channel_config_set_ring(&dma_cfg, true, ABUS_RING_BITS + 2);
+    channel_config_set_dreq(&dma_cfg, pio_get_dreq(pio, sm, false));
+    channel_config_set_chain_to(&dma_cfg, abus_dma_reload_channel);
+    dma_channel_configure(abus_dma_channel, &dma_cfg, abus_ring, &pio->rxf[sm], ABUS_DMA_TRANSFER_COUNT, true);
+
+    // reload the transfer count when the capture channel has finished, the write address just continues in the ring
+    dma_channel_config reload_cfg = dma_channel_get_default_config(abus_dma_reload_channel);
+    channel_config_set_transfer_data_size(&reload_cfg, DMA_SIZE_32);
+    channel_config_set_read_increment(&reload_cfg, false);
+    channel_config_set_write_increment(&reload_cfg, false);
+    dma_channel_configure(abus_dma_reload_channel, &reload_cfg, &dma_hw->ch[abus_dma_channel].al1_transfer_count_trig,
+        &abus_dma_transfer_count, 1, false);
 
     pio_enable_sm_mask_in_sync(pio, (1 << ABUS_MAIN_SM));
 }
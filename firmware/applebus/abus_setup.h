@@ -25,6 +25,7 @@ SOFTWARE.
 #pragma once
 
 #include <hardware/pio.h>
+#include <hardware/dma.h>
 #include "util_queue_u32_inline.h"
 
 // use PIO 0 (PIO1 is used for VGA/DVI)
@@ -41,5 +42,21 @@ SOFTWARE.
 #define abus_pio_read()             (pio_sm_get(CONFIG_ABUS_PIO, ABUS_MAIN_SM))
 #define abus_pio_blocking_read()    (pio_sm_get_blocking(CONFIG_ABUS_PIO, ABUS_MAIN_SM))
 
+// the state machine stalled on a full RX FIFO, bus cycles were lost
+#define abus_pio_rx_stalled()       (CONFIG_ABUS_PIO->fdebug & (1u << (PIO_FDEBUG_RXSTALL_LSB + ABUS_MAIN_SM)))
+#define abus_pio_clear_rx_stall()   (CONFIG_ABUS_PIO->fdebug = (1u << (PIO_FDEBUG_RXSTALL_LSB + ABUS_MAIN_SM)))
+
+// ring buffer written by DMA from the RX FIFO, must be a power of 2 and aligned to its size (DMA ring wrap)
+#define ABUS_RING_BITS              12      //  4096 entries, 16384 byte, 1024 was too small
+#define ABUS_RING_SIZE              (1u << ABUS_RING_BITS)
+
+extern volatile uint32_t abus_ring[ABUS_RING_SIZE];     //  written by the DMA while abus_loop reads it
+extern int      abus_dma_channel;
+
+// index of the next ring entry to be written by DMA
+static inline uint32_t abus_ring_write_index(void)
+{
+    return ((dma_hw->ch[abus_dma_channel].write_addr - (uint32_t) abus_ring) >> 2) & (ABUS_RING_SIZE - 1);
+}
+
 void abus_pio_setup(void);
-void abus_pio_rx_irq_handler(void);
@@ -0,0 +1,394 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <string.h>
+#include <assert.h>
+#include <hardware/flash.h>
+#include "pico/time.h"
+#include "abus.h"
+#include "abus_trace.h"
+#include "buffers.h"
+#include "config/config.h"
+#include "render/render_cache.h"
+
+#ifdef FEATURE_ABUS_TRACE
+
+extern uint8_t __trace_data_start[];
+extern uint8_t __FLASH_TRACE_LEN[];
+
+#define TRACE_BLOCKS        (ABUS_TRACE_SIZE / ABUS_TRACE_BLOCK_SIZE)
+#define TRACE_RECORD_MAX    6           //  pending match (2) + longest literal (4)
+#define TRACE_BLOCK_WORDS   (((ABUS_TRACE_BLOCK_SIZE - ABUS_TRACE_BLOCK_HEADER) / 2) * ABUS_TRACE_MAX_MATCH)
+
+#define TRACE_HASH(value)   (((value) ^ ((value) >> 10) ^ ((value) >> 18)) & 0xff)
+
+volatile abus_trace_state_t abus_trace_state = AbusTraceIdle;
+
+uint32_t abus_trace_replay_cycles;
+uint32_t abus_trace_replay_ns;
+uint32_t abus_trace_replay_crc_main;
+uint32_t abus_trace_replay_crc_aux;
+
+//  The RAM ring, it also holds the decoded bus cycles of one block during a replay
+static uint32_t s_trace[ABUS_TRACE_SIZE / 4];
+static_assert(sizeof(s_trace) >= TRACE_BLOCK_WORDS * sizeof(uint32_t), "ABUS_TRACE_SIZE too small for a replay");
+
+static uint32_t s_trace_blocks;         //  blocks started since the capture was started
+static uint8_t* s_block;
+static uint32_t s_block_pos;
+static uint32_t s_block_cycle;          //  first bus cycle of the current block
+static uint32_t s_cycle;
+static uint32_t s_prev_address;
+static bool     s_prev_valid;
+static uint32_t s_match_length;
+static uint32_t s_match_distance;
+static uint32_t s_history[ABUS_TRACE_WINDOW];
+static uint32_t s_hash[256];            //  most recent bus cycle with this hash
+static uint32_t s_start_flags;
+static uint8_t  s_start_machine;
+static bool     s_replaying;
+
+static inline uint8_t* abus_trace_block(uint32_t index)
+{
+    return ((uint8_t*) s_trace) + (index % TRACE_BLOCKS) * ABUS_TRACE_BLOCK_SIZE;
+}
+
+static inline void __time_critical_func(abus_trace_flush_match)(void)
+{
+    if (s_match_length)
+    {
+        s_block[s_block_pos++] = ABUS_TRACE_MATCH | (s_match_length - 1);
+        s_block[s_block_pos++] = s_match_distance - 1;
+        s_match_length = 0;
+    }
+}
+
+static void __time_critical_func(abus_trace_new_block)(void)
+{
+    if (s_block)
+    {
+        abus_trace_flush_match();
+        memset(s_block + s_block_pos, ABUS_TRACE_END, ABUS_TRACE_BLOCK_SIZE - s_block_pos);
+        s_block = NULL;
+    }
+
+    if ((abus_trace_state == AbusTraceOneShot)&&(s_trace_blocks >= TRACE_BLOCKS))
+    {
+        abus_trace_state = AbusTraceSave;
+        return;
+    }
+
+    //  In ring mode this drops the oldest block
+    s_block = abus_trace_block(s_trace_blocks++);
+    ((uint32_t*) s_block)[0] = s_cycle;
+    ((uint32_t*) s_block)[1] = soft_switches;
+    s_block_pos   = ABUS_TRACE_BLOCK_HEADER;
+    s_block_cycle = s_cycle;
+    s_prev_valid  = false;
+}
+
+static inline void __time_critical_func(abus_trace_literal)(uint32_t value)
+{
+    uint32_t address = ADDRESS_BUS(value);
+    uint8_t* p = s_block + s_block_pos;
+    uint32_t mode;
+    uint32_t size = 1;
+
+    if (!s_prev_valid)
+        mode = ABUS_TRACE_ADDR_FULL;
+    else
+    if (address == ((s_prev_address + 1) & 0xffff))
+        mode = ABUS_TRACE_ADDR_NEXT;
+    else
+    if (address == s_prev_address)
+        mode = ABUS_TRACE_ADDR_SAME;
+    else
+    if ((address >> 8) == (s_prev_address >> 8))
+        mode = ABUS_TRACE_ADDR_PAGE;
+    else
+        mode = ABUS_TRACE_ADDR_FULL;
+
+    if (mode == ABUS_TRACE_ADDR_FULL)
+    {
+        p[size++] = address & 0xff;
+        p[size++] = address >> 8;
+    }
+    else
+    if (mode == ABUS_TRACE_ADDR_PAGE)
+    {
+        p[size++] = address & 0xff;
+    }
+    p[0] = ABUS_TRACE_LITERAL | (mode << 2) | ((value >> 8) & 0x3);
+    p[size++] = DATA_BUS(value);
+    s_block_pos += size;
+}
+
+// Record one bus cycle, before it is processed by abus_interface
+void __time_critical_func(abus_trace_record)(uint32_t value)
+{
+    if (s_block_pos > ABUS_TRACE_BLOCK_SIZE - TRACE_RECORD_MAX)
+    {
+        abus_trace_new_block();
+        if (!s_block)
+            return;
+    }
+
+    //  Extend the current match, or look for a new one in the window of the current block
+    if ((s_match_length)&&
+        ((s_match_length >= ABUS_TRACE_MAX_MATCH)||(s_history[(s_cycle - s_match_distance) & (ABUS_TRACE_WINDOW-1)] != value)))
+    {
+        abus_trace_flush_match();
+    }
+
+    uint32_t hash = TRACE_HASH(value);
+    if (s_match_length)
+    {
+        s_match_length++;
+    }
+    else
+    {
+        uint32_t candidate = s_hash[hash];
+        uint32_t distance = s_cycle - candidate;
+        if ((candidate >= s_block_cycle)&&(distance > 0)&&(distance <= ABUS_TRACE_WINDOW)&&
+            (s_history[candidate & (ABUS_TRACE_WINDOW-1)] == value))
+        {
+            s_match_length   = 1;
+            s_match_distance = distance;
+        }
+        else
+        {
+            abus_trace_literal(value);
+        }
+    }
+
+    s_hash[hash] = s_cycle;
+    s_history[s_cycle & (ABUS_TRACE_WINDOW-1)] = value;
+    s_prev_address = ADDRESS_BUS(value);
+    s_prev_valid = true;
+    s_cycle++;
+}
+
+void abus_trace_start(abus_trace_state_t mode)
+{
+    if ((s_replaying)||((mode != AbusTraceRing)&&(mode != AbusTraceOneShot)))
+        return;
+
+    abus_trace_state = AbusTraceIdle;
+
+    memset(s_hash, 0, sizeof(s_hash));
+    s_cycle         = 0;
+    s_trace_blocks  = 0;
+    s_block         = NULL;
+    s_block_pos     = ABUS_TRACE_BLOCK_SIZE;    //  start a block with the first bus cycle
+    s_match_length  = 0;
+    s_start_flags   = internal_flags;
+    s_start_machine = current_machine;
+
+    abus_trace_state = mode;
+}
+
+void abus_trace_stop(void)
+{
+    if ((abus_trace_state == AbusTraceRing)||(abus_trace_state == AbusTraceOneShot))
+        abus_trace_state = AbusTraceSave;
+}
+
+// Write the RAM ring to flash, called by abus_loop (bus cycles are lost while the flash is busy)
+void abus_trace_save(void)
+{
+    if (s_block)
+    {
+        abus_trace_flush_match();
+        memset(s_block + s_block_pos, ABUS_TRACE_END, ABUS_TRACE_BLOCK_SIZE - s_block_pos);
+        s_block = NULL;
+    }
+
+    uint32_t count = (s_trace_blocks < TRACE_BLOCKS) ? s_trace_blocks : TRACE_BLOCKS;
+    uint32_t max_count = (((uint32_t) __FLASH_TRACE_LEN) - FLASH_PAGE_SIZE) / ABUS_TRACE_BLOCK_SIZE;
+    if (count > max_count)
+        count = max_count;
+    uint32_t first = s_trace_blocks - count;
+
+    const uint32_t flash_offset = ((uint32_t) __trace_data_start) - XIP_BASE;
+    const uint32_t size = FLASH_PAGE_SIZE + count * ABUS_TRACE_BLOCK_SIZE;
+    flash_range_erase(flash_offset, (size + FLASH_SECTOR_SIZE - 1) & -FLASH_SECTOR_SIZE);
+
+    uint32_t page[FLASH_PAGE_SIZE/4];
+    abus_trace_header_t* header = (abus_trace_header_t*) page;
+    memset(page, 0xff, sizeof(page));
+    header->magic          = ABUS_TRACE_MAGIC;
+    header->version        = ABUS_TRACE_VERSION;
+    header->block_size     = ABUS_TRACE_BLOCK_SIZE;
+    header->block_count    = count;
+    header->cycle_count    = s_cycle;
+    header->internal_flags = s_start_flags;
+    header->machine        = s_start_machine;
+    flash_range_program(flash_offset, (uint8_t*) page, FLASH_PAGE_SIZE);
+
+    for (uint32_t i=0;i<count;i++)
+    {
+        flash_range_program(flash_offset + FLASH_PAGE_SIZE + i * ABUS_TRACE_BLOCK_SIZE, abus_trace_block(first + i), ABUS_TRACE_BLOCK_SIZE);
+    }
+
+    abus_trace_state = AbusTraceIdle;
+}
+
+bool abus_trace_saved(void)
+{
+    const abus_trace_header_t* header = (const abus_trace_header_t*) __trace_data_start;
+    return (header->magic == ABUS_TRACE_MAGIC)&&(header->version == ABUS_TRACE_VERSION)&&
+           (header->block_size == ABUS_TRACE_BLOCK_SIZE);
+}
+
+void abus_trace_erase(void)
+{
+    if (abus_trace_saved())
+        flash_range_erase(((uint32_t) __trace_data_start) - XIP_BASE, FLASH_SECTOR_SIZE);
+}
+
+static uint32_t abus_trace_decode_block(const uint8_t* block, uint32_t* words)
+{
+    uint32_t pos = ABUS_TRACE_BLOCK_HEADER;
+    uint32_t count = 0;
+    uint32_t address = 0;
+
+    while (pos <= ABUS_TRACE_BLOCK_SIZE - 2)
+    {
+        uint8_t tag = block[pos++];
+        if (tag == ABUS_TRACE_END)
+            break;
+
+        if (tag & ABUS_TRACE_MATCH)
+        {
+            uint32_t length   = (tag & 0x3f) + 1;
+            uint32_t distance = block[pos++] + 1;
+            if (distance > count)
+                break;
+            while (length--)
+            {
+                words[count] = words[count - distance];
+                count++;
+            }
+        }
+        else
+        {
+            switch ((tag >> 2) & 0x3)
+            {
+                case ABUS_TRACE_ADDR_FULL:
+                    address = block[pos] | (block[pos+1] << 8);
+                    pos += 2;
+                    break;
+                case ABUS_TRACE_ADDR_NEXT:
+                    address = (address + 1) & 0xffff;
+                    break;
+                case ABUS_TRACE_ADDR_PAGE:
+                    address = (address & 0xff00) | block[pos++];
+                    break;
+                default:
+                    break;
+            }
+            words[count++] = (address << 10) | ((tag & 0x3) << 8) | block[pos++];
+        }
+        address = ADDRESS_BUS(words[count-1]);
+    }
+    return count;
+}
+
+static uint32_t abus_trace_crc32(const uint8_t* data, uint32_t size)
+{
+    uint32_t crc = 0xffffffff;
+    for (uint32_t i=0;i<size;i++)
+    {
+        crc ^= data[i];
+        for (uint32_t bit=0;bit<8;bit++)
+            crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1));
+    }
+    return ~crc;
+}
+
+// Replay the saved trace from abus_loop (card command 0x43 is processed by abus_interface)
+void abus_trace_request_replay(void)
+{
+    if ((abus_trace_saved())&&(abus_trace_state == AbusTraceIdle))
+        abus_trace_state = AbusTraceReplay;
+}
+
+/* Replay the trace saved in flash through abus_interface, starting with cleared
+ * shadow memory. Card register accesses are skipped. The live machine state is
+ * restored afterwards, the shadow memory keeps the result until the Apple II
+ * overwrites it. Called by abus_loop, live bus cycles are not processed meanwhile. */
+bool abus_trace_replay(void)
+{
+    const abus_trace_header_t* header = (const abus_trace_header_t*) __trace_data_start;
+    if ((abus_trace_state != AbusTraceIdle)&&(abus_trace_state != AbusTraceReplay))
+        return false;
+    abus_trace_state = AbusTraceIdle;
+    if (!abus_trace_saved())
+        return false;
+
+    s_replaying = true;
+    uint32_t live_switches = soft_switches;
+    uint32_t live_flags    = internal_flags;
+
+    memset(apple_memory, 0, sizeof(apple_memory));
+    memset(aux_memory, 0, sizeof(aux_memory));
+    internal_flags = (live_flags & ~(IFLAGS_IIE_REGS|IFLAGS_IIGS_REGS)) | (header->internal_flags & (IFLAGS_IIE_REGS|IFLAGS_IIGS_REGS));
+
+    uint32_t cycles = 0;
+    uint64_t time_us = 0;
+    for (uint32_t i=0;i<header->block_count;i++)
+    {
+        const uint8_t* block = __trace_data_start + FLASH_PAGE_SIZE + i * ABUS_TRACE_BLOCK_SIZE;
+        if (i == 0)
+            soft_switches = ((const uint32_t*) block)[1];
+
+        uint32_t count = abus_trace_decode_block(block, s_trace);
+
+        uint32_t start = time_us_32();
+        for (uint32_t j=0;j<count;j++)
+        {
+            uint32_t value = s_trace[j];
+            if (!CARD_SELECT(value))
+            {
+                abus_interface(value);
+                cycles++;
+            }
+        }
+        time_us += time_us_32() - start;
+    }
+
+    abus_trace_replay_cycles   = cycles;
+    abus_trace_replay_ns       = (cycles) ? (uint32_t) ((time_us * 1000) / cycles) : 0;
+    abus_trace_replay_crc_main = abus_trace_crc32(&apple_memory[0x400], MAX_ADDRESS - 0x400);
+    abus_trace_replay_crc_aux  = abus_trace_crc32(&aux_memory[0x400], MAX_ADDRESS - 0x400);
+
+    soft_switches  = live_switches;
+    internal_flags = live_flags;
+    s_replaying    = false;
+    render_mark_all_dirty();
+
+    return true;
+}
+
+#endif // FEATURE_ABUS_TRACE
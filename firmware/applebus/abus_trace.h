@@ -0,0 +1,122 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*  Apple II bus trace (FEATURE_ABUS_TRACE builds only)
+
+    The raw 26 bit abus words (data, ~SELECT, R/W, address) are compressed into
+    a RAM ring of 256 byte blocks while abus_loop processes them, and written to
+    the FLASH_TRACE area when the capture stops. Read it back with
+    "picotool save -r 0x101d0000 0x101e0000 trace.bin" (RP2350: 0x103d0000 0x103e0000)
+    and decode it with tools/abus_trace.py.
+
+    The boot is traced when the FLASH_TRACE area is empty. Card commands (device_regs.c)
+    start a capture in ring mode (0x40) or one shot mode (0x41), stop and save it (0x42),
+    replay the saved trace through abus_interface to benchmark it (0x43, results on the
+    debug page of the menu) and erase it (0x44).
+
+    The replay runs in abus_loop after the card command was processed, not within it.
+    Like while saving, the bus cycles of the live machine are skipped meanwhile, the
+    shadow memory holds the replay result until the Apple II overwrites it.
+    tools/abus_trace.py replays a trace read back from flash on the host.
+
+    The FLASH_TRACE area is only reserved in FEATURE_ABUS_TRACE builds (flash_trace.ld).
+
+    Flash layout: one abus_trace_header_t page, followed by the blocks, oldest first.
+
+    Block: uint32_t number of the first bus cycle in the block, uint32_t soft
+    switches before that bus cycle, then records:
+      0x00-0x0f  literal: bit 0 ~SELECT, bit 1 R/W, bits 2-3 address mode
+                 (0: 16 bit address follows, 1: previous address + 1,
+                  2: previous high byte, low byte follows, 3: previous address),
+                 followed by the data byte
+      0x40-0x7f  match: repeat (tag & 0x3f) + 1 bus cycles, starting at the cycle
+                 (next byte + 1) cycles back
+      0xff       end of block
+    A block never references bus cycles of an earlier block, so the oldest blocks
+    of the ring can be dropped.
+*/
+
+#define ABUS_TRACE_MAGIC        0x52543241      //  "A2TR"
+#define ABUS_TRACE_VERSION      1
+#define ABUS_TRACE_BLOCK_SIZE   256             //  one flash page
+#define ABUS_TRACE_BLOCK_HEADER 8
+
+#ifndef ABUS_TRACE_SIZE
+#define ABUS_TRACE_SIZE         (32*1024)       //  RAM ring, must fit into FLASH_TRACE with the header
+#endif
+
+#define ABUS_TRACE_LITERAL      0x00
+#define ABUS_TRACE_MATCH        0x40
+#define ABUS_TRACE_END          0xff
+
+#define ABUS_TRACE_ADDR_FULL    0
+#define ABUS_TRACE_ADDR_NEXT    1
+#define ABUS_TRACE_ADDR_PAGE    2
+#define ABUS_TRACE_ADDR_SAME    3
+
+#define ABUS_TRACE_WINDOW       256             //  match distance
+#define ABUS_TRACE_MAX_MATCH    64
+
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t block_size;
+    uint32_t block_count;       //  number of blocks following the header page
+    uint32_t cycle_count;       //  bus cycles recorded (including dropped blocks)
+    uint32_t internal_flags;    //  when the capture was started
+    uint8_t  machine;
+    uint8_t  reserved[3];
+} abus_trace_header_t;
+
+typedef enum
+{
+    AbusTraceIdle    = 0,
+    AbusTraceRing    = 1,       //  keep the most recent bus cycles until stopped
+    AbusTraceOneShot = 2,       //  stop when the RAM ring is full
+    AbusTraceSave    = 3,       //  stopped, write to flash from abus_loop
+    AbusTraceReplay  = 4        //  replay the saved trace from abus_loop
+} abus_trace_state_t;
+
+extern volatile abus_trace_state_t abus_trace_state;
+
+// results of the last replay
+extern uint32_t abus_trace_replay_cycles;
+extern uint32_t abus_trace_replay_ns;           //  per bus cycle
+extern uint32_t abus_trace_replay_crc_main;     //  CRC32 of apple_memory[0x400..MAX_ADDRESS)
+extern uint32_t abus_trace_replay_crc_aux;      //  CRC32 of aux_memory[0x400..MAX_ADDRESS)
+
+void abus_trace_start  (abus_trace_state_t mode);
+void abus_trace_stop   (void);
+void abus_trace_record (uint32_t value);
+void abus_trace_save   (void);
+bool abus_trace_saved  (void);
+void abus_trace_erase  (void);
+bool abus_trace_replay (void);
+void abus_trace_request_replay(void);
@@ -24,6 +24,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#include <stddef.h>
 #include "buffers.h"
 
 volatile uint32_t reset_counter;
@@ -55,14 +56,29 @@ uint8_t __attribute__((section (".appledata."))) aux_memory[MAX_ADDRESS];
 
 uint8_t __attribute__((section (".appledata."))) status_line[4*40]; // 4 rows of 40 columns
 
+#ifdef FEATURE_SHR
+uint8_t __attribute__((section (".appledata."))) shr_memory[SHR_MEMORY_SIZE];
+
+// set when a palette was written, the render core then updates its TMDS colors
+volatile uint8_t shr_palette_dirty[16] = { [0 ... 15] = 1 };
+#endif
+
 volatile uint8_t *text_p1 = apple_memory + 0x0400;
 volatile uint8_t *text_p2 = apple_memory + 0x0800;
 volatile uint8_t *text_p3 = aux_memory   + 0x0400;
 volatile uint8_t *text_p4 = aux_memory   + 0x0800;
+#ifndef FEATURE_A2C
 volatile uint8_t *hgr_p1  = apple_memory + 0x2000;
 volatile uint8_t *hgr_p2  = apple_memory + 0x4000;
 volatile uint8_t *hgr_p3  = aux_memory   + 0x2000;
 volatile uint8_t *hgr_p4  = aux_memory   + 0x4000;
+#else
+// no hires pages in the A2C build
+volatile uint8_t *hgr_p1  = NULL;
+volatile uint8_t *hgr_p2  = NULL;
+volatile uint8_t *hgr_p3  = NULL;
+volatile uint8_t *hgr_p4  = NULL;
+#endif
 
 // The currently programmed character generator ROMs for text mode (US + local char set)
 uint8_t __attribute__((section (".appledata."))) character_rom[2* CHARACTER_ROM_SIZE];
@@ -50,7 +50,13 @@ extern          uint32_t dbg_counter2;
 
 extern volatile uint8_t  cardslot;
 
+#ifdef FEATURE_A2C
+// the A2C firmware captures the screen from SEROUT, it only needs the text pages
+// (menu and error screens), the RAM is used for frame buffers instead
+#define MAX_ADDRESS (0x0C00)
+#else
 #define MAX_ADDRESS (0x6000)
+#endif
 
 extern uint8_t apple_memory[MAX_ADDRESS];
 extern uint8_t aux_memory[MAX_ADDRESS];
@@ -68,6 +74,16 @@ extern volatile uint8_t *hgr_p2;
 extern volatile uint8_t *hgr_p3;
 extern volatile uint8_t *hgr_p4;
 
+#ifdef FEATURE_SHR
+// IIgs super hires memory ($E1/2000-$9FFF): pixels, scan line control bytes and palettes
+#define SHR_MEMORY_SIZE       0x8000
+#define SHR_SCBS              0x7D00
+#define SHR_PALETTES          0x7E00
+
+extern uint8_t shr_memory[SHR_MEMORY_SIZE];
+extern volatile uint8_t shr_palette_dirty[16];
+#endif
+
 /* Videx VideoTerm */
 extern volatile uint8_t *videx_page;
 
@@ -105,8 +121,8 @@ extern volatile uint32_t internal_flags;
 #define SOFTSW_ALTCHAR        0x00004000ul
 #define SOFTSW_DGR            0x00008000ul
 #define SOFTSW_MONOCHROME     0x00010000ul
-//#define SOFTSW_LINEARIZE    0x00020000ul
-//#define SOFTSW_SHR          0x00040000ul
+#define SOFTSW_LINEARIZE      0x00020000ul
+#define SOFTSW_SHR            0x00040000ul
 #define SOFTSW_IOUDIS         0x00080000ul
 // Video7-specific soft switches
 #define SOFTSW_V7_MODE0       0x00000000ul
@@ -130,7 +146,7 @@ extern volatile uint32_t internal_flags;
 #define IFLAGS_DEBUG_LINES    0x00100000ul
 //                            0x00200000ul
 #define IFLAGS_FORCED_MONO    0x00400000ul
-//                            0x00800000ul
+#define IFLAGS_NTSC_DHGR      0x00800000ul
 #define IFLAGS_INTERP_DGR     0x01000000ul
 #define IFLAGS_INTERP_DHGR    0x02000000ul
 #define IFLAGS_VIDEO7         0x04000000ul
@@ -26,7 +26,6 @@ SOFTWARE.
 
 #include <pico.h>
 #include <string.h>
-#include <malloc.h>
 #include <hardware/flash.h>
 
 #include "config.h"
@@ -56,15 +55,28 @@ DviVideoMode_t     cfg_video_mode;
 ToggleSwitchMode_t input_switch_mode = ModeSwitchCycleVideo;
 bool               cfg_audio_enabled = false;
 bool               cfg_laser_enabled = false;
+int8_t             cfg_ntsc_hue        = 0;     //  A2C color LUT adjustments, see a2c/a2c_lut.h
+int8_t             cfg_ntsc_saturation = 0;
+int8_t             cfg_ntsc_brightness = 0;
+int8_t             cfg_ntsc_sharpness  = 0;
+HdmiContent_t      cfg_hdmi_content      = HdmiContentGame;
+uint8_t            cfg_hdmi_quantization = 2;  //  full range
+uint8_t            cfg_hdmi_vic          = 0;  //  automatic
 #define            CFG_AUDIO_ENABLE_BIT 0x01
 #define            CFG_LASER_ENABLE_BIT 0x01
 
 // A block of flash is reserved for storing configuration persistently across power cycles
 // and firmware updates.
 //
-// The memory is divided as:
-//  * 4K for a 'config' structure
-//  * the remaining is reserved for future use
+// The memory is used as a journal of small config records, to avoid erasing a flash
+// sector (and stalling both cores) on every save:
+//  * the area is divided into slots of CFG_SLOT_SIZE bytes
+//  * each save appends a record (a 'config' structure, with a trailer holding a sequence
+//    number and a checksum at the end of the slot) to the next blank slot
+//  * the record with the highest sequence number and a valid checksum is the current config
+//  * a sector is only erased when the journal wraps into it, so all sectors wear evenly
+//  * a config written by older firmware (slot 0, no trailer) is used when there is no
+//    journal record yet
 
 // DVI2
 #define CFG_MAGIC_WORD_VALUE 0x32495644
@@ -102,6 +114,13 @@ struct __attribute__((__packed__)) config_t
     // to determine if the field you're looking for is actually present in the stored config.
     uint8_t  audio_config;
     uint8_t  laser_config;
+    int8_t   ntsc_hue;
+    int8_t   ntsc_saturation;
+    int8_t   ntsc_brightness;
+    int8_t   ntsc_sharpness;
+    uint8_t  hdmi_content;
+    uint8_t  hdmi_quantization;
+    uint8_t  hdmi_vic;
 };
 
 // 'FONT'
@@ -118,10 +137,32 @@ typedef char config_struct_size_check[(sizeof(struct config_t) <= FLASH_SECTOR_S
 
 #define IS_STORED_IN_CONFIG(cfg, field) ((offsetof(struct config_t, field) + sizeof((cfg)->field)) <= (cfg)->size)
 
+// journal record trailer, stored at the end of each slot
+struct __attribute__((__packed__)) config_trailer_t
+{
+    uint32_t sequence;      // 0xffffffff: no journal record (blank or old style config)
+    uint32_t checksum;      // crc32 of the record data and the sequence number
+};
+
+#define CFG_SLOT_SIZE         64
+#define CFG_SLOT_DATA_SIZE    (CFG_SLOT_SIZE - sizeof(struct config_trailer_t))
+#define CFG_SLOTS_PER_SECTOR  (FLASH_SECTOR_SIZE / CFG_SLOT_SIZE)
+#define CFG_SLOTS             ((int32_t)(((uint32_t)__FLASH_CONFIG_LEN) / CFG_SLOT_SIZE))
+#define CFG_SLOT(slot)        (&__config_data_start[(slot)*CFG_SLOT_SIZE])
+#define CFG_TRAILER(slot)     ((struct config_trailer_t *)(CFG_SLOT(slot) + CFG_SLOT_DATA_SIZE))
+#define CFG_NO_SEQUENCE       0xffffffff
+
+// make sure the config struct fits into a journal slot
+typedef char config_slot_size_check[(sizeof(struct config_t) <= CFG_SLOT_DATA_SIZE) - 1];
 
 extern uint8_t __config_data_start[];
+extern uint8_t __FLASH_CONFIG_LEN[];
 static struct config_t *cfg = (struct config_t *)__config_data_start;
 
+// journal slot holding the current config (-1: none) and its sequence number
+static int32_t  cfg_slot = -1;
+static uint32_t cfg_sequence;
+
 extern uint8_t __font_dir_start[];
 static struct fontdir_t *font_directory = (struct fontdir_t *)__font_dir_start;
 
@@ -243,6 +284,126 @@ bool DELAYED_COPY_CODE(config_flash_write)(void* flash_address, uint8_t* data, u
     return true;
 }
 
+static uint32_t DELAYED_COPY_CODE(config_checksum)(const uint8_t* data, uint32_t size, uint32_t sequence)
+{
+    uint32_t crc = 0xffffffff;
+    for (uint32_t i=0;i<size+sizeof(sequence);i++)
+    {
+        crc ^= (i<size) ? data[i] : (uint8_t) (sequence >> ((i-size)*8));
+        for (uint32_t bit=0;bit<8;bit++)
+            crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1));
+    }
+    return ~crc;
+}
+
+static bool DELAYED_COPY_CODE(config_slot_blank)(int32_t slot, uint32_t count)
+{
+    const uint32_t* p = (const uint32_t*) CFG_SLOT(slot);
+    for (uint32_t i=0;i<count*CFG_SLOT_SIZE/4;i++)
+    {
+        if (p[i] != 0xffffffff)
+            return false;
+    }
+    return true;
+}
+
+/* Find the journal record with the highest sequence number and a valid checksum.
+ * Only the trailers are scanned, the checksum is just verified for the winner.
+ * A save interrupted by a power loss leaves a broken record, and its sequence number
+ * is used again by the next save. So candidates are ordered by sequence and slot. */
+static void DELAYED_COPY_CODE(config_journal_scan)(void)
+{
+    uint32_t limit      = CFG_NO_SEQUENCE;
+    int32_t  limit_slot = 0;
+
+    cfg_slot = -1;
+    cfg_sequence = 0;
+    while (cfg_slot < 0)
+    {
+        int32_t  best_slot = -1;
+        uint32_t best_sequence = 0;
+        for (int32_t slot=0;slot<CFG_SLOTS;slot++)
+        {
+            uint32_t sequence = CFG_TRAILER(slot)->sequence;
+            if (((sequence < limit)||((sequence == limit)&&(slot < limit_slot)))&&
+                ((best_slot < 0)||(sequence >= best_sequence)))
+            {
+                best_slot     = slot;
+                best_sequence = sequence;
+            }
+        }
+
+        if (best_slot < 0)
+            break;
+
+        // broken record: try the next older one
+        const struct config_t* record = (const struct config_t*) CFG_SLOT(best_slot);
+        if ((record->magic_word == CFG_MAGIC_WORD_VALUE)&&
+            (record->size <= CFG_SLOT_DATA_SIZE)&&
+            (CFG_TRAILER(best_slot)->checksum == config_checksum(CFG_SLOT(best_slot), record->size, best_sequence)))
+        {
+            cfg_slot     = best_slot;
+            cfg_sequence = best_sequence;
+        }
+        limit      = best_sequence;
+        limit_slot = best_slot;
+    }
+
+    if (cfg_slot < 0)
+    {
+        // no journal record: fall back to a config written by older firmware (if any)
+        cfg = (struct config_t *)__config_data_start;
+        if (cfg->magic_word == CFG_MAGIC_WORD_VALUE)
+            cfg_slot = 0;
+    }
+    else
+    {
+        cfg = (struct config_t *)CFG_SLOT(cfg_slot);
+    }
+}
+
+/* Append a record to the config journal. */
+static bool DELAYED_COPY_CODE(config_journal_append)(const uint8_t* data, uint32_t size)
+{
+    if (size > CFG_SLOT_DATA_SIZE)
+        return false;
+
+    // the slot following the current record, unless that's the end of its sector
+    int32_t slot = cfg_slot+1;
+    if (cfg_slot >= 0)
+    {
+        while ((slot % CFG_SLOTS_PER_SECTOR != 0)&&(!config_slot_blank(slot, 1)))
+            slot++;
+    }
+    if (slot >= CFG_SLOTS)
+        slot = 0;
+
+    // moving on to the next sector: it only holds older records - or nothing at all
+    if ((slot % CFG_SLOTS_PER_SECTOR == 0)&&(!config_slot_blank(slot, CFG_SLOTS_PER_SECTOR)))
+    {
+        flash_range_erase(((uint32_t) CFG_SLOT(slot)) - XIP_BASE, FLASH_SECTOR_SIZE);
+    }
+
+    // program the page containing the slot: bits of the other slots are left untouched (0xff)
+    uint32_t page[FLASH_PAGE_SIZE/4];
+    uint8_t* record = ((uint8_t*) page) + ((slot*CFG_SLOT_SIZE) % FLASH_PAGE_SIZE);
+    struct config_trailer_t* trailer = (struct config_trailer_t*) (record + CFG_SLOT_DATA_SIZE);
+
+    memset(page, 0xff, sizeof(page));
+    memcpy(record, data, size);
+    trailer->sequence = cfg_sequence+1;
+    trailer->checksum = config_checksum(record, size, trailer->sequence);
+
+    const uint32_t flash_offset = (((uint32_t) CFG_SLOT(slot)) - XIP_BASE) & -FLASH_PAGE_SIZE;
+    flash_range_program(flash_offset, (uint8_t*) page, FLASH_PAGE_SIZE);
+
+    cfg_slot     = slot;
+    cfg_sequence = trailer->sequence;
+    cfg          = (struct config_t *)CFG_SLOT(slot);
+
+    return true;
+}
+
 void DELAYED_COPY_CODE(config_font_update)(void)
 {
     // We could use the "directory" to store the name of each custom font.
@@ -313,8 +474,9 @@ void DELAYED_COPY_CODE(config_load_charsets)(void)
 
 void config_setflags(void)
 {
-    SET_IFLAG(((cfg_rendering_fx==FX_ENABLED)||(cfg_rendering_fx == FX_DGR_ONLY)), IFLAGS_INTERP_DGR);
+    SET_IFLAG(((cfg_rendering_fx==FX_ENABLED)||(cfg_rendering_fx == FX_DGR_ONLY)||(cfg_rendering_fx == FX_DHGR_NTSC)), IFLAGS_INTERP_DGR);
     SET_IFLAG(((cfg_rendering_fx==FX_ENABLED)||(cfg_rendering_fx == FX_DHGR_ONLY)),IFLAGS_INTERP_DHGR);
+    SET_IFLAG((cfg_rendering_fx == FX_DHGR_NTSC), IFLAGS_NTSC_DHGR);
 
     videx_enabled = (cfg_videx_selection > 0);
 }
@@ -326,7 +488,9 @@ void config_load(void)
         invalid_fonts = font_directory->invalid_fonts;
     }
 
-    if((cfg->magic_word != CFG_MAGIC_WORD_VALUE) || (cfg->size > FLASH_SECTOR_SIZE))
+    config_journal_scan();
+
+    if((cfg->magic_word != CFG_MAGIC_WORD_VALUE) || (cfg->size > CFG_SLOT_DATA_SIZE))
     {
         config_load_defaults();
         return;
@@ -406,6 +570,36 @@ void config_load(void)
         cfg_laser_enabled = ((cfg->laser_config & CFG_LASER_ENABLE_BIT) != 0);
     else
         cfg_laser_enabled = false;                        //  By default, audio is off, user can enable
+
+    //  color LUT adjustments, the build time LUTs when not stored
+    if(IS_STORED_IN_CONFIG(cfg, ntsc_sharpness))
+    {
+        cfg_ntsc_hue        = cfg->ntsc_hue;
+        cfg_ntsc_saturation = cfg->ntsc_saturation;
+        cfg_ntsc_brightness = cfg->ntsc_brightness;
+        cfg_ntsc_sharpness  = cfg->ntsc_sharpness;
+    }
+    else
+    {
+        cfg_ntsc_hue        = 0;
+        cfg_ntsc_saturation = 0;
+        cfg_ntsc_brightness = 0;
+        cfg_ntsc_sharpness  = 0;
+    }
+
+    //  HDMI AVI InfoFrame, game mode when not stored
+    if(IS_STORED_IN_CONFIG(cfg, hdmi_vic))
+    {
+        cfg_hdmi_content      = (cfg->hdmi_content <= HdmiContentMax) ? cfg->hdmi_content : HdmiContentGame;
+        cfg_hdmi_quantization = cfg->hdmi_quantization & 3;
+        cfg_hdmi_vic          = cfg->hdmi_vic;
+    }
+    else
+    {
+        cfg_hdmi_content      = HdmiContentGame;
+        cfg_hdmi_quantization = 2;
+        cfg_hdmi_vic          = 0;
+    }
 }
 
 void config_load_defaults(void)
@@ -438,6 +632,15 @@ void config_load_defaults(void)
     cfg_audio_enabled       = false;                        //  By default, audio is off, user can enable
     cfg_laser_enabled       = false;                        //  By default, laser is off, user can enable
 
+    cfg_ntsc_hue            = 0;
+    cfg_ntsc_saturation     = 0;
+    cfg_ntsc_brightness     = 0;
+    cfg_ntsc_sharpness      = 0;
+
+    cfg_hdmi_content        = HdmiContentGame;              //  TVs bypass their picture processing in game mode
+    cfg_hdmi_quantization   = 2;                            //  full range RGB
+    cfg_hdmi_vic            = 0;                            //  the VIC of the video mode
+
     config_setflags();
     set_machine(detected_machine);
 
@@ -447,10 +650,8 @@ void config_load_defaults(void)
 
 void DELAYED_COPY_CODE(config_save)(void)
 {
-    // the write buffer size must be a multiple of FLASH_PAGE_SIZE so round up
-    const int new_config_size = (sizeof(struct config_t) + FLASH_PAGE_SIZE - 1) & -FLASH_PAGE_SIZE;
-    struct config_t *new_config = malloc(new_config_size);
-    memset(new_config, 0xff, new_config_size);
+    struct config_t config;
+    struct config_t *new_config = &config;
     memset(new_config, 0, sizeof(struct config_t));
 
     // prepare header
@@ -477,9 +678,14 @@ void DELAYED_COPY_CODE(config_save)(void)
 
     new_config->audio_config            = (cfg_audio_enabled == true) ? CFG_AUDIO_ENABLE_BIT : 0;
     new_config->laser_config            = (cfg_laser_enabled == true) ? CFG_LASER_ENABLE_BIT : 0;
-
-    // update flash
-    config_flash_write(cfg, (uint8_t *)new_config, new_config_size);
-
-    free(new_config);
+    new_config->ntsc_hue                = cfg_ntsc_hue;
+    new_config->ntsc_saturation         = cfg_ntsc_saturation;
+    new_config->ntsc_brightness         = cfg_ntsc_brightness;
+    new_config->ntsc_sharpness          = cfg_ntsc_sharpness;
+    new_config->hdmi_content            = cfg_hdmi_content;
+    new_config->hdmi_quantization       = cfg_hdmi_quantization;
+    new_config->hdmi_vic                = cfg_hdmi_vic;
+
+    // append to the flash journal
+    config_journal_append((uint8_t *)new_config, sizeof(struct config_t));
 }
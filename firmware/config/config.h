@@ -48,7 +48,8 @@ typedef enum {
     FX_NONE       = 0,
     FX_ENABLED    = 1,
     FX_DHGR_ONLY  = 2,
-    FX_DGR_ONLY   = 3
+    FX_DGR_ONLY   = 3,
+    FX_DHGR_NTSC  = 4
 } rendering_fx_t;
 
 typedef enum
@@ -73,6 +74,21 @@ extern    rendering_fx_t cfg_rendering_fx;
 extern    DviVideoMode_t cfg_video_mode;
 extern    ScanlineMode_t cfg_scanline_mode;
 
+// Content type of the HDMI AVI InfoFrame, TVs switch to their low latency (game) mode for HdmiContentGame
+typedef enum
+{
+    HdmiContentNone     = 0,    // no content type (no InfoFrame at all on builds without audio: plain DVI)
+    HdmiContentGraphics = 1,
+    HdmiContentPhoto    = 2,
+    HdmiContentCinema   = 3,
+    HdmiContentGame     = 4,
+    HdmiContentMax      = HdmiContentGame
+} HdmiContent_t;
+
+extern    HdmiContent_t  cfg_hdmi_content;
+extern    uint8_t        cfg_hdmi_quantization;  // RGB quantization range: 0 default, 1 limited, 2 full
+extern    uint8_t        cfg_hdmi_vic;           // video identification code, 0: the one of the video mode
+
 typedef enum
 {
     ModeSwitchDisabled   = 0,
@@ -125,8 +141,25 @@ extern volatile uint8_t color_mode;
     #define DELAYED_COPY_DATA(n) __attribute__((section(".time_critical." "A2C")))(n)
 #endif
 
+// Render LUTs, placed in the SRAM banks of the layout selected with SRAM_LAYOUT (see scripts/sram_*.ld).
+// RENDER_LUT_SMALL must stay small (shares SCRATCH_Y with the stack in the "scratch" layout),
+// RENDER_LUT_BSS is filled at run-time and not zeroed.
+#define RENDER_LUT_SMALL(n) __attribute__((section(".render_lut_small."))) n
+#define RENDER_LUT(n)       __attribute__((section(".render_lut."))) n
+#define RENDER_LUT_BSS(n)   __attribute__((section(".render_lut_bss."))) n
+extern void* __render_lut_small_source__[];
+extern void* __render_lut_small_start__[];
+extern void* __render_lut_small_end__[];
+extern void* __render_lut_source__[];
+extern void* __render_lut_start__[];
+extern void* __render_lut_end__[];
+
 extern          bool cfg_audio_enabled;
 extern          bool cfg_laser_enabled;
+extern          int8_t cfg_ntsc_hue;
+extern          int8_t cfg_ntsc_saturation;
+extern          int8_t cfg_ntsc_brightness;
+extern          int8_t cfg_ntsc_sharpness;
 
 extern void set_machine         (compat_t machine);
 extern void config_load         (void);
@@ -31,6 +31,7 @@ SOFTWARE.
 
 #include "util/dmacopy.h"
 #include "applebus/buffers.h"
+#include "applebus/abus_trace.h"
 #include "fonts/textfont.h"
 #include "menu/menu.h"
 #ifdef APPLE_MODEL_IIPLUS
@@ -218,6 +219,22 @@ void device_write(uint_fast8_t reg, uint_fast8_t data)
         }
         break;
 
+    // HDMI AVI InfoFrame: bits 0-2 content type (HdmiContent_t), bits 4-5 RGB quantization range
+    case 0xa:
+        if (((data & 7) <= HdmiContentMax) && ((data & 0x30) != 0x30))
+        {
+            cfg_hdmi_content      = data & 7;
+            cfg_hdmi_quantization = (data >> 4) & 3;
+            cfg_video_mode |= 0x10;     // the DVI output is restarted by the render loop
+        }
+        break;
+
+    // HDMI AVI InfoFrame: video identification code, 0 selects the one of the video mode
+    case 0xb:
+        cfg_hdmi_vic = data;
+        cfg_video_mode |= 0x10;
+        break;
+
     default:
         break;
     }
@@ -251,6 +268,28 @@ void device_command(uint_fast8_t cmd)
             cfg_local_charset = cmd - 0x10;
             reload_charsets  |= 1;
             break;
+#ifdef FEATURE_ABUS_TRACE
+        case 0x40:
+            // start a bus trace, keeping the most recent bus cycles
+            abus_trace_start(AbusTraceRing);
+            break;
+        case 0x41:
+            // start a bus trace, until the RAM buffer is full
+            abus_trace_start(AbusTraceOneShot);
+            break;
+        case 0x42:
+            // stop the bus trace and save it to flash
+            abus_trace_stop();
+            break;
+        case 0x43:
+            // replay the saved bus trace (benchmark), from abus_loop
+            abus_trace_request_replay();
+            break;
+        case 0x44:
+            // erase the saved bus trace, the next boot will be traced
+            abus_trace_erase();
+            break;
+#endif
         default:
             break;
     }
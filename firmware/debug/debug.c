@@ -24,12 +24,14 @@ SOFTWARE.
 
 #include <malloc.h>
 #include <stdarg.h>
+#include <string.h>
 
 #include "pico/multicore.h"
 #include "pico/bootrom.h"
 #include "hardware/clocks.h"
 #include "hardware/irq.h"
 #include "hardware/sync.h"
+#include "hardware/timer.h"
 #include "hardware/gpio.h"
 #include "hardware/structs/ioqspi.h"
 #include "hardware/structs/sio.h"
@@ -105,6 +107,89 @@ static void debug_flashmode()
 }
 #endif
 
+// separate lists per core, so both cores can record milestones without locking
+static boot_milestone_t boot_timeline[2][BOOT_TIMELINE_ENTRIES];
+static volatile uint8_t boot_timeline_count[2];
+
+void boot_milestone(const char* name)
+{
+    uint core = get_core_num();
+    uint8_t count = boot_timeline_count[core];
+    if (count < BOOT_TIMELINE_ENTRIES)
+    {
+        boot_timeline[core][count].name    = name;
+        boot_timeline[core][count].time_us = time_us_32();
+        boot_timeline_count[core] = count+1;
+    }
+}
+
+uint32_t boot_milestone_count(void)
+{
+    return boot_timeline_count[0] + boot_timeline_count[1];
+}
+
+// get the milestones of both cores, in the order they were recorded
+bool boot_milestone_get(uint32_t index, boot_milestone_t* milestone)
+{
+    uint32_t pos[2] = {0, 0};
+    uint32_t count[2] = {boot_timeline_count[0], boot_timeline_count[1]};
+
+    for (uint32_t i=0;i<=index;i++)
+    {
+        uint core;
+        if (pos[0] < count[0])
+            core = ((pos[1] < count[1])&&(boot_timeline[1][pos[1]].time_us < boot_timeline[0][pos[0]].time_us)) ? 1 : 0;
+        else
+        if (pos[1] < count[1])
+            core = 1;
+        else
+            return false;
+
+        *milestone = boot_timeline[core][pos[core]++];
+    }
+    return true;
+}
+
+static ram_budget_t ram_budget[RAM_BUDGET_ENTRIES];
+static uint8_t      ram_budget_entries;
+
+void ram_budget_add(const char* name, uint32_t bytes)
+{
+    if (ram_budget_entries < RAM_BUDGET_ENTRIES)
+    {
+        ram_budget[ram_budget_entries].name  = name;
+        ram_budget[ram_budget_entries].bytes = bytes;
+        ram_budget_entries++;
+    }
+}
+
+// entries depending on the video mode are updated when it changes
+void ram_budget_set(const char* name, uint32_t bytes)
+{
+    for (uint32_t i=0;i<ram_budget_entries;i++)
+    {
+        if (strcmp(ram_budget[i].name, name) == 0)
+        {
+            ram_budget[i].bytes = bytes;
+            return;
+        }
+    }
+    ram_budget_add(name, bytes);
+}
+
+uint32_t ram_budget_count(void)
+{
+    return ram_budget_entries;
+}
+
+bool ram_budget_get(uint32_t index, ram_budget_t* entry)
+{
+    if (index >= ram_budget_entries)
+        return false;
+    *entry = ram_budget[index];
+    return true;
+}
+
 void debug_init()
 {
     // LED
@@ -42,3 +42,31 @@ void     debug_sos          (void);
 
 uint32_t getTotalHeap       (void);
 uint32_t getFreeHeap        (void);
+
+// boot timeline: named milestones with their time since boot, recorded per core
+#define BOOT_TIMELINE_ENTRIES 8
+
+typedef struct
+{
+    const char* name;
+    uint32_t    time_us;
+} boot_milestone_t;
+
+void     boot_milestone     (const char* name);
+uint32_t boot_milestone_count(void);
+bool     boot_milestone_get (uint32_t index, boot_milestone_t* milestone);
+
+// RAM budget: the large RAM consumers, recorded at startup (core 0 only), the ones
+// depending on the video mode again when it changes
+#define RAM_BUDGET_ENTRIES 12
+
+typedef struct
+{
+    const char* name;
+    uint32_t    bytes;
+} ram_budget_t;
+
+void     ram_budget_add     (const char* name, uint32_t bytes);
+void     ram_budget_set     (const char* name, uint32_t bytes);
+uint32_t ram_budget_count   (void);
+bool     ram_budget_get     (uint32_t index, ram_budget_t* entry);
@@ -23,14 +23,18 @@ SOFTWARE.
 */
 
 #include "hardware/clocks.h"
+#include "hardware/vreg.h"
 
 #include "a2dvi.h"
 #include "dvi.h"
 #include "tmds.h"
+#include "tmds_mono.h"
 #include "dvi_pin_config.h"
 #include "dvi_serialiser.h"
 #include "dvi_timing.h"
 #include "render/render.h"
+#include "render/render_cache.h"
+#include "applebus/buffers.h"
 #include "util/dmacopy.h"
 #include "config/config.h"
 #include "debug/debug.h"
@@ -43,19 +47,65 @@ SOFTWARE.
 // struct dvi_inst __attribute__((section (".appledata."))) dvi0;
 struct dvi_inst dvi0;           //  Need to move this to normal RAM or there is an init race condition 
 
+#define VREG_VSEL         VREG_VOLTAGE_1_20
+
+static absolute_time_t vreg_settled;
+
+void a2dvi_vreg_init(void)
+{
+    vreg_set_voltage(VREG_VSEL);
+
+    // the raised core VCC needs a bit to settle, other init code runs meanwhile
+    vreg_settled = make_timeout_time_ms(2);
+    boot_milestone("VREG");
+}
+
+static struct dvi_timing* DELAYED_COPY_CODE(a2dvi_timing)(uint32_t video_mode)
+{
+    return (video_mode == Dvi720x480) ? &dvi_timing_720x480p_60hz : &dvi_timing_640x480p_60hz;
+}
+
+// RAM of the TMDS buffers for the resolution of the timing
+static uint32_t DELAYED_COPY_CODE(a2dvi_tmds_bytes)(const struct dvi_timing* timing)
+{
+    return DVI_N_TMDS_BUFFERS * 3 * timing->h_active_pixels / DVI_SYMBOLS_PER_WORD * sizeof(uint32_t);
+}
+
 static void a2dvi_init(void)
 {
-    // wait a bit, until the raised core VCC has settled
-    sleep_ms(2);
-    // shift into higher gears...
-    set_sys_clock_khz(dvi_timing_640x480p_60hz.bit_clk_khz, true);
+    // wait until the raised core VCC has settled
+    sleep_until(vreg_settled);
+    // shift into higher gears - directly to the clock of the configured video mode,
+    // so enabling the DVI output doesn't need to switch the PLL again
+    set_sys_clock_khz(a2dvi_timing(cfg_video_mode)->bit_clk_khz, true);
+}
+
+// time the DVI output was off for the last resolution change (microseconds)
+uint32_t a2dvi_switch_time;
+
+#ifdef FEATURE_A2_AUDIO
+// set while the other core is queuing audio samples
+static volatile bool audio_busy;
+#endif
+
+#if DVI_DATA_ISLAND
+// HDMI AVI InfoFrame configuration, a change restarts the DVI output
+static uint32_t DELAYED_COPY_CODE(a2dvi_infoframe_config)(void)
+{
+    return cfg_hdmi_content | (cfg_hdmi_quantization << 4) | (cfg_hdmi_vic << 8);
 }
+#endif
 
+// Must be called by the render core, between two frames. The other core may keep running.
 void DELAYED_COPY_CODE(a2dvi_dvi_enable)(uint32_t video_mode)
 {
     static uint32_t current_video_mode = DviInvalid;
+#if DVI_DATA_ISLAND
+    static uint32_t current_infoframe;
+#endif
     static uint     spinlock1;
     static uint     spinlock2;
+    uint32_t        switch_start = 0;
 
     if (current_video_mode == DviInvalid)
     {
@@ -64,24 +114,70 @@ void DELAYED_COPY_CODE(a2dvi_dvi_enable)(uint32_t video_mode)
     }
     else
     {
-        if (current_video_mode == video_mode)
+        if ((current_video_mode == video_mode)
+#if DVI_DATA_ISLAND
+            && (current_infoframe == a2dvi_infoframe_config())
+#endif
+           )
             return;
+
+        switch_start = time_us_32();
+
+        // stop the other core from queuing audio samples, and wait until it's out of the audio queue
+        dvi0.dvi_started = false;
+#ifdef FEATURE_A2_AUDIO
+        __dmb();
+        while (audio_busy)
+        {
+            tight_loop_contents();
+        }
+#endif
+#ifdef FEATURE_A2C
+        // release the state machine and the DMA channels, dvi_destroy clears the PIO program memory
+        tmds_mono_deinit();
+#endif
         dvi_destroy(&dvi0, DMA_IRQ_0);
+#ifndef FEATURE_A2C
+        render_cache_free();
+#endif
     }
 
     // remember current mode
     current_video_mode = video_mode;
+#if DVI_DATA_ISLAND
+    current_infoframe  = a2dvi_infoframe_config();
+#endif
 
     // select timing
-    struct dvi_timing* p_dvi_timing = (video_mode == Dvi720x480) ? &dvi_timing_720x480p_60hz : &dvi_timing_640x480p_60hz;
+    struct dvi_timing* p_dvi_timing = a2dvi_timing(video_mode);
 
     // configure DVI
-    set_sys_clock_khz(p_dvi_timing->bit_clk_khz, true);
+    if (clock_get_hz(clk_sys) != p_dvi_timing->bit_clk_khz*1000)
+        set_sys_clock_khz(p_dvi_timing->bit_clk_khz, true);
     DVI_INIT_RESOLUTION(p_dvi_timing->h_active_pixels);
     dvi0.timing = p_dvi_timing;
     dvi0.ser_cfg = &DVI_SERIAL_CONFIG;
     dvi_init(&dvi0, spinlock1, spinlock2);
 
+#ifdef FEATURE_A2C
+    // B&W lines are encoded on the spare state machine of the DVI PIO (when there are enough DMA channels left)
+    tmds_mono_init();
+#endif
+
+#ifndef FEATURE_A2C
+    // the line cache takes the heap left after the TMDS buffers of this resolution
+    render_cache_init();
+#endif
+
+    // the TMDS buffers and the heap left depend on the resolution
+    ram_budget_set("TMDS", a2dvi_tmds_bytes(p_dvi_timing));
+    ram_budget_set("FREE", getFreeHeap());
+
+#ifdef FEATURE_A2C
+    // collect capture-to-display latency statistics
+    dvi0.scanline_callback = a2c_latency_scanline_loaded;
+#endif
+
     // Audio Init
 #ifdef FEATURE_A2_AUDIO
     switch (video_mode)
@@ -99,31 +195,70 @@ void DELAYED_COPY_CODE(a2dvi_dvi_enable)(uint32_t video_mode)
             break;
     }
 
+#endif
+
+#if DVI_DATA_ISLAND
+    // AVI InfoFrame, sent with or without audio: the content type lets TVs select their game mode
+    set_AVI_info_frame(&dvi0.avi_info_frame, UNDERSCAN, RGB, ITU601, PIC_ASPECT_RATIO_4_3, SAME_AS_PAR,
+                       (RGB_quantization_range) cfg_hdmi_quantization,
+                       (cfg_hdmi_content == HdmiContentNone) ? IT_CONTENT_NO_DATA : (it_content_type) (cfg_hdmi_content - 1),
+                       (cfg_hdmi_vic != 0) ? (video_code) cfg_hdmi_vic : ((video_mode == Dvi720x480) ? _720x480P60 : _640x480P60));
+
+#ifdef FEATURE_A2_AUDIO
     dvi_enable_data_island(&dvi0);
 
     a2dvi_audio_enable(cfg_audio_enabled);
+#else
+    // plain DVI without a content type
+    if (cfg_hdmi_content != HdmiContentNone)
+        dvi_enable_data_island(&dvi0);
+#endif
 #endif
 
     dvi_register_irqs_this_core(&dvi0, DMA_IRQ_0);
     dvi_start(&dvi0);
+
+    if (switch_start)
+        a2dvi_switch_time = time_us_32() - switch_start;
+    else
+        boot_milestone("DVI");
 }
 
 void DELAYED_COPY_CODE(a2dvi_loop)(void)
 {
+    // load TMDS color palette from flash (with DMA), while the raised core VCC settles
+    tmds_color_load();
+
+    // load character sets etc
+    render_init();
+    boot_milestone("FONT");
+
     // CPU clock configuration required for DVI
     a2dvi_init();
+    boot_milestone("CLK");
 
-    // load TMDS color palette from flash (with DMA)
-    tmds_color_load();
+    // RAM used by the main buffers of this build, shown on the debug monitor
+    ram_budget_add("A2M",  sizeof(apple_memory) + sizeof(aux_memory));
+    ram_budget_add("TMDS", a2dvi_tmds_bytes(a2dvi_timing(cfg_video_mode)));
+#ifdef FEATURE_A2_AUDIO
+    ram_budget_add("AUD",  NUMBER_OF_AUDIO_PACKETS * 2 * sizeof(data_island_stream_t));
+#endif
+#ifdef FEATURE_A2C
+    a2c_ram_budget();
+#endif
+    ram_budget_add("HEAP", getTotalHeap());
+    // "FREE" is added by a2dvi_dvi_enable, after the TMDS buffers and the line cache were allocated
+
+#ifdef FEATURE_A2C
+    // start loading the hires color LUT of the active color style, finished while the splash screen is shown
+    a2c_lut_update();
+#endif
 
     // free DMA channel and stop others from using it (would interfere with the DVI processing)
     dmacopy_disable_dma();
     // when testing: release flash, so we can access the BOOTSEL button
     debug_flash_release();
 
-    // load character sets etc
-    render_init();
-
     // start DVI output
     render_loop();
 
@@ -158,7 +293,16 @@ bool DELAYED_COPY_CODE(a2dvi_audio_enabled)(void)
 
 bool DELAYED_COPY_CODE(a2dvi_queue_audio_samples)(const int16_t* samples, int count)
 {
-    return dvi_queue_audio_samples(&dvi0, samples, count);
+    bool result = false;
+
+    // the DVI output may be reinitialized by the other core (resolution change)
+    audio_busy = true;
+    __dmb();
+    if (dvi_is_started(&dvi0))
+        result = dvi_queue_audio_samples(&dvi0, samples, count);
+    audio_busy = false;
+
+    return result;
 }
 
 #endif  // FEATURE_A2_AUDIO
\ No newline at end of file
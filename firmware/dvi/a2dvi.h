@@ -24,6 +24,7 @@ SOFTWARE.
 
 #pragma once
 
+void     a2dvi_vreg_init      (void);
 void     a2dvi_dvi_enable     (uint32_t video_mode);
 void     a2dvi_loop           (void);
 void     a2dvi_check_hardware (void);
@@ -33,3 +34,5 @@ void     a2dvi_audio_enable   (bool enable);
 bool     a2dvi_audio_enabled  (void);
 bool     a2dvi_queue_audio_samples(const int16_t* samples, int count);
 
+extern uint32_t a2dvi_switch_time;
+
@@ -31,7 +31,7 @@ uint32_t DELAYED_COPY_DATA(dvi_xofs560);
 uint32_t DELAYED_COPY_DATA(dvi_xofs640);
 
 // TMDS data for RGB channels for a double pixel (a perfectly bit balanced pixel)
-uint32_t DELAYED_COPY_DATA(tmds_mono_double_pixel)[3*5] =
+uint32_t RENDER_LUT_SMALL(tmds_mono_double_pixel)[3*5] =
 {
     /* R                 G                    B               */
     TMDS_SYMBOL_255_255, TMDS_SYMBOL_255_255, TMDS_SYMBOL_255_255, /* white */
@@ -43,7 +43,7 @@ uint32_t DELAYED_COPY_DATA(tmds_mono_double_pixel)[3*5] =
 };
 
 // TMDS data for RGB channels for a pattern of two pixels (a perfectly bit balanced pixel pair)
-uint32_t DELAYED_COPY_DATA(tmds_mono_pixel_pair)[4*3*3] =
+uint32_t RENDER_LUT_SMALL(tmds_mono_pixel_pair)[4*3*3] =
 {
     // white
     /*R*/ TMDS_SYMBOL_0_0, TMDS_SYMBOL_255_0, TMDS_SYMBOL_0_255, TMDS_SYMBOL_255_255,
@@ -64,6 +64,7 @@ uint32_t DELAYED_COPY_DATA(tmds_mono_pixel_pair)[4*3*3] =
 void DELAYED_COPY_CODE(tmds_color_load)(void)
 {
     tmds_color_load_lores(cfg_color_style);
+    // also on the A2C: render_dhgr_bytes draws its double hires lines rebuilt from SEROUT
     tmds_color_load_dhgr(cfg_color_style);
     reload_colors = false;
 }
@@ -25,6 +25,7 @@ SOFTWARE.
 #pragma once
 
 #include "dvi.h"
+#include "config/config.h"
 
 extern struct dvi_inst dvi0;
 
@@ -71,9 +72,19 @@ extern uint32_t dvi_xofs640;
 #define TMDS_SYMBOL_0_128   0xdfd00
 #define TMDS_SYMBOL_128_128 0x5fd80
 
+#ifdef FEATURE_RENDER_BENCH
+#include "render/render_bench.h"
+
+#define dvi_get_scanline(tmdsbuf)  \
+    uint32_t* tmdsbuf;\
+    render_bench_wait();\
+    queue_remove_blocking_u32(&dvi0.q_tmds_free, &tmdsbuf);\
+    render_bench_resume();
+#else
 #define dvi_get_scanline(tmdsbuf)  \
     uint32_t* tmdsbuf;\
     queue_remove_blocking_u32(&dvi0.q_tmds_free, &tmdsbuf);
+#endif
 
 // get scanline rgb pointers
 #define dvi_scanline_rgb(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue) \
@@ -108,8 +119,16 @@ extern uint32_t dvi_xofs640;
         destbuf[i+2*DVI_WORDS_PER_CHANNEL] = srcbuf[i+2*DVI_WORDS_PER_CHANNEL]; \
     }
 
+#ifdef FEATURE_RENDER_BENCH
+#define dvi_send_scanline(tmdsbuf) \
+    render_bench_wait();\
+    render_bench_line();\
+    queue_add_blocking_u32(&dvi0.q_tmds_valid, &tmdsbuf);\
+    render_bench_resume();
+#else
 #define dvi_send_scanline(tmdsbuf) \
     queue_add_blocking_u32(&dvi0.q_tmds_valid, &tmdsbuf);
+#endif
 
 // TMDS data for a duplicated monochrome pixel (a "bit balanced" double pixel).
 extern uint32_t tmds_mono_double_pixel[3*5];
@@ -121,9 +140,17 @@ extern uint32_t tmds_mono_pixel_pair[4*3*3];
 // 16 entries, matching the LORES color palette
 extern uint32_t tmds_lorescolor[3*16];
 
-extern uint32_t tmds_hires_color_patterns_red[2*256];
-extern uint32_t tmds_hires_color_patterns_green[2*256];
-extern uint32_t tmds_hires_color_patterns_blue[2*256];
+#ifdef FEATURE_A2C
+// A2C: the hires patterns stay in flash, only the table of the active color style
+// is loaded into RAM (see a2c_lut_update).
+#define TMDS_HIRES_DATA(n) const __in_flash("chr_rom") n
+#else
+#define TMDS_HIRES_DATA(n) RENDER_LUT(n)
+#endif
+
+extern uint32_t TMDS_HIRES_DATA(tmds_hires_color_patterns_red)[2*256];
+extern uint32_t TMDS_HIRES_DATA(tmds_hires_color_patterns_green)[2*256];
+extern uint32_t TMDS_HIRES_DATA(tmds_hires_color_patterns_blue)[2*256];
 
 extern uint32_t tmds_dhgr_red[16*16];
 extern uint32_t tmds_dhgr_green[16*16];
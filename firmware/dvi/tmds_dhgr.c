@@ -26,9 +26,9 @@ SOFTWARE.
 #include "config/config.h"
 #include "util/dmacopy.h"
 
-uint32_t __attribute__((section (".appledata."))) tmds_dhgr_red[16*16];
-uint32_t __attribute__((section (".appledata."))) tmds_dhgr_green[16*16];
-uint32_t __attribute__((section (".appledata."))) tmds_dhgr_blue[16*16];
+uint32_t RENDER_LUT_BSS(tmds_dhgr_red)[16*16];
+uint32_t RENDER_LUT_BSS(tmds_dhgr_green)[16*16];
+uint32_t RENDER_LUT_BSS(tmds_dhgr_blue)[16*16];
 
 // TMDS symbols for DHGR RGB colors - for each two pixel combination
 // (each symbol covers two pixels and is encoded with a perfect 'bit balance').
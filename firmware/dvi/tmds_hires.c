@@ -26,7 +26,7 @@ SOFTWARE.
 #include "config/config.h"
 
 // hires TMDS color patterns
-uint32_t DELAYED_COPY_DATA(tmds_hires_color_patterns_red)[2*256] = {
+uint32_t TMDS_HIRES_DATA(tmds_hires_color_patterns_red)[2*256] = {
 	0x7fd00,
 	0x7fd00,
 	0x7fd00,
@@ -541,7 +541,7 @@ uint32_t DELAYED_COPY_DATA(tmds_hires_color_patterns_red)[2*256] = {
 	0xbfe00
 };
 
-uint32_t DELAYED_COPY_DATA(tmds_hires_color_patterns_green)[2*256] = {
+uint32_t TMDS_HIRES_DATA(tmds_hires_color_patterns_green)[2*256] = {
 	0x7fd00,
 	0x7fd00,
 	0x7fd00,
@@ -1056,7 +1056,7 @@ uint32_t DELAYED_COPY_DATA(tmds_hires_color_patterns_green)[2*256] = {
 	0xbfe00
 };
 
-uint32_t DELAYED_COPY_DATA(tmds_hires_color_patterns_blue)[2*256] = {
+uint32_t TMDS_HIRES_DATA(tmds_hires_color_patterns_blue)[2*256] = {
 	0x7fd00,
 	0x7fd00,
 	0x7fd00,
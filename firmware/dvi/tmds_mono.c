@@ -0,0 +1,160 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "tmds_mono.h"
+#include "tmds.h"
+#include "config/config.h"
+
+#include "hardware/dma.h"
+#include "hardware/pio.h"
+#include "tmds_encode_1bpp.pio.h"
+
+static PIO      s_mono_pio;
+static int      s_mono_sm = -1;
+static uint     s_mono_offset;
+static int      s_mono_dma_tx;
+static int      s_mono_dma_rx;
+static int      s_mono_dma_lane[2];                     //  red, blue
+static dma_channel_config s_mono_lane_config[2];
+
+static const uint32_t DELAYED_COPY_DATA(s_mono_black) = TMDS_SYMBOL_0_0;
+
+bool tmds_mono_init(void)
+{
+    s_mono_pio = dvi0.ser_cfg->pio;
+    if (!pio_can_add_program(s_mono_pio, &tmds_encode_1bpp_program))
+        return false;
+
+    int sm = pio_claim_unused_sm(s_mono_pio, false);
+    if (sm < 0)
+        return false;
+
+    int channels[4];
+    for (uint i = 0; i < 4; i++)
+    {
+        channels[i] = dma_claim_unused_channel(false);
+        if (channels[i] < 0)
+        {
+            while (i--)
+                dma_channel_unclaim(channels[i]);
+            pio_sm_unclaim(s_mono_pio, sm);
+            return false;
+        }
+    }
+    s_mono_dma_tx      = channels[0];
+    s_mono_dma_rx      = channels[1];
+    s_mono_dma_lane[0] = channels[2];
+    s_mono_dma_lane[1] = channels[3];
+
+    //  the dots of a SEROUT word are shifted out MSB first, the symbols of a pair come out LSB first
+    s_mono_offset = pio_add_program(s_mono_pio, &tmds_encode_1bpp_program);
+    pio_sm_config c = tmds_encode_1bpp_program_get_default_config(s_mono_offset);
+    sm_config_set_out_shift(&c, false, true, 32);
+    sm_config_set_in_shift(&c, true, true, 24);
+    pio_sm_init(s_mono_pio, sm, s_mono_offset, &c);
+    pio_sm_set_enabled(s_mono_pio, sm, true);
+
+    //  dots to the state machine
+    dma_channel_config tx = dma_channel_get_default_config(s_mono_dma_tx);
+    channel_config_set_transfer_data_size(&tx, DMA_SIZE_32);
+    channel_config_set_read_increment(&tx, true);
+    channel_config_set_write_increment(&tx, false);
+    channel_config_set_dreq(&tx, pio_get_dreq(s_mono_pio, sm, true));
+    dma_channel_configure(s_mono_dma_tx, &tx, &s_mono_pio->txf[sm], NULL, 0, false);
+
+    //  symbol pairs to the green lane, then the red and blue lanes
+    dma_channel_config rx = dma_channel_get_default_config(s_mono_dma_rx);
+    channel_config_set_transfer_data_size(&rx, DMA_SIZE_32);
+    channel_config_set_read_increment(&rx, false);
+    channel_config_set_write_increment(&rx, true);
+    channel_config_set_dreq(&rx, pio_get_dreq(s_mono_pio, sm, false));
+    channel_config_set_chain_to(&rx, s_mono_dma_lane[0]);
+    dma_channel_configure(s_mono_dma_rx, &rx, NULL, &s_mono_pio->rxf[sm], 0, false);
+
+    for (uint i = 0; i < 2; i++)
+    {
+        s_mono_lane_config[i] = dma_channel_get_default_config(s_mono_dma_lane[i]);
+        channel_config_set_transfer_data_size(&s_mono_lane_config[i], DMA_SIZE_32);
+        channel_config_set_write_increment(&s_mono_lane_config[i], true);
+    }
+    channel_config_set_chain_to(&s_mono_lane_config[0], s_mono_dma_lane[1]);
+
+    s_mono_sm = sm;
+    return true;
+}
+
+void tmds_mono_deinit(void)
+{
+    if (s_mono_sm < 0)
+        return;
+
+    pio_sm_set_enabled(s_mono_pio, s_mono_sm, false);
+    pio_remove_program(s_mono_pio, &tmds_encode_1bpp_program, s_mono_offset);
+    pio_sm_unclaim(s_mono_pio, s_mono_sm);
+
+    int channels[4] = { s_mono_dma_tx, s_mono_dma_rx, s_mono_dma_lane[0], s_mono_dma_lane[1] };
+    for (uint i = 0; i < 4; i++)
+    {
+        dma_channel_abort(channels[i]);
+        dma_channel_unclaim(channels[i]);
+    }
+
+    s_mono_sm     = -1;
+    s_mono_offset = 0;
+}
+
+bool DELAYED_COPY_CODE(tmds_mono_encode)(const uint32_t* dots, uint32_t words, uint32_t* tmdsbuf_red, uint32_t* tmdsbuf_green, uint32_t* tmdsbuf_blue, uint8_t color_mode)
+{
+    if ((s_mono_sm < 0) || (color_mode > COLOR_MODE_GREEN))
+        return false;
+
+    //  16 pixel pairs per word of dots
+    uint32_t pairs = words * 16;
+    bool white = (color_mode == COLOR_MODE_BW);
+    const uint32_t* lane_source = (white) ? tmdsbuf_green : &s_mono_black;
+    uint32_t* lane_target[2] = { tmdsbuf_red, tmdsbuf_blue };
+
+    for (uint i = 0; i < 2; i++)
+    {
+        dma_channel_config c = s_mono_lane_config[i];
+        channel_config_set_read_increment(&c, white);
+        dma_channel_configure(s_mono_dma_lane[i], &c, lane_target[i], lane_source, pairs, false);
+    }
+    dma_channel_set_write_addr(s_mono_dma_rx, tmdsbuf_green, false);
+    dma_channel_set_trans_count(s_mono_dma_rx, pairs, false);
+    dma_channel_set_read_addr(s_mono_dma_tx, dots, false);
+    dma_channel_set_trans_count(s_mono_dma_tx, words, false);
+
+    dma_start_channel_mask((1u << s_mono_dma_tx) | (1u << s_mono_dma_rx));
+    return true;
+}
+
+void DELAYED_COPY_CODE(tmds_mono_wait)(void)
+{
+    //  in the order of the chain, each channel is triggered by the end of the previous one
+    dma_channel_wait_for_finish_blocking(s_mono_dma_rx);
+    dma_channel_wait_for_finish_blocking(s_mono_dma_lane[0]);
+    dma_channel_wait_for_finish_blocking(s_mono_dma_lane[1]);
+}
@@ -0,0 +1,50 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*  Monochrome TMDS encoding on the PIO
+
+    libdvi's tmds_encode_1bpp program runs on the spare state machine of the DVI PIO.
+    One DMA channel feeds it a line of dots (32 bit words, first dot in bit 31), a second
+    one stores the TMDS symbol pairs it returns in the green lane. Two more channels,
+    chained to the second one, complete the red and blue lanes: a copy of the green lane
+    for white, black for green. Amber needs a 128 level in the green lane, which the
+    program cannot encode, so it stays on the CPU (tmds_mono_pixel_pair).
+
+    tmds_mono_encode only starts the transfers, tmds_mono_wait must return before the
+    scanline is sent. tmds_mono_init claims the state machine and the DMA channels after
+    dvi_init, when they are not available the renderers keep encoding on the CPU.
+    tmds_mono_deinit releases them again before dvi_destroy, which clears the program
+    memory of the DVI PIO.
+*/
+
+bool tmds_mono_init  (void);
+void tmds_mono_deinit(void);
+bool tmds_mono_encode(const uint32_t* dots, uint32_t words, uint32_t* tmdsbuf_red, uint32_t* tmdsbuf_green, uint32_t* tmdsbuf_blue, uint8_t color_mode);
+void tmds_mono_wait  (void);
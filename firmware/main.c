@@ -24,7 +24,6 @@ SOFTWARE.
 
 #include <string.h>
 #include "pico/multicore.h"
-#include "hardware/vreg.h"
 
 #include "dvi/a2dvi.h"
 #include "applebus/abus.h"
@@ -41,6 +40,10 @@ SOFTWARE.
 #include "a2c/a2c.h"
 #endif 
 
+#ifdef FEATURE_A2C_USB
+#include "usb/usb_device.h"
+#endif
+
 #include "fonts/textfont.h"
 
 #ifdef FEATURE_TEST
@@ -50,21 +53,28 @@ SOFTWARE.
 
 #include "debug/profiler.h"
 
-#define VREG_VSEL         VREG_VOLTAGE_1_20
-
 int main()
 {
+#ifdef FEATURE_A2C_USB
+    // the USB device stack with the screenshot disk and the stream, stdio_usb adds the CDC interface
+    usb_device_init();
+#endif
+
     //  Enable to reboot without BOOTSEL button
     stdio_init_all();
     
     // slightly rise the core voltage, preparation for overclocking
-    vreg_set_voltage(VREG_VSEL);
+    a2dvi_vreg_init();
 
     PROFILER_INIT(boot_time);
 
     // enable LED etc
     debug_init();
 
+    // copy the render LUTs to the SRAM banks of the selected layout (SRAM_LAYOUT)
+    memcpy32(__render_lut_small_start__, __render_lut_small_source__, ((uint32_t)__render_lut_small_end__) - (uint32_t) __render_lut_small_start__);
+    memcpy32(__render_lut_start__, __render_lut_source__, ((uint32_t)__render_lut_end__) - (uint32_t) __render_lut_start__);
+
 #ifndef FEATURE_A2C
     // Finish copying remaining data and code from flash to RAM
     memcpy32(__ram_delayed_copy_start__, __ram_delayed_copy_source__, ((uint32_t)__ram_delayed_copy_end__) - (uint32_t) __ram_delayed_copy_start__);
@@ -77,6 +87,7 @@ int main()
 
     // load config settings
     config_load();
+    boot_milestone("CFG");
 
 #ifdef FEATURE_TEST
     // start testsuite, simulating some 6502 activity and
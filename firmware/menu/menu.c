@@ -26,10 +26,14 @@ SOFTWARE.
 
 #include "applebus/abus.h"
 #include "applebus/buffers.h"
+#include "applebus/abus_trace.h"
 #include "config/config.h"
 #include "fonts/textfont.h"
 #include "debug/debug.h"
 #include "dvi/a2dvi.h"
+#include "render/render.h"
+#include "render/render_cache.h"
+#include "render/render_bench.h"
 #include "menu.h"
 
 // number of elements in the menu
@@ -218,6 +222,7 @@ char DELAYED_COPY_DATA(MenuRendering)[] =
     "ENABLED\0"
     "DOUBLE HIRES ONLY\0"
     "DOUBLE LORES ONLY\0"
+    "DOUBLE HIRES NTSC\0"
     "\0";
 
 
@@ -590,6 +595,21 @@ void DELAYED_COPY_CODE(menuShowDebug)()
         int2str(devicemem_counter, s, 14);
         printXY(X2,12, s, PRINTMODE_NORMAL);
 
+#ifdef FEATURE_ABUS_TRACE
+        // results of the last bus trace replay
+        printXY(X1,13, "TRACE NS/CYCLE:", PRINTMODE_NORMAL);
+        int2str(abus_trace_replay_ns, s, 14);
+        printXY(X2,13, s, PRINTMODE_NORMAL);
+
+        printXY(X1,14, "TRACE CRC:", PRINTMODE_NORMAL);
+        char crc[18];
+        int2hex((uint8_t*) crc, abus_trace_replay_crc_main, 8);
+        crc[8] = ' '|0x80;
+        int2hex((uint8_t*) &crc[9], abus_trace_replay_crc_aux, 8);
+        crc[17] = 0;
+        printXY(X2-3,14, crc, PRINTMODE_NORMAL);
+#endif
+
         printXY(X1,15, "AVAILABLE MEMORY:", PRINTMODE_NORMAL);
         int2str(getFreeHeap(), s, 14);
         printXY(X2,15, s, PRINTMODE_NORMAL);
@@ -598,6 +618,26 @@ void DELAYED_COPY_CODE(menuShowDebug)()
         int2str(boot_time, s, 14);
         printXY(X2, 16, s, PRINTMODE_NORMAL);
 
+#ifndef FEATURE_A2C
+        printXY(X1,17, "CACHED LINES:", PRINTMODE_NORMAL);
+        int2str(render_cache_lines, s, 4);
+        printXY(X2, 17, s, PRINTMODE_NORMAL);
+        int2str(render_cache_hits, s, 10);
+        printXY(X2+4, 17, s, PRINTMODE_NORMAL);
+#endif
+
+#ifdef FEATURE_RENDER_BENCH
+        // CPU cycles per scanline: worst and average of the last 64 frames, worst since boot
+        printXY(X1,18, "LINE CYCLES:", PRINTMODE_NORMAL);
+        printXY(X1,19, "SRAM LAYOUT: " SRAM_LAYOUT, PRINTMODE_NORMAL);
+        int2str(render_bench_worst, s, 6);
+        printXY(X2, 18, s, PRINTMODE_NORMAL);
+        int2str(render_bench_average, s, 6);
+        printXY(X2+6, 18, s, PRINTMODE_NORMAL);
+        int2str(render_bench_peak, s, 6);
+        printXY(X2+12, 18, s, PRINTMODE_NORMAL);
+#endif
+
 #if 0
         printXY(X1,17, "IFLAGS:", PRINTMODE_NORMAL);
         int2str(internal_flags, s, 8);
@@ -767,7 +807,7 @@ bool DELAYED_COPY_CODE(menuDoSelectionPage0)(bool increase)
         case 8: // RENDERING
             if (increase)
             {
-                if (cfg_rendering_fx < FX_DGR_ONLY)
+                if (cfg_rendering_fx < FX_DHGR_NTSC)
                     cfg_rendering_fx++;
             }
             else
@@ -31,7 +31,21 @@ SOFTWARE.
 #include "dvi/a2dvi.h"
 
 #include "render.h"
+#include "render_cache.h"
+#include "render_bench.h"
 #include "menu/menu.h"
+#ifdef FEATURE_A2C_RECORD
+#include "a2c/a2c_record.h"
+#endif
+#ifdef FEATURE_A2C_SCREENSHOT
+#include "a2c/a2c_screenshot.h"
+#endif
+#ifdef FEATURE_A2C_STREAM
+#include "a2c/a2c_stream.h"
+#endif
+#ifdef FEATURE_A2C_USB
+#include "usb/usb_device.h"
+#endif
 
 uint32_t led_bus_cycle_counter;
 bool mono_rendering = false;
@@ -262,18 +276,30 @@ void DELAYED_COPY_CODE(render_loop)()
 {
     // show splash/diagnostic screen
     render_splash();
+    render_cache_invalidate();
+#ifdef FEATURE_RENDER_BENCH
+    render_bench_init();
+#endif
 
     for(;;)
     {
         // copy soft switches - since we need consistent settings throughout a rendering cycle
         uint32_t current_softsw = soft_switches;
         bool IsVidex = ((current_softsw & (SOFTSW_TEXT_MODE|SOFTSW_VIDEX_80COL)) == (SOFTSW_TEXT_MODE|SOFTSW_VIDEX_80COL));
+#ifdef FEATURE_SHR
+        bool IsShr = ((current_softsw & SOFTSW_SHR) != 0);
+#endif
 #ifndef FEATURE_TEST_TMDS
 
         //  Render the top (true) two text lines for debug
 #ifdef FEATURE_A2C
         render_a2c_debug(IsVidex, true);
 #else
+#ifdef FEATURE_SHR
+        if (IsShr)
+            render_shr_border();
+        else
+#endif
         render_debug(IsVidex, true);
 #endif
 
@@ -282,6 +308,9 @@ void DELAYED_COPY_CODE(render_loop)()
 
         // prepare state indicating whether the current display mode supports colors
         color_support = (current_softsw & SOFTSW_MONOCHROME) ? false : true;
+
+        // cached scanlines are only valid for an unchanged display mode
+        render_cache_update(current_softsw);
 #else
         // no scanlines/no videx when running the TMDS test
         cfg_scanline_mode = ScanlinesOff;
@@ -292,6 +321,11 @@ void DELAYED_COPY_CODE(render_loop)()
             render_tmds_test();
         }
         else
+#endif
+#ifdef FEATURE_SHR
+        if (IsShr)
+            render_shr();
+        else
 #endif
         if (IsVidex)
             render_videx_text();
@@ -365,11 +399,13 @@ void DELAYED_COPY_CODE(render_loop)()
                     if (reload_charsets)
                     {
                         config_load_charsets();
+                        render_cache_invalidate();
                     }
                     else
                     if (reload_colors)
                     {
                         tmds_color_load();
+                        render_cache_invalidate();
                     }
                     break;
             }
@@ -379,7 +415,27 @@ void DELAYED_COPY_CODE(render_loop)()
         //  Render the bottom (false) two text lines for debug
 #ifdef FEATURE_A2C
         render_a2c_debug(IsVidex, false);
+#ifdef FEATURE_A2C_RECORD
+        // the DVI vertical blank follows, the time to write the recorded frames to flash
+        a2c_record_write();
+#endif
+#ifdef FEATURE_A2C_SCREENSHOT
+        // encode the screenshot line and write it to flash
+        a2c_screenshot_write();
+#endif
+#ifdef FEATURE_A2C_USB
+        // then serve the USB disk and the stream
+        usb_device_task();
+#endif
+#ifdef FEATURE_A2C_STREAM
+        a2c_stream_send();
+#endif
 #else
+#ifdef FEATURE_SHR
+        if (IsShr)
+            render_shr_border();
+        else
+#endif
         render_debug(IsVidex, false);
 #endif
 
@@ -392,6 +448,9 @@ void DELAYED_COPY_CODE(render_loop)()
                                     (mono_rendering || (color_support == false))));
 
         frame_counter++;
+#ifdef FEATURE_RENDER_BENCH
+        render_bench_frame();
+#endif
 
         // toggle LED
         if ((frame_counter&7) == 0)
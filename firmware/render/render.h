@@ -42,16 +42,20 @@ extern void update_text_flasher();
 extern void render_text();
 extern void render_mixed_text();
 extern void render_text40_line(const uint8_t *page, unsigned int line, uint8_t color_mode);
+extern void render_text80_line(const uint8_t *page_a, const uint8_t *page_b, unsigned int line, uint8_t color_mode);
 extern void render_color_text40_line(unsigned int line);
+extern void render_color_text40_span(uint32_t* tmdsbuf, unsigned int line, unsigned int glyph_line, unsigned int first, unsigned int last, bool shade);
 
 extern void render_lores();
 extern void render_mixed_lores();
 
 extern void render_hires();
 extern void render_mixed_hires();
+extern void render_hires_bytes(const uint8_t *line_mem, bool mono, uint32_t* tmdsbuf_red, uint32_t* tmdsbuf_green, uint32_t* tmdsbuf_blue);
 
 extern void render_dhgr();
 extern void render_mixed_dhgr();
+extern void render_dhgr_bytes(const uint8_t *line_mema, const uint8_t *line_memb, bool mono, uint32_t* tmdsbuf_red, uint32_t* tmdsbuf_green, uint32_t* tmdsbuf_blue);
 
 extern void render_dgr();
 extern void render_mixed_dgr();
@@ -62,6 +66,11 @@ extern void render_debug(bool IsVidexMode, bool top);
 extern void copy_str(uint8_t* dest, const char* pMsg);
 extern void int2hex(uint8_t* pStrBuf, uint32_t value, uint32_t digits);
 
+#ifdef FEATURE_SHR
+extern void render_shr();
+extern void render_shr_border();
+#endif
+
 #ifdef FEATURE_A2C
 extern void render_a2c();
 extern void render_a2c_debug(bool IsVidexMode, bool top);
@@ -0,0 +1,77 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "render_bench.h"
+
+#ifdef FEATURE_RENDER_BENCH
+
+#include "config/config.h"
+
+uint32_t render_bench_start;
+uint32_t render_bench_busy;
+uint32_t render_bench_line_max;
+uint64_t render_bench_line_sum;
+uint32_t render_bench_line_count;
+
+uint32_t render_bench_worst;
+uint32_t render_bench_average;
+uint32_t render_bench_peak;
+
+static uint32_t render_bench_frames;
+
+//  called on the render core: SysTick is a per core timer
+void DELAYED_COPY_CODE(render_bench_init)(void)
+{
+    // CPU clock source, no exception, free running 24 bit down counter
+    systick_hw->csr = 0x5;
+    systick_hw->rvr = 0x00FFFFFF;
+    systick_hw->cvr = 0x00FFFFFF;
+
+    render_bench_start      = systick_hw->cvr;
+    render_bench_busy       = 0;
+    render_bench_line_max   = 0;
+    render_bench_line_sum   = 0;
+    render_bench_line_count = 0;
+    render_bench_frames     = 0;
+    render_bench_peak       = 0;
+}
+
+void DELAYED_COPY_CODE(render_bench_frame)(void)
+{
+    if (++render_bench_frames < RENDER_BENCH_FRAMES)
+        return;
+
+    render_bench_worst   = render_bench_line_max;
+    render_bench_average = (render_bench_line_count) ? (uint32_t)(render_bench_line_sum / render_bench_line_count) : 0;
+    if (render_bench_worst > render_bench_peak)
+        render_bench_peak = render_bench_worst;
+
+    render_bench_line_max   = 0;
+    render_bench_line_sum   = 0;
+    render_bench_line_count = 0;
+    render_bench_frames     = 0;
+}
+
+#endif // FEATURE_RENDER_BENCH
@@ -0,0 +1,83 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+
+/*  Render benchmark (FEATURE_RENDER_BENCH builds only)
+
+    Measures the CPU cycles the render core spends per scanline, with the SysTick timer
+    of core 0: the time between two dvi_send_scanline calls, without the time spent
+    waiting for a free TMDS buffer or for room in the valid queue. Renderers preparing
+    several scanlines at once (lores, dgr) count the work for the first one sent.
+    The results of the last 64 frames are shown on the debug page of the menu (A2C: debug
+    monitor), with the SRAM layout of the build, so the layouts (SRAM_LAYOUT in
+    CMakeLists.txt) can be compared by their worst case.
+*/
+
+#ifdef FEATURE_RENDER_BENCH
+
+#include "hardware/structs/systick.h"
+
+#define RENDER_BENCH_FRAMES     64
+
+extern uint32_t render_bench_start;         //  SysTick value (counting down) when the render core resumed
+extern uint32_t render_bench_busy;          //  cycles spent on the current scanline
+extern uint32_t render_bench_line_max;      //  current period
+extern uint64_t render_bench_line_sum;
+extern uint32_t render_bench_line_count;
+
+//  results of the last period, in CPU cycles per scanline
+extern uint32_t render_bench_worst;
+extern uint32_t render_bench_average;
+extern uint32_t render_bench_peak;          //  worst period since render_bench_init
+
+//  before blocking on a TMDS queue
+static inline void render_bench_wait(void)
+{
+    render_bench_busy += (render_bench_start - systick_hw->cvr) & 0x00FFFFFF;
+}
+
+//  after a TMDS queue operation returned
+static inline void render_bench_resume(void)
+{
+    render_bench_start = systick_hw->cvr;
+}
+
+//  a scanline is sent
+static inline void render_bench_line(void)
+{
+    if (render_bench_busy > render_bench_line_max)
+        render_bench_line_max = render_bench_busy;
+    render_bench_line_sum += render_bench_busy;
+    render_bench_line_count++;
+    render_bench_busy = 0;
+}
+
+void render_bench_init (void);
+void render_bench_frame(void);
+
+#endif
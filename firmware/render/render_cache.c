@@ -0,0 +1,147 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "applebus/buffers.h"
+#include "config/config.h"
+#include "debug/debug.h"
+#include "render.h"
+#include "render_cache.h"
+
+// heap left for other allocations when the cache takes the rest
+#define RENDER_CACHE_HEAP_RESERVE   (8*1024)
+
+// soft switches changing the output of a renderer (PAGE_2 is part of the cache key)
+#define RENDER_CACHE_SOFTSW_MASK    (SOFTSW_MODE_MASK | SOFTSW_80STORE | SOFTSW_80COL | SOFTSW_ALTCHAR | \
+                                     SOFTSW_DGR | SOFTSW_MONOCHROME | SOFTSW_V7_MODE3 | SOFTSW_VIDEX_80COL | SOFTSW_SHR)
+
+volatile uint8_t render_dirty_hires[2][RENDER_HIRES_LINES];
+volatile uint8_t render_dirty_text[2][RENDER_TEXT_ROWS];
+
+uint32_t render_cache_lines;
+uint32_t render_cache_hits;
+
+static uint32_t* s_cache_buffers;
+static uint32_t  s_cache_line_words;
+static uint32_t  s_cache_keys[RENDER_HIRES_LINES];
+static uint32_t  s_generation = 1;
+
+// Allocate the pinned TMDS buffers from the heap left after dvi_init. Called whenever the DVI resolution changes.
+void DELAYED_COPY_CODE(render_cache_init)(void)
+{
+    render_cache_free();
+
+    s_cache_line_words = 3 * DVI_WORDS_PER_CHANNEL;
+    uint32_t line_bytes = s_cache_line_words * sizeof(uint32_t);
+    uint32_t heap = getFreeHeap();
+    uint32_t lines = (heap > RENDER_CACHE_HEAP_RESERVE) ? (heap - RENDER_CACHE_HEAP_RESERVE) / line_bytes : 0;
+    if (lines > RENDER_HIRES_LINES)
+        lines = RENDER_HIRES_LINES;
+
+    while ((lines)&&((s_cache_buffers = malloc(lines * line_bytes)) == NULL))
+        lines--;
+    if (!lines)
+        return;
+
+    dvi0.tmds_pinned_start = s_cache_buffers;
+    dvi0.tmds_pinned_end   = s_cache_buffers + lines * s_cache_line_words;
+    render_cache_invalidate();
+    render_cache_lines = lines;
+}
+
+// Must be called after dvi_destroy, when no pinned buffer is queued anymore
+void DELAYED_COPY_CODE(render_cache_free)(void)
+{
+    render_cache_lines = 0;
+    if (s_cache_buffers)
+    {
+        free(s_cache_buffers);
+        s_cache_buffers = NULL;
+    }
+    dvi0.tmds_pinned_start = NULL;
+    dvi0.tmds_pinned_end   = NULL;
+}
+
+void DELAYED_COPY_CODE(render_cache_invalidate)(void)
+{
+    if (++s_generation >= 0x10000)
+    {
+        // keys of lines not rendered for a long time could match again
+        memset(s_cache_keys, 0, sizeof(s_cache_keys));
+        s_generation = 1;
+    }
+}
+
+// Called once per frame by the render loop: invalidates the cache when the display state changed
+void DELAYED_COPY_CODE(render_cache_update)(uint32_t current_softsw)
+{
+    static uint32_t last_softsw;
+    static uint32_t last_flags;
+    static uint32_t last_colors;
+
+    // the menu and splash screens are drawn directly into the video memory
+    uint32_t colors = (color_mode << 2) | (mono_rendering << 1) | language_switch;
+    if ((current_softsw & (SOFTSW_MENU_ENABLE | SOFTSW_SHOW_SPLASH))||
+        ((current_softsw & RENDER_CACHE_SOFTSW_MASK) != last_softsw)||
+        (internal_flags != last_flags)||
+        (colors != last_colors))
+    {
+        render_cache_invalidate();
+    }
+    last_softsw = current_softsw & RENDER_CACHE_SOFTSW_MASK;
+    last_flags  = internal_flags;
+    last_colors = colors;
+}
+
+uint32_t DELAYED_COPY_CODE(render_cache_key)(uint32_t renderer, bool page2, uint32_t variant)
+{
+    return (s_generation << 16) | ((variant & 0xff) << 8) | (renderer << 1) | page2;
+}
+
+bool DELAYED_COPY_CODE(render_cache_valid)(uint32_t line, uint32_t key)
+{
+    return (line < render_cache_lines)&&(key)&&(s_cache_keys[line] == key);
+}
+
+void DELAYED_COPY_CODE(render_cache_send)(uint32_t line)
+{
+    uint32_t* tmdsbuf = s_cache_buffers + line * s_cache_line_words;
+    dvi_send_scanline(tmdsbuf);
+    render_cache_hits++;
+}
+
+// TMDS buffer to render a source line into: its pinned buffer, or one from the DVI free queue
+uint32_t* DELAYED_COPY_CODE(render_cache_scanline)(uint32_t line, uint32_t key)
+{
+    if ((line < render_cache_lines)&&(key))
+    {
+        s_cache_keys[line] = key;
+        return s_cache_buffers + line * s_cache_line_words;
+    }
+
+    dvi_get_scanline(tmdsbuf);
+    return tmdsbuf;
+}
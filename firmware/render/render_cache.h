@@ -0,0 +1,120 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*  Line cache of the slotted renderers.
+
+    bus_func_screen_write marks every line of the video pages it writes to in
+    the dirty maps. The renderers keep the TMDS output of the first
+    render_cache_lines source lines in pinned buffers (libdvi never returns
+    them to its free queue), and send a pinned buffer as is when its line is
+    clean and was rendered with the same cache key. The key holds the renderer,
+    the page and a generation, which render_cache_update increments whenever
+    the soft switches, charsets or colors change.
+
+    The dirty maps use one byte per line, so both cores can update them without
+    atomics: the abus core sets them, the render core clears them before it
+    reads the video memory.
+*/
+
+#define RENDER_HIRES_LINES      192
+#define RENDER_TEXT_ROWS        24
+
+// renderers, part of the cache key
+#define RENDER_CACHE_TEXT40     1
+#define RENDER_CACHE_TEXT80     2
+#define RENDER_CACHE_COLORTEXT  3
+#define RENDER_CACHE_LORES      4
+#define RENDER_CACHE_HIRES      5
+#define RENDER_CACHE_DHGR       6
+
+extern volatile uint8_t render_dirty_hires[2][RENDER_HIRES_LINES];
+extern volatile uint8_t render_dirty_text[2][RENDER_TEXT_ROWS];
+
+extern uint32_t render_cache_lines;     // number of source lines with a pinned TMDS buffer
+extern uint32_t render_cache_hits;      // cached lines sent, for the debug monitor
+
+// Mark the line of a video page written by the Apple II (abus core)
+static inline void render_mark_dirty(uint32_t address)
+{
+    uint32_t column = address & 0x7f;
+    if (column >= 120)                  // screen holes
+        return;
+    uint32_t third = (column >= 40) + (column >= 80);
+
+    if ((address >= 0x2000)&&(address < 0x6000))
+    {
+        // hires/double hires: line = third*64 + ((address >> 7) & 7)*8 + ((address >> 10) & 7)
+        render_dirty_hires[(address >> 14) & 1][(third << 6) | ((address >> 4) & 0x38) | ((address >> 10) & 0x7)] = 1;
+    }
+    else
+    if (address < 0xc00)
+    {
+        // text/lores/double lores, address is at least 0x400
+        render_dirty_text[(address >> 11) & 1][(third << 3) | ((address >> 7) & 0x7)] = 1;
+    }
+}
+
+// Mark all lines after the video memory was changed without bus cycles
+static inline void render_mark_all_dirty(void)
+{
+    for (uint32_t i=0;i<RENDER_HIRES_LINES;i++)
+    {
+        render_dirty_hires[0][i] = 1;
+        render_dirty_hires[1][i] = 1;
+    }
+    for (uint32_t i=0;i<RENDER_TEXT_ROWS;i++)
+    {
+        render_dirty_text[0][i] = 1;
+        render_dirty_text[1][i] = 1;
+    }
+}
+
+static inline bool render_take_dirty_line(bool page2, uint32_t line)
+{
+    bool dirty = render_dirty_hires[page2][line];
+    render_dirty_hires[page2][line] = 0;
+    return dirty;
+}
+
+static inline bool render_take_dirty_row(bool page2, uint32_t row)
+{
+    bool dirty = render_dirty_text[page2][row];
+    render_dirty_text[page2][row] = 0;
+    return dirty;
+}
+
+void      render_cache_init      (void);
+void      render_cache_free      (void);
+void      render_cache_invalidate(void);
+void      render_cache_update    (uint32_t current_softsw);
+uint32_t  render_cache_key       (uint32_t renderer, bool page2, uint32_t variant);
+bool      render_cache_valid     (uint32_t line, uint32_t key);
+void      render_cache_send      (uint32_t line);
+uint32_t* render_cache_scanline  (uint32_t line, uint32_t key);
@@ -187,7 +187,7 @@ void DELAYED_COPY_CODE(update_debug_monitor)(void)
 #ifdef FEATURE_A2_AUDIO
         extern uint64_t s_abus_boot_time;
         extern uint32_t s_abus_snd_data_count;
-        extern uint32_t s_abus_irq_count;
+        extern uint32_t s_abus_ring_high_water;
         extern uint_fast8_t s_C000_value;
         extern bool s_snd_rate_NTSC;
 
@@ -208,13 +208,10 @@ void DELAYED_COPY_CODE(update_debug_monitor)(void)
             copy_str(&line1[x], s_temp_abus_line_buffer);
             x = x + (6+1);
 
-            copy_str(&line1[x], "I:");
+            //  Bus ring buffer high water mark
+            copy_str(&line1[x], "R:");
             x = x + 2;
-            float irq_rate = 110.0;
-            if (time_f != 0.0)
-                irq_rate = (float)s_abus_irq_count / time_f;
-            uint32_t irq_rate_int = irq_rate;
-            int2str(irq_rate_int, s_temp_abus_line_buffer, 6);
+            int2str(s_abus_ring_high_water, s_temp_abus_line_buffer, 6);
             copy_str(&line1[x], s_temp_abus_line_buffer);
             x = x + (6+1);
 
@@ -27,6 +27,8 @@ SOFTWARE.
 #include "applebus/buffers.h"
 #include "config/config.h"
 #include "render.h"
+#include "render_cache.h"
+#include "dhgr_patterns.h"
 
 // map DHGR values to the LORES palette (also multiply by 3, as we need an index to the RGB TMDS table, with 3 values per color)
 uint8_t DELAYED_COPY_DATA(tmds_dhgr_lores_mapping)[16] =
@@ -37,6 +39,9 @@ uint8_t DELAYED_COPY_DATA(tmds_dhgr_lores_mapping)[16] =
     9*3 /*9:HVIOLET*/, 11*3 /*11:LBLUE*/, 13*3 /*13:PINK*/,    15*3 /*15:WHITE*/
 };
 
+// tmds_dhgr_* index bits of the pixels of a pair shown by two dots of a dhgr_pixel_table mask
+static uint8_t DELAYED_COPY_DATA(dhgr_dot_mask)[4] = { 0x00, 0x0f, 0xf0, 0xff };
+
 #define PAGE2SEL ((soft_switches & (SOFTSW_80STORE | SOFTSW_PAGE_2)) == SOFTSW_PAGE_2)
 
 // add pixels to TMDS line
@@ -65,22 +70,16 @@ static inline uint dhgr_line_to_mem_offset(uint line)
     return ((line & 0x07) << 10) | ((line & 0x38) << 4) | (((line & 0xc0) >> 6) * 40);
 }
 
-static void DELAYED_COPY_CODE(render_dhgr_line)(bool p2, uint line, bool mono)
+//  Render the 40 main and 40 aux bytes of a double hires line into 280 pixel pairs (not the Video-7 modes),
+//  also used by the A2C with the bytes rebuilt from SEROUT
+void DELAYED_COPY_CODE(render_dhgr_bytes)(const uint8_t *line_mema, const uint8_t *line_memb, bool mono, uint32_t* tmdsbuf_red, uint32_t* tmdsbuf_green, uint32_t* tmdsbuf_blue)
 {
-     // Construct scanline
-    dvi_get_scanline(tmdsbuf);
-
-    const uint8_t *line_mema = (const uint8_t *)((p2 ? hgr_p2 : hgr_p1) + dhgr_line_to_mem_offset(line));
-    const uint8_t *line_memb = (const uint8_t *)((p2 ? hgr_p4 : hgr_p3) + dhgr_line_to_mem_offset(line));
-
-    // DHGR is weird. Video-7 just makes it weirder. Nuff said.
     uint32_t dots = 0;
     uint_fast8_t dotc = 0;
     uint i = 0;
 
     if(mono)
     {
-        dvi_scanline_rgb560(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
         uint8_t color_offset = color_mode*12;
         while(i < 40)
         {
@@ -107,8 +106,207 @@ static void DELAYED_COPY_CODE(render_dhgr_line)(bool p2, uint line, bool mono)
             }
         }
     }
+#if 0
+    else
+    if((internal_flags & (IFLAGS_INTERP | IFLAGS_GRILL)) == (IFLAGS_INTERP | IFLAGS_GRILL))
+    {
+        // Preload black into the sliding window
+        dots = 0;
+        dotc = 4;
+
+        while(i < 40)
+        {
+            // Load in as many subpixels as possible
+            while((dotc <= 18) && (i < 40))
+            {
+                dots |= (line_memb[i] & 0x7f) << dotc;
+                dotc += 7;
+                dots |= (line_mema[i] & 0x7f) << dotc;
+                dotc += 7;
+                i++;
+            }
+
+            while((dotc >= 8) || ((dotc > 0) && (i == 40)))
+            {
+                dots &= 0xfffffffe;
+                dots |= (dots >> 4) & 1;
+                pixeldata = half_palette[dots & 0xf];
+                dots &= 0xfffffffc;
+                dots |= (dots >> 4) & 3;
+                pixeldata |= dhgr_palette[dots & 0xf] << 16;
+                sl->data[sl_pos++] = pixeldata;
+
+                dots &= 0xfffffff8;
+                dots |= (dots >> 4) & 7;
+                pixeldata = half_palette[dots & 0xf];
+                dots >>= 4;
+                pixeldata |= dhgr_palette[dots & 0xf] << 16;
+                sl->data[sl_pos++] = pixeldata;
+
+                dotc -= 4;
+            }
+        }
+    }
+#endif
     else
-    if(IS_IFLAG(IFLAGS_VIDEO7) && ((soft_switches & (SOFTSW_80STORE | SOFTSW_80COL)) == SOFTSW_80STORE))
+    if(IS_IFLAG(IFLAGS_NTSC_DHGR))
+    {
+        // 12 dot window: previous, current and next colour cell. Each dhgr_pixel_table entry holds the
+        // colour of the current cell (low nibble) and which of its 4 dots show it (high nibble), the
+        // others are black. Preload black into the previous cell.
+        dots = 0;
+        dotc = 4;
+
+        while(i < 40)
+        {
+            // Load in as many subpixels as possible
+            while((dotc <= 18) && (i < 40))
+            {
+                dots |= (line_memb[i] & 0x7f) << dotc;
+                dotc += 7;
+                dots |= (line_mema[i] & 0x7f) << dotc;
+                dotc += 7;
+                i++;
+            }
+
+            // the window needs the next cell (black after the end of the line)
+            while((dotc >= 12) || ((dotc > 4) && (i == 40)))
+            {
+                uint32_t pattern = dhgr_pixel_table[dots & 0xfff];
+                uint32_t colors  = (pattern & 0xf) * 0x11;      // the colour for both pixels of a pair
+                uint32_t mask    = pattern >> 4;
+
+                // add 2 pixels (dots 0 and 1)
+                uint8_t dhgr_index = colors & dhgr_dot_mask[mask & 3];
+                *(tmdsbuf_red++)   = tmds_dhgr_red[dhgr_index];
+                *(tmdsbuf_green++) = tmds_dhgr_green[dhgr_index];
+                *(tmdsbuf_blue++)  = tmds_dhgr_blue[dhgr_index];
+
+                // add 2 pixels (dots 2 and 3)
+                dhgr_index = colors & dhgr_dot_mask[mask >> 2];
+                *(tmdsbuf_red++)   = tmds_dhgr_red[dhgr_index];
+                *(tmdsbuf_green++) = tmds_dhgr_green[dhgr_index];
+                *(tmdsbuf_blue++)  = tmds_dhgr_blue[dhgr_index];
+
+                dots >>= 4;
+                dotc -= 4;
+            }
+        }
+    }
+    else
+    if(IS_IFLAG(IFLAGS_INTERP_DHGR))
+    {
+        // Preload black into the sliding window
+        dots = 0;
+        dotc = 4;
+
+        while(i < 40)
+        {
+            // Load in as many subpixels as possible
+            while((dotc <= 18) && (i < 40))
+            {
+                dots |= (line_memb[i] & 0x7f) << dotc;
+                dotc += 7;
+                dots |= (line_mema[i] & 0x7f) << dotc;
+                dotc += 7;
+                i++;
+            }
+
+            while((dotc >= 8) || ((dotc > 4) && (i == 40)))
+            {
+                dots &= 0xfffffffe;
+                dots |= (dots >> 4) & 1;
+                uint8_t dhgr_index = dots & 0xf; // index for first pixel
+                dots &= 0xfffffffc;
+                dots |= (dots >> 4) & 3;
+                dhgr_index |= (dots & 0xf)<<4;   // index for second pixel
+
+                // add 2 pixels
+                *(tmdsbuf_red++)   = tmds_dhgr_red[dhgr_index];
+                *(tmdsbuf_green++) = tmds_dhgr_green[dhgr_index];
+                *(tmdsbuf_blue++)  = tmds_dhgr_blue[dhgr_index];
+
+                dots &= 0xfffffff8;
+                dots |= (dots >> 4) & 7;
+                dhgr_index = dots & 0xf;         // index for third pixel
+                dots >>= 4;
+                dhgr_index |= (dots & 0xf)<<4;   // index for fourth pixel
+
+                // add 2 pixels
+                *(tmdsbuf_red++)   = tmds_dhgr_red[dhgr_index];
+                *(tmdsbuf_green++) = tmds_dhgr_green[dhgr_index];
+                *(tmdsbuf_blue++)  = tmds_dhgr_blue[dhgr_index];
+
+                dotc -= 4;
+            }
+        }
+    }
+    else
+    {
+        while(i < 40)
+        {
+            // Load in as many subpixels as possible
+            while((dotc <= 18) && (i < 40))
+            {
+                dots |= (line_memb[i] & 0x7f) << dotc;
+                dotc += 7;
+                dots |= (line_mema[i] & 0x7f) << dotc;
+                dotc += 7;
+                i++;
+            }
+
+            // Consume pixels
+            while(dotc >= 8)
+            {
+                // map HGR dot values to 16 color (RGB LORES) palette
+                uint32_t* pTmds = &tmds_lorescolor[tmds_dhgr_lores_mapping[dots&0xf]];
+                uint32_t r = pTmds[0];
+                uint32_t g = pTmds[1];
+                uint32_t b = pTmds[2];
+
+                // add 4 pixels (two double pixels)
+                ADD_TMDS_4PIXELS_RGB(tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue, r, g, b);
+                dots >>= 4;
+
+                // map HGR dot values to 16 color (LORES) palette
+                pTmds = &tmds_lorescolor[tmds_dhgr_lores_mapping[dots&0xf]];
+                dots >>= 4;
+
+                r = pTmds[0];
+                g = pTmds[1];
+                b = pTmds[2];
+
+                // add 4 pixels (two double pixels)
+                ADD_TMDS_4PIXELS_RGB(tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue, r, g, b);
+
+                dotc -= 8;
+            }
+        }
+    }
+}
+
+static void DELAYED_COPY_CODE(render_dhgr_line)(bool p2, uint line, bool mono)
+{
+    // send the cached line when the Apple II did not write to it (main or aux)
+    uint32_t key = render_cache_key(RENDER_CACHE_DHGR, p2, mono);
+    if ((!render_take_dirty_line(p2, line))&&(render_cache_valid(line, key)))
+    {
+        render_cache_send(line);
+        return;
+    }
+
+    // Construct scanline
+    uint32_t* tmdsbuf = render_cache_scanline(line, key);
+
+    const uint8_t *line_mema = (const uint8_t *)((p2 ? hgr_p2 : hgr_p1) + dhgr_line_to_mem_offset(line));
+    const uint8_t *line_memb = (const uint8_t *)((p2 ? hgr_p4 : hgr_p3) + dhgr_line_to_mem_offset(line));
+
+    // DHGR is weird. Video-7 just makes it weirder. Nuff said.
+    uint32_t dots = 0;
+    uint_fast8_t dotc = 0;
+    uint i = 0;
+
+    if((!mono) && IS_IFLAG(IFLAGS_VIDEO7) && ((soft_switches & (SOFTSW_80STORE | SOFTSW_80COL)) == SOFTSW_80STORE))
     {
         dvi_scanline_rgb560(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
 
@@ -159,7 +357,7 @@ static void DELAYED_COPY_CODE(render_dhgr_line)(bool p2, uint line, bool mono)
         }
     }
     else
-    if(IS_IFLAG(IFLAGS_VIDEO7) && ((soft_switches & SOFTSW_V7_MODE3) == SOFTSW_V7_MODE2))
+    if((!mono) && IS_IFLAG(IFLAGS_VIDEO7) && ((soft_switches & SOFTSW_V7_MODE3) == SOFTSW_V7_MODE2))
     {
         uint8_t color;
 
@@ -193,7 +391,7 @@ static void DELAYED_COPY_CODE(render_dhgr_line)(bool p2, uint line, bool mono)
         }
     }
     else
-    if(IS_IFLAG(IFLAGS_VIDEO7) && ((soft_switches & SOFTSW_V7_MODE3) == SOFTSW_V7_MODE1))
+    if((!mono) && IS_IFLAG(IFLAGS_VIDEO7) && ((soft_switches & SOFTSW_V7_MODE3) == SOFTSW_V7_MODE1))
     {
         dvi_scanline_rgb560(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
 
@@ -250,139 +448,10 @@ static void DELAYED_COPY_CODE(render_dhgr_line)(bool p2, uint line, bool mono)
             }
         }
     }
-#if 0
-    else
-    if((internal_flags & (IFLAGS_INTERP | IFLAGS_GRILL)) == (IFLAGS_INTERP | IFLAGS_GRILL))
-    {
-        // Preload black into the sliding window
-        dots = 0;
-        dotc = 4;
-
-        while(i < 40)
-        {
-            // Load in as many subpixels as possible
-            while((dotc <= 18) && (i < 40))
-            {
-                dots |= (line_memb[i] & 0x7f) << dotc;
-                dotc += 7;
-                dots |= (line_mema[i] & 0x7f) << dotc;
-                dotc += 7;
-                i++;
-            }
-
-            while((dotc >= 8) || ((dotc > 0) && (i == 40)))
-            {
-                dots &= 0xfffffffe;
-                dots |= (dots >> 4) & 1;
-                pixeldata = half_palette[dots & 0xf];
-                dots &= 0xfffffffc;
-                dots |= (dots >> 4) & 3;
-                pixeldata |= dhgr_palette[dots & 0xf] << 16;
-                sl->data[sl_pos++] = pixeldata;
-
-                dots &= 0xfffffff8;
-                dots |= (dots >> 4) & 7;
-                pixeldata = half_palette[dots & 0xf];
-                dots >>= 4;
-                pixeldata |= dhgr_palette[dots & 0xf] << 16;
-                sl->data[sl_pos++] = pixeldata;
-
-                dotc -= 4;
-            }
-        }
-    }
-#endif
-    else
-    if(IS_IFLAG(IFLAGS_INTERP_DHGR))
-    {
-        dvi_scanline_rgb560(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
-        // Preload black into the sliding window
-        dots = 0;
-        dotc = 4;
-
-        while(i < 40)
-        {
-            // Load in as many subpixels as possible
-            while((dotc <= 18) && (i < 40))
-            {
-                dots |= (line_memb[i] & 0x7f) << dotc;
-                dotc += 7;
-                dots |= (line_mema[i] & 0x7f) << dotc;
-                dotc += 7;
-                i++;
-            }
-
-            while((dotc >= 8) || ((dotc > 4) && (i == 40)))
-            {
-                dots &= 0xfffffffe;
-                dots |= (dots >> 4) & 1;
-                uint8_t dhgr_index = dots & 0xf; // index for first pixel
-                dots &= 0xfffffffc;
-                dots |= (dots >> 4) & 3;
-                dhgr_index |= (dots & 0xf)<<4;   // index for second pixel
-
-                // add 2 pixels
-                *(tmdsbuf_red++)   = tmds_dhgr_red[dhgr_index];
-                *(tmdsbuf_green++) = tmds_dhgr_green[dhgr_index];
-                *(tmdsbuf_blue++)  = tmds_dhgr_blue[dhgr_index];
-
-                dots &= 0xfffffff8;
-                dots |= (dots >> 4) & 7;
-                dhgr_index = dots & 0xf;         // index for third pixel
-                dots >>= 4;
-                dhgr_index |= (dots & 0xf)<<4;   // index for fourth pixel
-
-                // add 2 pixels
-                *(tmdsbuf_red++)   = tmds_dhgr_red[dhgr_index];
-                *(tmdsbuf_green++) = tmds_dhgr_green[dhgr_index];
-                *(tmdsbuf_blue++)  = tmds_dhgr_blue[dhgr_index];
-
-                dotc -= 4;
-            }
-        }
-    }
     else
     {
         dvi_scanline_rgb560(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
-        while(i < 40)
-        {
-            // Load in as many subpixels as possible
-            while((dotc <= 18) && (i < 40))
-            {
-                dots |= (line_memb[i] & 0x7f) << dotc;
-                dotc += 7;
-                dots |= (line_mema[i] & 0x7f) << dotc;
-                dotc += 7;
-                i++;
-            }
-
-            // Consume pixels
-            while(dotc >= 8)
-            {
-                // map HGR dot values to 16 color (RGB LORES) palette
-                uint32_t* pTmds = &tmds_lorescolor[tmds_dhgr_lores_mapping[dots&0xf]];
-                uint32_t r = pTmds[0];
-                uint32_t g = pTmds[1];
-                uint32_t b = pTmds[2];
-
-                // add 4 pixels (two double pixels)
-                ADD_TMDS_4PIXELS_RGB(tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue, r, g, b);
-                dots >>= 4;
-
-                // map HGR dot values to 16 color (LORES) palette
-                pTmds = &tmds_lorescolor[tmds_dhgr_lores_mapping[dots&0xf]];
-                dots >>= 4;
-
-                r = pTmds[0];
-                g = pTmds[1];
-                b = pTmds[2];
-
-                // add 4 pixels (two double pixels)
-                ADD_TMDS_4PIXELS_RGB(tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue, r, g, b);
-
-                dotc -= 8;
-            }
-        }
+        render_dhgr_bytes(line_mema, line_memb, mono, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
     }
 
     // send buffer
@@ -27,23 +27,35 @@ SOFTWARE.
 #include "applebus/buffers.h"
 #include "config/config.h"
 #include "render.h"
+#include "render_cache.h"
 #include "hires_dot_patterns.h"
+#ifdef FEATURE_A2C
+#include "a2c/a2c.h"
+#endif
 
 #define PAGE2SEL ((soft_switches & (SOFTSW_80STORE | SOFTSW_PAGE_2)) == SOFTSW_PAGE_2)
 
+#ifdef FEATURE_A2C
+//  A2C: tmds_hires_color_patterns stay in flash (TMDS_HIRES_DATA), the bytes are only rendered with
+//  the CS_A2DVI LUT loaded, the same table in RAM
+#define HIRES_PATTERNS_RED      s_hires_lut_red
+#define HIRES_PATTERNS_GREEN    s_hires_lut_green
+#define HIRES_PATTERNS_BLUE     s_hires_lut_blue
+#else
+#define HIRES_PATTERNS_RED      tmds_hires_color_patterns_red
+#define HIRES_PATTERNS_GREEN    tmds_hires_color_patterns_green
+#define HIRES_PATTERNS_BLUE     tmds_hires_color_patterns_blue
+#endif
+
 static inline uint hires_line_to_mem_offset(uint line)
 {
     return ((line & 0x07) << 10) | ((line & 0x38) << 4) | (((line & 0xc0) >> 6) * 40);
 }
 
-static void DELAYED_COPY_CODE(render_hires_line)(bool p2, uint line)
+//  Render the 40 bytes of a hires line into 280 pixel pairs, also used by the A2C with the bytes rebuilt from SEROUT
+void DELAYED_COPY_CODE(render_hires_bytes)(const uint8_t *line_mem, bool mono, uint32_t* tmdsbuf_red, uint32_t* tmdsbuf_green, uint32_t* tmdsbuf_blue)
 {
-    const uint8_t *line_mem = (const uint8_t *)((p2 ? hgr_p2 : hgr_p1) + hires_line_to_mem_offset(line));
-
-    dvi_get_scanline(tmdsbuf);
-    dvi_scanline_rgb560(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
-
-    if(mono_rendering)
+    if(mono)
     {
         uint32_t lastmsb = 0;
         uint_fast8_t dotc = 0;
@@ -108,14 +120,31 @@ static void DELAYED_COPY_CODE(render_hires_line)(bool p2, uint line)
             for(uint j=0; j < 7; j++)
             {
                 uint dot_pattern = oddness | ((dots >> 24) & 0xff);
-                *(tmdsbuf_red++)   = tmds_hires_color_patterns_red[dot_pattern];
-                *(tmdsbuf_green++) = tmds_hires_color_patterns_green[dot_pattern];
-                *(tmdsbuf_blue++)  = tmds_hires_color_patterns_blue[dot_pattern];
+                *(tmdsbuf_red++)   = HIRES_PATTERNS_RED[dot_pattern];
+                *(tmdsbuf_green++) = HIRES_PATTERNS_GREEN[dot_pattern];
+                *(tmdsbuf_blue++)  = HIRES_PATTERNS_BLUE[dot_pattern];
                 dots <<= 2;
                 oddness ^= 0x100;
             }
         }
     }
+}
+
+static void DELAYED_COPY_CODE(render_hires_line)(bool p2, uint line)
+{
+    // send the cached line when the Apple II did not write to it
+    uint32_t key = render_cache_key(RENDER_CACHE_HIRES, p2, 0);
+    if ((!render_take_dirty_line(p2, line))&&(render_cache_valid(line, key)))
+    {
+        render_cache_send(line);
+        return;
+    }
+
+    const uint8_t *line_mem = (const uint8_t *)((p2 ? hgr_p2 : hgr_p1) + hires_line_to_mem_offset(line));
+
+    uint32_t* tmdsbuf = render_cache_scanline(line, key);
+    dvi_scanline_rgb560(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
+    render_hires_bytes(line_mem, mono_rendering, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
 
     dvi_send_scanline(tmdsbuf);
 }
@@ -27,9 +27,10 @@ SOFTWARE.
 #include "applebus/buffers.h"
 #include "config/config.h"
 #include "render.h"
+#include "render_cache.h"
 
 // monochrome dot pattern: 14 dots (bits) per word
-uint16_t DELAYED_COPY_DATA(lores_dot_pattern)[16] =
+uint16_t RENDER_LUT_SMALL(lores_dot_pattern)[16] =
 {
     0x0000,
     0x1111,
@@ -75,11 +76,23 @@ void DELAYED_COPY_CODE(render_mixed_lores)()
 
 static void DELAYED_COPY_CODE(render_lores_line)(bool p2, uint line)
 {
+    // send the 8 cached scanlines when the Apple II did not write to this row
+    uint scanline = line*8;
+    uint32_t key = render_cache_key(RENDER_CACHE_LORES, p2, 0);
+    if ((!render_take_dirty_row(p2, line))&&(render_cache_valid(scanline+7, key))&&(render_cache_valid(scanline, key)))
+    {
+        for (uint i=0;i<8;i++)
+        {
+            render_cache_send(scanline+i);
+        }
+        return;
+    }
+
     // Construct two scanlines for the two different colored cells at the same time
-    dvi_get_scanline(tmdsbuf1);
+    uint32_t* tmdsbuf1 = render_cache_scanline(scanline, key);
     dvi_scanline_rgb560(tmdsbuf1, tmdsbuf1_red, tmdsbuf1_green, tmdsbuf1_blue);
 
-    dvi_get_scanline(tmdsbuf2);
+    uint32_t* tmdsbuf2 = render_cache_scanline(scanline+4, key);
     dvi_scanline_rgb560(tmdsbuf2, tmdsbuf2_red, tmdsbuf2_green, tmdsbuf2_blue);
 
     const uint8_t *line_buf = (const uint8_t *)((p2 ? text_p2 : text_p1) + ((line & 0x7) << 7) + (((line >> 3) & 0x3) * 40));
@@ -146,7 +159,7 @@ static void DELAYED_COPY_CODE(render_lores_line)(bool p2, uint line)
     // repeat this line 3 more times (4x in total)
     for (uint yrepeat=0;yrepeat<3;yrepeat++)
     {
-        dvi_get_scanline(tmdsbufRepeat);
+        uint32_t* tmdsbufRepeat = render_cache_scanline(scanline+1+yrepeat, key);
         dvi_copy_scanline(tmdsbufRepeat, tmdsbuf1);
         // send copied buffer
         dvi_send_scanline(tmdsbufRepeat);
@@ -157,7 +170,7 @@ static void DELAYED_COPY_CODE(render_lores_line)(bool p2, uint line)
     // repeat this line 3 more times (4x in total)
     for (uint yrepeat=0;yrepeat<3;yrepeat++)
     {
-        dvi_get_scanline(tmdsbufRepeat);
+        uint32_t* tmdsbufRepeat = render_cache_scanline(scanline+5+yrepeat, key);
         dvi_copy_scanline(tmdsbufRepeat, tmdsbuf2);
         // send copied buffer
         dvi_send_scanline(tmdsbufRepeat);
@@ -0,0 +1,195 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "applebus/buffers.h"
+#include "config/config.h"
+#include "render.h"
+
+#ifdef FEATURE_SHR
+
+/*  Apple IIgs super hires: 200 lines of 160 bytes, one scan line control byte
+    (SCB) per line selecting the 640 mode, color fill and one of 16 palettes of
+    16 colors (12 bit RGB).
+
+    The TMDS symbols must be perfectly balanced pixel pairs, so every super hires
+    pixel pair becomes one double pixel per channel:
+    - 320 mode: each pixel is a double pixel of its palette color,
+    - 640 mode: the two pixels of a pair are averaged (their colors come from
+      different quarters of the palette, so they are dithered colors anyway).
+    The double pixels of each palette are cached, and a palette is converted
+    again when the bus core has marked it as written ($9E00-$9FFF).
+*/
+
+#define SHR_LINES           200
+#define SHR_BYTES_PER_LINE  160
+#define SHR_SCB_640         0x80
+#define SHR_SCB_FILL        0x20
+
+// blank lines above and below the screen area (224 scanlines in total)
+#define SHR_BORDER_LINES    ((192+2*16-SHR_LINES)/2)
+
+// Balanced TMDS symbol pairs for 6 bit channel values (generated by libdvi's tmds_table_gen.py)
+static uint32_t RENDER_LUT(shr_tmds_table)[64] =
+{
+#include "tmds_table.h"
+};
+
+// TMDS double pixels (R,G,B) for the 16 colors of each palette (320 mode)
+static uint32_t RENDER_LUT_BSS(shr_tmds320)[16][16*3];
+
+// TMDS double pixels (R,G,B) for all 16 pairs of 640 mode pixels of each palette:
+// [0] pixels 0+1 of a byte (colors 8-11 and 12-15), [1] pixels 2+3 (colors 0-3 and 4-7)
+static uint32_t RENDER_LUT_BSS(shr_tmds640)[16][2][16*3];
+
+// sum: two 4 bit channel values
+static inline uint32_t shr_tmds_channel(uint32_t sum)
+{
+    return shr_tmds_table[(sum * 17) >> 3];
+}
+
+static void DELAYED_COPY_CODE(shr_palette_update)(uint32_t palette)
+{
+    const uint8_t* colors = &shr_memory[SHR_PALETTES + palette*32];
+    uint8_t r[16], g[16], b[16];
+
+    for (uint c=0;c<16;c++)
+    {
+        // color word: $0RGB, low byte first
+        r[c] = colors[c*2+1] & 0xf;
+        g[c] = colors[c*2] >> 4;
+        b[c] = colors[c*2] & 0xf;
+    }
+
+    uint32_t* pTmds = shr_tmds320[palette];
+    for (uint c=0;c<16;c++)
+    {
+        *(pTmds++) = shr_tmds_channel(2*r[c]);
+        *(pTmds++) = shr_tmds_channel(2*g[c]);
+        *(pTmds++) = shr_tmds_channel(2*b[c]);
+    }
+
+    for (uint half=0;half<2;half++)
+    {
+        uint left  = (half) ? 0 : 8;
+        pTmds = shr_tmds640[palette][half];
+        for (uint pair=0;pair<16;pair++)
+        {
+            uint c1 = left + (pair >> 2);
+            uint c2 = left + 4 + (pair & 3);
+            *(pTmds++) = shr_tmds_channel(r[c1] + r[c2]);
+            *(pTmds++) = shr_tmds_channel(g[c1] + g[c2]);
+            *(pTmds++) = shr_tmds_channel(b[c1] + b[c2]);
+        }
+    }
+}
+
+#define ADD_SHR_PIXEL(pTmds) { \
+    *(tmdsbuf_red++)   = (pTmds)[0]; \
+    *(tmdsbuf_green++) = (pTmds)[1]; \
+    *(tmdsbuf_blue++)  = (pTmds)[2]; \
+}
+
+static void DELAYED_COPY_CODE(render_shr_line)(uint line)
+{
+    const uint8_t* pixels = &shr_memory[line * SHR_BYTES_PER_LINE];
+    uint8_t scb = shr_memory[SHR_SCBS + line];
+    uint palette = scb & 0xf;
+
+    if (shr_palette_dirty[palette])
+    {
+        // clear first: a palette write during the update marks it again
+        shr_palette_dirty[palette] = 0;
+        shr_palette_update(palette);
+    }
+
+    dvi_get_scanline(tmdsbuf);
+    dvi_scanline_rgb640(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
+
+    if (scb & SHR_SCB_640)
+    {
+        const uint32_t* pairs01 = shr_tmds640[palette][0];
+        const uint32_t* pairs23 = shr_tmds640[palette][1];
+        for (uint i=0;i<SHR_BYTES_PER_LINE;i++)
+        {
+            uint32_t p = pixels[i];
+            ADD_SHR_PIXEL(&pairs01[(p >> 4)*3]);
+            ADD_SHR_PIXEL(&pairs23[(p & 0xf)*3]);
+        }
+    }
+    else
+    {
+        const uint32_t* colors = shr_tmds320[palette];
+        if (scb & SHR_SCB_FILL)
+        {
+            // color 0 repeats the color of the previous pixel
+            uint32_t last = 0;
+            for (uint i=0;i<SHR_BYTES_PER_LINE*2;i++)
+            {
+                uint32_t c = (i & 1) ? (pixels[i>>1] & 0xf) : (pixels[i>>1] >> 4);
+                if (c)
+                    last = c;
+                ADD_SHR_PIXEL(&colors[last*3]);
+            }
+        }
+        else
+        {
+            for (uint i=0;i<SHR_BYTES_PER_LINE;i++)
+            {
+                uint32_t p = pixels[i];
+                ADD_SHR_PIXEL(&colors[(p >> 4)*3]);
+                ADD_SHR_PIXEL(&colors[(p & 0xf)*3]);
+            }
+        }
+    }
+
+    dvi_send_scanline(tmdsbuf);
+}
+
+// Super hires needs 200 of the 224 scanlines, so there is no room for the status lines
+void DELAYED_COPY_CODE(render_shr_border)(void)
+{
+    for (uint row=0;row<SHR_BORDER_LINES;row++)
+    {
+        dvi_get_scanline(tmdsbuf);
+        dvi_scanline_rgb640(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
+        for (uint32_t x=0;x<320;x++)
+        {
+            *(tmdsbuf_red++)   = TMDS_SYMBOL_0_0;
+            *(tmdsbuf_green++) = TMDS_SYMBOL_0_0;
+            *(tmdsbuf_blue++)  = TMDS_SYMBOL_0_0;
+        }
+        dvi_send_scanline(tmdsbuf);
+    }
+}
+
+void DELAYED_COPY_CODE(render_shr)(void)
+{
+    for (uint line=0;line<SHR_LINES;line++)
+    {
+        render_shr_line(line);
+    }
+}
+
+#endif // FEATURE_SHR
@@ -28,6 +28,9 @@ SOFTWARE.
 #include "render.h"
 #include "menu/menu.h"
 #include "dvi/a2dvi.h"
+#ifdef FEATURE_A2C
+#include "a2c/a2c.h"
+#endif
 
 /*
  *
@@ -207,6 +210,11 @@ void DELAYED_COPY_CODE(render_splash)()
         update_text_flasher();
         splash_frames++;
 
+#ifdef FEATURE_A2C
+        // continue loading the hires color LUT in the background
+        a2c_lut_update();
+#endif
+
         if (bus_cycle_counter > 3*1000)
         {
             centerY(LINE_ACTIVITY, pStatus6502_5, PRINTMODE_FLASH);
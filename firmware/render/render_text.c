@@ -31,6 +31,7 @@ SOFTWARE.
 #include "config/config.h"
 
 #include "render.h"
+#include "render_cache.h"
 
 #define PAGE2SEL ((soft_switches & (SOFTSW_80STORE | SOFTSW_PAGE_2)) == SOFTSW_PAGE_2)
 
@@ -88,13 +89,28 @@ static inline uint_fast8_t char_text_bits(uint_fast8_t ch, uint_fast8_t glyph_li
     return (bits ^ invert) & 0x7f;
 }
 
-void DELAYED_COPY_CODE(render_text40_line)(const uint8_t *page, unsigned int line, uint8_t color_mode)
+// cache key of a text row (flashing characters are rendered differently for each flasher phase)
+static inline uint32_t text_cache_key(uint32_t renderer, bool page2, uint8_t color_mode)
+{
+    return render_cache_key(renderer, page2, (color_mode << 1) | (text_flasher_mask & 1));
+}
+
+// key 0: the row is not from a video page (status and debug lines), never cached
+static void DELAYED_COPY_CODE(render_text40_row)(const uint8_t *page, unsigned int line, uint8_t color_mode, uint32_t key)
 {
     const uint8_t *line_buf = (const uint8_t *)(page + ((line & 0x7) << 7) + (((line >> 3) & 0x3) * 40));
+    bool dirty = (key) ? render_take_dirty_row(page == (const uint8_t *)text_p2, line) : true;
 
     for(uint glyph_line=0; glyph_line < 8; glyph_line++)
     {
-        dvi_get_scanline(tmdsbuf);
+        uint scanline = line*8 + glyph_line;
+        if ((!dirty)&&(render_cache_valid(scanline, key)))
+        {
+            render_cache_send(scanline);
+            continue;
+        }
+
+        uint32_t* tmdsbuf = render_cache_scanline(scanline, key);
         dvi_scanline_rgb560(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
 
         for(uint col=0; col < 40; )
@@ -120,6 +136,11 @@ void DELAYED_COPY_CODE(render_text40_line)(const uint8_t *page, unsigned int lin
     }
 }
 
+void DELAYED_COPY_CODE(render_text40_line)(const uint8_t *page, unsigned int line, uint8_t color_mode)
+{
+    render_text40_row(page, line, color_mode, 0);
+}
+
 #define ADD_LORES_PIXEL(color3) { \
     uint32_t* pTmds = &tmds_lorescolor[color3]; \
     *(tmdsbuf_red++)   = *(pTmds++); \
@@ -132,10 +153,19 @@ void DELAYED_COPY_CODE(render_color_text40_line)(unsigned int line)
     const uint16_t xofs = ((line & 0x7) << 7) + (((line >> 3) & 0x3) * 40);
     const uint32_t *line_buf  = (const uint32_t *)(text_p1 + xofs);
     const uint32_t *color_buf = (const uint32_t *)(text_p3 + xofs);
+    uint32_t key = text_cache_key(RENDER_CACHE_COLORTEXT, false, 0);
+    bool dirty = render_take_dirty_row(false, line);
 
     for(uint glyph_line=0; glyph_line < 8; glyph_line++)
     {
-        dvi_get_scanline(tmdsbuf);
+        uint scanline = line*8 + glyph_line;
+        if ((!dirty)&&(render_cache_valid(scanline, key)))
+        {
+            render_cache_send(scanline);
+            continue;
+        }
+
+        uint32_t* tmdsbuf = render_cache_scanline(scanline, key);
         dvi_scanline_rgb560(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
 
         for(uint col=0; col < 10; col++)
@@ -167,6 +197,38 @@ void DELAYED_COPY_CODE(render_color_text40_line)(unsigned int line)
     }
 }
 
+// Render the columns [first, last) of a glyph line of render_color_text40_line into a scanline that
+// already holds a video line, for an overlay. With "shade" the background only covers every other
+// pixel pair, in a checkerboard, and the video shows through.
+void DELAYED_COPY_CODE(render_color_text40_span)(uint32_t* tmdsbuf, unsigned int line, unsigned int glyph_line, unsigned int first, unsigned int last, bool shade)
+{
+    const uint16_t xofs = ((line & 0x7) << 7) + (((line >> 3) & 0x3) * 40);
+    dvi_scanline_rgb(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
+
+    uint32_t pos = DVI_APPLE2_XOFS_560 + first * 7;
+    for(uint col=first; col < last; col++)
+    {
+        uint32_t bits = char_text_bits(text_p1[xofs + col], glyph_line);
+        uint8_t colors = text_p3[xofs + col];
+        const uint32_t* foreground = &tmds_lorescolor[((colors >> 4) & 0xf)*3];
+        const uint32_t* background = &tmds_lorescolor[((colors     ) & 0xf)*3];
+
+        for(int i=0; i < 7; i++, pos++)
+        {
+            const uint32_t* pTmds = foreground;
+            if ((bits & 1)==0)
+                pTmds = ((shade)&&((pos ^ glyph_line) & 1)) ? NULL : background;
+            if (pTmds)
+            {
+                tmdsbuf_red[pos]   = pTmds[0];
+                tmdsbuf_green[pos] = pTmds[1];
+                tmdsbuf_blue[pos]  = pTmds[2];
+            }
+            bits >>= 1;
+        }
+    }
+}
+
 void DELAYED_COPY_CODE(render_text80_line)(const uint8_t *page_a, const uint8_t *page_b, unsigned int line, uint8_t color_mode)
 {
     uint line_offset = ((line & 0x7) << 7) + (((line >> 3) & 0x3) * 40);
@@ -174,10 +236,20 @@ void DELAYED_COPY_CODE(render_text80_line)(const uint8_t *page_a, const uint8_t
     const uint8_t *line_buf_b = (const uint8_t *) (page_b + line_offset);
 
     uint8_t color_offset = color_mode*12;
+    bool page2 = (page_a == (const uint8_t *)text_p2);
+    uint32_t key = text_cache_key(RENDER_CACHE_TEXT80, page2, color_mode);
+    bool dirty = render_take_dirty_row(page2, line);
 
     for(uint glyph_line=0; glyph_line < 8; glyph_line++)
     {
-        dvi_get_scanline(tmdsbuf);
+        uint scanline = line*8 + glyph_line;
+        if ((!dirty)&&(render_cache_valid(scanline, key)))
+        {
+            render_cache_send(scanline);
+            continue;
+        }
+
+        uint32_t* tmdsbuf = render_cache_scanline(scanline, key);
         dvi_scanline_rgb560(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
 
         for(uint col=0; col < 40;)
@@ -234,9 +306,10 @@ void DELAYED_COPY_CODE(render_mixed_text)()
         else
         {
             // 40 column mode rendering
+            uint32_t key = text_cache_key(RENDER_CACHE_TEXT40, page2, cmode);
             for(uint line=20; line < 24; line++)
             {
-                render_text40_line(pageA, line, cmode);
+                render_text40_row(pageA, line, cmode, key);
             }
         }
     }
@@ -277,9 +350,10 @@ void DELAYED_COPY_CODE(render_text)()
         else
         {
             // 40 column mode rendering
+            uint32_t key = text_cache_key(RENDER_CACHE_TEXT40, page2, color_mode);
             for(uint line=0; line < 24; line++)
             {
-                render_text40_line(pageA, line, color_mode);
+                render_text40_row(pageA, line, color_mode, key);
             }
         }
     }
@@ -0,0 +1,60 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+//  TinyUSB configuration of the A2C screenshot, stream and text firmware (FEATURE_A2C_USB): the CDC
+//  interface and, with FEATURE_A2C_SCREENSHOT, the read only mass storage disk of usb/usb_msc.c.
+//  The other firmware variants use the configuration of pico_stdio_usb.
+
+#define CFG_TUSB_RHPORT0_MODE   (OPT_MODE_DEVICE)
+
+#define CFG_TUD_ENDPOINT0_SIZE  64
+
+#define CFG_TUD_CDC             1
+#ifdef FEATURE_A2C_SCREENSHOT
+#define CFG_TUD_MSC             1
+#else
+#define CFG_TUD_MSC             0
+#endif
+#define CFG_TUD_HID             0
+#define CFG_TUD_MIDI            0
+#define CFG_TUD_VENDOR          0
+
+#define CFG_TUD_CDC_RX_BUFSIZE  256
+#ifdef FEATURE_A2C_STREAM
+//  Bytes of the stream sent per transfer (a2c/a2c_stream.h), tud_task runs once per frame
+#define CFG_TUD_CDC_TX_BUFSIZE  2048
+#define CFG_TUD_CDC_EP_BUFSIZE  2048
+#elif defined(FEATURE_A2C_TEXT)
+//  A text snapshot (a2c/a2c_text.h) fits at once
+#define CFG_TUD_CDC_TX_BUFSIZE  2048
+#define CFG_TUD_CDC_EP_BUFSIZE  64
+#else
+#define CFG_TUD_CDC_TX_BUFSIZE  256
+#define CFG_TUD_CDC_EP_BUFSIZE  64
+#endif
+
+//  Bytes read from the disk per transfer, tud_task runs once per frame
+#define CFG_TUD_MSC_EP_BUFSIZE  2048
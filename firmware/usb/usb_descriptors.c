@@ -0,0 +1,155 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <pico/stdlib.h>
+#include "config/config.h"
+
+#if defined(FEATURE_A2C) && defined(FEATURE_A2C_USB)
+
+#include <pico/unique_id.h>
+#include "tusb.h"
+
+//  USB descriptors of the A2C screenshot and stream firmware: the CDC interface (like pico_stdio_usb)
+//  and the mass storage disk of usb_msc.c (FEATURE_A2C_SCREENSHOT)
+
+#define USBD_VID            0x2E8A              //  Raspberry Pi
+#define USBD_PID            0x000A              //  Raspberry Pi Pico SDK CDC
+#define USBD_BCD_DEVICE     0x0110              //  not the stdio_usb device, the host reads the interfaces again
+
+#define USBD_MAX_POWER_MA   250
+
+enum
+{
+    ITF_NUM_CDC = 0,
+    ITF_NUM_CDC_DATA,
+#ifdef FEATURE_A2C_SCREENSHOT
+    ITF_NUM_MSC,
+#endif
+    ITF_NUM_TOTAL
+};
+
+#define EPNUM_CDC_NOTIF     0x81
+#define EPNUM_CDC_OUT       0x02
+#define EPNUM_CDC_IN        0x82
+#define EPNUM_MSC_OUT       0x03
+#define EPNUM_MSC_IN        0x83
+
+#define USBD_CDC_CMD_MAX_SIZE   8
+#define USBD_CDC_IN_OUT_MAX_SIZE 64
+#define USBD_MSC_IN_OUT_MAX_SIZE 64
+
+#ifdef FEATURE_A2C_SCREENSHOT
+#define USBD_DESC_LEN       (TUD_CONFIG_DESC_LEN + TUD_CDC_DESC_LEN + TUD_MSC_DESC_LEN)
+#else
+#define USBD_DESC_LEN       (TUD_CONFIG_DESC_LEN + TUD_CDC_DESC_LEN)
+#endif
+
+enum
+{
+    USBD_STR_LANGUAGE = 0,
+    USBD_STR_MANUF,
+    USBD_STR_PRODUCT,
+    USBD_STR_SERIAL,
+    USBD_STR_CDC,
+    USBD_STR_MSC,
+    USBD_STR_COUNT
+};
+
+static const tusb_desc_device_t DELAYED_COPY_DATA(s_device_descriptor) =
+{
+    .bLength            = sizeof(tusb_desc_device_t),
+    .bDescriptorType    = TUSB_DESC_DEVICE,
+    .bcdUSB             = 0x0200,
+    .bDeviceClass       = TUSB_CLASS_MISC,
+    .bDeviceSubClass    = MISC_SUBCLASS_COMMON,
+    .bDeviceProtocol    = MISC_PROTOCOL_IAD,
+    .bMaxPacketSize0    = CFG_TUD_ENDPOINT0_SIZE,
+    .idVendor           = USBD_VID,
+    .idProduct          = USBD_PID,
+    .bcdDevice          = USBD_BCD_DEVICE,
+    .iManufacturer      = USBD_STR_MANUF,
+    .iProduct           = USBD_STR_PRODUCT,
+    .iSerialNumber      = USBD_STR_SERIAL,
+    .bNumConfigurations = 1,
+};
+
+static const uint8_t DELAYED_COPY_DATA(s_config_descriptor)[USBD_DESC_LEN] =
+{
+    TUD_CONFIG_DESCRIPTOR(1, ITF_NUM_TOTAL, 0, USBD_DESC_LEN, 0, USBD_MAX_POWER_MA),
+    TUD_CDC_DESCRIPTOR(ITF_NUM_CDC, USBD_STR_CDC, EPNUM_CDC_NOTIF, USBD_CDC_CMD_MAX_SIZE,
+                       EPNUM_CDC_OUT, EPNUM_CDC_IN, USBD_CDC_IN_OUT_MAX_SIZE),
+#ifdef FEATURE_A2C_SCREENSHOT
+    TUD_MSC_DESCRIPTOR(ITF_NUM_MSC, USBD_STR_MSC, EPNUM_MSC_OUT, EPNUM_MSC_IN, USBD_MSC_IN_OUT_MAX_SIZE),
+#endif
+};
+
+static const char* const DELAYED_COPY_DATA(s_strings)[USBD_STR_COUNT] =
+{
+    [USBD_STR_MANUF]   = "Far Left Lane",
+    [USBD_STR_PRODUCT] = "A2C DVI",
+    [USBD_STR_SERIAL]  = NULL,                  //  the board id
+    [USBD_STR_CDC]     = "A2C DVI Board CDC",
+    [USBD_STR_MSC]     = "A2C DVI Screenshot",
+};
+
+const uint8_t* DELAYED_COPY_CODE(tud_descriptor_device_cb)(void)
+{
+    return (const uint8_t*) &s_device_descriptor;
+}
+
+const uint8_t* DELAYED_COPY_CODE(tud_descriptor_configuration_cb)(__unused uint8_t index)
+{
+    return s_config_descriptor;
+}
+
+const uint16_t* DELAYED_COPY_CODE(tud_descriptor_string_cb)(uint8_t index, __unused uint16_t langid)
+{
+    static uint16_t descriptor[33];             //  header and up to 32 UTF-16 characters
+    char serial[2 * PICO_UNIQUE_BOARD_ID_SIZE_BYTES + 1];
+    uint len;
+
+    if (index == USBD_STR_LANGUAGE)
+    {
+        descriptor[1] = 0x0409;                 //  English
+        len = 1;
+    }
+    else if (index < USBD_STR_COUNT)
+    {
+        const char* text = s_strings[index];
+        if (index == USBD_STR_SERIAL)
+        {
+            pico_get_unique_board_id_string(serial, sizeof(serial));
+            text = serial;
+        }
+        for (len = 0; (len < 32) && (text[len]); len++)
+            descriptor[1 + len] = text[len];
+    }
+    else
+        return NULL;
+
+    descriptor[0] = (TUSB_DESC_STRING << 8) | (2 * len + 2);
+    return descriptor;
+}
+
+#endif
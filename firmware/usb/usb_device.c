@@ -0,0 +1,53 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <pico/stdlib.h>
+#include "config/config.h"
+#include "usb_device.h"
+
+#if defined(FEATURE_A2C) && defined(FEATURE_A2C_USB)
+
+#include <pico/bootrom.h>
+#include <pico/stdio_usb.h>
+#include "tusb.h"
+
+void DELAYED_COPY_CODE(usb_device_init)(void)
+{
+    //  Before stdio_init_all, which expects the device stack to be running when the application uses TinyUSB
+    tusb_init();
+}
+
+void DELAYED_COPY_CODE(usb_device_task)(void)
+{
+    tud_task();
+}
+
+//  Reboot to BOOTSEL at the magic baud rate, stdio_usb leaves this to an application using TinyUSB
+void DELAYED_COPY_CODE(tud_cdc_line_coding_cb)(__unused uint8_t itf, cdc_line_coding_t const* p_line_coding)
+{
+    if (p_line_coding->bit_rate == PICO_STDIO_USB_RESET_MAGIC_BAUD_RATE)
+        reset_usb_boot(0, 0);
+}
+
+#endif
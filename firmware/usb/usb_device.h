@@ -0,0 +1,38 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+/*  USB device of the A2C firmware (FEATURE_A2C_USB: the screenshot disk and/or the live stream)
+
+    The firmware runs the TinyUSB device stack itself, with the descriptors of usb_descriptors.c
+    and tusb_config.h: the CDC interface (stdio_usb, or the stream of a2c/a2c_stream.h) and
+    the mass storage disk of usb_msc.h.
+
+    The render core runs the device stack (tud_task) once per frame, in the vertical blank
+    after the flash writes of the frame, so the disk is never read while the flash is programmed.
+*/
+
+void usb_device_init (void);
+void usb_device_task (void);
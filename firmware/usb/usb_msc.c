@@ -0,0 +1,219 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <string.h>
+#include <pico/stdlib.h>
+#include "config/config.h"
+#include "usb_msc.h"
+
+#if defined(FEATURE_A2C) && defined(FEATURE_A2C_SCREENSHOT)
+
+#include "tusb.h"
+#include "a2c/a2c_screenshot.h"
+
+extern uint8_t __screenshot_data_start[];
+
+#define DIR_ENTRY_SIZE  32
+#define FAT_DATE        ((45 << 9) | (1 << 5) | 1)      //  2025-01-01, the screenshot has no date
+
+static const uint8_t DELAYED_COPY_DATA(s_boot_sector)[62] =
+{
+    0xEB, 0x3C, 0x90,                                   //  jump
+    'M', 'S', 'D', 'O', 'S', '5', '.', '0',
+    USB_MSC_SECTOR_SIZE & 0xff, USB_MSC_SECTOR_SIZE >> 8,
+    USB_MSC_CLUSTER_SECTORS,
+    USB_MSC_FAT_LBA, 0x00,                              //  reserved sectors
+    0x01,                                               //  FATs
+    (USB_MSC_SECTOR_SIZE / DIR_ENTRY_SIZE) & 0xff, 0x00,    //  root directory entries, one sector
+    USB_MSC_SECTORS & 0xff, USB_MSC_SECTORS >> 8,
+    0xF8,                                               //  fixed disk
+    USB_MSC_ROOT_LBA - USB_MSC_FAT_LBA, 0x00,           //  sectors per FAT
+    0x01, 0x00,                                         //  sectors per track
+    0x01, 0x00,                                         //  heads
+    0x00, 0x00, 0x00, 0x00,                             //  hidden sectors
+    0x00, 0x00, 0x00, 0x00,                             //  32 bit sector count
+    0x80, 0x00, 0x29,                                   //  drive, reserved, extended boot signature
+    0x43, 0x32, 0x41, 0x53,                             //  volume id
+    'A', '2', 'C', ' ', 'D', 'V', 'I', ' ', ' ', ' ', ' ',
+    'F', 'A', 'T', '1', '2', ' ', ' ', ' '
+};
+
+static uint32_t s_disk_time = 0;                        //  a2c_screenshot_header_t.time the host knows about
+
+//  Size of SCREEN.QOI, 0 when there is no screenshot
+static uint32_t DELAYED_COPY_CODE(screen_file_size)(void)
+{
+    const a2c_screenshot_header_t* header = a2c_screenshot_saved();
+    if ((header == NULL) || (header->data_bytes > USB_MSC_CLUSTERS * USB_MSC_CLUSTER_SECTORS * USB_MSC_SECTOR_SIZE))
+        return 0;
+    return header->data_bytes;
+}
+
+static void DELAYED_COPY_CODE(fat12_set)(uint8_t* fat, uint32_t cluster, uint32_t value)
+{
+    uint8_t* p = fat + cluster + cluster / 2;
+    if (cluster & 1)
+    {
+        p[0] = (p[0] & 0x0f) | ((value << 4) & 0xf0);
+        p[1] = value >> 4;
+    }
+    else
+    {
+        p[0] = value;
+        p[1] = (p[1] & 0xf0) | ((value >> 8) & 0x0f);
+    }
+}
+
+static void DELAYED_COPY_CODE(dir_entry)(uint8_t* entry, const char* name, uint8_t attributes, uint16_t cluster, uint32_t size)
+{
+    memcpy(entry, name, 11);
+    entry[11] = attributes;
+    entry[16] = entry[24] = FAT_DATE & 0xff;            //  created, written
+    entry[17] = entry[25] = FAT_DATE >> 8;
+    entry[18] = FAT_DATE & 0xff;                        //  accessed
+    entry[19] = FAT_DATE >> 8;
+    entry[26] = cluster;
+    entry[27] = cluster >> 8;
+    entry[28] = size;
+    entry[29] = size >> 8;
+    entry[30] = size >> 16;
+    entry[31] = size >> 24;
+}
+
+//  Reads "size" bytes at "offset" of a sector
+static void DELAYED_COPY_CODE(disk_read)(uint32_t lba, uint32_t offset, uint8_t* out, uint32_t size)
+{
+    uint32_t file_size = screen_file_size();
+
+    if (lba >= USB_MSC_DATA_LBA)
+    {
+        uint32_t position = (lba - USB_MSC_DATA_LBA) * USB_MSC_SECTOR_SIZE + offset;
+        uint32_t count = (position < file_size) ? MIN(size, file_size - position) : 0;
+        memcpy(out, __screenshot_data_start + A2C_SCREENSHOT_PAGE_SIZE + position, count);
+        memset(out + count, 0, size - count);
+        return;
+    }
+
+    uint8_t sector[USB_MSC_SECTOR_SIZE];
+    memset(sector, 0, sizeof(sector));
+
+    if (lba == 0)
+    {
+        memcpy(sector, s_boot_sector, sizeof(s_boot_sector));
+        sector[510] = 0x55;
+        sector[511] = 0xAA;
+    }
+    else if (lba == USB_MSC_FAT_LBA)
+    {
+        fat12_set(sector, 0, 0xFF8);
+        fat12_set(sector, 1, 0xFFF);
+
+        //  SCREEN.QOI is one chain from cluster 2 on
+        uint32_t clusters = (file_size + USB_MSC_CLUSTER_SECTORS * USB_MSC_SECTOR_SIZE - 1) / (USB_MSC_CLUSTER_SECTORS * USB_MSC_SECTOR_SIZE);
+        for (uint32_t i = 0; i < clusters; i++)
+            fat12_set(sector, 2 + i, (i + 1 < clusters) ? 3 + i : 0xFFF);
+    }
+    else
+    {
+        dir_entry(sector, "A2C DVI    ", 0x08, 0, 0);  //  volume label
+        if (file_size)
+            dir_entry(sector + DIR_ENTRY_SIZE, "SCREEN  QOI", 0x01, 2, file_size);
+    }
+
+    memcpy(out, sector + offset, size);
+}
+
+void DELAYED_COPY_CODE(tud_msc_inquiry_cb)(__unused uint8_t lun, uint8_t vendor_id[8], uint8_t product_id[16], uint8_t product_rev[4])
+{
+    memcpy(vendor_id, "A2DVI   ", 8);
+    memcpy(product_id, "A2C SCREENSHOT  ", 16);
+    memcpy(product_rev, "1.0 ", 4);
+}
+
+bool DELAYED_COPY_CODE(tud_msc_test_unit_ready_cb)(uint8_t lun)
+{
+    const a2c_screenshot_header_t* header = a2c_screenshot_saved();
+    uint32_t time = header ? header->time : 0;
+
+    if (time != s_disk_time)
+    {
+        //  A new screenshot (or none while it is taken), the host reads the directory again
+        s_disk_time = time;
+        tud_msc_set_sense(lun, SCSI_SENSE_UNIT_ATTENTION, 0x28, 0x00);
+        return false;
+    }
+    return true;
+}
+
+void DELAYED_COPY_CODE(tud_msc_capacity_cb)(__unused uint8_t lun, uint32_t* block_count, uint16_t* block_size)
+{
+    *block_count = USB_MSC_SECTORS;
+    *block_size  = USB_MSC_SECTOR_SIZE;
+}
+
+bool DELAYED_COPY_CODE(tud_msc_start_stop_cb)(__unused uint8_t lun, __unused uint8_t power_condition, __unused bool start, __unused bool load_eject)
+{
+    return true;
+}
+
+bool DELAYED_COPY_CODE(tud_msc_is_writable_cb)(__unused uint8_t lun)
+{
+    return false;
+}
+
+int32_t DELAYED_COPY_CODE(tud_msc_read10_cb)(__unused uint8_t lun, uint32_t lba, uint32_t offset, void* buffer, uint32_t bufsize)
+{
+    if (lba >= USB_MSC_SECTORS)
+        return -1;
+
+    uint8_t* out = buffer;
+    uint32_t left = bufsize;
+    while ((left > 0) && (lba < USB_MSC_SECTORS))
+    {
+        uint32_t size = MIN(left, USB_MSC_SECTOR_SIZE - offset);
+        disk_read(lba, offset, out, size);
+        out += size;
+        left -= size;
+        offset = 0;
+        lba++;
+    }
+    return bufsize - left;
+}
+
+int32_t DELAYED_COPY_CODE(tud_msc_write10_cb)(uint8_t lun, __unused uint32_t lba, __unused uint32_t offset, __unused uint8_t* buffer, __unused uint32_t bufsize)
+{
+    tud_msc_set_sense(lun, SCSI_SENSE_DATA_PROTECT, 0x27, 0x00);
+    return -1;
+}
+
+int32_t DELAYED_COPY_CODE(tud_msc_scsi_cb)(uint8_t lun, uint8_t const scsi_cmd[16], __unused void* buffer, __unused uint16_t bufsize)
+{
+    if (scsi_cmd[0] == SCSI_CMD_PREVENT_ALLOW_MEDIUM_REMOVAL)
+        return 0;
+
+    tud_msc_set_sense(lun, SCSI_SENSE_ILLEGAL_REQUEST, 0x20, 0x00);
+    return -1;
+}
+
+#endif
@@ -0,0 +1,43 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+/*  USB mass storage disk of the A2C screenshot (FEATURE_A2C_SCREENSHOT builds only)
+
+    A read only FAT12 disk "A2C DVI" with the file SCREEN.QOI, the last screenshot in the
+    FLASH_SCREENSHOT area (a2c/a2c_screenshot.h), next to the stdio CDC interface. The
+    sectors are made up when the host reads them. The host is told that the medium changed
+    when a screenshot is started and when it is complete.
+
+    The disk is served by the device stack of usb_device.h, never while the flash is programmed.
+*/
+
+#define USB_MSC_SECTOR_SIZE         512
+#define USB_MSC_CLUSTER_SECTORS     8
+#define USB_MSC_CLUSTERS            64              //  256KB, the FLASH_SCREENSHOT area
+#define USB_MSC_FAT_LBA             1
+#define USB_MSC_ROOT_LBA            2
+#define USB_MSC_DATA_LBA            3
+#define USB_MSC_SECTORS             (USB_MSC_DATA_LBA + USB_MSC_CLUSTERS * USB_MSC_CLUSTER_SECTORS)
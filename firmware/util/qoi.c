@@ -0,0 +1,140 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <string.h>
+#include <pico.h>
+#include "qoi.h"
+
+#define QOI_OP_INDEX    0x00
+#define QOI_OP_DIFF     0x40
+#define QOI_OP_LUMA     0x80
+#define QOI_OP_RUN      0xc0
+#define QOI_OP_RGB      0xfe
+
+#define QOI_MAX_RUN     62
+#define QOI_ALPHA       0xff000000
+
+static inline uint32_t qoi_put32(uint8_t* out, uint32_t value)
+{
+    out[0] = value >> 24;
+    out[1] = value >> 16;
+    out[2] = value >> 8;
+    out[3] = value;
+    return 4;
+}
+
+uint32_t __time_critical_func(qoi_encode_begin)(qoi_encoder_t* encoder, uint32_t width, uint32_t height, uint8_t* out)
+{
+    memset(encoder->index, 0, sizeof(encoder->index));
+    encoder->previous = QOI_ALPHA;                      //  black
+    encoder->run = 0;
+
+    memcpy(out, "qoif", 4);
+    qoi_put32(out + 4, width);
+    qoi_put32(out + 8, height);
+    out[12] = 3;                                        //  RGB
+    out[13] = 0;                                        //  sRGB with linear alpha
+    return QOI_HEADER_SIZE;
+}
+
+uint32_t __time_critical_func(qoi_encode_pixels)(qoi_encoder_t* encoder, const uint8_t* rgb, uint32_t count, uint8_t* out)
+{
+    uint8_t* p = out;
+    uint32_t previous = encoder->previous;
+    uint32_t run = encoder->run;
+
+    for (uint32_t i = 0; i < count; i++, rgb += 3)
+    {
+        uint32_t pixel = rgb[0] | (rgb[1] << 8) | (rgb[2] << 16) | QOI_ALPHA;
+
+        if (pixel == previous)
+        {
+            if (++run == QOI_MAX_RUN)
+            {
+                *(p++) = QOI_OP_RUN | (run - 1);
+                run = 0;
+            }
+            continue;
+        }
+
+        if (run)
+        {
+            *(p++) = QOI_OP_RUN | (run - 1);
+            run = 0;
+        }
+
+        uint32_t hash = (rgb[0] * 3 + rgb[1] * 5 + rgb[2] * 7 + 255 * 11) & 63;
+        if (encoder->index[hash] == pixel)
+        {
+            *(p++) = QOI_OP_INDEX | hash;
+        }
+        else
+        {
+            encoder->index[hash] = pixel;
+
+            int8_t dr = (int8_t) (rgb[0] - (uint8_t) previous);
+            int8_t dg = (int8_t) (rgb[1] - (uint8_t) (previous >> 8));
+            int8_t db = (int8_t) (rgb[2] - (uint8_t) (previous >> 16));
+            int8_t dr_dg = dr - dg;
+            int8_t db_dg = db - dg;
+
+            if ((dr >= -2) && (dr <= 1) && (dg >= -2) && (dg <= 1) && (db >= -2) && (db <= 1))
+            {
+                *(p++) = QOI_OP_DIFF | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2);
+            }
+            else if ((dg >= -32) && (dg <= 31) && (dr_dg >= -8) && (dr_dg <= 7) && (db_dg >= -8) && (db_dg <= 7))
+            {
+                *(p++) = QOI_OP_LUMA | (dg + 32);
+                *(p++) = ((dr_dg + 8) << 4) | (db_dg + 8);
+            }
+            else
+            {
+                *(p++) = QOI_OP_RGB;
+                *(p++) = rgb[0];
+                *(p++) = rgb[1];
+                *(p++) = rgb[2];
+            }
+        }
+        previous = pixel;
+    }
+
+    encoder->previous = previous;
+    encoder->run = run;
+    return p - out;
+}
+
+uint32_t __time_critical_func(qoi_encode_end)(qoi_encoder_t* encoder, uint8_t* out)
+{
+    uint8_t* p = out;
+
+    if (encoder->run)
+    {
+        *(p++) = QOI_OP_RUN | (encoder->run - 1);
+        encoder->run = 0;
+    }
+
+    static const uint8_t end_marker[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+    memcpy(p, end_marker, sizeof(end_marker));
+    return (p - out) + sizeof(end_marker);
+}
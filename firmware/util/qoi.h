@@ -0,0 +1,54 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+/*  Streaming QOI image encoder ("The Quite OK Image Format", qoiformat.org)
+
+    Encodes 8 bit RGB pixels (3 channels, sRGB) in any number of parts, so an image can
+    be encoded a few lines at a time into a small output buffer. The output is the same
+    as the one of the reference encoder, checked on the host by tools/qoi_check.py.
+
+    qoi_encode_begin writes the header, qoi_encode_pixels encodes the next pixels, left
+    to right and top to bottom, and qoi_encode_end closes a pending run and writes the
+    end marker. Each returns the number of bytes written to "out", which must have room
+    for QOI_HEADER_SIZE, QOI_PIXELS_MAX(count) and QOI_END_MAX bytes.
+*/
+
+#define QOI_HEADER_SIZE         14
+#define QOI_END_MAX             (1 + 8)                 //  pending run and the end marker
+#define QOI_PIXELS_MAX(count)   (1 + (count) * 4)       //  pending run, then QOI_OP_RGB for every pixel
+
+typedef struct
+{
+    uint32_t index[64];         //  recently seen pixels, alpha (255) in bits 24-31
+    uint32_t previous;
+    uint32_t run;
+} qoi_encoder_t;
+
+uint32_t qoi_encode_begin   (qoi_encoder_t* encoder, uint32_t width, uint32_t height, uint8_t* out);
+uint32_t qoi_encode_pixels  (qoi_encoder_t* encoder, const uint8_t* rgb, uint32_t count, uint8_t* out);
+uint32_t qoi_encode_end     (qoi_encoder_t* encoder, uint8_t* out);
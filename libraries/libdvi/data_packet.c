@@ -20,7 +20,9 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
-#ifdef FEATURE_A2_AUDIO
+#include "dvi_config_defs.h"
+
+#if DVI_DATA_ISLAND
 
 #include "data_packet.h"
 #include <string.h>
@@ -351,7 +353,7 @@ void __not_in_flash_func(set_audio_info_frame)(data_packet_t *data_packet, int f
 }
 
 void __not_in_flash_func(set_AVI_info_frame)(data_packet_t *data_packet, scan_info s, pixel_format y, colorimetry c, picture_aspect_ratio m,
-    active_format_aspect_ratio r, RGB_quantization_range q, video_code vic) {
+    active_format_aspect_ratio r, RGB_quantization_range q, it_content_type cn, video_code vic) {
     set_null_data_packet(data_packet);
     data_packet->header[0] = 0x82;
     data_packet->header[1] = 2;  // version
@@ -362,8 +364,9 @@ void __not_in_flash_func(set_AVI_info_frame)(data_packet_t *data_packet, scan_in
 
     data_packet->subpacket[0][1] = (int)(s) | (r == ACTIVE_FORMAT_ASPECT_RATIO_NO_DATA ? 0 : 16) | ((int)(y) << 5);
     data_packet->subpacket[0][2] = (int)(r) | ((int)(m) << 4) | ((int)(c) << 6);
-    data_packet->subpacket[0][3] = sc | ((int)(q) << 2);
+    data_packet->subpacket[0][3] = sc | ((int)(q) << 2) | (cn == IT_CONTENT_NO_DATA ? 0 : 0x80);    // ITC
     data_packet->subpacket[0][4] = (int)(vic);
+    data_packet->subpacket[0][5] = (cn == IT_CONTENT_NO_DATA ? 0 : ((int)(cn) << 4));                  // CN1:0
 
     compute_info_frame_checkSum(data_packet);
     compute_parity(data_packet);
@@ -383,4 +386,4 @@ void __not_in_flash_func(encode_data_packet)(data_island_stream_t *dst, const da
     dst->data[2][N_DATA_ISLAND_WORDS - 1] = dataGaurdbandSym_;
 }
 
-#endif      //  FEATURE_A2_AUDIO
\ No newline at end of file
+#endif      //  DVI_DATA_ISLAND
\ No newline at end of file
@@ -60,6 +60,14 @@ typedef enum {
     FULL
 } RGB_quantization_range;
 
+typedef enum {
+    IT_CONTENT_NO_DATA = -1,
+    IT_CONTENT_GRAPHICS,
+    IT_CONTENT_PHOTO,
+    IT_CONTENT_CINEMA,
+    IT_CONTENT_GAME
+} it_content_type;
+
 typedef enum {
     _640x480P60 = 1,
     _720x480P60 = 2,
@@ -89,7 +97,7 @@ int  set_audio_samples(data_packet_t *data_packet, const int16_t* samples, int n
 void set_audio_clock_regeneration(data_packet_t *data_packet, int CTS, int N);
 void set_audio_info_frame(data_packet_t *data_packet, int freq);
 void set_AVI_info_frame(data_packet_t *data_packet, scan_info s, pixel_format y, colorimetry c, picture_aspect_ratio m,
-    active_format_aspect_ratio r, RGB_quantization_range q, video_code vic);
+    active_format_aspect_ratio r, RGB_quantization_range q, it_content_type cn, video_code vic);
 
 // Public Functions
 extern uint32_t defaultDataPacket12_[N_DATA_ISLAND_WORDS];
@@ -31,9 +31,9 @@ void __dvi_func(dvi_init)(struct dvi_inst *inst, uint spinlock_tmds_queue, uint
     inst->timing_state.v_ctr  = 0;
 	inst->data_island_is_enabled = false;
 	inst->audio_enabled = false;
-#ifdef FEATURE_A2_AUDIO
+#if DVI_DATA_ISLAND
     inst->dvi_frame_count = 0;
-    dvi_audio_init(inst);
+    dvi_data_island_init(inst);
 #endif
 
 	dvi_timing_state_init(&inst->timing_state);
@@ -49,8 +49,11 @@ void __dvi_func(dvi_init)(struct dvi_inst *inst, uint spinlock_tmds_queue, uint
 	inst->scanline_errors = 0;
 	inst->tmds_buf_release_next = NULL;
 	inst->tmds_buf_release = NULL;
-	queue_init_with_spinlock(&inst->q_tmds_valid,   sizeof(void*),  8, spinlock_tmds_queue);
-	queue_init_with_spinlock(&inst->q_tmds_free,    sizeof(void*),  8, spinlock_tmds_queue);
+	inst->tmds_pinned_start = NULL;
+	inst->tmds_pinned_end = NULL;
+	inst->scanline_callback = NULL;
+	queue_init_with_spinlock(&inst->q_tmds_valid,   sizeof(void*),  DVI_N_TMDS_BUFFERS, spinlock_tmds_queue);
+	queue_init_with_spinlock(&inst->q_tmds_free,    sizeof(void*),  DVI_N_TMDS_BUFFERS, spinlock_tmds_queue);
 #if 0
 	queue_init_with_spinlock(&inst->q_colour_valid, sizeof(void*),  8, spinlock_colour_queue);
 	queue_init_with_spinlock(&inst->q_colour_free,  sizeof(void*),  8, spinlock_colour_queue);
@@ -60,7 +63,7 @@ void __dvi_func(dvi_init)(struct dvi_inst *inst, uint spinlock_tmds_queue, uint
 	dvi_setup_scanline_for_vblank(inst->timing, inst->dma_cfg, false, &inst->dma_list_vblank_nosync);
 	dvi_setup_scanline_for_active(inst->timing, inst->dma_cfg, (void*)SRAM_BASE, &inst->dma_list_active, false);
 	dvi_setup_scanline_for_active(inst->timing, inst->dma_cfg, NULL, &inst->dma_list_error, false);
-#ifdef FEATURE_A2_AUDIO
+#if DVI_DATA_ISLAND
     dvi_setup_scanline_for_active(inst->timing, inst->dma_cfg, NULL, &inst->dma_list_active_blank, true);
 #endif
 
@@ -84,8 +87,10 @@ void __dvi_func(dvi_init)(struct dvi_inst *inst, uint spinlock_tmds_queue, uint
 		queue_add_blocking_u32(&inst->q_tmds_free, &tmdsbuf);
 	}
 
-#ifdef FEATURE_A2_AUDIO
-    set_AVI_info_frame(&inst->avi_info_frame, UNDERSCAN, RGB, ITU601, PIC_ASPECT_RATIO_4_3, SAME_AS_PAR, FULL, _640x480P60);	
+#if DVI_DATA_ISLAND
+	//	Default AVI InfoFrame, the application can replace it before dvi_start()
+    set_AVI_info_frame(&inst->avi_info_frame, UNDERSCAN, RGB, ITU601, PIC_ASPECT_RATIO_4_3, SAME_AS_PAR, FULL, IT_CONTENT_NO_DATA,
+		(inst->timing->h_active_pixels == 720) ? _720x480P60 : _640x480P60);
 #endif
 }
 
@@ -268,7 +273,8 @@ static void __dvi_func(dvi_dma_irq_handler)(struct dvi_inst *inst)
 	// now have until the end of this region to generate DMA blocklist for next
 	// scanline.
 	dvi_timing_state_advance(inst->timing, &inst->timing_state);
-	if (inst->tmds_buf_release && !queue_try_add_u32(&inst->q_tmds_free, &inst->tmds_buf_release))
+	if (inst->tmds_buf_release && !dvi_tmds_buf_pinned(inst, inst->tmds_buf_release) &&
+		!queue_try_add_u32(&inst->q_tmds_free, &inst->tmds_buf_release))
 		panic("TMDS free queue full in IRQ!");
 	inst->tmds_buf_release = inst->tmds_buf_release_next;
 	inst->tmds_buf_release_next = NULL;
@@ -285,7 +291,8 @@ static void __dvi_func(dvi_dma_irq_handler)(struct dvi_inst *inst)
 	{
 		// If we displayed this buffer then it would be in the wrong vertical
 		// position on-screen. Just pass it back.
-		queue_add_blocking_u32(&inst->q_tmds_free, &tmdsbuf);
+		if (!dvi_tmds_buf_pinned(inst, tmdsbuf))
+			queue_add_blocking_u32(&inst->q_tmds_free, &tmdsbuf);
 		--inst->late_scanline_ctr;
 	}
 
@@ -304,6 +311,8 @@ static void __dvi_func(dvi_dma_irq_handler)(struct dvi_inst *inst)
 		if (inst->timing_state.v_ctr % DVI_VERTICAL_REPEAT == DVI_VERTICAL_REPEAT - 1) {
 			queue_remove_blocking_u32(&inst->q_tmds_valid, &tmdsbuf);
 			inst->tmds_buf_release_next = tmdsbuf;
+			if (inst->scanline_callback)
+				inst->scanline_callback((inst->timing_state.v_ctr - (inst->timing->v_active_lines-A2DVI_SCANLINES)/2) / DVI_VERTICAL_REPEAT);
 		}
 	}
 	else {
@@ -323,15 +332,10 @@ static void __dvi_func(dvi_dma_irq_handler)(struct dvi_inst *inst)
 			else {
 				_dvi_load_dma_op(inst->dma_cfg, &inst->dma_list_error);
 			}
-#if 0
-			if (inst->scanline_callback && inst->timing_state.v_ctr % DVI_VERTICAL_REPEAT == DVI_VERTICAL_REPEAT - 1) {
-				inst->scanline_callback();
-			}
-#endif
 			break;
 		case DVI_STATE_SYNC:
 			_dvi_load_dma_op(inst->dma_cfg, &inst->dma_list_vblank_sync);
-#ifdef FEATURE_A2_AUDIO
+#if DVI_DATA_ISLAND
             if (inst->timing_state.v_ctr == 0) {
                 ++inst->dvi_frame_count;
             }
@@ -343,13 +347,9 @@ static void __dvi_func(dvi_dma_irq_handler)(struct dvi_inst *inst)
 			_dvi_load_dma_op(inst->dma_cfg, &inst->dma_list_vblank_nosync);
 			break;
 	}
-#ifdef FEATURE_A2_AUDIO
-    if (inst->data_island_is_enabled) {
-		if (inst->audio_enabled)
-        	dvi_update_data_stream(inst);
-		else
-			dvi_update_data_stream_null(inst);
-    }
+#if DVI_DATA_ISLAND
+    if (inst->data_island_is_enabled)
+		dvi_update_data_stream(inst);
 #endif
 }
 
@@ -380,18 +380,18 @@ void __dvi_func(dvi_destroy)(struct dvi_inst *inst, uint irq_num)
 	// remove tmds buffers from queues and free memory
 	{
 		uint buf_count = 0;
-		if (inst->tmds_buf_release)
+		if (inst->tmds_buf_release && !dvi_tmds_buf_pinned(inst, inst->tmds_buf_release))
 		{
 			free(inst->tmds_buf_release);
-			inst->tmds_buf_release = NULL;
 			buf_count++;
 		}
-		if (inst->tmds_buf_release_next)
+		inst->tmds_buf_release = NULL;
+		if (inst->tmds_buf_release_next && !dvi_tmds_buf_pinned(inst, inst->tmds_buf_release_next))
 		{
 			free(inst->tmds_buf_release_next);
-			inst->tmds_buf_release_next = NULL;
 			buf_count++;
 		}
+		inst->tmds_buf_release_next = NULL;
 		while (buf_count < DVI_N_TMDS_BUFFERS)
 		{
 			void *tmdsbuf = NULL;
@@ -402,7 +402,8 @@ void __dvi_func(dvi_destroy)(struct dvi_inst *inst, uint irq_num)
 				buf_count++;
 			}
 			// also consider valid queue, since we may have aborted a frame display cycle
-			if (queue_try_remove_u32(&inst->q_tmds_valid, &tmdsbuf))
+			// (pinned buffers are freed by their owner)
+			if (queue_try_remove_u32(&inst->q_tmds_valid, &tmdsbuf) && !dvi_tmds_buf_pinned(inst, tmdsbuf))
 			{
 				free(tmdsbuf);
 				buf_count++;
@@ -435,6 +436,10 @@ void __dvi_func(dvi_destroy)(struct dvi_inst *inst, uint irq_num)
 	// free queues
 	queue_free(&inst->q_tmds_valid);
 	queue_free(&inst->q_tmds_free);
+#ifdef FEATURE_A2_AUDIO
+	queue_free(&inst->q_audio_streams_valid);
+	queue_free(&inst->q_audio_streams_free);
+#endif
 
 #if 0
 	queue_free(&inst->q_colour_valid);
@@ -442,26 +447,23 @@ void __dvi_func(dvi_destroy)(struct dvi_inst *inst, uint irq_num)
 #endif
 }
 
-#ifdef FEATURE_A2_AUDIO
+#if DVI_DATA_ISLAND
 
-#define NUMBER_OF_AUDIO_PACKETS 4
+#ifdef FEATURE_A2_AUDIO
 typedef struct data_island_streams {
     data_island_stream_t stream_true;
 	data_island_stream_t stream_false;
 } data_island_streams_t;
 
 data_island_streams_t s_audio_data_streams[NUMBER_OF_AUDIO_PACKETS];	//	We calculate both the true and false versions of the stream on the render processor
+#endif
 data_island_stream_t s_zero_stream_true;								//	We cache the two most used null streams
 data_island_stream_t s_zero_stream_false;
 
 // DVI Data island related
-void __dvi_func(dvi_audio_init)(struct dvi_inst *inst) {
+void __dvi_func(dvi_data_island_init)(struct dvi_inst *inst) {
     inst->data_island_is_enabled = false;
 	inst->audio_enabled = false;
-    inst->audio_freq = 0;
-    inst->samples_per_frame = 0;
-    inst->samples_per_line16 = 0;
-    inst->audio_frame_count = 0;
 
 	data_packet_t packet;
 	set_null_data_packet(&packet);
@@ -470,6 +472,12 @@ void __dvi_func(dvi_audio_init)(struct dvi_inst *inst) {
 	set_null_data_packet(&packet);
     encode_data_packet(&s_zero_stream_false, &packet, false, inst->timing->h_sync_polarity);
 
+#ifdef FEATURE_A2_AUDIO
+    inst->audio_freq = 0;
+    inst->samples_per_frame = 0;
+    inst->samples_per_line16 = 0;
+    inst->audio_frame_count = 0;
+
 	//	We have a queue of audio data packets so that they can be processed on the other core
     uint spinlock3 = next_striped_spin_lock_num();
 	queue_init_with_spinlock(&inst->q_audio_streams_free, sizeof(void*), NUMBER_OF_AUDIO_PACKETS, spinlock3);
@@ -484,6 +492,7 @@ void __dvi_func(dvi_audio_init)(struct dvi_inst *inst) {
 		void *stream = &s_audio_data_streams[i];
 		queue_add_blocking_u32(&inst->q_audio_streams_free, &stream);
 	}
+#endif
 }
 
 void __dvi_func(dvi_enable_data_island)(struct dvi_inst *inst) {
@@ -517,6 +526,7 @@ void __dvi_func(dvi_update_data_island_ptr)(struct dvi_scanline_dma_list *dma_li
     }
 }
 
+#ifdef FEATURE_A2_AUDIO
 // video_freq: video sampling frequency = 
 // audio_freq: audio sampling frequency
 // CTS: Cycle Time Stamp  (32176 == 720x480)
@@ -572,68 +582,65 @@ bool __dvi_func(dvi_queue_audio_samples)(struct dvi_inst *inst, const int16_t* s
 
 	return result;
 }
+#endif		//	FEATURE_A2_AUDIO
 
 //	Called on the DVI core
 void __dvi_func(dvi_update_data_stream)(struct dvi_inst *inst) {
 	data_packet_t packet;
     bool vsync = inst->timing_state.v_state == DVI_STATE_SYNC;
 	bool encode = false;
+#ifdef FEATURE_A2_AUDIO
+	bool audio = (inst->audio_enabled) && (inst->samples_per_frame != 0);
+#endif
 
-    if (inst->samples_per_frame != 0)
+	//	These are all infrequent, the AVI InfoFrame is sent every frame without audio
+	if (inst->timing_state.v_state == DVI_STATE_FRONT_PORCH) 
 	{
-		//	These are all infrequent
-		if (inst->timing_state.v_state == DVI_STATE_FRONT_PORCH) 
+		if (inst->timing_state.v_ctr == 0) 
 		{
-			if (inst->timing_state.v_ctr == 0) 
-			{
-				if (inst->dvi_frame_count & 1) 
-				{
-					packet = inst->avi_info_frame;
-					encode = true;
-				} 
-				else 
-				{
-					packet = inst->audio_info_frame;
-					encode = true;
-				}
-			} 
-			else if (inst->timing_state.v_ctr == 1) 
-			{
-				packet = inst->audio_clock_regeneration;
-				encode = true;
-			}
-
-			if (encode)
-			{
-				//	return the packet encoded, this doesn't happen often
-				encode_data_packet(&inst->next_data_stream, &packet, inst->timing->v_sync_polarity == vsync, inst->timing->h_sync_polarity);
-				return;
-			}
+#ifdef FEATURE_A2_AUDIO
+			if ((audio) && ((inst->dvi_frame_count & 1) == 0))
+				packet = inst->audio_info_frame;
 			else
-			{
-				dvi_update_data_stream_null(inst);
-				return;
-			}
+#endif
+				packet = inst->avi_info_frame;
+			encode = true;
+		} 
+#ifdef FEATURE_A2_AUDIO
+		else if ((inst->timing_state.v_ctr == 1) && (audio))
+		{
+			packet = inst->audio_clock_regeneration;
+			encode = true;
 		}
-		else if (inst->audio_enabled) 
+#endif
+
+		if (encode)
 		{
-			//	Pull a stream from the queue, if there is one ready.
-			//	Each packet is 4 samples at 44100Hz
-			data_island_streams_t* audio_streams;
-			if (queue_try_remove_u32(&inst->q_audio_streams_valid, &audio_streams))
-			{
-				//	Select the right pre-encoded stream
-				if (inst->timing->v_sync_polarity == vsync)
-					inst->next_data_stream = audio_streams->stream_true;
-				else
-					inst->next_data_stream = audio_streams->stream_false;
+			//	return the packet encoded, this doesn't happen often
+			encode_data_packet(&inst->next_data_stream, &packet, inst->timing->v_sync_polarity == vsync, inst->timing->h_sync_polarity);
+			return;
+		}
+	}
+#ifdef FEATURE_A2_AUDIO
+	else if (audio)
+	{
+		//	Pull a stream from the queue, if there is one ready.
+		//	Each packet is 4 samples at 44100Hz
+		data_island_streams_t* audio_streams;
+		if (queue_try_remove_u32(&inst->q_audio_streams_valid, &audio_streams))
+		{
+			//	Select the right pre-encoded stream
+			if (inst->timing->v_sync_polarity == vsync)
+				inst->next_data_stream = audio_streams->stream_true;
+			else
+				inst->next_data_stream = audio_streams->stream_false;
 
-				queue_add_blocking_u32(&inst->q_audio_streams_free, &audio_streams);
+			queue_add_blocking_u32(&inst->q_audio_streams_free, &audio_streams);
 
-				return;
-			}
+			return;
 		}
 	}
+#endif
 	
 	//	By default, return a null stream
 	dvi_update_data_stream_null(inst);
@@ -647,10 +654,12 @@ void __dvi_func(dvi_update_data_stream_null)(struct dvi_inst *inst) {
 		inst->next_data_stream = s_zero_stream_false;
 }
 
+#ifdef FEATURE_A2_AUDIO
 void __dvi_func(dvi_audio_enable)(struct dvi_inst *inst, bool enable)
 {
 	if (inst->data_island_is_enabled == true)
 		inst->audio_enabled = enable;
 }
+#endif
 
-#endif		//	FEATURE_A2_AUDIO
\ No newline at end of file
+#endif		//	DVI_DATA_ISLAND
\ No newline at end of file
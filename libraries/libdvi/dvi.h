@@ -26,13 +26,12 @@ extern "C" {
 #include "dvi_timing.h"
 #include "dvi_serialiser.h"
 #include "util_queue_u32_inline.h"
-#ifdef FEATURE_A2_AUDIO
+#if DVI_DATA_ISLAND
 #include "data_packet.h"
 #endif
 
-#if 0
-typedef void (*dvi_callback_t)(void);
-#endif
+// Called with the row index (0..223) of the A2DVI letterbox area whose TMDS buffer was just loaded
+typedef void (*dvi_callback_t)(uint row);
 
 struct dvi_inst {
 	// Config ---
@@ -40,17 +39,15 @@ struct dvi_inst {
 	struct dvi_lane_dma_cfg dma_cfg[N_TMDS_LANES];
 	struct dvi_timing_state timing_state;
 	struct dvi_serialiser_cfg* ser_cfg;
-#if 0
 	// Called in the DMA IRQ once per scanline -- careful with the run time!
 	dvi_callback_t scanline_callback;
-#endif
 
 	// State ---
 	struct dvi_scanline_dma_list dma_list_vblank_sync;
 	struct dvi_scanline_dma_list dma_list_vblank_nosync;
 	struct dvi_scanline_dma_list dma_list_active;
 	struct dvi_scanline_dma_list dma_list_error;
-#ifdef FEATURE_A2_AUDIO
+#if DVI_DATA_ISLAND
     struct dvi_scanline_dma_list dma_list_active_blank;
 #endif
 
@@ -60,6 +57,10 @@ struct dvi_inst {
 	// the actual data DMA transfer has completed.
 	uint32_t *tmds_buf_release_next;
 	uint32_t *tmds_buf_release;
+	// TMDS buffers in this range are owned by the application (A2DVI line cache)
+	// and are never passed back through q_tmds_free.
+	uint32_t *tmds_pinned_start;
+	uint32_t *tmds_pinned_end;
 	// Remember how far behind the source is on TMDS scanlines, so we can output
 	// solid colour until they catch up (rather than dying spectacularly)
 	uint32_t late_scanline_ctr;
@@ -82,18 +83,20 @@ struct dvi_inst {
 
 	bool    dvi_started;
 	
-#ifdef FEATURE_A2_AUDIO
+#if DVI_DATA_ISLAND
     uint    dvi_frame_count;
 
-    // Data Packet and audio related
+    // Data Packet related, the AVI InfoFrame is sent with or without audio
     data_packet_t avi_info_frame;
+    data_island_stream_t next_data_stream;
+#endif
+
+#ifdef FEATURE_A2_AUDIO
     data_packet_t audio_clock_regeneration;
     data_packet_t audio_info_frame;
     int audio_freq;
     int samples_per_frame;
     int samples_per_line16;
-    
-    data_island_stream_t next_data_stream;
 
     int audio_frame_count;
 
@@ -102,6 +105,10 @@ struct dvi_inst {
 #endif
 };
 
+static inline bool dvi_tmds_buf_pinned(const struct dvi_inst *inst, const uint32_t *tmdsbuf) {
+	return (tmdsbuf >= inst->tmds_pinned_start) && (tmdsbuf < inst->tmds_pinned_end);
+}
+
 // Reports DVI status 1: active 0: inactive
 inline bool dvi_is_started(struct dvi_inst *inst) {
     return inst->dvi_started;
@@ -142,15 +149,19 @@ void dvi_framebuf_main_8bpp(struct dvi_inst *inst);
 void dvi_framebuf_main_16bpp(struct dvi_inst *inst);
 #endif
 
-#ifdef FEATURE_A2_AUDIO
-// Data island (and audio) related api
-void dvi_audio_init(struct dvi_inst *inst);
+#if DVI_DATA_ISLAND
+// Data island related api
+void dvi_data_island_init(struct dvi_inst *inst);
 void dvi_enable_data_island(struct dvi_inst *inst);
 void dvi_update_data_island_ptr(struct dvi_scanline_dma_list *dma_list, data_island_stream_t *stream);
-void dvi_audio_sample_buffer_set(struct dvi_inst *inst, audio_sample_t *buffer, int size);
-void dvi_set_audio_freq(struct dvi_inst *inst, int audio_freq, int cts, int n);
 void dvi_update_data_stream(struct dvi_inst *inst);
 void dvi_update_data_stream_null(struct dvi_inst *inst);
+#endif
+
+#ifdef FEATURE_A2_AUDIO
+// Audio related api
+void dvi_audio_sample_buffer_set(struct dvi_inst *inst, audio_sample_t *buffer, int size);
+void dvi_set_audio_freq(struct dvi_inst *inst, int audio_freq, int cts, int n);
 void dvi_audio_enable(struct dvi_inst *inst, bool enable);
 bool dvi_queue_audio_samples(struct dvi_inst *inst, const int16_t* samples, int count);
 #endif
@@ -26,6 +26,24 @@
 #define DVI_N_TMDS_BUFFERS 3
 #endif
 
+// If 1, the DMA lists carry a data island in the horizontal blanking of every
+// scanline. It transports the HDMI AVI InfoFrame (content type, VIC,
+// quantisation range) and, with FEATURE_A2_AUDIO, the audio packets. Builds
+// without audio can set it to 0 for a plain DVI signal.
+#ifndef DVI_DATA_ISLAND
+#define DVI_DATA_ISLAND 1
+#endif
+
+#if defined(FEATURE_A2_AUDIO) && !DVI_DATA_ISLAND
+#error "FEATURE_A2_AUDIO requires DVI_DATA_ISLAND"
+#endif
+
+// Number of encoded audio data islands queued between the render core and the
+// DMA IRQ (FEATURE_A2_AUDIO)
+#ifndef NUMBER_OF_AUDIO_PACKETS
+#define NUMBER_OF_AUDIO_PACKETS 4
+#endif
+
 // If 1, replace the DVI serialiser with a 10n1 UART (1 start bit, 10 data
 // bits, 1 stop bit) so the stream can be dumped and analysed easily.
 #ifndef DVI_SERIAL_DEBUG
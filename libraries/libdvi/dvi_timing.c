@@ -264,7 +264,7 @@ static uint32_t __attribute__((aligned(8))) __dvi_const(black_scanline_tmds)[3]
 	0x7fd00u, // 0x00, 0x00
 };
 
-#ifdef FEATURE_A2_AUDIO
+#if DVI_DATA_ISLAND
 // Video Gaurdband
 static uint32_t __attribute__((aligned(8))) __dvi_const(video_gaurdband_syms)[3] = {
 	0b10110011001011001100,
@@ -344,7 +344,7 @@ void __dvi_func(dvi_setup_scanline_for_vblank)(const struct dvi_timing *t, const
 	}
 }
 
-#ifdef FEATURE_A2_AUDIO
+#if DVI_DATA_ISLAND
 void __dvi_func(dvi_setup_scanline_for_vblank_with_audio)(const struct dvi_timing *t, const struct dvi_lane_dma_cfg dma_cfg[],
 		bool vsync_asserted, struct dvi_scanline_dma_list *l) {
 
@@ -414,7 +414,7 @@ void __dvi_func(dvi_setup_scanline_for_active)(const struct dvi_timing *t, const
 	}
 }
 
-#ifdef FEATURE_A2_AUDIO
+#if DVI_DATA_ISLAND
 void __dvi_func(dvi_setup_scanline_for_active_with_audio)(const struct dvi_timing *t, const struct dvi_lane_dma_cfg dma_cfg[],
 		uint32_t *tmdsbuf, struct dvi_scanline_dma_list *l, bool black) {
 
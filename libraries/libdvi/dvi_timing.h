@@ -4,6 +4,7 @@
 #include "hardware/dma.h"
 #include "pico/util/queue.h"
 
+#include "dvi_config_defs.h"
 #include "dvi.h"
 
 struct dvi_timing {
@@ -30,7 +31,7 @@ enum dvi_line_state {
 	DVI_STATE_COUNT
 };
 
-#ifdef FEATURE_A2_AUDIO
+#if DVI_DATA_ISLAND
 enum dvi_sync_lane_state
 {
 	DVI_SYNC_LANE_STATE_FRONT_PORCH,
@@ -84,13 +85,13 @@ static_assert(__builtin_offsetof(dma_cb_t, c.ctrl) == __builtin_offsetof(dma_cha
 #define DVI_SYNC_LANE_CHUNKS DVI_STATE_COUNT
 #define DVI_NOSYNC_LANE_CHUNKS 2
 
-#ifdef FEATURE_A2_AUDIO
+#if DVI_DATA_ISLAND
 #define DVI_SYNC_LANE_CHUNKS_WITH_AUDIO DVI_SYNC_LANE_STATE_COUNT
 #define DVI_NOSYNC_LANE_CHUNKS_WITH_AUDIO DVI_NOSYNC_LANE_STATE_COUNT
 #endif
 
 struct dvi_scanline_dma_list {
-#ifdef FEATURE_A2_AUDIO
+#if DVI_DATA_ISLAND
 	dma_cb_t l0[DVI_SYNC_LANE_CHUNKS_WITH_AUDIO];
 	dma_cb_t l1[DVI_NOSYNC_LANE_CHUNKS_WITH_AUDIO];
 	dma_cb_t l2[DVI_NOSYNC_LANE_CHUNKS_WITH_AUDIO];
@@ -139,7 +140,7 @@ void dvi_setup_scanline_for_vblank(const struct dvi_timing *t, const struct dvi_
 void dvi_setup_scanline_for_active(const struct dvi_timing *t, const struct dvi_lane_dma_cfg dma_cfg[],
 		uint32_t *tmdsbuf, struct dvi_scanline_dma_list *l, bool black);
 
-#ifdef FEATURE_A2_AUDIO
+#if DVI_DATA_ISLAND
 void dvi_setup_scanline_for_vblank_with_audio(const struct dvi_timing *t, const struct dvi_lane_dma_cfg dma_cfg[],
 											  bool vsync_asserted, struct dvi_scanline_dma_list *l);
 
@@ -0,0 +1,144 @@
+#!/usr/bin/env python3
+
+# MIT License
+# Copyright (c) 2025 Michael Neil, Far Left Lane
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+# Host simulation of the A2C capture -> render -> DVI queue pipeline.
+#
+# Models the timing of:
+#  * a2c_loop on core 1, receiving 18 SEROUT words per Apple IIc scan line,
+#  * render_a2c on core 0, rendering 16 debug rows, 192 lines and 16 debug rows
+#    per frame into the DVI_N_TMDS_BUFFERS deep TMDS buffer queue,
+#  * dvi_dma_irq_handler, loading one TMDS buffer every DVI_VERTICAL_REPEAT lines.
+#
+# The latency is measured the same way as the firmware does it (a2c.c,
+# a2c_latency_scanline_loaded), so the histogram can be compared directly
+# with the "LAT:" line of the debug monitor.
+#
+# Usage: a2c_latency_sim.py [--mode 640|720] [--buffers N] [--render-us US] [--frames N]
+
+import argparse
+
+# Apple IIc video timing (NTSC): 14.31818MHz / 912 dots per line, 262 lines
+IIC_LINE_US       = 912 / 14.31818
+IIC_LINES         = 262
+IIC_WNDW_US       = 40 * IIC_LINE_US / 65    # 40 of 65 cycles per line are visible
+
+# DVI timing, pixels per line (incl. blanking), total lines, pixel clock (MHz)
+DVI_TIMINGS = {
+    "640" : (800, 525, 25.2),
+    "720" : (858, 525, 27.0),
+}
+DVI_ACTIVE_LINES  = 480
+DVI_VERTICAL_REPEAT = 2
+A2DVI_ROWS        = 16 + 192 + 16
+A2DVI_SCANLINES   = DVI_VERTICAL_REPEAT * A2DVI_ROWS
+
+LATENCY_BUCKETS      = 16
+LATENCY_BUCKET_SHIFT = 11
+
+class Stats:
+    def __init__(self):
+        self.count = 0
+        self.sum = 0
+        self.min = None
+        self.max = None
+        self.histogram = [0] * LATENCY_BUCKETS
+        self.errors = 0
+
+    def add(self, latency_us):
+        latency_us = int(latency_us)
+        self.count += 1
+        self.sum += latency_us
+        self.min = latency_us if self.min is None else min(self.min, latency_us)
+        self.max = latency_us if self.max is None else max(self.max, latency_us)
+        self.histogram[min(latency_us >> LATENCY_BUCKET_SHIFT, LATENCY_BUCKETS - 1)] += 1
+
+    def report(self, title):
+        print(title)
+        if self.count == 0:
+            print("  no samples")
+            return
+        print("  samples: %d  scanline errors: %d" % (self.count, self.errors))
+        print("  min/avg/max (us): %d / %d / %d" % (self.min, self.sum // self.count, self.max))
+        largest = max(self.histogram)
+        for i, n in enumerate(self.histogram):
+            bar = "#" * ((n * 50 + largest - 1) // largest) if largest else ""
+            print("  %5d-%5dus %7d %s" % (i << LATENCY_BUCKET_SHIFT, ((i + 1) << LATENCY_BUCKET_SHIFT) - 1, n, bar))
+
+def capture_time(line, t, phase_us):
+    """ Time at which the most recent capture of 'line' completed, at or before time 't'. """
+    frame_us = IIC_LINES * IIC_LINE_US
+    offset = phase_us + line * IIC_LINE_US + IIC_WNDW_US
+    frame = (t - offset) // frame_us
+    return offset + frame * frame_us
+
+def simulate(mode, buffers, render_us, debug_row_us, frames, phase_us):
+    h_total, v_total, pixel_mhz = DVI_TIMINGS[mode]
+    dvi_line_us  = h_total / pixel_mhz
+    dvi_frame_us = v_total * dvi_line_us
+    first_line   = (DVI_ACTIVE_LINES - A2DVI_SCANLINES) // 2
+
+    stats = Stats()
+    release = []            # time at which each TMDS buffer was returned to the free queue
+    render_done = 0.0
+
+    for frame in range(frames):
+        frame_start = frame * dvi_frame_us
+        for row in range(A2DVI_ROWS):
+            n = frame * A2DVI_ROWS + row
+
+            # dvi_get_scanline blocks until a buffer is on the free queue
+            start = render_done
+            if n >= buffers:
+                start = max(start, release[n - buffers])
+
+            is_video = (16 <= row < 16 + 192)
+            captured = capture_time(row - 16, start, phase_us) if is_video else None
+            render_done = start + (render_us if is_video else debug_row_us)
+
+            # the IRQ removes the buffer on the last repeated line and releases it two IRQs later
+            v_ctr   = first_line + row * DVI_VERTICAL_REPEAT
+            loaded  = frame_start + (v_ctr + DVI_VERTICAL_REPEAT - 1) * dvi_line_us
+            if render_done > frame_start + v_ctr * dvi_line_us:
+                stats.errors += 1
+            release.append(loaded + 2 * dvi_line_us)
+
+            if is_video:
+                stats.add(loaded - captured)
+
+    return stats
+
+def main():
+    parser = argparse.ArgumentParser(description="Simulate the A2C capture to display latency")
+    parser.add_argument("--mode",      default="720", choices=DVI_TIMINGS.keys(), help="DVI output resolution")
+    parser.add_argument("--buffers",   default=8,     type=int,   help="number of TMDS buffers (DVI_N_TMDS_BUFFERS)")
+    parser.add_argument("--render-us", default=20.0,  type=float, help="render time of a captured line in microseconds")
+    parser.add_argument("--debug-us",  default=4.0,   type=float, help="render time of a debug row in microseconds")
+    parser.add_argument("--frames",    default=600,   type=int,   help="number of DVI frames to simulate")
+    parser.add_argument("--phase-us",  default=0.0,   type=float, help="initial offset of the Apple IIc frame")
+    args = parser.parse_args()
+
+    stats = simulate(args.mode, args.buffers, args.render_us, args.debug_us, args.frames, args.phase_us)
+    stats.report("%sx480, %d TMDS buffers, %.1fus per line" % (args.mode, args.buffers, args.render_us))
+
+if __name__ == "__main__":
+    main()
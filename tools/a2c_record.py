@@ -0,0 +1,275 @@
+#!/usr/bin/env python3
+
+# MIT License
+# Copyright (c) 2025 Michael Neil, Far Left Lane
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+
+# Decoder of the A2C video recordings (FEATURE_A2C_RECORD, firmware/a2c/a2c_record.h).
+#
+# Reads the FLASH_RECORD area saved with
+#   picotool save -r 0x10160000 0x101e0000 record.bin
+# and reports the frames: their size, the time between them, and the WNDW timing of the
+# lines (the microseconds between the capture of two lines, 65 for NTSC).
+#
+#   --export FILE   writes the header page and the decoded frame images, the input of
+#                   "render_golden_a2c --replay"
+#   --replay        renders every frame through the A2C renderers on this computer (the
+#                   render_golden harness, built like render_golden.py does) with the
+#                   settings of the recording, and reports the host cycles per frame
+#   --ppm DIR       with --replay, writes every --every'th frame as DIR/frame_NNNN.ppm
+#   --check         records test frames with firmware/a2c/a2c_record.c built for this computer
+#                   into a fake flash (the harness of tools/a2c_stream.py), and checks that every
+#                   recorded frame is decoded exactly: with the ring wrapping around, frames
+#                   skipped or dropped when the ring is full or the frame is overtaken, and the
+#                   flash area filling up
+#
+# Usage: a2c_record.py RECORD [--export FILE] [--replay] [--ppm DIR] [--every N] [--cc CC]
+#        a2c_record.py --check [--seed N] [--cc CC]
+
+import argparse
+import os
+import shutil
+import struct
+import subprocess
+import sys
+import tempfile
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, os.path.join(HERE, "render_golden"))
+sys.path.insert(0, HERE)
+
+MAGIC         = 0x52433241          # "A2CR"
+VERSION       = 1
+HEADER        = struct.Struct("<IHHIIIIBBBB4b")
+FRAME_HEADER  = struct.Struct("<IHH")
+LINE_WORDS    = 22                  # 18 SEROUT words, GR, TEXT, VIDD7 (2 words)
+TIMES_WORDS   = 192 // 4
+FRAME_WORDS   = 192 * LINE_WORDS + TIMES_WORDS
+LINE_US       = 65                  # NTSC line, 912 / 14.31818MHz
+RING_SIZE     = 18688               # A2C_RECORD_RING_SIZE, the largest frame
+
+def read_header(data):
+    fields = HEADER.unpack_from(data)
+    keys = ("magic", "version", "page_size", "frame_count", "data_bytes", "skipped", "internal_flags",
+            "color_style", "rendering_fx", "color_mode", "laser")
+    header = dict(zip(keys, fields))
+    header["adjust"] = fields[len(keys):]
+    if header["magic"] != MAGIC:
+        sys.exit("no A2C recording (magic %08x)" % header["magic"])
+    if header["version"] != VERSION:
+        sys.exit("recording version %d, this tool reads version %d" % (header["version"], VERSION))
+    return header
+
+def decode_frame(data, pos, end, image):
+    """ Applies the XOR runs of a frame to image (a list of FRAME_WORDS words, or the words of a
+        stream frame, tools/a2c_stream.py) in place. """
+    word = 0
+    while pos < end:
+        tag = data[pos]
+        pos += 1
+        count = (tag & 0x7f) + 1
+        if tag & 0x80:
+            for value in struct.unpack_from("<%dI" % count, data, pos):
+                image[word] ^= value
+                word += 1
+            pos += 4 * count
+        else:
+            word += count
+        if word > len(image):
+            raise ValueError("frame data beyond the image")
+    if pos != end:
+        raise ValueError("frame data beyond its length")
+
+def read_frames(data, header):
+    """ Yields (time, skipped, bytes, image) per frame. """
+    pos = header["page_size"]
+    end = pos + header["data_bytes"]
+    image = [0] * FRAME_WORDS
+    for index in range(header["frame_count"]):
+        if pos + FRAME_HEADER.size > end:
+            sys.exit("frame %d: truncated recording" % index)
+        time, skipped, length = FRAME_HEADER.unpack_from(data, pos)
+        pos += FRAME_HEADER.size
+        if pos + length > end:
+            sys.exit("frame %d: truncated recording" % index)
+        try:
+            decode_frame(data, pos, pos + length, image)
+        except ValueError as error:
+            sys.exit("frame %d: %s" % (index, error))
+        pos += length
+        yield time, skipped, length, list(image)
+
+def line_times(image):
+    """ The microseconds between the capture of each line and the one before it. """
+    times = []
+    for word in image[192 * LINE_WORDS:]:
+        times += [(word >> shift) & 0xff for shift in (0, 8, 16, 24)]
+    return times
+
+def export(path, data, header, images):
+    with open(path, "wb") as f:
+        f.write(data[:header["page_size"]])
+        for image in images:
+            f.write(struct.pack("<%dI" % FRAME_WORDS, *image))
+
+def replay(args, data, header, images):
+    import render_golden
+    import tmds_check
+
+    workdir = tempfile.mkdtemp(prefix="a2c_record")
+    try:
+        exe = render_golden.build(args.cc, workdir, True)
+        frames = os.path.join(workdir, "frames.bin")
+        export(frames, data, header, images)
+        every = args.every if args.ppm else 0
+        result = subprocess.run([exe, "--replay", frames, workdir, str(every)], capture_output=True, text=True)
+        if result.returncode != 0 or result.stderr:
+            sys.exit("%s failed:\n%s" % (exe, result.stderr))
+
+        cycles = []
+        for line in result.stdout.splitlines():
+            name, lines, count = line.split()
+            cycles.append(int(count))
+            if args.ppm and os.path.exists(os.path.join(workdir, name + ".tmds")):
+                scanlines = tmds_check.read_capture(os.path.join(workdir, name + ".tmds"), render_golden.X_RESOLUTION)
+                os.makedirs(args.ppm, exist_ok=True)
+                tmds_check.write_ppm(os.path.join(args.ppm, name + ".ppm"), tmds_check.decode_scanlines(scanlines),
+                                     render_golden.X_RESOLUTION, int(lines))
+        if cycles:
+            print("replay: %d frames, host cycles per frame min %d, average %d, max %d (frame %d)" %
+                  (len(cycles), min(cycles), sum(cycles) // len(cycles), max(cycles), cycles.index(max(cycles))))
+    finally:
+        shutil.rmtree(workdir)
+
+def check_frames(rng, count):
+    """ A text screen being typed on, scrolled every 16 frames, switched to mixed mode now and
+        then, as the words of the harness of tools/a2c_stream.py. """
+    text = [[rng.getrandbits(32) & 0x3f3f3f3f for word in range(18)] + [0, 0xffffff, rng.getrandbits(32), 0xff]
+            for line in range(192)]
+    frames = []
+    for n in range(count):
+        for i in range(rng.randrange(1, 4)):
+            text[rng.randrange(192)][rng.randrange(18)] ^= 1 << rng.randrange(32)
+        if n % 16 == 15:
+            text = text[8:] + text[:8]
+        if n % 40 == 20:
+            for line in range(160):
+                text[line][18] ^= 0xffffff
+        frames.append([word for row in text for word in row])
+    return frames
+
+def check(args):
+    """ Records test frames with firmware/a2c/a2c_record.c built for this computer (the harness of
+        tools/a2c_stream.py, a fake flash) and checks that every recorded frame is decoded exactly. """
+    import random
+    import a2c_stream
+
+    rng = random.Random(args.seed)
+    frames = check_frames(rng, 240)
+    noise = [[rng.getrandbits(32) for word in range(192 * LINE_WORDS)] for n in range(12)]
+    workdir = tempfile.mkdtemp(prefix="a2c_record")
+    errors = 0
+    try:
+        # (case, frames, flash bytes, pages written per frame, capture core steps per frame,
+        # (frames, ring wraps, frames skipped) at least)
+        cases = (("ring wrap",      frames,                 0x80000, 64,  1000, (240, 4, 0)),
+                 ("ring full",      frames,                 0x80000, 2,   1000, (60, 4, 60)),
+                 ("noise",          frames[:20] + noise,    0x80000, 4,   1000, (10, 1, 6)),
+                 ("busy",           frames,                 0x80000, 64,  30,   (60, 4, 60)),
+                 ("overtaken",      frames,                 0x80000, 64,  (20, 20, 20, 1000), (50, 4, 100)),
+                 ("flash full",     frames,                 0x10000, 64,  1000, (20, 2, 1)))
+        for name, case_frames, record_len, pages, steps, expected in cases:
+            exe = a2c_stream.build(args.cc, workdir, record_len, ("A2C_RECORD_PAGES=%d" % pages,))
+            stream, reference, flash = a2c_stream.run(exe, workdir, case_frames, 0, steps, True)
+            count, bad = a2c_stream.check_record(flash, reference, case_frames, len(case_frames) - 1)
+            header = read_header(flash)
+            wraps = header["data_bytes"] // RING_SIZE
+            if count < expected[0] or wraps < expected[1] or header["skipped"] < expected[2] or stream:
+                bad += 1
+            if name == "flash full" and header["frame_count"] + header["skipped"] == len(case_frames):
+                bad += 1
+            print("%-10s %3d of %3d frames recorded, %3d skipped, %6d bytes, the ring wraps %2d times: %s" %
+                  (name, count, len(case_frames), header["skipped"], header["data_bytes"], wraps,
+                   "ok" if bad == 0 else "%d errors" % bad))
+            errors += bad
+    finally:
+        shutil.rmtree(workdir)
+    print("%d errors" % errors)
+    sys.exit(1 if errors else 0)
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode and replay an A2C video recording")
+    parser.add_argument("record", nargs="?", help="the saved FLASH_RECORD area")
+    parser.add_argument("--export",          help="write the header and the decoded frame images to this file")
+    parser.add_argument("--replay",          action="store_true", help="render the frames with the A2C renderers")
+    parser.add_argument("--ppm",             help="with --replay, write rendered frames to this directory")
+    parser.add_argument("--every", default=1, type=int, help="with --ppm, write every N'th frame")
+    parser.add_argument("--check",           action="store_true", help="check a2c_record.c built for this computer")
+    parser.add_argument("--seed",  default=1, type=int, help="random seed of the --check frames")
+    parser.add_argument("--cc",    default=os.environ.get("CC", "gcc"), help="host C compiler for --replay and --check")
+    args = parser.parse_args()
+
+    if args.check:
+        check(args)
+    if not args.record:
+        parser.error("RECORD is needed")
+
+    data = open(args.record, "rb").read()
+    header = read_header(data)
+    print("%d frames, %d bytes, %d frames skipped, color style %d, fx %d, flags %08x" %
+          (header["frame_count"], header["data_bytes"], header["skipped"], header["color_style"],
+           header["rendering_fx"], header["internal_flags"]))
+
+    images = []
+    previous = None
+    intervals = []
+    sizes = []
+    odd_lines = 0
+    periods = {}
+    for time, skipped, length, image in read_frames(data, header):
+        if previous is not None:
+            intervals.append(((time - previous) & 0xffffffff) / (skipped + 1))
+        previous = time
+        sizes.append(length + FRAME_HEADER.size)
+        times = line_times(image)
+        for period in times[1:]:
+            periods[period] = periods.get(period, 0) + 1
+            odd_lines += abs(period - LINE_US) > 1
+        images.append(image)
+
+    if images:
+        print("frame size: average %d bytes, max %d bytes (frame %d)" %
+              (sum(sizes) // len(sizes), max(sizes), sizes.index(max(sizes))))
+    if intervals:
+        print("frame interval: min %.0fus, average %.0fus, max %.0fus" %
+              (min(intervals), sum(intervals) / len(intervals), max(intervals)))
+    if periods:
+        common = sorted(periods, key=periods.get, reverse=True)[:4]
+        print("line period: %s, %d lines off by more than 1us" %
+              (", ".join("%dus %d" % (p, periods[p]) for p in sorted(common)), odd_lines))
+
+    if args.export:
+        export(args.export, data, header, images)
+    if args.replay:
+        replay(args, data, header, images)
+
+if __name__ == "__main__":
+    main()
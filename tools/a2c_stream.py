@@ -0,0 +1,598 @@
+#!/usr/bin/env python3
+
+# MIT License
+# Copyright (c) 2025 Michael Neil, Far Left Lane
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+
+# Receiver of the A2C live stream (FEATURE_A2C_STREAM, firmware/a2c/a2c_stream.h).
+#
+# Opens the CDC port of the A2C board, which starts the stream, rebuilds the frames from the
+# deltas and shows the SEROUT dots like a monochrome monitor (560x384, tkinter).
+#
+#   --save FILE     also writes the received stream to FILE, for --bench
+#   --ppm DIR       writes every --every'th frame as DIR/frame_NNNNNN.ppm
+#   --frames N      stops after N frames
+#
+# SOURCE can be a saved stream as well.
+#
+#   --bench         reports the bandwidth of a saved stream, the frames skipped and the
+#                   capture core cycles spent encoding the frames (measured by the firmware)
+#   --record        with --bench, SOURCE is an A2C recording (tools/a2c_record.py): its frames
+#                   are streamed through firmware/a2c/a2c_stream.c built for this computer, with
+#                   the USB budget of the firmware per frame, the cycles are estimated
+#   --check         streams test frames (or the frames of a recording) through a2c_stream.c and
+#                   the delta encoder it shares with the recorder (a2c_delta.c) built for this
+#                   computer, with and without recording them with a2c_record.c into a fake
+#                   flash, and checks that every frame sent or recorded is rebuilt exactly, also
+#                   with a slow host and with frames overtaken while they are encoded
+#
+# Usage: a2c_stream.py SOURCE [--save FILE] [--ppm DIR] [--every N] [--frames N] [--no-window]
+#        a2c_stream.py SOURCE --bench [--record] [--budget BYTES]
+#        a2c_stream.py [RECORD] --check [--seed N] [--cc CC]
+
+import argparse
+import os
+import random
+import stat
+import struct
+import subprocess
+import sys
+import tempfile
+import time
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, HERE)
+import a2c_record
+
+REPO          = os.path.dirname(HERE)
+FIRMWARE      = os.path.join(REPO, "firmware", "a2c")
+RECORD_LEN    = 0x80000             # __FLASH_RECORD_LEN of copy_to_ram_custom_rp2040_a2c.ld
+
+MAGIC         = 0x53433241          # "A2CS"
+VERSION       = 1
+HEADER        = struct.Struct("<IHHHHI")
+FRAME_HEADER  = struct.Struct("<IHHI")
+LINE_WORDS    = 18
+LINES         = 192
+FRAME_WORDS   = LINES * LINE_WORDS
+FIRST_DOT     = 7                   # A2C_FIRST_BYTE_DOT, 560 dots from there
+USB_BUDGET    = 2048                # CFG_TUD_CDC_EP_BUFSIZE, sent per frame
+FRAME_US      = 16683               # 60Hz NTSC frame
+
+# estimated capture core cycles of a2c_stream_step (code in RAM, no flash wait states)
+WORD_COST     = 14                  # load the dots and the reference, XOR, store the reference, loop
+LITERAL_COST  = 12                  # 4 ring stores with the index mask
+RUN_COST      = 16                  # close the run, new tag
+STEP_COST     = 40                  # call, SysTick, per A2C_DELTA_STEP_LINES lines
+STEP_LINES    = 4
+
+COLOURS = { "white": (255, 255, 255), "green": (0, 255, 64), "amber": (255, 176, 0) }
+
+class Receiver:
+    """ Rebuilds the frames of a stream, fed with the bytes as they arrive. """
+
+    def __init__(self):
+        self.data = bytearray()
+        self.header = None
+        self.image = None
+        self.garbage = 0
+
+    def feed(self, data):
+        """ Yields (time, skipped, bytes, cycles, image) per complete frame. """
+        self.data += data
+        pos = 0
+        while True:
+            if self.header is None:
+                start = self.data.find(struct.pack("<IH", MAGIC, VERSION), pos)
+                if start < 0:
+                    # keep what could be the beginning of the magic
+                    keep = max(pos, len(self.data) - 5)
+                    self.garbage += keep - pos
+                    pos = keep
+                    break
+                if start + HEADER.size > len(self.data):
+                    self.garbage += start - pos
+                    pos = start
+                    break
+                fields = HEADER.unpack_from(self.data, start)
+                self.garbage += start - pos
+                pos = start + HEADER.size
+                self.header = dict(zip(("magic", "version", "line_words", "lines", "frame_header", "sys_clock_khz"), fields))
+                if (self.header["line_words"], self.header["lines"], self.header["frame_header"]) != (LINE_WORDS, LINES, FRAME_HEADER.size):
+                    sys.exit("stream of %d words x %d lines, this tool shows %d x %d" %
+                             (self.header["line_words"], self.header["lines"], LINE_WORDS, LINES))
+                self.image = [0] * FRAME_WORDS
+                continue
+
+            if pos + FRAME_HEADER.size > len(self.data):
+                break
+            frame_time, skipped, length, cycles = FRAME_HEADER.unpack_from(self.data, pos)
+            end = pos + FRAME_HEADER.size + length
+            if end > len(self.data):
+                break
+            try:
+                a2c_record.decode_frame(self.data, pos + FRAME_HEADER.size, end, self.image)
+            except ValueError as error:
+                sys.exit("stream: %s" % error)
+            pos = end
+            yield frame_time, skipped, FRAME_HEADER.size + length, cycles, self.image
+        del self.data[:pos]
+
+def frame_ppm(image, colour):
+    """ The dots of a frame, every line twice. """
+    on = bytes(COLOURS[colour])
+    off = bytes(3)
+    table = [b"".join(on if (value >> (7 - bit)) & 1 else off for bit in range(8)) for value in range(256)]
+    rows = []
+    for line in range(LINES):
+        words = image[line * LINE_WORDS:(line + 1) * LINE_WORDS]
+        row = b"".join(table[b] for b in struct.pack(">%dI" % LINE_WORDS, *words))[FIRST_DOT * 3:(FIRST_DOT + 560) * 3]
+        rows += [row, row]
+    return b"P6\n560 %d\n255\n" % (2 * LINES) + b"".join(rows)
+
+def open_source(path):
+    """ A file object reading the stream, the CDC port in raw mode. """
+    f = open(path, "rb", buffering=0)
+    if stat.S_ISCHR(os.fstat(f.fileno()).st_mode):
+        import termios
+        import tty
+        tty.setraw(f.fileno())
+        attributes = termios.tcgetattr(f.fileno())
+        attributes[6][termios.VMIN] = 0
+        attributes[6][termios.VTIME] = 1        # reads return after 0.1s without data
+        termios.tcsetattr(f.fileno(), termios.TCSANOW, attributes)
+    return f
+
+def receive(args):
+    window = None
+    if not args.no_window:
+        try:
+            import tkinter
+            window = tkinter.Tk()
+            window.title("A2C stream %s" % args.source)
+            label = tkinter.Label(window)
+            label.pack()
+        except Exception as error:
+            print("no window (%s)" % error)
+            window = None
+
+    receiver = Receiver()
+    source = open_source(args.source)
+    save = open(args.save, "wb") if args.save else None
+    frames = 0
+    skipped = 0
+    received = 0
+    report = time.time()
+    photo = None
+    try:
+        while args.frames == 0 or frames < args.frames:
+            data = source.read(4096)
+            if not data and not stat.S_ISCHR(os.fstat(source.fileno()).st_mode):
+                break
+            received += len(data)
+            if save:
+                save.write(data)
+            latest = None
+            for frame_time, frame_skipped, length, cycles, image in receiver.feed(data):
+                frames += 1
+                skipped += frame_skipped
+                if args.ppm and (frames - 1) % args.every == 0:
+                    os.makedirs(args.ppm, exist_ok=True)
+                    with open(os.path.join(args.ppm, "frame_%06d.ppm" % (frames - 1)), "wb") as f:
+                        f.write(frame_ppm(image, args.colour))
+                latest = image
+                if args.frames and frames >= args.frames:
+                    break
+            if window is not None:
+                if latest is not None:
+                    photo = tkinter.PhotoImage(data=frame_ppm(latest, args.colour), format="PPM")
+                    label.configure(image=photo)
+                window.update()
+            now = time.time()
+            if now - report >= 1.0:
+                print("%d frames, %d skipped, %.1fKB/s" % (frames, skipped, received / 1024.0 / (now - report)))
+                received = 0
+                report = now
+    except KeyboardInterrupt:
+        pass
+    finally:
+        source.close()
+        if save:
+            save.close()
+
+def frame_cost(data, pos, end):
+    """ (changed words, runs) of a frame. """
+    changed = runs = 0
+    while pos < end:
+        tag = data[pos]
+        count = (tag & 0x7f) + 1
+        runs += 1
+        if tag & 0x80:
+            changed += count
+            pos += 1 + 4 * count
+        else:
+            pos += 1
+    return changed, runs
+
+def estimated_cycles(changed, runs):
+    return (FRAME_WORDS * WORD_COST + changed * LITERAL_COST + runs * RUN_COST +
+            (LINES // STEP_LINES) * STEP_COST)
+
+def bench(data, measured=True):
+    receiver = Receiver()
+    frames = []
+    for frame_time, skipped, length, cycles, image in receiver.feed(data):
+        frames.append((frame_time, skipped, length, cycles))
+    if not frames:
+        sys.exit("no frames in the stream")
+
+    # the cost of every frame from its runs, the stream is parsed again without decoding
+    estimates = []
+    pos = data.find(struct.pack("<IH", MAGIC, VERSION)) + HEADER.size
+    for frame_time, skipped, length, cycles in frames:
+        changed, runs = frame_cost(data, pos + FRAME_HEADER.size, pos + length)
+        estimates.append(estimated_cycles(changed, runs))
+        pos += length
+
+    clock_khz = receiver.header["sys_clock_khz"]
+    duration_us = (frames[-1][0] - frames[0][0]) & 0xffffffff
+    total = sum(1 + skipped for frame_time, skipped, length, cycles in frames[1:])
+    sizes = [length for frame_time, skipped, length, cycles in frames]
+    raw = FRAME_WORDS * 4
+    print("%d frames, %d skipped (%.1f%%), %d bytes before the first frame" %
+          (len(frames), total - (len(frames) - 1), 100.0 * (total - len(frames) + 1) / max(total, 1), receiver.garbage))
+    if duration_us:
+        print("%.1f frames/s over %.1fs, %.1fKB/s" % ((len(frames) - 1) * 1e6 / duration_us, duration_us / 1e6,
+                                                     sum(sizes[1:]) * 1e6 / duration_us / 1024.0))
+    print("frame size: average %d bytes, max %d bytes, %.1fx smaller than the %d bytes of a raw frame" %
+          (sum(sizes) // len(sizes), max(sizes), raw * len(sizes) / float(sum(sizes)), raw))
+    print("frames above the USB budget of %d bytes per frame: %d" % (USB_BUDGET, sum(size > USB_BUDGET for size in sizes)))
+
+    frame_cycles = clock_khz * FRAME_US / 1000.0
+    for name, cycles in (("measured", [c for t, s, l, c in frames]), ("estimated", estimates)):
+        if name == "measured" and (not measured or not any(cycles)):
+            continue
+        print("encoder (%s): average %d cycles, max %d cycles per frame, %.2f%% of a frame at %dMHz" %
+              (name, sum(cycles) // len(cycles), max(cycles), 100.0 * max(cycles) / frame_cycles, clock_khz // 1000))
+
+HARNESS = r"""
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+uint32_t s_screen_buffer[3][192][19];
+uint32_t s_screen_GR_mask[3][192];
+uint32_t s_screen_TEXT_mask[3][192];
+uint64_t s_screen_D7_buffer[3][192];
+uint32_t s_line_capture_time[3][192];
+
+//  settings of a2c_record_start
+volatile uint32_t internal_flags;
+volatile uint8_t color_mode;
+uint8_t cfg_color_style, cfg_rendering_fx;
+bool cfg_laser_enabled;
+int8_t cfg_ntsc_hue, cfg_ntsc_saturation, cfg_ntsc_brightness, cfg_ntsc_sharpness;
+
+//  FLASH_RECORD, __FLASH_RECORD_LEN is defined by the linker like in the firmware
+uint8_t __attribute__((aligned(4096))) __record_data_start[RECORD_LEN];
+
+void flash_range_erase(uint32_t offset, size_t count)
+{
+    if ((offset % 4096) || (count % 4096))
+        abort();
+    memset((uint8_t*)(uintptr_t) offset, 0xff, count);
+}
+
+void flash_range_program(uint32_t offset, const uint8_t* data, size_t count)
+{
+    uint8_t* flash = (uint8_t*)(uintptr_t) offset;
+    if ((offset % 256) || (count % 256) || (flash < __record_data_start) || (flash + count > __record_data_start + RECORD_LEN))
+        abort();
+    //  programming clears bits only
+    for (size_t i = 0; i < count; i++)
+        flash[i] &= data[i];
+}
+
+static uint32_t s_budget;                   //  bytes the host reads per frame
+static uint32_t s_available;
+
+bool tud_cdc_connected(void) { return s_budget != 0; }
+void tud_cdc_write_clear(void) { }
+uint32_t tud_cdc_write_available(void) { return s_available; }
+uint32_t tud_cdc_write(const void* buffer, uint32_t size)
+{
+    size = (size < s_available) ? size : s_available;
+    fwrite(buffer, 1, size, stdout);
+    s_available -= size;
+    return size;
+}
+uint32_t tud_cdc_write_flush(void) { return 0; }
+
+#include "a2c_delta.c"
+#include "a2c_record.h"
+#include "a2c_stream.h"
+
+//  harness BUDGET STEPS REFERENCE RECORD < frames > stream: every frame is 192 x 22 words (the
+//  lines of a recording), the capture core gets STEPS steps per frame (a list like 20,1000 is
+//  repeated frame by frame), the host reads BUDGET
+//  bytes per frame (0: the port is closed), and with a RECORD file the frames are recorded as well
+int main(int argc, char** argv)
+{
+    s_budget = atoi(argv[1]);
+    uint32_t steps[16];
+    uint32_t steps_count = 0;
+    char* p = argv[2];
+    while (*p && (steps_count < 16))
+    {
+        steps[steps_count++] = strtoul(p, &p, 10);
+        if (*p == ',')
+            p++;
+    }
+    bool record = (argc > 4);
+    uint32_t words[192 * 22];
+    uint32_t buffer = 0;
+
+    //  the host opens the port, the recording is started from the menu
+    a2c_stream_send();
+    if (record && !a2c_record_start())
+        return 1;
+    for (uint32_t frame = 0; fread(words, 4, 192 * 22, stdin) == 192 * 22; frame++)
+    {
+        //  a2c_loop: capture into the buffer after the previous one
+        buffer = frame % 3;
+        for (uint32_t line = 0; line < 192; line++)
+        {
+            const uint32_t* w = &words[line * 22];
+            for (uint32_t word = 0; word < 18; word++)
+                s_screen_buffer[buffer][line][word] = w[word];
+            s_screen_GR_mask[buffer][line]   = w[18];
+            s_screen_TEXT_mask[buffer][line] = w[19];
+            s_screen_D7_buffer[buffer][line] = w[20] | ((uint64_t) w[21] << 32);
+            s_line_capture_time[buffer][line] = frame * 16683 + line * 65;
+        }
+        a2c_record_frame(buffer);
+        a2c_stream_frame(buffer);
+        a2c_delta_frame(buffer);
+        for (uint32_t step = 0; (step < steps[frame % steps_count]) && a2c_delta_pending(); step++)
+            a2c_delta_step();
+
+        //  render core, vertical blank
+        s_available = s_budget;
+        a2c_stream_send();
+        a2c_record_write();
+    }
+
+    //  the last frame, everything in the stream ring, then stop and save the recording
+    while (a2c_delta_pending())
+        a2c_delta_step();
+    do
+    {
+        s_available = s_budget;
+        a2c_stream_send();
+    } while (s_available != s_budget);
+    a2c_record_stop();
+    while (a2c_record_state != A2cRecordIdle)
+    {
+        a2c_record_frame(buffer);
+        a2c_record_write();
+    }
+
+    FILE* f = fopen(argv[3], "wb");
+    fwrite(s_reference, 4, A2C_DELTA_FRAME_WORDS, f);
+    fclose(f);
+    if (record)
+    {
+        f = fopen(argv[4], "wb");
+        fwrite(__record_data_start, 1, RECORD_LEN, f);
+        fclose(f);
+    }
+    return 0;
+}
+"""
+
+STUBS = {
+    "pico/stdlib.h"              : "typedef unsigned int uint;\n#define MIN(a, b) ((a) < (b) ? (a) : (b))\n#define XIP_BASE 0\n",
+    "hardware/clocks.h"          : "#define clk_sys 0\n#define clock_get_hz(clock) 252000000u\n",
+    "hardware/flash.h"           : "void flash_range_erase(uint32_t offset, size_t count);\n"
+                                   "void flash_range_program(uint32_t offset, const uint8_t* data, size_t count);\n",
+    "hardware/sync.h"            : "#define __dmb()\n",
+    "hardware/structs/systick.h" : "static struct { uint32_t csr, rvr, cvr; } s_systick;\n#define systick_hw (&s_systick)\n",
+    "applebus/buffers.h"         : "extern volatile uint32_t internal_flags;\n",
+    "config/config.h"            : "#define __time_critical_func(x) x\n#define DELAYED_COPY_CODE(x) x\n"
+                                   "extern volatile uint8_t color_mode;\nextern uint8_t cfg_color_style, cfg_rendering_fx;\n"
+                                   "extern bool cfg_laser_enabled;\n"
+                                   "extern int8_t cfg_ntsc_hue, cfg_ntsc_saturation, cfg_ntsc_brightness, cfg_ntsc_sharpness;\n",
+    "debug/debug.h"              : "static inline void ram_budget_add(const char* name, uint32_t bytes) { }\n",
+    "tusb.h"                     : "bool tud_cdc_connected(void);\nvoid tud_cdc_write_clear(void);\n"
+                                   "uint32_t tud_cdc_write_available(void);\nuint32_t tud_cdc_write(const void* buffer, uint32_t size);\n"
+                                   "uint32_t tud_cdc_write_flush(void);\n",
+}
+
+def build(cc, workdir, record_len=RECORD_LEN, defines=()):
+    """ The harness with a2c_delta.c, a2c_stream.c and a2c_record.c, built like the firmware
+        with both outputs, the flash area of the recorder is record_len bytes. """
+    for name, text in STUBS.items():
+        os.makedirs(os.path.dirname(os.path.join(workdir, name)), exist_ok=True)
+        with open(os.path.join(workdir, name), "w") as f:
+            f.write("#pragma once\n#include <stddef.h>\n#include <stdint.h>\n#include <stdbool.h>\n" + text)
+    with open(os.path.join(workdir, "harness.c"), "w") as f:
+        f.write(HARNESS)
+    exe = os.path.join(workdir, "a2c_stream_harness")
+    sources = [os.path.join(workdir, "harness.c")] + [os.path.join(FIRMWARE, name) for name in ("a2c_stream.c", "a2c_record.c")]
+    # the firmware keeps flash addresses in 32 bits, the fake flash is linked below 4GB
+    result = subprocess.run([cc, "-std=gnu11", "-O2", "-Wall", "-Wno-pointer-to-int-cast", "-fno-pie", "-no-pie",
+                             "-DFEATURE_A2C", "-DFEATURE_A2C_RECORD", "-DFEATURE_A2C_STREAM", "-DRECORD_LEN=%d" % record_len,
+                             "-Wl,--defsym=__FLASH_RECORD_LEN=%d" % record_len,
+                             "-I" + workdir, "-I" + FIRMWARE] + ["-D" + define for define in defines] + sources + ["-o", exe],
+                            capture_output=True, text=True)
+    if result.returncode != 0:
+        sys.exit("build failed:\n%s" % result.stderr)
+    return exe
+
+def run(exe, workdir, frames, budget, steps, record=False):
+    """ Returns (stream, the encoder's reference after the last frame, the FLASH_RECORD area
+        or None). frames are images of a recording, their line times are generated. """
+    reference = os.path.join(workdir, "reference.bin")
+    flash = os.path.join(workdir, "record.bin")
+    size = LINES * a2c_record.LINE_WORDS
+    words = b"".join(struct.pack("<%dI" % size, *frame[:size]) for frame in frames)
+    steps = ",".join(str(n) for n in steps) if isinstance(steps, tuple) else str(steps)
+    result = subprocess.run([exe, str(budget), steps, reference] + ([flash] if record else []), input=words, capture_output=True)
+    if result.returncode != 0:
+        sys.exit("harness failed (%d)" % result.returncode)
+    data = open(reference, "rb").read()
+    return (result.stdout, list(struct.unpack("<%dI" % (len(data) // 4), data)),
+            open(flash, "rb").read() if record else None)
+
+def dots(image):
+    """ The SEROUT words of a recording image, a stream image. """
+    return [image[line * a2c_record.LINE_WORDS + word] for line in range(LINES) for word in range(LINE_WORDS)]
+
+def record_frames(path):
+    """ The images of the frames of an A2C recording. """
+    data = open(path, "rb").read()
+    header = a2c_record.read_header(data)
+    return [image for frame_time, skipped, length, image in a2c_record.read_frames(data, header)]
+
+def test_frames(rng):
+    """ A text screen being typed on and scrolled, hires noise and a blank screen, with the GR,
+        TEXT and VIDD7 words of a recording. """
+    frames = []
+    text = [[rng.getrandbits(32) & 0x3f3f3f3f for word in range(LINE_WORDS)] + [0, 0xffffff, 0, 0] for line in range(LINES)]
+    for n in range(40):
+        line = rng.randrange(LINES)
+        text[line][rng.randrange(LINE_WORDS)] ^= 1 << rng.randrange(32)
+        if n % 8 == 7:
+            text = text[8:] + text[:8]                  # scroll by a text line
+        frames.append([word for row in text for word in row])
+    for n in range(6):
+        frames.append([rng.getrandbits(32) for word in range(LINES * a2c_record.LINE_WORDS)])
+    frames += [[0] * (LINES * a2c_record.LINE_WORDS)] * 4
+    return frames
+
+def record_image(frame):
+    """ The recorded image of an input frame of the harness, its lines are 65us apart. """
+    return frame[:LINES * a2c_record.LINE_WORDS] + [0x41414100] + [0x41414141] * (a2c_record.TIMES_WORDS - 1)
+
+def check_stream(stream, reference, frames):
+    """ (frames received, last frame number, errors) of a stream of the harness. """
+    receiver = Receiver()
+    received = 0
+    count = 0
+    number = -1
+    errors = 0
+    image = None
+    for frame_time, skipped, length, cycles, image in receiver.feed(stream):
+        number = frame_time // 16683
+        count += 1 + skipped
+        received += 1
+        # frames are sent complete (encoded before their buffer is captured into again) or not at all
+        if image != dots(frames[number]):
+            errors += 1
+    if image != dots(reference):
+        errors += 1
+    # the skipped frames add up to the frame numbers
+    if count != number + 1 or receiver.garbage:
+        errors += 1
+    return received, number, errors
+
+def check_record(flash, reference, frames, last):
+    """ (frames recorded, errors) of a recording of the harness, the stream ended with frame
+        number last. """
+    header = a2c_record.read_header(flash)
+    count = 0
+    number = -1
+    errors = 0
+    image = None
+    for frame_time, skipped, length, image in a2c_record.read_frames(flash, header):
+        number = frame_time // 16683
+        count += 1 + skipped
+        if image != record_image(frames[number]):
+            errors += 1
+    # the running outputs take the same frames, the last one is the reference
+    if number == last and image != reference:
+        errors += 1
+    if count != number + 1 or count > header["frame_count"] + header["skipped"]:
+        errors += 1
+    # the recording is stopped after the last frame unless the flash area is full
+    full = header["data_bytes"] + a2c_record.RING_SIZE > len(flash) - header["page_size"]
+    if header["frame_count"] + header["skipped"] != len(frames) and not full:
+        errors += 1
+    return header["frame_count"], errors
+
+def check(args):
+    frames = record_frames(args.source) if args.source else test_frames(random.Random(args.seed))
+    workdir = tempfile.mkdtemp(prefix="a2c_stream")
+    exe = build(args.cc, workdir)
+    errors = 0
+    # (bytes the host reads per frame, capture core steps per frame), streamed and recorded
+    for budget, steps in ((1 << 20, 1000), (USB_BUDGET, 1000), (300, 1000), (1 << 20, 30), (USB_BUDGET, 7)):
+        for record in (False, True):
+            stream, reference, flash = run(exe, workdir, frames, budget, steps, record)
+            received, last, bad = check_stream(stream, reference, frames)
+            recorded = ""
+            if record:
+                count, record_bad = check_record(flash, reference, frames, last)
+                recorded = ", %d recorded" % count
+                bad += record_bad
+            print("budget %7d bytes, %4d steps: %d of %d frames sent%s, %d bytes, %s" %
+                  (budget, steps, received, len(frames), recorded, len(stream), "ok" if bad == 0 else "%d errors" % bad))
+            errors += bad
+    print("%d errors" % errors)
+    sys.exit(1 if errors else 0)
+
+def bench_record(args):
+    workdir = tempfile.mkdtemp(prefix="a2c_stream")
+    stream, reference, flash = run(build(args.cc, workdir), workdir, record_frames(args.source), args.budget, 1000)
+    bench(stream, measured=False)
+
+def main():
+    parser = argparse.ArgumentParser(description="Receive, show and benchmark the A2C live stream")
+    parser.add_argument("source",     nargs="?",     help="the CDC port of the A2C board (/dev/ttyACM0) or a saved stream")
+    parser.add_argument("--save",                    help="write the received stream to this file")
+    parser.add_argument("--ppm",                     help="write frames to this directory")
+    parser.add_argument("--every",    default=1, type=int, help="with --ppm, write every N'th frame")
+    parser.add_argument("--frames",   default=0, type=int, help="stop after N frames")
+    parser.add_argument("--colour",   default="white", choices=sorted(COLOURS), help="colour of the dots")
+    parser.add_argument("--no-window", action="store_true", help="do not show the frames")
+    parser.add_argument("--bench",    action="store_true", help="report the bandwidth and encoder cost of a saved stream")
+    parser.add_argument("--record",   action="store_true", help="with --bench, SOURCE is an A2C recording")
+    parser.add_argument("--budget",   default=USB_BUDGET, type=int, help="with --record, bytes sent per frame")
+    parser.add_argument("--check",    action="store_true", help="check a2c_stream.c built for this computer")
+    parser.add_argument("--seed",     default=1, type=int, help="random seed of the --check frames")
+    parser.add_argument("--cc",       default=os.environ.get("CC", "gcc"), help="host C compiler")
+    args = parser.parse_args()
+
+    if args.check:
+        check(args)
+    elif not args.source:
+        parser.error("SOURCE is needed")
+    elif args.bench and args.record:
+        bench_record(args)
+    elif args.bench:
+        bench(open(args.source, "rb").read())
+    else:
+        receive(args)
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,378 @@
+#!/usr/bin/env python3
+
+# MIT License
+# Copyright (c) 2025 Michael Neil, Far Left Lane
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+
+# Host check of the A2C text recognition (FEATURE_A2C_TEXT, firmware/a2c/a2c_text.c).
+#
+# Renders text screens with the character ROMs of firmware/fonts into SEROUT dots, the way
+# the IIc shows them (normal, inverse and flashing characters, ALTCHAR on and off, 40 and 80
+# columns), runs them through a2c_text.c built for this computer and checks that
+#  * every text row is recognized, with codes whose glyphs are the dots that were sent
+#    (render_text40_line/render_text80_line show them with ALTCHAR),
+#  * rows with graphics (GR high), noise or a glyph of another ROM are not recognized,
+#  * language_switch selects the half of character_rom in the index,
+#  * the USB serial snapshot is the screen as ASCII, and only sent when the text changes.
+# It also reports the steps of the capture core per frame and the longest lookup (slots
+# probed) of the index of each ROM, what the idle time of the capture core must cover.
+#
+# Usage: a2c_text_check.py [--font NAME ...] [--seed N] [--cc CC]
+
+import argparse
+import glob
+import os
+import random
+import re
+import struct
+import subprocess
+import sys
+import tempfile
+
+REPO = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SOURCE = os.path.join(REPO, "firmware", "a2c", "a2c_text.c")
+FONTS = os.path.join(REPO, "firmware", "fonts")
+
+ROWS = 24
+LINES = 192
+LINE_WORDS = 19                     # 18 SEROUT words and the blank one
+FIRST_BYTE_DOT = 7                  # A2C_FIRST_BYTE_DOT
+MOUSETEXT = "*"                     # A2C_TEXT_MOUSETEXT
+
+HARNESS = r"""
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+uint32_t s_screen_buffer[3][192][19];
+uint32_t s_screen_GR_mask[3][192];
+uint8_t character_rom[2 * 2048];
+volatile bool language_switch;
+
+static uint8_t  s_cdc[4096];
+static uint32_t s_cdc_size;
+
+bool tud_cdc_connected(void) { return true; }
+uint32_t tud_cdc_write_available(void) { return sizeof(s_cdc) - s_cdc_size; }
+uint32_t tud_cdc_write(const void* buffer, uint32_t size)
+{
+    memcpy(&s_cdc[s_cdc_size], buffer, size);
+    s_cdc_size += size;
+    return size;
+}
+uint32_t tud_cdc_write_flush(void) { return 0; }
+
+#include "a2c_text.c"
+
+//  The most slots probed by a lookup of a glyph of the index
+static uint32_t max_probe(void)
+{
+    uint32_t result = 0;
+    for (uint32_t code = 0; code < A2C_TEXT_GLYPHS; code++)
+    {
+        uint32_t slot = text_hash(s_glyphs[code]);
+        uint32_t probe = 1;
+        while (s_index[slot] != 0)
+        {
+            if (s_glyphs[s_index[slot] - 1] == s_glyphs[code])
+                break;
+            slot = (slot + 1) & (A2C_TEXT_HASH_SIZE - 1);
+            probe++;
+        }
+        result = (probe > result) ? probe : result;
+    }
+    return result;
+}
+
+//  harness ROM < screens > results: a screen is uint32_t language_switch, 192 x 19 words of dots and
+//  192 GR masks. Each result: uint32_t rows, rows80, rows_inverse, steps, max probe, main[24][40], aux[24][40],
+//  uint32_t bytes sent to USB serial and the bytes.
+int main(int argc, char** argv)
+{
+    FILE* rom = fopen(argv[1], "rb");
+    if ((rom == NULL) || (fread(character_rom, 1, sizeof(character_rom), rom) != sizeof(character_rom)))
+        return 1;
+    fclose(rom);
+
+    uint32_t language;
+    for (uint32_t n = 0; fread(&language, 4, 1, stdin) == 1; n++)
+    {
+        uint32_t frame = n % 3;
+        if ((fread(s_screen_buffer[frame], 4, 192 * 19, stdin) != 192 * 19) ||
+            (fread(s_screen_GR_mask[frame], 4, 192, stdin) != 192))
+            return 2;
+
+        //  render core: the index, capture core: the frame
+        language_switch = language;
+        a2c_text_update();
+        a2c_text_frame(frame, (frame + 1) % 3);
+        uint32_t steps = 0;
+        while (a2c_text_pending())
+        {
+            a2c_text_step();
+            steps++;
+        }
+
+        //  render core, the frame is shown
+        s_cdc_size = 0;
+        a2c_text_send(frame);
+
+        uint32_t header[5] = { s_text[frame].rows, s_text[frame].rows80, s_text[frame].rows_inverse, steps, max_probe() };
+        fwrite(header, 4, 5, stdout);
+        fwrite(s_text[frame].main, 1, sizeof(s_text[frame].main), stdout);
+        fwrite(s_text[frame].aux, 1, sizeof(s_text[frame].aux), stdout);
+        fwrite(&s_cdc_size, 4, 1, stdout);
+        fwrite(s_cdc, 1, s_cdc_size, stdout);
+    }
+    return 0;
+}
+"""
+
+STUBS = {
+    "pico/stdlib.h"         : "typedef unsigned int uint;\n#define MIN(a, b) ((a) < (b) ? (a) : (b))\n",
+    "hardware/sync.h"       : "#define __dmb()\n",
+    "config/config.h"       : "#define __time_critical_func(x) x\n#define DELAYED_COPY_CODE(x) x\n",
+    "applebus/buffers.h"    : "#include <stdbool.h>\nextern uint8_t character_rom[];\nextern volatile bool language_switch;\n",
+    "debug/debug.h"         : "static inline void ram_budget_add(const char* name, uint32_t bytes) { }\n",
+    "tusb.h"                : "",
+}
+
+def read_font(name):
+    """ The 256 x 8 glyph rows of a font of firmware/fonts, bit 0 the leftmost dot. """
+    text = open(os.path.join(FONTS, name + ".c")).read()
+    text = re.sub(r"//[^\n]*", "", text[text.index("{"):])
+    rows = [int(value, 2) for value in re.findall(r"\b0b([01]+)\b", text)]
+    if len(rows) != 256 * 8:
+        sys.exit("%s: %d glyph rows" % (name, len(rows)))
+    return rows
+
+def fonts():
+    return sorted(os.path.basename(path)[:-2] for path in glob.glob(os.path.join(FONTS, "*.c"))
+                  if os.path.basename(path) != "textfont.c")
+
+def glyph(rom, code, line):
+    return rom[code * 8 + line] & 0x7f
+
+def shown(rom, ch, line, altchar, flash):
+    """ The dots of a screen code, like char_text_bits of render_text.c. """
+    if (ch & 0x80) or altchar:
+        invert = 0
+    else:
+        invert = (0x7f if flash else 0) if (ch & 0x40) else 0x7f
+        ch = (ch & 0x3f) | 0x80
+    return (glyph(rom, ch, line) ^ invert) & 0x7f
+
+class Screen:
+    """ SEROUT dots and GR of a frame, dot n of a line is bit 31 - (n % 32) of word n / 32. """
+    def __init__(self, language=0):
+        self.language = language
+        self.words = [[0] * LINE_WORDS for line in range(LINES)]
+        self.gr = [0] * LINES
+
+    def dot(self, line, dot, value):
+        word, bit = dot >> 5, 31 - (dot & 31)
+        self.words[line][word] = (self.words[line][word] & ~(1 << bit)) | (value << bit)
+
+    def cell40(self, row, column, rows):
+        """ rows: the 8 glyph rows, bit 0 the leftmost dot, each dot doubled. """
+        for line in range(8):
+            for bit in range(7):
+                value = (rows[line] >> bit) & 1
+                start = FIRST_BYTE_DOT + 14 * column + 2 * bit
+                self.dot(row * 8 + line, start, value)
+                self.dot(row * 8 + line, start + 1, value)
+
+    def cell80(self, row, column, aux, main):
+        for line in range(8):
+            for bit in range(7):
+                start = FIRST_BYTE_DOT + 14 * column + bit
+                self.dot(row * 8 + line, start, (aux[line] >> bit) & 1)
+                self.dot(row * 8 + line, start + 7, (main[line] >> bit) & 1)
+
+    def pack(self):
+        words = [word for line in self.words for word in line]
+        return struct.pack("<I", self.language) + struct.pack("<%dI" % len(words), *words) + struct.pack("<192I", *self.gr)
+
+def build(cc, workdir):
+    for name, text in STUBS.items():
+        os.makedirs(os.path.dirname(os.path.join(workdir, name)), exist_ok=True)
+        with open(os.path.join(workdir, name), "w") as f:
+            f.write("#pragma once\n#include <stdint.h>\n" + text)
+    with open(os.path.join(workdir, "harness.c"), "w") as f:
+        f.write("#include <string.h>\n" + HARNESS)
+    exe = os.path.join(workdir, "a2c_text_harness")
+    result = subprocess.run([cc, "-std=gnu11", "-O2", "-Wall", "-DFEATURE_A2C", "-DFEATURE_A2C_TEXT",
+                             "-I" + workdir, "-I" + os.path.dirname(SOURCE), os.path.join(workdir, "harness.c"), "-o", exe],
+                            capture_output=True, text=True)
+    if result.returncode != 0:
+        sys.exit("build failed:\n%s" % result.stderr)
+    return exe
+
+def run(exe, workdir, rom, screens):
+    """ (rows, rows80, rows_inverse, steps, max probe, main, aux, serial) of each screen. """
+    path = os.path.join(workdir, "rom.bin")
+    with open(path, "wb") as f:
+        f.write(bytes(rom))
+    result = subprocess.run([exe, path], input=b"".join(screen.pack() for screen in screens), capture_output=True)
+    if result.returncode != 0:
+        sys.exit("harness failed (%d)" % result.returncode)
+    out, pos, results = result.stdout, 0, []
+    for screen in screens:
+        rows, rows80, inverse, steps, probe = struct.unpack_from("<5I", out, pos)
+        pos += 20
+        main = [list(out[pos + row * 40:pos + row * 40 + 40]) for row in range(ROWS)]
+        pos += ROWS * 40
+        aux = [list(out[pos + row * 40:pos + row * 40 + 40]) for row in range(ROWS)]
+        pos += ROWS * 40
+        size, = struct.unpack_from("<I", out, pos)
+        serial = out[pos + 4:pos + 4 + size]
+        pos += 4 + size
+        results.append((rows, rows80, inverse, steps, probe, main, aux, serial))
+    return results
+
+def ascii(code):
+    if 0x40 <= code < 0x60:
+        return MOUSETEXT
+    code &= 0x7f
+    return chr(code + 0x40 if code < 0x20 else code)
+
+def text_screen(rom, rng, language, columns, rows=range(ROWS)):
+    """ A random text screen, returns it with the shown glyphs of each row (24 lists of cells). """
+    screen = Screen(language)
+    cells = [None] * ROWS
+    for row in rows:
+        altchar, flash = rng.random() < 0.5, rng.random() < 0.5
+        cells[row] = []
+        for column in range(columns):
+            ch = rng.randrange(256)
+            cells[row].append([shown(rom, ch, line, altchar, flash) for line in range(8)])
+        for column in range(40):
+            if columns == 40:
+                screen.cell40(row, column, cells[row][column])
+            else:
+                screen.cell80(row, column, cells[row][2 * column], cells[row][2 * column + 1])
+    return screen, cells
+
+def graphics_rows(screen, rng, rows):
+    for row in rows:
+        for line in range(row * 8, row * 8 + 8):
+            screen.words[line][:18] = [rng.getrandbits(32) for word in range(18)]
+            screen.gr[line] = (1 << 18) - 1
+
+def check_font(exe, workdir, name, other, rng):
+    """ Returns (errors, steps, probe). """
+    local, alternate = read_font(name), read_font(other)
+    rom = local + alternate
+    errors = []
+
+    cases = []
+    screen, cells = text_screen(local, rng, 0, 40)
+    cases.append(("40 columns", screen, cells))
+    screen, cells = text_screen(local, rng, 0, 80)
+    cases.append(("80 columns", screen, cells))
+    screen, cells = text_screen(alternate, rng, 1, 80)
+    cases.append(("language switch", screen, cells))
+    screen, cells = text_screen(local, rng, 0, 40, range(20, 24))
+    graphics_rows(screen, rng, range(20))
+    cases.append(("mixed", screen, cells))
+    cases.append(("blank", Screen(), [[[0] * 8] * 40 for row in range(ROWS)]))
+
+    # a row with GR low but no text (hires noise), and one with a glyph that isn't in the ROM
+    screen, cells = text_screen(local, rng, 0, 80)
+    for line in range(8):
+        screen.words[line][:18] = [rng.getrandbits(32) for word in range(18)]
+    cells[0] = None
+    if name != other:
+        foreign = [g for g in ([glyph(alternate, code, line) for line in range(8)] for code in range(256))
+                   if g not in [[glyph(local, code, line) for line in range(8)] for code in range(256)]]
+        if foreign:
+            screen.cell80(5, 17, foreign[0], cells[5][35])
+            cells[5] = None
+    cases.append(("not text", screen, cells))
+
+    # the same screen again, nothing is sent
+    cases.append(("unchanged", cases[-1][1], cases[-1][2]))
+
+    results = run(exe, workdir, rom, [screen for case, screen, cells in cases])
+    steps = probe = 0
+    for (case, screen, cells), (rows, rows80, inverse, frame_steps, frame_probe, main, aux, serial) in zip(cases, results):
+        steps, probe = max(steps, frame_steps), max(probe, frame_probe)
+        font = alternate if screen.language else local
+        lines = []
+        for row in range(ROWS):
+            recognized = (rows >> row) & 1
+            if cells[row] is None:
+                if recognized:
+                    errors.append("%s: row %d is recognized" % (case, row))
+                lines.append("")
+                continue
+            if not recognized:
+                errors.append("%s: row %d is not recognized" % (case, row))
+                lines.append("")
+                continue
+            columns = 80 if (rows80 >> row) & 1 else 40
+            altchar = not (inverse >> row) & 1
+            codes = [c for pair in zip(aux[row], main[row]) for c in pair] if columns == 80 else main[row]
+            if columns != len(cells[row]):
+                errors.append("%s: row %d has %d columns" % (case, row, columns))
+                lines.append("")
+                continue
+            for column, code in enumerate(codes):
+                if not altchar and 0x40 <= code < 0x80:
+                    errors.append("%s: row %d column %d is code 0x%02x without ALTCHAR" % (case, row, column, code))
+                    break
+                if [shown(font, code, line, altchar, False) for line in range(8)] != cells[row][column]:
+                    errors.append("%s: row %d column %d is code 0x%02x, not the glyph shown" % (case, row, column, code))
+                    break
+            lines.append("".join(ascii(code) for code in codes).rstrip(" "))
+
+        snapshot = ("\f" + "".join(line + "\r\n" for line in lines)).encode("ascii")
+        if case == "unchanged":
+            if serial:
+                errors.append("%s: %d bytes sent" % (case, len(serial)))
+        elif serial != snapshot:
+            errors.append("%s: USB serial snapshot differs" % case)
+    return errors, steps, probe
+
+def main():
+    parser = argparse.ArgumentParser(description="Check the A2C text recognition with rendered text screens")
+    parser.add_argument("--font", action="append", help="fonts of firmware/fonts to check (default: all)")
+    parser.add_argument("--seed", default=1, type=int, help="random seed of the screens")
+    parser.add_argument("--cc",   default=os.environ.get("CC", "gcc"), help="host C compiler")
+    args = parser.parse_args()
+
+    names = args.font or fonts()
+    workdir = tempfile.mkdtemp(prefix="a2c_text")
+    exe = build(args.cc, workdir)
+    rng = random.Random(args.seed)
+    total = 0
+    for name in names:
+        errors, steps, probe = check_font(exe, workdir, name, "iie_us_enhanced", rng)
+        for error in errors[:10]:
+            print("  " + error)
+        print("%-26s %3d steps per frame, lookups probe up to %d slots, %d errors" % (name, steps, probe, len(errors)))
+        total += len(errors)
+    print("%d errors" % total)
+    sys.exit(1 if total else 0)
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,351 @@
+#!/usr/bin/env python3
+
+# MIT License
+# Copyright (c) 2025 Michael Neil, Far Left Lane
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+# Apple II bus trace tool (applebus/abus_trace.c, FEATURE_ABUS_TRACE builds).
+#
+# Reads a trace saved by the firmware ("picotool save -r 0x101d0000 0x101e0000 trace.bin")
+# and:
+#  * "info":   shows the header, compression and the bus cycle mix per abus_interface handler,
+#  * "raw":    writes the decoded bus cycles as raw 32 bit words, for abus_trace_bench.py,
+#  * "replay": replays the trace through the firmware's abus_trace_replay and abus_interface,
+#              built for the PC (tools/render_golden/abus_replay.c with the pico-sdk stand-in
+#              of render_golden), and prints the text page, the host time per bus cycle and
+#              the CRC32 of apple_memory/aux_memory, to compare with "TRACE CRC" of an
+#              on-device replay (card command 0x43). Card register accesses are skipped like
+#              on the device.
+#  * "encode": compresses raw 32 bit words (e.g. from abus_trace_bench.py) into a trace
+#              image, which can be written to the FLASH_TRACE area for an on-device replay,
+#  * "selftest": checks that encoding and decoding a synthetic workload is lossless.
+#
+# Usage: abus_trace.py info|raw|replay|encode|selftest [TRACE] [OUTPUT] [--cc CC]
+#
+# info and replay require a host C compiler (gcc or clang).
+
+import argparse
+import os
+import shutil
+import struct
+import subprocess
+import sys
+import tempfile
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "render_golden"))
+import render_golden
+
+ABUS_TRACE_MAGIC        = 0x52543241
+ABUS_TRACE_VERSION      = 1
+ABUS_TRACE_BLOCK_SIZE   = 256
+ABUS_TRACE_BLOCK_HEADER = 8
+ABUS_TRACE_WINDOW       = 256
+ABUS_TRACE_MAX_MATCH    = 64
+ABUS_TRACE_MATCH        = 0x40
+ABUS_TRACE_END          = 0xff
+FLASH_PAGE_SIZE         = 256
+TRACE_RECORD_MAX        = 6
+HEADER_FORMAT           = "<IHHIIIB3x"
+
+ADDR_FULL, ADDR_NEXT, ADDR_PAGE, ADDR_SAME = range(4)
+
+MAX_ADDRESS             = 0x6000
+SOFTSW_TEXT_MODE        = 0x00000001
+IFLAGS_IIE_REGS         = 0x00000001
+
+# the bus handling of the slotted firmware, built for the PC with tools/render_golden/abus_replay.c
+HOST_SOURCES = [
+    "applebus/abus.c",
+    "applebus/abus_trace.c",
+    "applebus/buffers.c",
+    "config/config.c",
+    "config/device_regs.c",
+    "render/render_cache.c",
+    "videx/videx_vterm.c",
+    "fonts/textfont.c",
+]
+
+def address_bus(value):
+    return (value >> 10) & 0xffff
+
+# --- decoder ---------------------------------------------------------------
+
+def decode_block(block):
+    """ Mirrors abus_trace_decode_block(). Returns (first cycle, soft switches, bus cycles). """
+    first_cycle, switches = struct.unpack_from("<II", block)
+    words = []
+    address = 0
+    pos = ABUS_TRACE_BLOCK_HEADER
+    while pos <= ABUS_TRACE_BLOCK_SIZE - 2:
+        tag = block[pos]
+        pos += 1
+        if tag == ABUS_TRACE_END:
+            break
+        if tag & ABUS_TRACE_MATCH:
+            length = (tag & 0x3f) + 1
+            distance = block[pos] + 1
+            pos += 1
+            if distance > len(words):
+                raise ValueError("match before the start of the block")
+            for _ in range(length):
+                words.append(words[-distance])
+        else:
+            mode = (tag >> 2) & 3
+            if mode == ADDR_FULL:
+                address = block[pos] | (block[pos+1] << 8)
+                pos += 2
+            elif mode == ADDR_NEXT:
+                address = (address + 1) & 0xffff
+            elif mode == ADDR_PAGE:
+                address = (address & 0xff00) | block[pos]
+                pos += 1
+            words.append((address << 10) | ((tag & 3) << 8) | block[pos])
+            pos += 1
+        address = address_bus(words[-1])
+    return first_cycle, switches, words
+
+def read_trace(path):
+    data = open(path, "rb").read()
+    magic, version, block_size, block_count, cycle_count, flags, machine = struct.unpack_from(HEADER_FORMAT, data)
+    if magic != ABUS_TRACE_MAGIC or version != ABUS_TRACE_VERSION or block_size != ABUS_TRACE_BLOCK_SIZE:
+        raise ValueError("%s: no bus trace (magic %08x, version %d)" % (path, magic, version))
+    header = { "block_count" : block_count, "cycle_count" : cycle_count, "internal_flags" : flags, "machine" : machine }
+    blocks = []
+    for i in range(block_count):
+        offset = FLASH_PAGE_SIZE + i * ABUS_TRACE_BLOCK_SIZE
+        blocks.append(decode_block(data[offset:offset + ABUS_TRACE_BLOCK_SIZE]))
+    return header, blocks
+
+# --- encoder ---------------------------------------------------------------
+
+class Encoder:
+    """ Mirrors abus_trace_record() (one shot mode, without the RAM size limit). """
+    def __init__(self, switches=SOFTSW_TEXT_MODE):
+        self.blocks = []
+        self.block = None
+        self.pos = ABUS_TRACE_BLOCK_SIZE
+        self.cycle = 0
+        self.block_cycle = 0
+        self.prev_address = None
+        self.match_length = 0
+        self.match_distance = 0
+        self.history = [0] * ABUS_TRACE_WINDOW
+        self.hash = [0] * 256
+        self.switches = switches
+
+    def flush_match(self):
+        if self.match_length:
+            self.block[self.pos:self.pos+2] = bytes((ABUS_TRACE_MATCH | (self.match_length - 1), self.match_distance - 1))
+            self.pos += 2
+            self.match_length = 0
+
+    def new_block(self):
+        if self.block is not None:
+            self.flush_match()
+            self.blocks.append(bytes(self.block))
+        self.block = bytearray(b"\xff" * ABUS_TRACE_BLOCK_SIZE)
+        struct.pack_into("<II", self.block, 0, self.cycle, self.switches)
+        self.pos = ABUS_TRACE_BLOCK_HEADER
+        self.block_cycle = self.cycle
+        self.prev_address = None
+
+    def literal(self, value):
+        address = address_bus(value)
+        prev = self.prev_address
+        if prev is None:
+            mode, extra = ADDR_FULL, bytes((address & 0xff, address >> 8))
+        elif address == (prev + 1) & 0xffff:
+            mode, extra = ADDR_NEXT, b""
+        elif address == prev:
+            mode, extra = ADDR_SAME, b""
+        elif (address >> 8) == (prev >> 8):
+            mode, extra = ADDR_PAGE, bytes((address & 0xff,))
+        else:
+            mode, extra = ADDR_FULL, bytes((address & 0xff, address >> 8))
+        record = bytes(((mode << 2) | ((value >> 8) & 3),)) + extra + bytes((value & 0xff,))
+        self.block[self.pos:self.pos+len(record)] = record
+        self.pos += len(record)
+
+    def record(self, value, switches=None):
+        if self.pos > ABUS_TRACE_BLOCK_SIZE - TRACE_RECORD_MAX:
+            if switches is not None:
+                self.switches = switches
+            self.new_block()
+
+        if self.match_length and (self.match_length >= ABUS_TRACE_MAX_MATCH or
+                                  self.history[(self.cycle - self.match_distance) % ABUS_TRACE_WINDOW] != value):
+            self.flush_match()
+
+        h = (value ^ (value >> 10) ^ (value >> 18)) & 0xff
+        if self.match_length:
+            self.match_length += 1
+        else:
+            candidate = self.hash[h]
+            distance = self.cycle - candidate
+            if (candidate >= self.block_cycle and 0 < distance <= ABUS_TRACE_WINDOW and
+                    self.history[candidate % ABUS_TRACE_WINDOW] == value):
+                self.match_length = 1
+                self.match_distance = distance
+            else:
+                self.literal(value)
+
+        self.hash[h] = self.cycle
+        self.history[self.cycle % ABUS_TRACE_WINDOW] = value
+        self.prev_address = address_bus(value)
+        self.cycle += 1
+
+    def image(self, internal_flags=IFLAGS_IIE_REGS, machine=0):
+        if self.block is not None:
+            self.flush_match()
+            self.blocks.append(bytes(self.block))
+            self.block = None
+        header = struct.pack(HEADER_FORMAT, ABUS_TRACE_MAGIC, ABUS_TRACE_VERSION, ABUS_TRACE_BLOCK_SIZE,
+                             len(self.blocks), self.cycle, internal_flags, machine)
+        return header + b"\xff" * (FLASH_PAGE_SIZE - len(header)) + b"".join(self.blocks)
+
+# --- host replay -----------------------------------------------------------
+
+class Host:
+    """ abus_replay built for the PC, see tools/render_golden/abus_replay.c. """
+    def __init__(self, cc):
+        self.workdir = tempfile.mkdtemp(prefix="abus_trace")
+        sources = HOST_SOURCES + render_golden.font_sources() + [os.path.join(render_golden.HERE, "abus_replay.c")]
+        self.exe = render_golden.host_build(cc, self.workdir, "abus_replay", sources, ["FEATURE_ABUS_TRACE"])
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        shutil.rmtree(self.workdir)
+
+    def run(self, *args):
+        result = subprocess.run([self.exe] + list(args), capture_output=True, text=True)
+        if result.returncode != 0:
+            sys.exit(result.stderr.strip())
+        return [line.split() for line in result.stdout.splitlines()]
+
+    def replay(self, trace):
+        """ Returns ({"cycles", "ns", "crc"}, main memory, aux memory). """
+        dump = os.path.join(self.workdir, "memory.bin")
+        result = { fields[0] : fields[1:] for fields in self.run(trace, dump) }
+        data = open(dump, "rb").read()
+        return result, data[:MAX_ADDRESS], data[MAX_ADDRESS:]
+
+    def profile(self, words, repeat=5):
+        """ Returns [(handler, bus cycles, host ns)] of abus_interface, the last one is "total",
+            and the handler of each bus cycle as an index into that list. """
+        path = os.path.join(self.workdir, "words.bin")
+        index = os.path.join(self.workdir, "index.bin")
+        with open(path, "wb") as f:
+            f.write(struct.pack("<%dI" % len(words), *words))
+        result = [(name, int(count), int(ns)) for name, count, ns in self.run("--profile", path, str(repeat), index)]
+        return result, open(index, "rb").read()
+
+def text_page(main, page=1):
+    base = 0x400 * page
+    lines = []
+    for row in range(24):
+        offset = base + ((row & 7) << 7) + (row >> 3) * 40
+        chars = []
+        for c in main[offset:offset+40]:
+            c &= 0x7f
+            if c < 0x20:
+                c += 0x40
+            chars.append(chr(c) if 0x20 <= c < 0x7f else ".")
+        lines.append("".join(chars))
+    return lines
+
+# --- commands --------------------------------------------------------------
+
+def all_words(blocks):
+    for _, _, words in blocks:
+        for value in words:
+            yield value
+
+def cmd_info(args):
+    header, blocks = read_trace(args.trace)
+    words = sum(len(w) for _, _, w in blocks)
+    print("%d blocks, %d bus cycles in flash (%d recorded), %.2f bytes per bus cycle" %
+          (header["block_count"], words, header["cycle_count"],
+           header["block_count"] * ABUS_TRACE_BLOCK_SIZE / max(words, 1)))
+    print("internal flags %08x, machine %d" % (header["internal_flags"], header["machine"]))
+    if blocks:
+        print("first block: bus cycle %d, soft switches %08x" % (blocks[0][0], blocks[0][1]))
+    with Host(args.cc) as host:
+        for name, count, _ in host.profile(list(all_words(blocks)), 1)[0][:-1]:
+            print("  %-13s %8d" % (name, count))
+
+def cmd_raw(args):
+    _, blocks = read_trace(args.trace)
+    words = list(all_words(blocks))
+    open(args.output, "wb").write(struct.pack("<%dI" % len(words), *words))
+    print("%d bus cycles written to %s" % (len(words), args.output))
+
+def cmd_replay(args):
+    read_trace(args.trace)
+    with Host(args.cc) as host:
+        result, main, aux = host.replay(args.trace)
+    for line in text_page(main):
+        print("|" + line + "|")
+    print("%s bus cycles replayed, %s ns per bus cycle on the host" % (result["cycles"][0], result["ns"][0]))
+    print("TRACE CRC: %s %s" % tuple(result["crc"]))
+
+def cmd_encode(args):
+    data = open(args.trace, "rb").read()
+    encoder = Encoder()
+    for value in struct.unpack("<%dI" % (len(data) // 4), data[:len(data) & ~3]):
+        encoder.record(value & 0x3ffffff)
+    image = encoder.image()
+    open(args.output, "wb").write(image)
+    print("%d bus cycles, %d bytes" % (encoder.cycle, len(image)))
+
+def cmd_selftest(args):
+    from abus_trace_bench import synthetic_trace
+    words = synthetic_trace(200000, 1)
+    encoder = Encoder()
+    for value in words:
+        encoder.record(value)
+    image = encoder.image()
+    blocks = []
+    for i in range(len(encoder.blocks)):
+        offset = FLASH_PAGE_SIZE + i * ABUS_TRACE_BLOCK_SIZE
+        blocks.append(decode_block(image[offset:offset + ABUS_TRACE_BLOCK_SIZE]))
+    decoded = list(all_words(blocks))
+    ok = decoded == words and all(b[0] == sum(len(x[2]) for x in blocks[:i]) for i, b in enumerate(blocks))
+    print("%d bus cycles, %d bytes (%.2f bytes per bus cycle): %s" %
+          (len(words), len(image), len(image) / len(words), "OK" if ok else "FAILED"))
+    return ok
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode and replay Apple II bus traces")
+    parser.add_argument("command", choices=("info", "raw", "replay", "encode", "selftest"))
+    parser.add_argument("trace",  nargs="?", help="trace image (raw words for encode)")
+    parser.add_argument("output", nargs="?", help="output file for raw/encode")
+    parser.add_argument("--cc",   default=os.environ.get("CC", "gcc"), help="host C compiler for info/replay")
+    args = parser.parse_args()
+
+    if args.command == "selftest":
+        sys.exit(0 if cmd_selftest(args) else 1)
+    if not args.trace or (args.command in ("raw", "encode") and not args.output):
+        parser.error("missing file name")
+    { "info" : cmd_info, "raw" : cmd_raw, "replay" : cmd_replay, "encode" : cmd_encode }[args.command](args)
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,192 @@
+#!/usr/bin/env python3
+
+# MIT License
+# Copyright (c) 2025 Michael Neil, Far Left Lane
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+# Benchmark of the Apple II bus cycle processing (applebus/abus.c).
+#
+# Replays a bus trace through a model of abus_loop: the bus cycles arrive at the
+# Apple II bus rate and each one takes the time of its abus_interface handler, so
+# the backlog in the ring buffer is simulated for:
+#  * "irq": the old PIO IRQ every 6 bus cycles, copying the RX FIFO into the ring,
+#  * "dma": the DMA ring capture, abus_loop following the DMA write address.
+#
+# The handler times are measured: the trace goes through the real abus_interface,
+# built for the PC (abus_trace.py, tools/render_golden/abus_replay.c), which gives
+# the host time of each bus_functions[] handler. --device-ns scales them to the
+# device: "TRACE NS/CYCLE" on the debug monitor after replaying the same trace on
+# the device (abus_trace.py encode, card command 0x43). That time covers the replay
+# loop around abus_interface too (reading the decoded word, the card select check
+# and the cycle counter), which is what abus_loop does per ring entry apart from
+# the audio sample counter. Without --device-ns the host times are used as they
+# are, i.e. the report is for a device as fast as the host.
+#
+# The report gives the sustainable bus cycles per second (the rate at which the
+# backlog would grow without bound) and the ring high water mark, which can be
+# compared with "R:" on the debug monitor.
+#
+# A trace is the raw ring buffer content: little endian 32 bit words, data in
+# bits 0-7, ~SELECT in bit 8, R/W in bit 9 and the address in bits 10-25.
+# Without a trace file a synthetic 6502 workload is generated.
+#
+# Usage: abus_trace_bench.py [TRACE] [--device-ns NS] [--sys-mhz MHZ] [--stall-us US] [--cycles N] [--cc CC]
+
+import argparse
+import os
+import random
+import struct
+
+from abus_trace import Host
+
+APPLE_BUS_HZ       = 1020484        # 14.31818MHz * 65 / 912
+ABUS_RING_SIZE     = 4096
+ABUS_RING_WARN     = ABUS_RING_SIZE - ABUS_RING_SIZE // 8
+IRQ_BATCH          = 6              # abus.pio raised irq 0 every 6 bus cycles
+
+# system clock cycles of the capture paths around abus_loop, not part of the replay: the IRQ
+# handler is no longer in the firmware and the DMA poll is a few register reads per batch
+IRQ_ENTRY_COST     = 30             # exception entry/exit, pio_interrupt_clear
+IRQ_WORD_COST      = 14             # FIFO empty check, FIFO read, volatile index update, overflow compare
+DMA_POLL_COST      = 12             # read the DMA write address, backlog and high water mark
+
+def bus_word(address, data, write, select=False):
+    return (address << 10) | ((0 if write else 1) << 9) | ((0 if select else 1) << 8) | (data & 0xff)
+
+def synthetic_trace(cycles, seed):
+    """ A 6502 running code from RAM and ROM, writing to the text/hires pages and polling the keyboard. """
+    rng = random.Random(seed)
+    trace = []
+    pc = 0x0800
+    while len(trace) < cycles:
+        r = rng.random()
+        if r < 0.02:
+            pc = rng.choice((0x0800, 0x6000, 0xd000, 0xf800))
+        trace.append(bus_word(pc, rng.randrange(256), False))
+        pc = (pc + 1) & 0xffff
+        r = rng.random()
+        if r < 0.15:
+            trace.append(bus_word(rng.randrange(0x100), rng.randrange(256), rng.random() < 0.4))
+        elif r < 0.20:
+            trace.append(bus_word(rng.choice((0x0400, 0x2000, 0x4000)) + rng.randrange(0x400), rng.randrange(256), True))
+        elif r < 0.22:
+            trace.append(bus_word(rng.choice((0xc000, 0xc010, 0xc030, 0xc054, 0xc055)), rng.randrange(256), rng.random() < 0.3))
+        elif r < 0.221:
+            trace.append(bus_word(0xc0b0 + rng.randrange(16), rng.randrange(256), True, True))
+    return trace[:cycles]
+
+def read_trace(path):
+    data = open(path, "rb").read()
+    return list(struct.unpack("<%dI" % (len(data) // 4), data[:len(data) & ~3]))
+
+def handler_costs(profile, device_ns, sys_hz):
+    """ System clocks per bus cycle of each handler, from the host profile of abus_interface. """
+    ns = { name : cycles_ns / count for name, count, cycles_ns in profile if count }
+    scale = 1.0
+    if device_ns:
+        # the device replay skips card selects, like abus_trace_replay does
+        replayed = [(count, cycles_ns) for name, count, cycles_ns in profile[:-1] if name != "card_select"]
+        host_ns = sum(c for _, c in replayed) / max(sum(n for n, _ in replayed), 1)
+        scale = device_ns / host_ns
+    return { name : t * scale * sys_hz / 1e9 for name, t in ns.items() }
+
+def simulate(trace, handlers, costs, method, sys_hz, stall_us, stall_period_us):
+    """ Returns (ring high water, lost bus cycles). """
+    bus_cycle = sys_hz / APPLE_BUS_HZ          # system clocks per bus cycle
+    stall = stall_us * sys_hz / 1e6
+    stall_period = stall_period_us * sys_hz / 1e6
+    batch = IRQ_BATCH if method == "irq" else 1
+
+    finish = []                                 # time at which each bus cycle was processed
+    t = 0.0
+    done = 0
+    high_water = 0
+    lost = 0
+    for i in range(len(trace)):
+        # ring (and FIFO) usage when this bus cycle arrives
+        arrival = i * bus_cycle
+        while done < i and finish[done] <= arrival:
+            done += 1
+        backlog = i - done + 1
+        high_water = max(high_water, backlog)
+        if backlog > ABUS_RING_SIZE:
+            lost += 1
+
+        # the loop sees the cycle when the IRQ has copied its batch, or as soon as the DMA wrote it
+        visible = ((i // batch) + 1) * batch * bus_cycle - bus_cycle
+        cost = costs[handlers[i]]
+        if method == "irq":
+            cost += IRQ_WORD_COST + IRQ_ENTRY_COST / IRQ_BATCH
+        start = max(t, visible)
+        if method == "dma" and start == visible:
+            cost += DMA_POLL_COST
+
+        # the loop was held up by something slow (flash access, menu drawing)
+        if stall > 0:
+            k = int(start // stall_period)
+            if k > 0 and start < k * stall_period + stall:
+                start = k * stall_period + stall
+
+        t = start + cost
+        finish.append(t)
+
+    return high_water, lost
+
+def main():
+    parser = argparse.ArgumentParser(description="Replay an Apple II bus trace through a model of abus_loop")
+    parser.add_argument("trace",      nargs="?",     help="bus trace (raw 32 bit ring buffer words)")
+    parser.add_argument("--device-ns", type=float,   help="TRACE NS/CYCLE of an on-device replay of the trace")
+    parser.add_argument("--sys-mhz",  default=252.0, type=float, help="system clock (252 for 640x480, 270 for 720x480)")
+    parser.add_argument("--stall-us", default=0.0,   type=float, help="consumer stall, e.g. a flash write")
+    parser.add_argument("--stall-period-ms", default=100.0, type=float, help="time between consumer stalls")
+    parser.add_argument("--cycles",   default=1000000, type=int, help="length of the synthetic trace")
+    parser.add_argument("--seed",     default=1,     type=int, help="random seed of the synthetic trace")
+    parser.add_argument("--cc",       default=os.environ.get("CC", "gcc"), help="host C compiler")
+    args = parser.parse_args()
+
+    trace = read_trace(args.trace) if args.trace else synthetic_trace(args.cycles, args.seed)
+    sys_hz = args.sys_mhz * 1e6
+
+    with Host(args.cc) as host:
+        profile, index = host.profile(trace)
+    costs = handler_costs(profile, args.device_ns, sys_hz)
+    names = [name for name, _, _ in profile[:-1]]
+    handlers = [names[i] for i in index]
+    counts = { name : count for name, count, _ in profile[:-1] if count }
+
+    print("%d bus cycles (%.1fms at the Apple II bus rate), %s" %
+          (len(trace), len(trace) * 1000.0 / APPLE_BUS_HZ,
+           "scaled to %.0fns per replayed bus cycle on the device" % args.device_ns if args.device_ns else "host times"))
+    for name in names:
+        if name in counts:
+            print("  %-13s %8d %6.1f clocks" % (name, counts[name], costs[name]))
+
+    for method in ("irq", "dma"):
+        per_cycle = sum(counts[h] * costs[h] for h in counts) / len(trace)
+        if method == "irq":
+            per_cycle += IRQ_WORD_COST + IRQ_ENTRY_COST / IRQ_BATCH
+        sustainable = sys_hz / per_cycle
+        high_water, lost = simulate(trace, handlers, costs, method, sys_hz, args.stall_us, args.stall_period_ms * 1000)
+        print("%s: %.1f clocks per bus cycle, sustainable %.0f cycles/s (%.1fx), ring high water %d%s, lost %d" %
+              (method, per_cycle, sustainable, sustainable / APPLE_BUS_HZ, high_water,
+               " (above warn level)" if high_water >= ABUS_RING_WARN else "", lost))
+
+if __name__ == "__main__":
+    main()
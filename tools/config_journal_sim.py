@@ -0,0 +1,452 @@
+#!/usr/bin/env python3
+
+# MIT License
+# Copyright (c) 2025 Michael Neil, Far Left Lane
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+# Host check of the flash config journal (config.c).
+#
+# Builds firmware/config/config.c for this computer (with the pico-sdk stand-in of
+# tools/render_golden) against a fake FLASH_CONFIG area: NOR flash, erase sets a sector to
+# 0xff, programming can only clear bits, and the power can fail in the middle of an erase or
+# a page program. The harness drives config_journal_scan() and config_journal_append() of
+# the firmware directly, a reboot is a new scan.
+#
+#  * "check": torn writes and wrap around - a slot programmed half way, a trailer with a
+#    broken checksum, a record whose data no longer matches its crc, a power loss in the
+#    sector erase when the full journal wraps around, and the erase count of every sector
+#    after the journal wrapped twice.
+#  * "powerloss": interrupts random saves at a random point of the flash erase or
+#    program operation and checks that the next boot loads either the previous or
+#    the new config - never a corrupted one, and never an older one.
+#  * "bench": compares the save latency and the sector erase count of the old
+#    sector rewrite (config_flash_write) with the journal, and reports the amount of
+#    flash read at boot to find the current config.
+#
+# Usage: config_journal_sim.py [check|powerloss|bench] [--saves N] [--seed N] [--cc CC]
+
+import argparse
+import os
+import random
+import shutil
+import subprocess
+import sys
+import tempfile
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "render_golden"))
+import render_golden
+
+FLASH_SECTOR_SIZE    = 4096
+FLASH_CONFIG_LEN     = 60 * 1024          # __FLASH_CONFIG_LEN of the linker scripts
+
+CFG_SLOT_SIZE        = 64                 # config.c
+CFG_SLOT_DATA_SIZE   = CFG_SLOT_SIZE - 8
+CFG_SLOTS_PER_SECTOR = FLASH_SECTOR_SIZE // CFG_SLOT_SIZE
+CFG_SLOTS            = FLASH_CONFIG_LEN // CFG_SLOT_SIZE
+SECTORS              = FLASH_CONFIG_LEN // FLASH_SECTOR_SIZE
+
+# typical W25Q16JV timing (datasheet), XIP read rate of the RP2040 at the default clkdiv
+ERASE_US             = 45000
+PROGRAM_US           = 400
+XIP_BYTES_PER_US     = 25
+
+HARNESS = r"""
+#include <stdio.h>
+#include <stdlib.h>
+#include <setjmp.h>
+#include "config/config.h"
+
+//  one section per function, the linker drops what the journal does not use
+#undef DELAYED_COPY_CODE
+#define DELAYED_COPY_CODE(n) __noinline n
+
+#include "config/config.c"
+
+//  FLASH_CONFIG, __FLASH_CONFIG_LEN is defined by the linker like in the firmware
+uint8_t __attribute__((aligned(FLASH_SECTOR_SIZE))) __config_data_start[CONFIG_LEN];
+
+static jmp_buf  s_power_loss;
+static int32_t  s_fail_after = -1;          //  flash operations until the power fails, -1: never
+static int32_t  s_fail_bytes = -1;          //  bytes of the page programmed when it fails, -1: random
+static uint32_t s_random = 1;
+static uint64_t s_busy_us;
+static uint32_t s_erases[CONFIG_LEN / FLASH_SECTOR_SIZE];
+
+static uint32_t next_random(void)
+{
+    s_random ^= s_random << 13;
+    s_random ^= s_random >> 17;
+    s_random ^= s_random << 5;
+    return s_random;
+}
+
+static uint8_t* flash_address(uint32_t offset, size_t count)
+{
+    uint8_t* flash = (uint8_t*)(uintptr_t)(uint32_t)(offset + XIP_BASE);
+    if ((flash < __config_data_start) || (flash + count > __config_data_start + CONFIG_LEN))
+        abort();
+    return flash;
+}
+
+static bool power_fails(void)
+{
+    if (s_fail_after < 0)
+        return false;
+    return s_fail_after-- == 0;
+}
+
+void flash_range_erase(uint32_t offset, size_t count)
+{
+    uint8_t* flash = flash_address(offset, count);
+    if ((offset % FLASH_SECTOR_SIZE) || (count % FLASH_SECTOR_SIZE))
+        abort();
+    if (power_fails())
+    {
+        //  partially erased: some bytes are erased, the others have random bits set
+        for (size_t i = 0; i < count; i++)
+            flash[i] = (next_random() & 1) ? 0xff : flash[i] | next_random();
+        longjmp(s_power_loss, 1);
+    }
+    memset(flash, 0xff, count);
+    s_erases[(flash - __config_data_start) / FLASH_SECTOR_SIZE]++;
+    s_busy_us += ERASE_US;
+}
+
+void flash_range_program(uint32_t offset, const uint8_t* data, size_t count)
+{
+    uint8_t* flash = flash_address(offset, count);
+    //  config_flash_write programs the size of the config, from the start of a page
+    if (offset % FLASH_PAGE_SIZE)
+        abort();
+    size_t programmed = count;
+    if (power_fails())
+        programmed = (s_fail_bytes >= 0) ? (size_t) s_fail_bytes : next_random() % count;
+    for (size_t i = 0; i < programmed; i++)
+        flash[i] &= data[i];
+    if (programmed < count)
+    {
+        //  the byte being programmed when the power failed has random bits cleared
+        flash[programmed] &= data[programmed] | next_random();
+        longjmp(s_power_loss, 1);
+    }
+    s_busy_us += PROGRAM_US;
+}
+
+//  A config record: magic word, size and settings telling "value" apart
+static void make_config(uint32_t value, uint8_t* data)
+{
+    struct config_t* config = (struct config_t*) data;
+    for (uint32_t i = 0; i < sizeof(struct config_t); i++)
+        data[i] = value >> (8 * (i % 4));
+    config->magic_word = CFG_MAGIC_WORD_VALUE;
+    config->size = sizeof(struct config_t);
+}
+
+//  harness SEED < commands > answers, one line each:
+//    size                      sizeof(struct config_t)
+//    erase                     erases the area and boots, clears the statistics
+//    legacy VALUE              writes a config like older firmware did (config_flash_write)
+//    scan                      boots: "SLOT SEQUENCE RECORD" of the config loaded, or "none"
+//    append VALUE FAIL BYTES   saves a config, the power fails at flash operation FAIL
+//                              (-1: never) after BYTES of the page (-1: random): "ok" or "lost"
+//    clear SLOT OFFSET BIT     clears a bit of a slot
+//    stats                     "BUSY_US ERASES..."
+int main(int argc, char** argv)
+{
+    char line[256];
+    uint8_t data[sizeof(struct config_t)];
+
+    s_random = atoi(argv[1]) * 2654435761u + 1;
+    memset(__config_data_start, 0xff, CONFIG_LEN);
+    while (fgets(line, sizeof(line), stdin))
+    {
+        long a = 0, b = 0, c = 0;
+        char command[16];
+        if (sscanf(line, "%15s %ld %ld %ld", command, &a, &b, &c) < 1)
+            continue;
+
+        if (strcmp(command, "size") == 0)
+            printf("%u\n", (unsigned) sizeof(struct config_t));
+        else if (strcmp(command, "erase") == 0)
+        {
+            memset(__config_data_start, 0xff, CONFIG_LEN);
+            memset(s_erases, 0, sizeof(s_erases));
+            s_busy_us = 0;
+            config_journal_scan();
+            printf("ok\n");
+        }
+        else if (strcmp(command, "legacy") == 0)
+        {
+            make_config(a, data);
+            config_flash_write(__config_data_start, data, sizeof(data));
+            printf("ok\n");
+        }
+        else if (strcmp(command, "scan") == 0)
+        {
+            config_journal_scan();
+            if (cfg_slot < 0)
+                printf("none\n");
+            else
+            {
+                printf("%d %u ", (int) cfg_slot, (unsigned) cfg_sequence);
+                for (uint32_t i = 0; (i < cfg->size) && (i < CFG_SLOT_DATA_SIZE); i++)
+                    printf("%02x", ((const uint8_t*) cfg)[i]);
+                printf("\n");
+            }
+        }
+        else if (strcmp(command, "append") == 0)
+        {
+            make_config(a, data);
+            s_fail_after = b;
+            s_fail_bytes = c;
+            if (setjmp(s_power_loss) == 0)
+            {
+                config_journal_append(data, sizeof(data));
+                printf("ok\n");
+            }
+            else
+                printf("lost\n");
+            s_fail_after = -1;
+        }
+        else if (strcmp(command, "clear") == 0)
+        {
+            CFG_SLOT(a)[b] &= ~(1 << c);
+            printf("ok\n");
+        }
+        else if (strcmp(command, "stats") == 0)
+        {
+            printf("%llu", (unsigned long long) s_busy_us);
+            for (uint32_t i = 0; i < CONFIG_LEN / FLASH_SECTOR_SIZE; i++)
+                printf(" %u", s_erases[i]);
+            printf("\n");
+        }
+        fflush(stdout);
+    }
+    return 0;
+}
+"""
+
+class Journal:
+    """ config.c built for this computer with the fake flash, one process per run. """
+    def __init__(self, cc, seed):
+        self.workdir = tempfile.mkdtemp(prefix="config_journal_sim")
+        include = os.path.join(self.workdir, "include")
+        for header in render_golden.HOST_HEADERS:
+            path = os.path.join(include, header)
+            os.makedirs(os.path.dirname(path), exist_ok=True)
+            with open(path, "w") as f:
+                f.write('#include "%s"\n' % os.path.join(render_golden.HERE, "pico_host.h"))
+        source = os.path.join(self.workdir, "harness.c")
+        with open(source, "w") as f:
+            f.write(HARNESS)
+        exe = os.path.join(self.workdir, "config_journal")
+        # the firmware keeps flash addresses in 32 bits, the fake flash is linked below 4GB
+        result = subprocess.run([cc, "-std=gnu11", "-O2", "-w", "-fno-pie", "-no-pie", "-ffunction-sections", "-fdata-sections",
+                                 "-Wl,--gc-sections", "-Wl,--defsym=__FLASH_CONFIG_LEN=%d" % FLASH_CONFIG_LEN,
+                                 "-DCONFIG_LEN=%d" % FLASH_CONFIG_LEN, "-DERASE_US=%d" % ERASE_US, "-DPROGRAM_US=%d" % PROGRAM_US,
+                                 '-DFW_VERSION="sim"', "-I" + include, "-I" + render_golden.FIRMWARE, "-I" + render_golden.REPO,
+                                 source, "-o", exe], capture_output=True, text=True)
+        if result.returncode != 0:
+            shutil.rmtree(self.workdir)
+            sys.exit("config.c not built for the host:\n%s" % result.stderr)
+        self.process = subprocess.Popen([exe, str(seed)], stdin=subprocess.PIPE, stdout=subprocess.PIPE, text=True)
+        self.size = int(self.command("size"))
+        if self.size > CFG_SLOT_DATA_SIZE:
+            sys.exit("struct config_t has %d bytes, a slot holds %d" % (self.size, CFG_SLOT_DATA_SIZE))
+
+    def close(self):
+        self.process.stdin.close()
+        self.process.wait()
+        shutil.rmtree(self.workdir)
+
+    def command(self, *words):
+        self.process.stdin.write(" ".join(str(word) for word in words) + "\n")
+        self.process.stdin.flush()
+        answer = self.process.stdout.readline()
+        if not answer:
+            sys.exit("harness failed at: %s" % " ".join(str(word) for word in words))
+        return answer.strip()
+
+    def config(self, value):
+        """ The record the harness saves for value. """
+        data = bytearray((value >> (8 * (i % 4))) & 0xff for i in range(self.size))
+        data[0:6] = (0x32495644).to_bytes(4, "little") + self.size.to_bytes(2, "little")
+        return bytes(data)
+
+    def scan(self):
+        """ Boots: (slot, sequence, record) of the config loaded, or None. """
+        answer = self.command("scan")
+        if answer == "none":
+            return None
+        slot, sequence, record = answer.split()
+        return int(slot), int(sequence), bytes.fromhex(record)
+
+    def append(self, value, fail=-1, fail_bytes=-1):
+        """ False when the power failed. """
+        return self.command("append", value, fail, fail_bytes) == "ok"
+
+    def stats(self):
+        """ (busy microseconds, erases per sector). """
+        words = [int(word) for word in self.command("stats").split()]
+        return words[0], words[1:]
+
+def check_case(journal, name, expected, loaded):
+    ok = loaded is not None and loaded[2] == journal.config(expected)
+    print("%-40s %s" % (name, "ok" if ok else "loaded %s, expected config %d" % (loaded, expected)))
+    return ok
+
+def run_check(journal):
+    results = []
+
+    # older firmware's config, then the first journal records
+    journal.command("legacy", 7)
+    results.append(check_case(journal, "config of older firmware", 7, journal.scan()))
+    journal.append(8)
+    journal.append(9)
+    results.append(check_case(journal, "journal", 9, journal.scan()))
+
+    # the power fails with half of the slot programmed: the trailer is blank
+    slot = journal.scan()[0] + 1
+    page_pos = (slot * CFG_SLOT_SIZE) % 256
+    journal.append(10, 0, page_pos + CFG_SLOT_DATA_SIZE // 2)
+    results.append(check_case(journal, "half programmed slot", 9, journal.scan()))
+    journal.append(11)
+    loaded = journal.scan()
+    results.append(check_case(journal, "save after the half programmed slot", 11, loaded) and loaded[0] == slot + 1)
+
+    # the power fails in the checksum: the sequence is there, the crc is not
+    slot = loaded[0] + 1
+    page_pos = (slot * CFG_SLOT_SIZE) % 256
+    journal.append(12, 0, page_pos + CFG_SLOT_DATA_SIZE + 6)
+    results.append(check_case(journal, "torn checksum", 11, journal.scan()))
+    journal.append(13)
+    results.append(check_case(journal, "save after the torn checksum", 13, journal.scan()))
+
+    # a bit of the data is lost: bad crc, the previous record is loaded, its sequence is used again
+    slot, sequence, record = journal.scan()
+    journal.command("clear", slot, 12, 0)
+    results.append(check_case(journal, "bad crc", 11, journal.scan()))
+    journal.append(14)
+    loaded = journal.scan()
+    results.append(check_case(journal, "save after the bad crc", 14, loaded) and loaded[1] == sequence)
+
+    # the full journal wraps around into sector 0, the power fails in its erase
+    journal.command("erase")
+    for value in range(CFG_SLOTS):
+        journal.append(100 + value)
+    results.append(check_case(journal, "full journal", 100 + CFG_SLOTS - 1, journal.scan()))
+    journal.append(1, 0)
+    results.append(check_case(journal, "power loss in the erase of the wrap", 100 + CFG_SLOTS - 1, journal.scan()))
+    journal.append(2)
+    loaded = journal.scan()
+    results.append(check_case(journal, "save after the wrap", 2, loaded) and loaded[0] == 0)
+
+    # every sector is erased once per wrap
+    journal.command("erase")
+    for value in range(2 * CFG_SLOTS + 1):
+        journal.append(value)
+    busy_us, erases = journal.stats()
+    ok = erases == [2] + [1] * (SECTORS - 1)
+    print("%-40s %s" % ("sector erases after two wraps", "ok" if ok else erases))
+    results.append(ok and check_case(journal, "two wraps", 2 * CFG_SLOTS, journal.scan()))
+
+    print("%d of %d cases ok" % (sum(results), len(results)))
+    return all(results)
+
+def run_powerloss(journal, saves, seed):
+    rng = random.Random(seed)
+
+    # start with a config written by older firmware
+    journal.command("legacy", 0)
+    current = journal.config(0)
+    assert journal.scan()[2] == current, "old style config not loaded"
+
+    failures = losses = 0
+    for n in range(1, saves + 1):
+        new = journal.config(n)
+        if rng.random() < 0.25:
+            # fail the erase (if any) or the program
+            if not journal.append(n, rng.randrange(2)):
+                losses += 1
+        else:
+            journal.append(n)
+
+        # reboot
+        loaded = journal.scan()
+        loaded = loaded and loaded[2]
+        if loaded == new:
+            current = new
+        elif loaded != current:
+            failures += 1
+            print("save %d: loaded %s, expected %s or %s" % (n, loaded and loaded.hex(), current.hex(), new.hex()))
+            current = loaded
+
+    busy_us, erases = journal.stats()
+    print("%d saves, %d power losses injected, %d failures" % (saves, losses, failures))
+    print("sector erase count: min %d, max %d" % (min(erases), max(erases)))
+    return failures == 0
+
+def run_bench(journal, saves):
+    for n in range(saves):
+        journal.command("legacy", n)
+    legacy_us, legacy_erases = journal.stats()
+
+    journal.command("erase")
+    worst = 0
+    before = 0
+    for n in range(saves):
+        journal.append(n)
+        busy_us, erases = journal.stats()
+        worst = max(worst, busy_us - before)
+        before = busy_us
+
+    # the boot scan reads the sequence numbers of all slots, then the record of the winner
+    scan_bytes = CFG_SLOTS * 4 + journal.size
+    print("%d saves" % saves)
+    print("  sector rewrite: avg %6d us, max %6d us, sector erases %d (max per sector %d)" %
+          (legacy_us // saves, ERASE_US + PROGRAM_US, sum(legacy_erases), max(legacy_erases)))
+    print("  journal:        avg %6d us, max %6d us, sector erases %d (max per sector %d)" %
+          (busy_us // saves, worst, sum(erases), max(erases)))
+    print("  boot scan: %d bytes read from flash, ~%d us" % (scan_bytes, scan_bytes // XIP_BYTES_PER_US))
+    return True
+
+def main():
+    parser = argparse.ArgumentParser(description="Check the flash config journal of config.c on this computer")
+    parser.add_argument("test",    nargs="?", default="check", choices=("check", "powerloss", "bench"))
+    parser.add_argument("--saves", default=5000, type=int, help="number of config saves")
+    parser.add_argument("--seed",  default=1,    type=int, help="random seed for the power loss injection")
+    parser.add_argument("--cc",    default=os.environ.get("CC", "gcc"), help="host C compiler")
+    args = parser.parse_args()
+
+    journal = Journal(args.cc, args.seed)
+    print("struct config_t: %d bytes" % journal.size)
+    try:
+        if args.test == "check":
+            ok = run_check(journal)
+        elif args.test == "powerloss":
+            ok = run_powerloss(journal, args.saves, args.seed)
+        else:
+            ok = run_bench(journal, args.saves)
+    finally:
+        journal.close()
+    raise SystemExit(0 if ok else 1)
+
+if __name__ == "__main__":
+    main()
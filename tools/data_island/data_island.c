@@ -0,0 +1,86 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*  Host harness of tools/data_island/data_island.py: encodes the HDMI data island
+    packets of libdvi (data_packet.c) and prints the TMDS words of the three lanes.
+
+    Output, one packet per line:
+        <name> <parameters...> hv=<vsync,hsync> lane0=<18 words> lane1=<...> lane2=<...>
+*/
+
+#include <stdio.h>
+
+#include "data_packet.h"
+
+static void print_stream(const char* name, const data_packet_t *packet)
+{
+    for (int hv = 0; hv < 4; hv++)
+    {
+        data_island_stream_t stream;
+        encode_data_packet(&stream, packet, (hv & 2) != 0, (hv & 1) != 0);
+
+        printf("%s hv=%d", name, hv);
+        for (int lane = 0; lane < TMDS_CHANNELS; lane++)
+        {
+            printf(" lane%d=", lane);
+            for (int i = 0; i < N_DATA_ISLAND_WORDS; i++)
+                printf("%s%05x", i ? "," : "", stream.data[lane][i]);
+        }
+        printf("\n");
+    }
+}
+
+int main(void)
+{
+    data_packet_t packet;
+    char name[64];
+
+    set_null_data_packet(&packet);
+    print_stream("null", &packet);
+
+    // AVI InfoFrame, as sent by a2dvi_dvi_enable()
+    for (int cn = IT_CONTENT_NO_DATA; cn <= IT_CONTENT_GAME; cn++)
+    {
+        for (int q = DEFAULT; q <= FULL; q++)
+        {
+            static const video_code vics[] = { _640x480P60, _720x480P60 };
+            for (int v = 0; v < 2; v++)
+            {
+                set_AVI_info_frame(&packet, UNDERSCAN, RGB, ITU601, PIC_ASPECT_RATIO_4_3, SAME_AS_PAR, q, cn, vics[v]);
+                snprintf(name, sizeof(name), "avi cn=%d q=%d vic=%d", cn, q, vics[v]);
+                print_stream(name, &packet);
+            }
+        }
+    }
+
+    // audio clock regeneration and audio InfoFrame (FEATURE_A2_AUDIO)
+    set_audio_clock_regeneration(&packet, 28000, 6272);
+    print_stream("acr cts=28000 n=6272", &packet);
+    set_audio_clock_regeneration(&packet, 30000, 6272);
+    print_stream("acr cts=30000 n=6272", &packet);
+    set_audio_info_frame(&packet, 44100);
+    print_stream("audio freq=44100", &packet);
+
+    return 0;
+}
@@ -0,0 +1,253 @@
+#!/usr/bin/env python3
+
+# MIT License
+# Copyright (c) 2025 Michael Neil, Far Left Lane
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+
+# Host test of the HDMI data islands sent by libdvi (AVI InfoFrame, audio packets).
+#
+# Builds libraries/libdvi/data_packet.c for the PC with data_island.c as harness
+# (the pico-sdk is replaced by tools/render_golden/pico_host.h), and decodes the
+# emitted TMDS words of each packet independently of the encoder (HDMI 1.4 section
+# 5.2.3): the TERC4 symbols of the three lanes, the guard bands, the header and
+# subpacket bits and their BCH parity. The decoded packets are checked field by
+# field: the AVI InfoFrame for every content type, quantization range and VIC
+# the firmware can select (cfg_hdmi_*), the null packet, the audio clock
+# regeneration and the audio InfoFrame.
+#
+# Usage: data_island.py [--cc CC] [--verbose]
+#
+# Requires a host C compiler (gcc or clang).
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+
+HERE    = os.path.dirname(os.path.abspath(__file__))
+REPO    = os.path.normpath(os.path.join(HERE, "..", ".."))
+LIBDVI  = os.path.join(REPO, "libraries", "libdvi")
+PICO    = os.path.join(REPO, "tools", "render_golden", "pico_host.h")
+
+# pico-sdk headers included by data_packet.c, generated as one line files including PICO
+HOST_HEADERS = ["pico.h", "pico/config.h", "hardware/platform_defs.h"]
+
+# TERC4 code, HDMI 1.4 table 5-13: q_out[9:0] of D[3:0]
+TERC4 = [0b1010011100, 0b1001100011, 0b1011100100, 0b1011100010,
+         0b0101110001, 0b0100011110, 0b0110001110, 0b0100111100,
+         0b1011001100, 0b0100111001, 0b0110011100, 0b1011000110,
+         0b1010001110, 0b1001110001, 0b0101100011, 0b1011000011]
+TERC4_DECODE = {symbol: d for d, symbol in enumerate(TERC4)}
+
+DATA_GUARD_BAND = 0b0100110011          # lanes 1 and 2, lane 0 carries TERC4(0b11xx)
+PACKET_PIXELS   = 32
+GUARD_PIXELS    = 2
+
+# InfoFrame fields, CEA-861-D section 6.4
+AVI_TYPE, AVI_VERSION, AVI_LENGTH = 0x82, 2, 13
+AUDIO_TYPE, AUDIO_VERSION, AUDIO_LENGTH = 0x84, 1, 10
+CONTENT_NO_DATA = -1
+
+def bch(bits):
+    """ BCH parity of HDMI 1.4 figure 5-5, G(x) = 1 + x^6 + x^7 + x^8: bits in transmission order. """
+    r = 0
+    for b in bits:
+        feedback = b ^ (r & 1)
+        r >>= 1
+        if feedback:
+            r ^= 0x83           # x^8 + x^7 + x^6 + 1, reflected
+    return [(r >> i) & 1 for i in range(8)]
+
+def to_bytes(bits):
+    return [sum(bits[8 * i + j] << j for j in range(8)) for i in range(len(bits) // 8)]
+
+def decode(lanes, hv):
+    """ Returns (header, [4 subpackets], errors) of the TMDS words of one data island. """
+    errors = []
+    pixels = [[], [], []]
+    for lane in range(3):
+        for word in lanes[lane]:
+            pixels[lane] += [word & 0x3ff, (word >> 10) & 0x3ff]
+    if any(len(p) != PACKET_PIXELS + 2 * GUARD_PIXELS for p in pixels):
+        return None, None, ["%d pixels, expected %d" % (len(pixels[0]), PACKET_PIXELS + 2 * GUARD_PIXELS)]
+
+    # leading and trailing guard bands
+    for x in list(range(GUARD_PIXELS)) + list(range(GUARD_PIXELS + PACKET_PIXELS, PACKET_PIXELS + 2 * GUARD_PIXELS)):
+        if pixels[0][x] != TERC4[0b1100 | hv]:
+            errors.append("lane 0 guard band pixel %d: %03x" % (x, pixels[0][x]))
+        for lane in (1, 2):
+            if pixels[lane][x] != DATA_GUARD_BAND:
+                errors.append("lane %d guard band pixel %d: %03x" % (lane, x, pixels[lane][x]))
+
+    header_bits = []
+    subpacket_bits = [[], [], [], []]
+    for x in range(PACKET_PIXELS):
+        d = []
+        for lane in range(3):
+            symbol = pixels[lane][GUARD_PIXELS + x]
+            if symbol not in TERC4_DECODE:
+                errors.append("lane %d pixel %d: %03x is no TERC4 symbol" % (lane, x, symbol))
+                return None, None, errors
+            d.append(TERC4_DECODE[symbol])
+        # lane 0: HSYNC, VSYNC, header bit, 0 on the first pixel of the packet
+        if (d[0] & 3) != hv:
+            errors.append("pixel %d: sync %d, expected %d" % (x, d[0] & 3, hv))
+        if ((d[0] >> 3) & 1) != (0 if x == 0 else 1):
+            errors.append("pixel %d: packet start bit %d" % (x, (d[0] >> 3) & 1))
+        header_bits.append((d[0] >> 2) & 1)
+        # lanes 1 and 2: the even and odd bits of the four subpackets
+        for i in range(4):
+            subpacket_bits[i] += [(d[1] >> i) & 1, (d[2] >> i) & 1]
+
+    if bch(header_bits[:24]) != header_bits[24:]:
+        errors.append("header BCH parity")
+    for i in range(4):
+        if bch(subpacket_bits[i][:56]) != subpacket_bits[i][56:]:
+            errors.append("subpacket %d BCH parity" % i)
+
+    header = to_bytes(header_bits[:24])
+    subpackets = [to_bytes(bits[:56]) for bits in subpacket_bits]
+    return header, subpackets, errors
+
+def info_frame_payload(header, subpackets, length):
+    """ PB0 (checksum) .. PB<length>, 7 bytes per subpacket. """
+    payload = []
+    for sp in subpackets:
+        payload += sp
+    return payload[:length + 1]
+
+def check_info_frame(header, subpackets, type, version, length):
+    errors = []
+    if header != [type, version, length]:
+        errors.append("header %s, expected %s" % (header, [type, version, length]))
+    payload = info_frame_payload(header, subpackets, length)
+    if (sum(header) + sum(payload)) & 0xff:
+        errors.append("checksum")
+    # bytes beyond the length are zero
+    rest = sum((sp for sp in subpackets), [])[length + 1:]
+    if any(rest):
+        errors.append("data beyond the InfoFrame length")
+    return payload, errors
+
+def check_avi(header, subpackets, cn, q, vic):
+    pb, errors = check_info_frame(header, subpackets, AVI_TYPE, AVI_VERSION, AVI_LENGTH)
+    expected = {
+        "Y (RGB)"               : ((pb[1] >> 5) & 3, 0),
+        "A (active format)"     : ((pb[1] >> 4) & 1, 1),
+        "S (underscan)"         : (pb[1] & 3, 2),
+        "C (ITU601)"            : ((pb[2] >> 6) & 3, 1),
+        "M (4:3)"               : ((pb[2] >> 4) & 3, 1),
+        "R (same as picture)"   : (pb[2] & 15, 8),
+        "ITC"                   : ((pb[3] >> 7) & 1, 0 if cn == CONTENT_NO_DATA else 1),
+        "Q"                     : ((pb[3] >> 2) & 3, q),
+        "VIC"                   : (pb[4] & 0x7f, vic),
+        "CN"                    : ((pb[5] >> 4) & 3, 0 if cn == CONTENT_NO_DATA else cn),
+        "YQ"                    : ((pb[5] >> 6) & 3, 0),
+    }
+    for field, (value, want) in expected.items():
+        if value != want:
+            errors.append("%s is %d, expected %d" % (field, value, want))
+    return errors
+
+def check_acr(header, subpackets, cts, n):
+    errors = []
+    if header != [0x01, 0, 0]:
+        errors.append("header %s" % header)
+    for i, sp in enumerate(subpackets):
+        value_cts = (sp[1] << 16) | (sp[2] << 8) | sp[3]
+        value_n = (sp[4] << 16) | (sp[5] << 8) | sp[6]
+        if sp[0] != 0 or value_cts != cts or value_n != n:
+            errors.append("subpacket %d: CTS %d N %d, expected %d %d" % (i, value_cts, value_n, cts, n))
+    return errors
+
+def check_audio(header, subpackets, freq):
+    pb, errors = check_info_frame(header, subpackets, AUDIO_TYPE, AUDIO_VERSION, AUDIO_LENGTH)
+    sf = {32000: 1, 44100: 2, 48000: 3}[freq]
+    if pb[1] != 0x11 or pb[2] != (1 | (sf << 2)):
+        errors.append("CC/CT %02x SS/SF %02x" % (pb[1], pb[2]))
+    return errors
+
+def check(name, params, header, subpackets):
+    if name == "null":
+        return [] if header == [0, 0, 0] and not any(sum(subpackets, [])) else ["not empty"]
+    if name == "avi":
+        return check_avi(header, subpackets, params["cn"], params["q"], params["vic"])
+    if name == "acr":
+        return check_acr(header, subpackets, params["cts"], params["n"])
+    if name == "audio":
+        return check_audio(header, subpackets, params["freq"])
+    return ["unknown packet"]
+
+def build(cc, workdir):
+    include = os.path.join(workdir, "include")
+    for header in HOST_HEADERS:
+        path = os.path.join(include, header)
+        os.makedirs(os.path.dirname(path), exist_ok=True)
+        with open(path, "w") as f:
+            f.write('#include "%s"\n' % PICO)
+    exe = os.path.join(workdir, "data_island")
+    command = [cc, "-std=gnu11", "-O2", "-w", "-I" + include, "-I" + LIBDVI,
+               os.path.join(LIBDVI, "data_packet.c"), os.path.join(HERE, "data_island.c"), "-o", exe]
+    result = subprocess.run(command, capture_output=True, text=True)
+    if result.returncode != 0:
+        sys.exit("build failed:\n%s" % result.stderr)
+    return exe
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode and check the HDMI data islands of libdvi")
+    parser.add_argument("--cc",      default=os.environ.get("CC", "gcc"), help="host C compiler")
+    parser.add_argument("--verbose", action="store_true", help="print the decoded packets")
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as workdir:
+        output = subprocess.run([build(args.cc, workdir)], capture_output=True, text=True, check=True).stdout
+
+    packets = 0
+    failed = 0
+    for line in output.splitlines():
+        fields = line.split()
+        name = fields[0]
+        params = {}
+        lanes = [None, None, None]
+        for field in fields[1:]:
+            key, value = field.split("=")
+            if key.startswith("lane"):
+                lanes[int(key[4:])] = [int(w, 16) for w in value.split(",")]
+            else:
+                params[key] = int(value)
+
+        header, subpackets, errors = decode(lanes, params["hv"])
+        if header is not None:
+            errors += check(name, params, header, subpackets)
+        packets += 1
+        if errors:
+            failed += 1
+            print("FAIL %s: %s" % (line.split(" lane0")[0], "; ".join(errors)))
+        elif args.verbose:
+            print("ok   %s: HB %s PB %s" % (line.split(" lane0")[0], " ".join("%02x" % b for b in header),
+                                            " ".join("%02x" % b for b in sum(subpackets, []))))
+
+    print("%d packets, %d failed" % (packets, failed))
+    return 1 if failed or packets == 0 else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+
+# MIT License
+# Copyright (c) 2025 Michael Neil, Far Left Lane
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+# Host check of the DVI buffer geometry for each output resolution.
+#
+# When the resolution is switched at run-time (a2dvi_dvi_enable), everything
+# derived from the DVI timing is recomputed: DVI_INIT_RESOLUTION (tmds.h), the
+# TMDS buffers allocated by dvi_init (dvi.c), the margins of the A2C scan lines
+# (render_a2c_full_line in a2c.c) and the audio clock regeneration values.
+# This script reads the timings from libdvi/dvi_timing.c, recomputes the same
+# values and checks that they are consistent, for every resolution and for
+# every switch between two resolutions.
+#
+# Usage: dvi_geometry_check.py [--repo PATH]
+
+import argparse
+import os
+import re
+import sys
+
+DVI_SYMBOLS_PER_WORD = 2
+DVI_VERTICAL_REPEAT  = 2
+A2DVI_SCANLINES      = 2 * 192 + 4 * 16
+A2C_WORDS            = 18               # SEROUT words per line
+A2C_DOTS             = 32 * A2C_WORDS
+AUDIO_RATE           = 44100
+
+# audio clock regeneration values per mode, see a2dvi_dvi_enable
+AUDIO_CTS_N = {
+    640 : (28000, 6272),
+    720 : (30000, 6272),
+}
+
+# first dot rendered, and the number of black words inserted before it, per A2C render mode
+A2C_COLOR_SHIFT = {
+    "A2DVI(640)" : (0, 0),
+    "A2DVI(720)" : (2, 1),
+    "NTSC"       : (4, 2),
+    "CLAMP"      : (2, 1),
+}
+
+def read_timings(repo):
+    text = open(os.path.join(repo, "libraries", "libdvi", "dvi_timing.c")).read()
+    text = text.split("#if 0")[0]           # only the timings which are built
+    timings = {}
+    for name, body in re.findall(r"__dvi_const\((\w+)\)\s*=\s*\{(.*?)\};", text, re.S):
+        fields = dict((k, v.strip()) for k, v in re.findall(r"\.(\w+)\s*=\s*(\w+)", body))
+        timings[name] = dict((k, int(v) if v.isdigit() else v == "true") for k, v in fields.items())
+    return timings
+
+def read_buffer_count(repo):
+    text = open(os.path.join(repo, "CMakeLists.txt")).read()
+    match = re.search(r"-DDVI_N_TMDS_BUFFERS=(\d+)", text)
+    return int(match.group(1)) if match else 3
+
+class Checker:
+    def __init__(self):
+        self.errors = 0
+
+    def check(self, condition, message):
+        if not condition:
+            print("  FAIL: " + message)
+            self.errors += 1
+
+def geometry(timing, buffers):
+    x = timing["h_active_pixels"]
+    g = {}
+    # DVI_INIT_RESOLUTION
+    g["dvi_words_per_channel"] = x // 2
+    g["dvi_xofs560"] = (x // 2 - 560 // 2) // 2
+    g["dvi_xofs640"] = (x // 2 - 640 // 2) // 2
+    # dvi_init
+    g["tmds_buffer_bytes"] = 3 * x // DVI_SYMBOLS_PER_WORD * 4
+    g["tmds_heap_bytes"] = buffers * g["tmds_buffer_bytes"]
+    # render_a2c_full_line
+    g["left_margin"] = ((x - A2C_WORDS * 32) // 8) * 2
+    g["right_margin"] = A2C_DOTS // 2 + g["left_margin"]
+    # vertical
+    g["first_line"] = (timing["v_active_lines"] - A2DVI_SCANLINES) // 2
+    h_total = x + timing["h_front_porch"] + timing["h_sync_width"] + timing["h_back_porch"]
+    v_total = timing["v_active_lines"] + timing["v_front_porch"] + timing["v_sync_width"] + timing["v_back_porch"]
+    g["pixel_hz"] = timing["bit_clk_khz"] * 100
+    g["frame_hz"] = g["pixel_hz"] / (h_total * v_total)
+    return g
+
+def check_mode(c, name, timing, buffers):
+    x = timing["h_active_pixels"]
+    g = geometry(timing, buffers)
+    print("%s: %dx%d, %d TMDS buffers of %d bytes (%d bytes), %.2fHz" %
+          (name, x, timing["v_active_lines"], buffers, g["tmds_buffer_bytes"], g["tmds_heap_bytes"], g["frame_hz"]))
+
+    c.check(x % 4 == 0, "horizontal resolution must be a multiple of 4 pixels")
+    c.check(g["dvi_xofs560"] >= 0 and g["dvi_xofs640"] >= 0, "80 column content does not fit")
+    c.check(g["left_margin"] % 2 == 0, "A2C left margin must be even")
+    c.check(g["left_margin"] * 2 + A2C_DOTS // 2 == g["dvi_words_per_channel"],
+            "A2C line is %d words, DVI line is %d words" % (g["left_margin"] * 2 + A2C_DOTS // 2, g["dvi_words_per_channel"]))
+
+    # the color render modes shift the picture right, but must not write past the right margin
+    for mode, (first_dot, black_words) in A2C_COLOR_SHIFT.items():
+        if mode.startswith("A2DVI(") and mode != "A2DVI(%d)" % x:
+            continue
+        words = black_words + (A2C_DOTS - first_dot) // 2
+        c.check(words <= A2C_DOTS // 2, "%s renders %d words, only %d available" % (mode, words, A2C_DOTS // 2))
+
+    c.check(g["first_line"] >= 0, "A2DVI_SCANLINES do not fit vertically")
+    c.check(A2DVI_SCANLINES % DVI_VERTICAL_REPEAT == 0, "A2DVI_SCANLINES is not a multiple of DVI_VERTICAL_REPEAT")
+    c.check(abs(g["frame_hz"] - 60) < 0.1, "frame rate is %.2fHz" % g["frame_hz"])
+
+    if x in AUDIO_CTS_N:
+        cts, n = AUDIO_CTS_N[x]
+        audio = g["pixel_hz"] * n / cts / 128
+        c.check(abs(audio - AUDIO_RATE) < 1, "audio CTS/N give %.1fHz instead of %dHz" % (audio, AUDIO_RATE))
+    else:
+        c.check(False, "no audio CTS/N values for %d pixels" % x)
+    return g
+
+def main():
+    parser = argparse.ArgumentParser(description="Check the DVI buffer geometry of all output resolutions")
+    parser.add_argument("--repo", default=os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+    args = parser.parse_args()
+
+    timings = read_timings(args.repo)
+    buffers = read_buffer_count(args.repo)
+    c = Checker()
+
+    results = {}
+    for name, timing in sorted(timings.items()):
+        results[name] = check_mode(c, name, timing, buffers)
+
+    # live resolution switch: all buffers are freed before the new ones are allocated
+    for a in results:
+        for b in results:
+            if a != b:
+                print("switch %s -> %s: heap %+d bytes" % (a, b, results[b]["tmds_heap_bytes"] - results[a]["tmds_heap_bytes"]))
+
+    print("%d errors" % c.errors)
+    sys.exit(1 if c.errors else 0)
+
+if __name__ == "__main__":
+    main()
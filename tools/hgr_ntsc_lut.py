@@ -0,0 +1,306 @@
+#!/usr/bin/env python3
+
+# MIT License
+# Copyright (c) 2025 Michael Neil, Far Left Lane
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+
+# Generator of the A2C NTSC hires decode LUTs (COLOR: NTSC and CLAMP).
+#
+# By default the tables are the hand tuned ones the firmware shipped with
+# (hgrdecode_LUT_tuned.h, the former firmware/a2c/hgrdecode_LUT.h). Their pairs
+# that aren't DC balanced are moved to the nearest balanced values, a few LSBs
+# (TUNED_TOLERANCE). --check compares the default output with the tuned tables.
+#
+# With parameters (or "model" for the fitted defaults below) the tables are
+# decoded from a model of the monitor instead. The A2C renders the SEROUT dots (14M dot clock, 4 dots per colour cycle) two at a
+# time: a window of "taps" dots plus a phase bit index a LUT, which returns the TMDS
+# symbol pair of the two dots in the middle of the window (dots taps/2-1 and taps/2).
+# Index bit taps-1 is the first (leftmost) dot, bit "taps" the phase of the pair.
+#
+# Every entry decodes the window like a colour monitor would:
+#   Y    = average of the dots over "luma" dots around the pixel
+#   I, Q = the dots demodulated with the colour carrier, averaged over "chroma" dots,
+#          rotated by "hue" degrees and scaled by "saturation"
+# converted to RGB and clipped. The colour carrier phase of the first dot of the
+# window is "phase" (in dots) plus 2 for odd pairs.
+#
+# The RGB values of a pair are then moved to the nearest values that have a balanced
+# TMDS symbol pair, as the scanlines are never re-encoded (see tools/tmds_check.py).
+# The RGB reference (--rgb) holds the values before that, one line per entry:
+#   <table> <index> <r0> <g0> <b0> <r1> <g1> <b1>
+#
+# The default parameters approximate the tuned tables, they are also the ones the
+# device synthesizes the tables with when the colours are adjusted (a2c/a2c_lut.c).
+# The build generates the header (A2C_LUT_CLAMP / A2C_LUT_NTSC in CMakeLists.txt), e.g.
+#   cmake -DA2C_LUT_NTSC="taps=8,chroma=6" ..
+# builds a 9 bit NTSC table from the model instead of the tuned 11 bit one.
+#
+# Usage: hgr_ntsc_lut.py OUTPUT [--clamp PARAMS] [--ntsc PARAMS] [--rgb FILE]
+#        hgr_ntsc_lut.py --check
+#   PARAMS: "model" and/or comma separated key=value, keys: taps, phase, hue, saturation,
+#           luma, chroma. Empty for the tuned table.
+
+import argparse
+import math
+import os
+import re
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import tmds_check
+
+DEFAULTS = {
+    "clamp": {"taps": 8,  "phase": 1, "hue": 46.0, "saturation": 0.8,  "luma": 4, "chroma": 4},
+    "ntsc":  {"taps": 10, "phase": 1, "hue": 48.0, "saturation": 0.95, "luma": 4, "chroma": 8},
+}
+TAPS_RANGE = range(4, 11, 2)        # the RAM copy of a 10 tap LUT is already 24KB
+
+# the hand tuned tables and their arrays
+TUNED = os.path.join(os.path.dirname(os.path.abspath(__file__)), "hgrdecode_LUT_tuned.h")
+TUNED_ARRAYS = {
+    "clamp": "tmds_hgrdecode8to3_LUT_color_patterns",
+    "ntsc":  "tmds_hgrdecode_NTSC_8to4_LUT_color_patterns",
+}
+TUNED_TOLERANCE = 4                 # LSBs an entry may move to be DC balanced
+
+# the license header of the generated file, the one of the A2C sources
+LICENSE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "firmware", "a2c", "a2c.c")
+
+def parse_params(table, text):
+    """ Returns (parameters, True for the model or False for the tuned table). """
+    params = dict(DEFAULTS[table])
+    items = [item.strip() for item in (text or "").split(",") if item.strip()]
+    for item in items:
+        if item == "model":
+            continue
+        key, _, value = item.partition("=")
+        key = key.strip()
+        if key not in params:
+            sys.exit("%s: unknown parameter '%s'" % (table, key))
+        params[key] = type(params[key])(value)
+    if params["taps"] not in TAPS_RANGE:
+        sys.exit("%s: taps must be one of %s" % (table, list(TAPS_RANGE)))
+    if params["luma"] < 1 or params["chroma"] < 1:
+        sys.exit("%s: luma and chroma must be at least 1 dot" % table)
+    return params, bool(items)
+
+def kernel(width):
+    """ [(offset, weight)] of a box filter over "width" dots, centered on a dot. """
+    if width % 2:
+        half = width // 2
+        return [(o, 1.0) for o in range(-half, half + 1)]
+    half = width // 2
+    return [(o, 0.5 if abs(o) == half else 1.0) for o in range(-half, half + 1)]
+
+def decode_pixel(dots, center, params, phase):
+    """ RGB (0-255) of the dot at "center" of the window. """
+    luma, chroma = kernel(params["luma"]), kernel(params["chroma"])
+    hue = math.radians(params["hue"])
+
+    y = sum(w * dots[center + o] for o, w in luma if 0 <= center + o < len(dots)) / sum(w for o, w in luma)
+    i = q = 0.0
+    for o, w in chroma:
+        k = center + o
+        if 0 <= k < len(dots) and dots[k]:
+            angle = 2 * math.pi * (k + phase) / 4 + hue
+            i += w * math.cos(angle)
+            q += w * math.sin(angle)
+    scale = 2 * params["saturation"] / sum(w for o, w in chroma)
+    i, q = i * scale, q * scale
+
+    rgb = (y + 0.956 * i + 0.621 * q,
+           y - 0.272 * i - 0.647 * q,
+           y - 1.106 * i + 1.703 * q)
+    return tuple(min(255, max(0, int(round(c * 255)))) for c in rgb)
+
+def decode_entry(index, params):
+    """ RGB of both pixels of a LUT entry. """
+    taps = params["taps"]
+    dots = [(index >> (taps - 1 - k)) & 1 for k in range(taps)]
+    phase = params["phase"] + (2 if index >> taps else 0)
+    center = taps // 2 - 1
+    return decode_pixel(dots, center, params, phase), decode_pixel(dots, center + 1, params, phase)
+
+# --- balanced symbol pairs
+
+def symbols(value):
+    """ Both TMDS data symbols of a value (plain and inverted). """
+    q_m = tmds_check.transition_minimize(value)
+    return (q_m, (q_m ^ 0xff) | 0x200)
+
+# NEAREST[disparity][value]: (value, symbol) closest to value with a symbol of that disparity
+NEAREST = {}
+for d in range(-10, 11, 2):
+    candidates = [(v, s) for v in range(256) for s in symbols(v) if tmds_check.disparity(s) == d]
+    if candidates:
+        NEAREST[d] = [min(candidates, key=lambda c: (abs(c[0] - v), c[0])) for v in range(256)]
+
+def balanced_pair(first, second, reach=3):
+    """ Symbol pair (first pixel in bits 0-9) of the values closest to (first, second) with a disparity of 0. """
+    best = None
+    for a in range(max(0, first - reach), min(255, first + reach) + 1):
+        for s in symbols(a):
+            d = -tmds_check.disparity(s)
+            if d not in NEAREST:
+                continue
+            b, t = NEAREST[d][second]
+            error = (a - first) ** 2 + (b - second) ** 2
+            if best is None or error < best[0]:
+                best = (error, s | (t << 10))
+    return best[1]
+
+def build_table(params):
+    """ Returns ([red], [green], [blue]) symbol pairs and [rgb pairs] of the reference. """
+    reference = [decode_entry(index, params) for index in range(2 << params["taps"])]
+    channels = []
+    for c in range(3):
+        channels.append([balanced_pair(p0[c], p1[c]) for p0, p1 in reference])
+    return channels, reference
+
+def read_tuned(table):
+    """ [red], [green], [blue] symbol pairs of the tuned table. """
+    text = open(TUNED).read()
+    channels = []
+    for colour in ("red", "green", "blue"):
+        match = re.search(r"%s_%s\[(\d+)\]\s*=\s*\{(.*?)\}" % (TUNED_ARRAYS[table], colour), text, re.S)
+        if not match:
+            sys.exit("%s: no %s_%s" % (TUNED, TUNED_ARRAYS[table], colour))
+        words = [int(w, 16) for w in re.findall(r"0x[0-9a-fA-F]+", match.group(2))]
+        if len(words) != int(match.group(1)):
+            sys.exit("%s: %s_%s has %d entries" % (TUNED, TUNED_ARRAYS[table], colour, len(words)))
+        channels.append(words)
+    return channels
+
+def build_tuned(table):
+    """ The tuned table with its unbalanced pairs moved to balanced ones, and its RGB pairs as the reference. """
+    tuned = read_tuned(table)
+    reference = [tuple(tmds_check.decode_pair(words[index]) for words in tuned) for index in range(len(tuned[0]))]
+    reference = [((r[0], g[0], b[0]), (r[1], g[1], b[1])) for r, g, b in reference]
+    channels = []
+    for words in tuned:
+        channels.append([word if not tmds_check.pair_errors(word) else balanced_pair(*tmds_check.decode_pair(word)) for word in words])
+    return channels, reference
+
+def max_error(channels, reference):
+    error = 0
+    for c, words in enumerate(channels):
+        for word, pair in zip(words, reference):
+            decoded = tmds_check.decode_pair(word)
+            error = max(error, abs(decoded[0] - pair[0][c]), abs(decoded[1] - pair[1][c]))
+    return error
+
+def describe(params, model=True):
+    if not model:
+        return "tuned table (hgrdecode_LUT_tuned.h), DC balanced"
+    return ", ".join("%s=%s" % (key, params[key]) for key in ("taps", "phase", "hue", "saturation", "luma", "chroma"))
+
+def write_header(path, tables):
+    lines = [open(LICENSE).read().split("*/")[0] + "*/", "",
+             "//  Generated by tools/hgr_ntsc_lut.py, do not edit.",
+             "", "#pragma once", ""]
+    for name, params, model, channels, reference in tables:
+        # the parameters, for the LUT synthesis on the device (a2c/a2c_lut.c)
+        hue = math.radians(params["hue"])
+        prefix = "HGRDECODE_" + name.upper()
+        lines += [("#define %-28s %-8d%s" % (prefix + "_" + key, value, comment)).rstrip() for key, value, comment in (
+                  ("TAPS",       params["taps"],                         ""),
+                  ("PHASE",      params["phase"],                        ""),
+                  ("LUMA",       params["luma"],                         ""),
+                  ("CHROMA",     params["chroma"],                       ""),
+                  ("SATURATION", round(params["saturation"] * 100),      "//  percent"),
+                  ("HUE_COS",    round(math.cos(hue) * 16384),           "//  cos(hue), 1.14 fixed point"),
+                  ("HUE_SIN",    round(math.sin(hue) * 16384),           "//  sin(hue)"))]
+        lines.append("")
+    for name, params, model, channels, reference in tables:
+        lines += ["//  %s: %s" % (name, describe(params, model)),
+                  "//  largest difference to the RGB reference after balancing: %d" % max_error(channels, reference)]
+        for colour, words in zip(("red", "green", "blue"), channels):
+            lines.append('const uint32_t __in_flash("chr_rom") tmds_hgrdecode_%s_LUT_%s[%d] = {' % (name, colour, len(words)))
+            for i in range(0, len(words), 8):
+                lines.append("    " + " ".join("0x%05X," % w for w in words[i:i + 8]))
+            lines.append("};")
+        lines.append("")
+    with open(path, "w") as f:
+        f.write("\n".join(lines))
+
+def write_rgb(path, tables):
+    with open(path, "w") as f:
+        for name, params, model, channels, reference in tables:
+            f.write("# %s: %s\n" % (name, describe(params, model)))
+            for index, (p0, p1) in enumerate(reference):
+                f.write("%s %d %d %d %d %d %d %d\n" % ((name, index) + p0 + p1))
+
+def check():
+    """ Compares the default tables with the tuned ones, returns True when they match. """
+    ok = True
+    for name in ("clamp", "ntsc"):
+        params, model = parse_params(name, "")
+        channels, reference = build_table(params) if model else build_tuned(name)
+        tuned = read_tuned(name)
+        changed = error = unbalanced = 0
+        for words, tuned_words in zip(channels, tuned):
+            for word, tuned_word in zip(words, tuned_words):
+                unbalanced += bool(tmds_check.pair_errors(word))
+                if word == tuned_word:
+                    continue
+                if not tmds_check.pair_errors(tuned_word):
+                    error = 256                 # a balanced pair must be kept
+                changed += 1
+                a, b = tmds_check.decode_pair(word), tmds_check.decode_pair(tuned_word)
+                error = max(error, abs(a[0] - b[0]), abs(a[1] - b[1]))
+        model_channels, _ = build_table(params)
+        model_error = max_error(model_channels, reference)
+        passed = error <= TUNED_TOLERANCE and unbalanced == 0
+        ok &= passed
+        print("%-5s %5d of %5d pairs balanced, largest change %d (%d allowed), model defaults up to %d off: %s" %
+              (name, changed, 3 * len(tuned[0]), error, TUNED_TOLERANCE, model_error, "OK" if passed else "FAIL"))
+    return ok
+
+def main():
+    parser = argparse.ArgumentParser(description="Generate the A2C NTSC hires decode LUTs")
+    parser.add_argument("output",  nargs="?",  help="C header to write")
+    parser.add_argument("--clamp", default="", help="parameters of the CLAMP table, e.g. model or taps=8,hue=46")
+    parser.add_argument("--ntsc",  default="", help="parameters of the NTSC table, e.g. model or taps=10,chroma=8")
+    parser.add_argument("--rgb",               help="also write the RGB reference to this file")
+    parser.add_argument("--check", action="store_true", help="compare the default tables with the tuned ones")
+    args = parser.parse_args()
+
+    if args.check:
+        sys.exit(0 if check() else 1)
+    if not args.output:
+        parser.error("the output header is required")
+
+    tables = []
+    for name, text in (("clamp", args.clamp), ("ntsc", args.ntsc)):
+        params, model = parse_params(name, text)
+        channels, reference = build_table(params) if model else build_tuned(name)
+        for words in channels:
+            for index, word in enumerate(words):
+                if tmds_check.pair_errors(word):
+                    sys.exit("%s[%d] 0x%05x: %s" % (name, index, word, ", ".join(tmds_check.pair_errors(word))))
+        tables.append((name, params, model, channels, reference))
+
+    write_header(args.output, tables)
+    if args.rgb:
+        write_rgb(args.rgb, tables)
+
+if __name__ == "__main__":
+    main()
@@ -29,7 +29,7 @@ SOFTWARE.
 
     // compress_LUT_Clamp NUM_TAPS: 8, NUM_TAPS_COMPRESS: 3, switchToMSB dump_hgr_LUT_compress_Sharp phaseShift: 1
     // hires hgrdecode8to3_LUT color pattern:
-    uint32_t DELAYED_COPY_DATA(tmds_hgrdecode8to3_LUT_color_patterns_red)[512] = {
+    const uint32_t __in_flash("chr_rom") tmds_hgrdecode8to3_LUT_color_patterns_red[512] = {
         0x7FD00, 0x7FD00, 0x7FD00, 0xF9900, 0x7FD00, 0x7FD00, 0x7FD00, 0xFD100,
         0xC01F8, 0x901F8, 0x93DE1, 0x9F9E1, 0x7FD00, 0xF9D00, 0xC7D01, 0xA7D01,
         0x73EC2, 0xB92C2, 0x6E2F2, 0x2F2, 0x706DE, 0x612DE, 0x60E39, 0x81A39,
@@ -95,7 +95,7 @@ SOFTWARE.
         0x439CE, 0xC01CE, 0x4626F, 0x40E6F, 0xBDE00, 0x31E00, 0xBFA00, 0xB9E00,
         0x8DE02, 0x27E02, 0x8FA06, 0x1E606, 0xBFE00, 0xBFE00, 0xBFE00, 0xBFE00
     };
-    uint32_t DELAYED_COPY_DATA(tmds_hgrdecode8to3_LUT_color_patterns_green)[512] = {
+    const uint32_t __in_flash("chr_rom") tmds_hgrdecode8to3_LUT_color_patterns_green[512] = {
         0x7FD00, 0x7FD00, 0x43D00, 0x7FD00, 0x4E5F3, 0x45DF3, 0xB7DE2, 0xA3DE2,
         0xFF500, 0x7FD00, 0x2F100, 0xF9D00, 0xA1EB8, 0x772B8, 0xEC1C7, 0xB01C7,
         0x7FD00, 0x7FD00, 0x7D900, 0x7E500, 0x7311D, 0x4F91D, 0x64117, 0x9F117,
@@ -161,7 +161,7 @@ SOFTWARE.
         0x99D43, 0x9FD43, 0x49E17, 0x58E17, 0xF7940, 0xB7D40, 0xA19BF, 0xC1BF,
         0x86E00, 0x3F600, 0xBDA00, 0xBFE00, 0x7E00, 0xBFE00, 0x83E00, 0xBFE00
     };
-    uint32_t DELAYED_COPY_DATA(tmds_hgrdecode8to3_LUT_color_patterns_blue)[512] = {
+    const uint32_t __in_flash("chr_rom") tmds_hgrdecode8to3_LUT_color_patterns_blue[512] = {
         0x7FD00, 0xFF100, 0x7FD00, 0x7FD00, 0x7FD00, 0x7F500, 0x7FD00, 0x7FD00,
         0xBFEF0, 0xBFEF0, 0x82633, 0xBFE33, 0x2F2, 0x2F2, 0xBDD61, 0xBFD61,
         0x8E680, 0xD3E80, 0x40DE6, 0x781E6, 0xB1E86, 0x86E86, 0x7F51C, 0x7851C,
@@ -232,7 +232,7 @@ SOFTWARE.
 #ifndef NO_NTSC_LUT
      // compress_LUT NUM_TAPS: 8, NUM_TAPS_COMPRESS: 4, switchToMSB dump_hgr_LUT_compress_Sharp phaseShift: 0
      // hires hgrdecode_NTSC_8to4_LUT color pattern:
-     uint32_t DELAYED_COPY_DATA(tmds_hgrdecode_NTSC_8to4_LUT_color_patterns_red)[2048] = {
+     const uint32_t __in_flash("chr_rom") tmds_hgrdecode_NTSC_8to4_LUT_color_patterns_red[2048] = {
         0x7F901, 0x7FD01, 0xFFD00, 0x7FD00, 0xA7D11, 0x2F911, 0xA71E1, 0x7A1E1,
         0x4F519, 0x78D19, 0xCF909, 0x47D09, 0xB21DE, 0x60DDE, 0x585CE, 0xE01CE,
         0x7FD00, 0x7FD00, 0x7FD00, 0x7FD00, 0x261E3, 0xC4DE3, 0xCC5F3, 0x441F3,
@@ -490,7 +490,7 @@ SOFTWARE.
         0x51EFF, 0x2EFF, 0xB82FF, 0x1EFF, 0xB3A0E, 0xBA20E, 0x6FA04, 0xB8604,
         0xBE200, 0x3FE00, 0x3FE00, 0xBFE00, 0x87A03, 0xBE603, 0x812FE, 0x802FE
     };
-    uint32_t DELAYED_COPY_DATA(tmds_hgrdecode_NTSC_8to4_LUT_color_patterns_green)[2048] = {
+    const uint32_t __in_flash("chr_rom") tmds_hgrdecode_NTSC_8to4_LUT_color_patterns_green[2048] = {
         0x7FD00, 0xFF900, 0x7FD00, 0x7F900, 0x7FD00, 0x7FD00, 0x7FD00, 0xFFD00,
         0x4E5E7, 0xA61E7, 0x7191C, 0x99D1C, 0x4F10D, 0xF3D0D, 0x4F50E, 0xF390E,
         0xF41DE, 0x205DE, 0x7429E, 0xA069E, 0x9CD30, 0xA1D30, 0xA3939, 0xA0939,
@@ -748,7 +748,7 @@ SOFTWARE.
         0x6221B, 0x5F21B, 0x8CE10, 0x89E10, 0x3D207, 0xBBE07, 0xBE604, 0xD7E04,
         0x8FA0B, 0x59E0B, 0x3BAE0, 0x8F2E0, 0x802FF, 0x812FF, 0x2FF, 0x802FF
     };
-    uint32_t DELAYED_COPY_DATA(tmds_hgrdecode_NTSC_8to4_LUT_color_patterns_blue)[2048] = {
+    const uint32_t __in_flash("chr_rom") tmds_hgrdecode_NTSC_8to4_LUT_color_patterns_blue[2048] = {
         0x7FD00, 0x7FD00, 0xF1D0D, 0x4F90D, 0xAF90E, 0xAE10E, 0x5CD11, 0xDED11,
         0x7FD00, 0x7FD00, 0x7FD00, 0x7FD00, 0x7FD00, 0x7FD00, 0x79100, 0x78900,
         0xFFD00, 0x7FD00, 0x241F7, 0x4E1F7, 0xCF90C, 0xAF90C, 0xB7113, 0x63913,
@@ -0,0 +1,232 @@
+#!/usr/bin/env python3
+
+# MIT License
+# Copyright (c) 2025 Michael Neil, Far Left Lane
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+
+# Host check of the streaming QOI encoder (firmware/util/qoi.c), used by the A2C
+# screenshots (firmware/a2c/a2c_screenshot.c).
+#
+# Builds qoi.c with a small harness and encodes test images in parts of various
+# sizes, like the firmware encodes a few lines per frame. Every encoding must be
+# byte for byte the one of the reference encoder below (qoiformat.org) and decode
+# to the image again. The test images cover runs around the 62 pixel limit, index
+# hits, the DIFF and LUMA ranges with wrap around, Apple II like lines of a few
+# colours and noise.
+#
+# --decode converts a QOI file (SCREEN.QOI of the A2C screenshot disk) to a PPM.
+#
+# Usage: qoi_check.py [--seed N] [--cc CC]
+#        qoi_check.py --decode QOI PPM
+
+import argparse
+import os
+import random
+import struct
+import subprocess
+import sys
+import tempfile
+
+REPO = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SOURCE = os.path.join(REPO, "firmware", "util", "qoi.c")
+
+HARNESS = r"""
+#include <stdio.h>
+#include <stdlib.h>
+#include "qoi.h"
+
+// qoi_harness WIDTH HEIGHT PART < rgb > qoi: encodes PART pixels at a time
+int main(int argc, char** argv)
+{
+    uint32_t width = atoi(argv[1]), height = atoi(argv[2]), part = atoi(argv[3]);
+    uint32_t pixels = width * height;
+    uint8_t* rgb = malloc(pixels * 3 + 1);
+    uint8_t* out = malloc(QOI_HEADER_SIZE + QOI_PIXELS_MAX(pixels) + QOI_END_MAX);
+    if (fread(rgb, 3, pixels, stdin) != pixels)
+        return 1;
+
+    qoi_encoder_t encoder;
+    uint32_t size = qoi_encode_begin(&encoder, width, height, out);
+    for (uint32_t i = 0; i < pixels; i += part)
+    {
+        uint32_t count = (pixels - i < part) ? pixels - i : part;
+        uint32_t bytes = qoi_encode_pixels(&encoder, rgb + i * 3, count, out + size);
+        if (bytes > QOI_PIXELS_MAX(count))
+            return 2;
+        size += bytes;
+    }
+    size += qoi_encode_end(&encoder, out + size);
+    fwrite(out, 1, size, stdout);
+    return 0;
+}
+"""
+
+def qoi_hash(r, g, b):
+    return (r * 3 + g * 5 + b * 7 + 255 * 11) % 64
+
+def encode(width, height, rgb):
+    """ The reference encoder, for RGB images. """
+    out = bytearray(b"qoif" + struct.pack(">II", width, height) + bytes((3, 0)))
+    index = [None] * 64
+    previous = (0, 0, 0)
+    run = 0
+    pixels = width * height
+    for i in range(pixels):
+        pixel = tuple(rgb[i * 3:i * 3 + 3])
+        if pixel == previous:
+            run += 1
+            if run == 62 or i == pixels - 1:
+                out.append(0xc0 | (run - 1))
+                run = 0
+            continue
+        if run:
+            out.append(0xc0 | (run - 1))
+            run = 0
+        h = qoi_hash(*pixel)
+        if index[h] == pixel:
+            out.append(h)
+        else:
+            index[h] = pixel
+            dr, dg, db = (((c - p + 128) & 0xff) - 128 for c, p in zip(pixel, previous))
+            if -2 <= dr <= 1 and -2 <= dg <= 1 and -2 <= db <= 1:
+                out.append(0x40 | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2))
+            elif -32 <= dg <= 31 and -8 <= dr - dg <= 7 and -8 <= db - dg <= 7:
+                out += bytes((0x80 | (dg + 32), ((dr - dg + 8) << 4) | (db - dg + 8)))
+            else:
+                out += bytes((0xfe,) + pixel)
+        previous = pixel
+    return bytes(out + bytes(7) + b"\x01")
+
+def decode(data):
+    """ Returns (width, height, rgb) of an RGB or RGBA QOI image (alpha dropped). """
+    if data[:4] != b"qoif":
+        raise ValueError("not a QOI image")
+    width, height = struct.unpack(">II", data[4:12])
+    index = [(0, 0, 0, 0)] * 64
+    r, g, b, a = 0, 0, 0, 255
+    rgb = bytearray()
+    pos = 14
+    while len(rgb) < width * height * 3:
+        op = data[pos]
+        pos += 1
+        if op == 0xfe:
+            r, g, b = data[pos:pos + 3]
+            pos += 3
+        elif op == 0xff:
+            r, g, b, a = data[pos:pos + 4]
+            pos += 4
+        elif op >> 6 == 0:
+            r, g, b, a = index[op]
+        elif op >> 6 == 1:
+            r = (r + ((op >> 4) & 3) - 2) & 0xff
+            g = (g + ((op >> 2) & 3) - 2) & 0xff
+            b = (b + (op & 3) - 2) & 0xff
+        elif op >> 6 == 2:
+            dg = (op & 0x3f) - 32
+            second = data[pos]
+            pos += 1
+            r = (r + dg + (second >> 4) - 8) & 0xff
+            g = (g + dg) & 0xff
+            b = (b + dg + (second & 0xf) - 8) & 0xff
+        else:
+            rgb += bytes((r, g, b)) * (op & 0x3f)
+        index[(r * 3 + g * 5 + b * 7 + a * 11) % 64] = (r, g, b, a)
+        rgb += bytes((r, g, b))
+    if data[pos:pos + 8] != bytes(7) + b"\x01":
+        raise ValueError("no end marker")
+    return width, height, bytes(rgb[:width * height * 3])
+
+def test_images(rng):
+    """ (name, width, height, rgb) """
+    images = []
+    black = bytes(3)
+    for run in (1, 61, 62, 63, 124, 125, 200):
+        images.append(("run %d" % run, run + 2, 1, black * run + bytes((255, 0, 0)) + black))
+    images.append(("flat", 64, 48, bytes((20, 200, 50)) * (64 * 48)))
+
+    diffs = bytearray()
+    for dr in range(-3, 3):
+        for dg in range(-34, 34, 5):
+            for db in range(-10, 10, 3):
+                diffs += bytes((0, 128, 255))
+                diffs += bytes(((0 + dr) & 0xff, (128 + dg) & 0xff, (255 + db) & 0xff))
+    images.append(("diff/luma", len(diffs) // 3, 1, bytes(diffs)))
+
+    # 16 colours in runs of 1 to 14 dots, like the DHGR and NTSC lines
+    palette = [bytes(rng.randrange(256) for _ in range(3)) for _ in range(16)]
+    line = bytearray()
+    while len(line) < 560 * 3 * 192:
+        line += palette[rng.randrange(16)] * rng.randrange(1, 15)
+    images.append(("palette", 560, 192, bytes(line[:560 * 3 * 192])))
+
+    images.append(("noise", 97, 31, bytes(rng.randrange(256) for _ in range(97 * 31 * 3))))
+    return images
+
+def build(cc, workdir):
+    with open(os.path.join(workdir, "pico.h"), "w") as f:
+        f.write("#define __time_critical_func(x) x\n")
+    with open(os.path.join(workdir, "harness.c"), "w") as f:
+        f.write(HARNESS)
+    exe = os.path.join(workdir, "qoi_harness")
+    result = subprocess.run([cc, "-std=gnu11", "-O2", "-Wall", "-I" + workdir, "-I" + os.path.dirname(SOURCE),
+                             SOURCE, os.path.join(workdir, "harness.c"), "-o", exe], capture_output=True, text=True)
+    if result.returncode != 0:
+        sys.exit("build failed:\n%s" % result.stderr)
+    return exe
+
+def check(exe, rng):
+    errors = 0
+    for name, width, height, rgb in test_images(rng):
+        expected = encode(width, height, rgb)
+        if decode(expected) != (width, height, rgb):
+            sys.exit("%s: the reference encoder does not round trip" % name)
+        pixels = width * height
+        for part in sorted({1, 3, 62, 63, width, pixels, rng.randrange(1, pixels + 1)}):
+            result = subprocess.run([exe, str(width), str(height), str(part)], input=rgb, capture_output=True)
+            if result.returncode != 0:
+                print("%s, parts of %d: harness failed (%d)" % (name, part, result.returncode))
+                errors += 1
+            elif result.stdout != expected:
+                print("%s, parts of %d: %d bytes, the reference encoder has %d" % (name, part, len(result.stdout), len(expected)))
+                errors += 1
+        print("%-10s %4dx%-3d %7d bytes (%.2f per pixel)" % (name, width, height, len(expected), len(expected) / pixels))
+    return errors
+
+def main():
+    parser = argparse.ArgumentParser(description="Check the streaming QOI encoder against the reference encoder")
+    parser.add_argument("--seed",   default=1, type=int, help="random seed of the test images")
+    parser.add_argument("--cc",     default=os.environ.get("CC", "gcc"), help="host C compiler")
+    parser.add_argument("--decode", nargs=2, metavar=("QOI", "PPM"), help="convert a QOI image to a PPM")
+    args = parser.parse_args()
+
+    if args.decode:
+        width, height, rgb = decode(open(args.decode[0], "rb").read())
+        with open(args.decode[1], "wb") as f:
+            f.write(b"P6\n%d %d\n255\n" % (width, height) + rgb)
+        return
+
+    workdir = tempfile.mkdtemp(prefix="qoi_check")
+    errors = check(build(args.cc, workdir), random.Random(args.seed))
+    print("%d errors" % errors)
+    sys.exit(1 if errors else 0)
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,314 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*  Host harness of tools/abus_trace.py and tools/abus_trace_bench.py
+
+    Built by abus_trace.py from the firmware sources of the slotted bus handling
+    (applebus/abus.c, abus_trace.c, config/device_regs.c, ...) with pico_host.h, like
+    render_golden.c. The bus cycles go through the real abus_interface:
+
+      abus_replay <trace image> [memory dump]
+
+    loads a trace saved by the firmware (FLASH_TRACE area read back with picotool) and
+    runs abus_trace_replay on it, like card command 0x43 on the device. Prints
+    "cycles <bus cycles>", "ns <host ns per bus cycle>" and "crc <main> <aux>" (the
+    "TRACE CRC" of the debug page) and writes main and aux memory to the dump.
+
+      abus_replay --profile <raw words> [repeat] [handler index]
+
+    replays raw 32 bit bus words (abus_trace.py raw) through abus_interface, best of
+    [repeat] runs, and prints "<handler> <bus cycles> <host ns>" per bus_functions[]
+    handler (and card_select), then "total <bus cycles> <host ns>". The handler of
+    each bus cycle, as one byte indexing the printed lines, goes to [handler index].
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#if defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+#include <pico/stdlib.h>
+#include "applebus/abus.h"
+#include "applebus/abus_trace.h"
+#include "applebus/buffers.h"
+#include "config/config.h"
+
+//  flash areas of the linker script: the trace image is loaded into FLASH_TRACE, which is larger
+//  than on the device for the images encoded on the host (abus_trace.py encode)
+uint8_t __trace_data_start[4*1024*1024];
+uint8_t __config_data_start[4096];
+uint8_t __font_dir_start[4096];
+uint8_t __font_roms_start[4096];
+
+//  abus.c dispatch table and handlers
+extern void (*bus_functions[16*2])(uint32_t value);
+extern void bus_func_ignore(uint32_t value);
+extern void bus_func_screen_write(uint32_t value);
+extern void bus_func_cxxx_read(uint32_t value);
+extern void bus_func_cxxx_write(uint32_t value);
+extern void bus_func_fxxx_read(uint32_t value);
+#ifdef FEATURE_SHR
+extern void bus_func_shr_write(uint32_t value);
+#endif
+
+/*  pico-sdk stand-ins */
+
+static uint64_t host_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+absolute_time_t get_absolute_time(void)             { return host_ns() / 1000; }
+uint64_t time_us_64(void)                           { return host_ns() / 1000; }
+uint32_t time_us_32(void)                           { return (uint32_t)(host_ns() / 1000); }
+
+uint32_t save_and_disable_interrupts(void)          { return 0; }
+void restore_interrupts(uint32_t status)            { (void)status; }
+void __dmb(void)                                    { }
+
+void panic(const char* fmt, ...)
+{
+    fprintf(stderr, "abus_replay: panic %s\n", fmt);
+    exit(2);
+}
+
+void memcpy32(void* dst, const void* src, uint32_t size)   { memcpy(dst, src, size); }
+
+//  the menu (device_regs.c, card register writes of the profile), not shown by the harness
+void menuShow(char key)                             { (void)key; }
+void menuShowSaved(void)                            { }
+
+//  linked, but never called by the harness
+void flash_range_erase(uint32_t offset, size_t count)                       { (void)offset; (void)count; panic("flash"); }
+void flash_range_program(uint32_t offset, const uint8_t* data, size_t count) { (void)offset; (void)data; (void)count; panic("flash"); }
+
+static uint64_t host_cycles(void)
+{
+#if defined(__i386__) || defined(__x86_64__)
+    return __rdtsc();
+#else
+    return host_ns();
+#endif
+}
+
+static uint8_t* read_file(const char* path, size_t* size)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return NULL;
+    fseek(file, 0, SEEK_END);
+    *size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    uint8_t* data = malloc(*size + 1);
+    if ((!data) || (fread(data, 1, *size, file) != *size))
+    {
+        fclose(file);
+        return NULL;
+    }
+    fclose(file);
+    return data;
+}
+
+//  The trace through abus_trace_replay, see the top of the file
+static int replay(const char* path, const char* dump)
+{
+    size_t size;
+    uint8_t* image = read_file(path, &size);
+    if (!image)
+    {
+        fprintf(stderr, "abus_replay: cannot read %s\n", path);
+        return 2;
+    }
+    if (size > sizeof(__trace_data_start))
+    {
+        fprintf(stderr, "abus_replay: %s is larger than %u bytes\n", path, (uint)sizeof(__trace_data_start));
+        return 2;
+    }
+    memset(__trace_data_start, 0xff, sizeof(__trace_data_start));
+    memcpy(__trace_data_start, image, size);
+
+    if (!abus_trace_replay())
+    {
+        fprintf(stderr, "abus_replay: %s is no bus trace\n", path);
+        return 2;
+    }
+    printf("cycles %u\n", abus_trace_replay_cycles);
+    printf("ns %u\n", abus_trace_replay_ns);
+    printf("crc %08X %08X\n", abus_trace_replay_crc_main, abus_trace_replay_crc_aux);
+
+    if (dump)
+    {
+        FILE* file = fopen(dump, "wb");
+        if ((!file) || (fwrite(apple_memory, MAX_ADDRESS, 1, file) != 1) || (fwrite(aux_memory, MAX_ADDRESS, 1, file) != 1))
+        {
+            fprintf(stderr, "abus_replay: cannot write %s\n", dump);
+            return 2;
+        }
+        fclose(file);
+    }
+    return 0;
+}
+
+typedef struct
+{
+    const char* name;
+    void        (*handler)(uint32_t value);
+    uint32_t    count;
+    uint64_t    cycles;
+} profile_t;
+
+//  Host cycles of abus_interface per handler, see the top of the file
+static int profile(const char* path, uint repeat, const char* index_path)
+{
+    size_t size;
+    uint32_t* words = (uint32_t*) read_file(path, &size);
+    if (!words)
+    {
+        fprintf(stderr, "abus_replay: cannot read %s\n", path);
+        return 2;
+    }
+    size_t count = size / 4;
+
+    profile_t handlers[] =
+    {
+        { "card_select",  NULL                  },
+        { "ignore",       bus_func_ignore       },
+        { "screen_write", bus_func_screen_write },
+#ifdef FEATURE_SHR
+        { "shr_write",    bus_func_shr_write    },
+#endif
+        { "cxxx_read",    bus_func_cxxx_read    },
+        { "cxxx_write",   bus_func_cxxx_write   },
+        { "fxxx_read",    bus_func_fxxx_read    },
+    };
+    const uint handler_count = sizeof(handlers) / sizeof(handlers[0]);
+
+    //  The handler of each bus cycle, looked up like abus_interface does
+    uint8_t* index = malloc(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        uint32_t value = words[i];
+        void (*handler)(uint32_t) = NULL;
+        if (!CARD_SELECT(value))
+            handler = bus_functions[ADDRESS_BUS_HI_NIBBLE(value) + (ACCESS_WRITE(value) ? 0x10 : 0)];
+        index[i] = 0;
+        for (uint h = 0; h < handler_count; h++)
+        {
+            if (handlers[h].handler == handler)
+                index[i] = h;
+        }
+        handlers[index[i]].count++;
+    }
+
+    if (index_path)
+    {
+        FILE* file = fopen(index_path, "wb");
+        if ((!file) || (fwrite(index, 1, count, file) != count))
+        {
+            fprintf(stderr, "abus_replay: cannot write %s\n", index_path);
+            return 2;
+        }
+        fclose(file);
+    }
+
+    //  Cost of reading the cycle counter twice, subtracted from each bus cycle
+    uint64_t overhead = UINT64_MAX;
+    for (uint i = 0; i < 1000; i++)
+    {
+        uint64_t start = host_cycles();
+        uint64_t cycles = host_cycles() - start;
+        if (cycles < overhead)
+            overhead = cycles;
+    }
+
+    uint64_t best_total = UINT64_MAX;
+    uint64_t best_ns = UINT64_MAX;
+    uint64_t best_sum = UINT64_MAX;
+    uint64_t best[sizeof(handlers) / sizeof(handlers[0])];
+    for (uint r = 0; r < repeat; r++)
+    {
+        //  Every run starts from the same state, a IIe after a reset
+        memset(apple_memory, 0, sizeof(apple_memory));
+        memset(aux_memory, 0, sizeof(aux_memory));
+        soft_switches = SOFTSW_TEXT_MODE | SOFTSW_V7_MODE3;
+        SET_IFLAG(1, IFLAGS_IIE_REGS);
+
+        //  The whole trace, then every bus cycle on its own for the share of each handler
+        uint64_t start_ns = host_ns();
+        uint64_t start = host_cycles();
+        for (size_t i = 0; i < count; i++)
+            abus_interface(words[i]);
+        uint64_t total = host_cycles() - start;
+        uint64_t ns = host_ns() - start_ns;
+        if (total < best_total)
+        {
+            best_total = total;
+            best_ns = ns;
+        }
+
+        uint64_t cycles[sizeof(handlers) / sizeof(handlers[0])] = { 0 };
+        for (size_t i = 0; i < count; i++)
+        {
+            start = host_cycles();
+            abus_interface(words[i]);
+            uint64_t time = host_cycles() - start;
+            cycles[index[i]] += (time > overhead) ? time - overhead : 0;
+        }
+        uint64_t sum = 0;
+        for (uint h = 0; h < handler_count; h++)
+            sum += cycles[h];
+        if (sum < best_sum)
+        {
+            best_sum = sum;
+            for (uint h = 0; h < handler_count; h++)
+                best[h] = cycles[h];
+        }
+    }
+
+    //  Shares of the timed bus cycles, scaled to the time of the best run of the whole trace
+    for (uint h = 0; h < handler_count; h++)
+    {
+        uint64_t ns = best_sum ? (best[h] * best_ns + best_sum / 2) / best_sum : 0;
+        printf("%s %u %llu\n", handlers[h].name, handlers[h].count, (unsigned long long)ns);
+    }
+    printf("total %zu %llu\n", count, (unsigned long long)best_ns);
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    config_load_defaults();
+
+    if ((argc >= 3) && (strcmp(argv[1], "--profile") == 0))
+        return profile(argv[2], (argc > 3) ? atoi(argv[3]) : 5, (argc > 4) ? argv[4] : NULL);
+    if (argc >= 2)
+        return replay(argv[1], (argc > 2) ? argv[2] : NULL);
+
+    fprintf(stderr, "usage: abus_replay <trace image> [memory dump] | --profile <raw words> [repeat] [handler index]\n");
+    return 2;
+}
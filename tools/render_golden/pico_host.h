@@ -0,0 +1,337 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*  Host stand-in for the pico-sdk, used by tools/render_golden.py to build the
+    renderers for the PC. The TMDS queues pass the buffer pointers, not uint32_t.
+
+    render_golden.py generates the pico-sdk header names (pico.h, hardware/pio.h, ...)
+    as one line files including this one. Only the declarations are here, the few
+    functions the renderers really call are implemented in render_golden.c, the rest
+    is removed by the linker (--gc-sections).
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+//  TMDS queues: render_golden.c captures the scanlines sent to q_tmds_valid
+typedef struct { uint32_t *data; uint element_count; uint wptr, rptr; } queue_t;
+void queue_init(queue_t*, uint, uint);
+void queue_add_blocking(queue_t*, const void*);
+void queue_remove_blocking(queue_t*, void*);
+bool queue_try_add(queue_t*, const void*);
+bool queue_try_remove(queue_t*, void*);
+uint queue_get_level(queue_t*);
+#define queue_add_blocking_u32(q, p)    queue_add_blocking(q, p)
+#define queue_remove_blocking_u32(q, p) queue_remove_blocking(q, p)
+
+typedef struct pio_hw { volatile uint32_t ctrl, fstat, fdebug, flevel; volatile uint32_t txf[4]; volatile uint32_t rxf[4]; volatile uint32_t irq, irq_force, input_sync_bypass; } pio_hw_t;
+typedef pio_hw_t *PIO;
+#define pio0 ((PIO)0x50200000)
+#define pio1 ((PIO)0x50300000)
+typedef struct { uint32_t ctrl; } dma_channel_config;
+typedef struct { uint32_t c; } pio_sm_config;
+typedef struct pio_program { const uint16_t *instructions; uint8_t length; int8_t origin; } pio_program_t;
+#define spin_lock_t uint32_t
+struct repeating_timer { int x; };
+typedef bool (*repeating_timer_callback_t)(struct repeating_timer *);
+typedef void (*gpio_irq_callback_t)(uint, uint32_t);
+typedef void (*irq_handler_t)(void);
+typedef struct { volatile uint32_t read_addr, write_addr, transfer_count, ctrl_trig, al1_ctrl, al1_read_addr, al1_write_addr, al1_transfer_count_trig; } dma_channel_hw_t;
+typedef struct { dma_channel_hw_t ch[12]; volatile uint32_t ints0, inte0, ints1, inte1, multi_channel_trigger; } dma_hw_t;
+extern dma_hw_t *dma_hw;
+typedef struct { struct { volatile uint32_t ctrdeq, dbg_tcr; } ch[12]; } dma_debug_hw_t;
+extern dma_debug_hw_t *dma_debug_hw;
+typedef struct { volatile uint32_t csr, rvr, cvr, calib; } systick_hw_t;
+extern systick_hw_t *systick_hw;
+typedef struct { volatile uint32_t cpuid, gpio_in, gpio_hi_in; volatile uint32_t fifo_st, fifo_wr, fifo_rd; } sio_hw_t;
+extern sio_hw_t *sio_hw;
+typedef struct { struct { volatile uint32_t status, ctrl; } io[6]; } ioqspi_hw_t;
+extern ioqspi_hw_t *ioqspi_hw;
+typedef struct { volatile uint32_t timerawl, timerawh; } timer_hw_t;
+extern timer_hw_t *timer_hw;
+typedef struct { uint32_t accum[2]; uint32_t base[3]; uint32_t pop[3]; uint32_t peek[3]; uint32_t ctrl[2]; uint32_t add_raw[2]; uint32_t base01; } interp_hw_t;
+extern interp_hw_t *interp0, *interp1;
+typedef struct { uint32_t c; } interp_config;
+
+#define __time_critical_func(x) x
+#define __not_in_flash_func(x) x
+#define __no_inline_not_in_flash_func(x) x
+#define __noinline __attribute__((noinline))
+#define __unused __attribute__((unused))
+#define __in_flash(x) __attribute__((section(".flashdata." x)))
+#define __scratch_x(x) __attribute__((section(".scratch_x." x)))
+#define __scratch_y(x) __attribute__((section(".scratch_y." x)))
+#define __aligned(x) __attribute__((aligned(x)))
+#define __force_inline inline __attribute__((always_inline))
+#define __STRING(x) #x
+#define __compiler_memory_barrier() __asm volatile ("" : : : "memory")
+#define XIP_BASE 0x10000000
+#define SRAM_BASE 0x20000000
+#define FLASH_SECTOR_SIZE 4096
+#define FLASH_PAGE_SIZE 256
+#define PICO_DEFAULT_LED_PIN 25
+#define PICO_RP2040 1
+#define NUM_DMA_CHANNELS 12
+#define DMA_IRQ_0 11
+#define DMA_IRQ_1 12
+#define PIO0_IRQ_0 7
+#define PIO0_IRQ_1 8
+#define PIO1_IRQ_0 9
+#define GPIO_IN 0
+#define GPIO_OUT 1
+#define GPIO_IRQ_EDGE_FALL 4
+#define GPIO_IRQ_EDGE_RISE 8
+#define GPIO_FUNC_NULL 0x1f
+#define GPIO_FUNC_PIO0 6
+#define GPIO_FUNC_PIO1 7
+#define GPIO_OVERRIDE_LOW 2
+#define GPIO_OVERRIDE_NORMAL 0
+#define IO_QSPI_GPIO_QSPI_SS_CTRL_OEOVER_LSB 12
+#define IO_QSPI_GPIO_QSPI_SS_CTRL_OEOVER_BITS 0x3000
+#define DMA_SIZE_8 0
+#define DMA_SIZE_16 1
+#define DMA_SIZE_32 2
+#define DREQ_PIO0_RX0 4
+#define DREQ_FORCE 0x3f
+#define VREG_VOLTAGE_1_20 0
+#define pio_fifo_join_rx 2
+#define PIO_FIFO_JOIN_RX 2
+#define clk_sys 5
+#define tight_loop_contents() do{}while(0)
+#define PICO_FLASH_SIZE_BYTES (2*1024*1024)
+
+static inline uint64_t to_us_since_boot(absolute_time_t t) { return t; }
+static inline uint32_t to_ms_since_boot(absolute_time_t t) { return (uint32_t)(t/1000); }
+absolute_time_t get_absolute_time(void);
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+void sleep_ms(uint32_t);
+void sleep_us(uint64_t);
+void busy_wait_us(uint64_t);
+void busy_wait_us_32(uint32_t);
+bool stdio_init_all(void);
+void vreg_set_voltage(int);
+bool set_sys_clock_khz(uint32_t, bool);
+uint32_t clock_get_hz(int);
+void gpio_init(uint);
+void gpio_set_dir(uint, bool);
+void gpio_set_pulls(uint, bool, bool);
+void gpio_pull_down(uint);
+void gpio_pull_up(uint);
+void gpio_disable_pulls(uint);
+bool gpio_get(uint);
+void gpio_put(uint, bool);
+void gpio_xor_mask(uint32_t);
+uint32_t gpio_get_all(void);
+void gpio_set_function(uint, int);
+void gpio_set_irq_enabled_with_callback(uint, uint32_t, bool, gpio_irq_callback_t);
+void gpio_set_irq_enabled(uint, uint32_t, bool);
+void gpio_set_input_enabled(uint, bool);
+void gpio_set_slew_rate(uint, int);
+void gpio_set_drive_strength(uint, int);
+void gpio_set_inover(uint, uint);
+void hw_write_masked(volatile void*, uint32_t, uint32_t);
+uint pio_add_program(PIO, const pio_program_t*);
+bool pio_can_add_program(PIO, const pio_program_t*);
+void pio_remove_program(PIO, const pio_program_t*, uint);
+void pio_clear_instruction_memory(PIO);
+int pio_claim_unused_sm(PIO, bool);
+void pio_sm_claim(PIO, uint);
+void pio_sm_unclaim(PIO, uint);
+bool pio_sm_is_rx_fifo_empty(PIO, uint);
+bool pio_sm_is_rx_fifo_full(PIO, uint);
+bool pio_sm_is_tx_fifo_full(PIO, uint);
+uint pio_sm_get_rx_fifo_level(PIO, uint);
+uint32_t pio_sm_get(PIO, uint);
+uint32_t pio_sm_get_blocking(PIO, uint);
+void pio_sm_put(PIO, uint, uint32_t);
+void pio_sm_put_blocking(PIO, uint, uint32_t);
+void pio_sm_set_enabled(PIO, uint, bool);
+void pio_sm_clear_fifos(PIO, uint);
+void pio_sm_restart(PIO, uint);
+void pio_sm_init(PIO, uint, uint, const pio_sm_config*);
+void pio_sm_set_consecutive_pindirs(PIO, uint, uint, uint, bool);
+void pio_sm_exec(PIO, uint, uint);
+void pio_sm_drain_tx_fifo(PIO, uint);
+void pio_gpio_init(PIO, uint);
+uint pio_get_dreq(PIO, uint, bool);
+uint pio_get_index(PIO);
+void pio_set_irq0_source_enabled(PIO, int, bool);
+pio_sm_config pio_get_default_sm_config(void);
+void sm_config_set_in_pins(pio_sm_config*, uint);
+void sm_config_set_out_pins(pio_sm_config*, uint, uint);
+void sm_config_set_in_shift(pio_sm_config*, bool, bool, uint);
+void sm_config_set_out_shift(pio_sm_config*, bool, bool, uint);
+void sm_config_set_fifo_join(pio_sm_config*, int);
+void sm_config_set_clkdiv(pio_sm_config*, float);
+void sm_config_set_wrap(pio_sm_config*, uint, uint);
+void sm_config_set_jmp_pin(pio_sm_config*, uint);
+void sm_config_set_sideset_pins(pio_sm_config*, uint);
+extern const pio_program_t a2c_input_program, a2c_input_laser_program, a2c_mode_program, abus_program, tmds_encode_1bpp_program;
+void a2c_input_program_init(PIO, uint, uint, uint);
+void a2c_input_laser_program_init(PIO, uint, uint, uint);
+void a2c_mode_program_init(PIO, uint, uint, uint);
+pio_sm_config a2c_input_program_get_default_config(uint);
+pio_sm_config a2c_input_laser_program_get_default_config(uint);
+pio_sm_config a2c_mode_program_get_default_config(uint);
+pio_sm_config tmds_encode_1bpp_program_get_default_config(uint);
+void tmds_encode_1bpp_init(PIO, uint);
+int dma_claim_unused_channel(bool);
+void dma_channel_claim(uint);
+void dma_channel_unclaim(uint);
+void dma_channel_cleanup(uint);
+dma_channel_config dma_channel_get_default_config(uint);
+void channel_config_set_transfer_data_size(dma_channel_config*, int);
+void channel_config_set_read_increment(dma_channel_config*, bool);
+void channel_config_set_write_increment(dma_channel_config*, bool);
+void channel_config_set_ring(dma_channel_config*, bool, uint);
+void channel_config_set_dreq(dma_channel_config*, uint);
+void channel_config_set_chain_to(dma_channel_config*, uint);
+void channel_config_set_irq_quiet(dma_channel_config*, bool);
+void channel_config_set_high_priority(dma_channel_config*, bool);
+void channel_config_set_bswap(dma_channel_config*, bool);
+void dma_channel_configure(uint, const dma_channel_config*, volatile void*, const volatile void*, uint, bool);
+void dma_channel_set_config(uint, const dma_channel_config*, bool);
+void dma_channel_set_read_addr(uint, const volatile void*, bool);
+void dma_channel_set_write_addr(uint, volatile void*, bool);
+void dma_channel_set_trans_count(uint, uint32_t, bool);
+void dma_channel_start(uint);
+void dma_channel_abort(uint);
+void dma_start_channel_mask(uint32_t);
+void dma_channel_wait_for_finish_blocking(uint);
+bool dma_channel_is_busy(uint);
+void dma_irqn_acknowledge_channel(uint, uint);
+void dma_channel_set_irq0_enabled(uint, bool);
+void irq_set_exclusive_handler(uint, irq_handler_t);
+void irq_add_shared_handler(uint, irq_handler_t, uint8_t);
+void irq_remove_handler(uint, irq_handler_t);
+void irq_set_enabled(uint, bool);
+void irq_set_priority(uint, uint8_t);
+uint32_t save_and_disable_interrupts(void);
+void restore_interrupts(uint32_t);
+uint next_striped_spin_lock_num(void);
+void multicore_launch_core1(void (*)(void));
+void multicore_reset_core1(void);
+void multicore_fifo_push_blocking(uint32_t);
+uint32_t multicore_fifo_pop_blocking(void);
+bool multicore_fifo_rvalid(void);
+void multicore_lockout_victim_init(void);
+void multicore_lockout_start_blocking(void);
+void multicore_lockout_end_blocking(void);
+bool multicore_lockout_start_timeout_us(uint64_t);
+bool multicore_lockout_end_timeout_us(uint64_t);
+uint get_core_num(void);
+bool add_repeating_timer_ms(int32_t, repeating_timer_callback_t, void*, struct repeating_timer*);
+bool cancel_repeating_timer(struct repeating_timer*);
+void watchdog_enable(uint32_t, bool);
+void flash_range_erase(uint32_t, size_t);
+void flash_range_program(uint32_t, const uint8_t*, size_t);
+void adc_init(void);
+void adc_gpio_init(uint);
+void adc_select_input(uint);
+void adc_set_round_robin(uint);
+void adc_irq_set_enabled(bool);
+void adc_set_clkdiv(float);
+void adc_fifo_setup(bool, bool, uint16_t, bool, bool);
+void adc_fifo_drain(void);
+void adc_run(bool);
+bool adc_fifo_is_empty(void);
+uint16_t adc_fifo_get(void);
+uint adc_fifo_get_level(void);
+void reset_usb_boot(uint32_t, uint32_t);
+void interp_config_set_shift(interp_config*, uint);
+void interp_config_set_mask(interp_config*, uint, uint);
+void interp_config_set_add_raw(interp_config*, bool);
+interp_config interp_default_config(void);
+void interp_set_config(interp_hw_t*, uint, interp_config*);
+void pwm_set_wrap(uint, uint16_t);
+uint pwm_gpio_to_slice_num(uint);
+void panic(const char*, ...);
+void __breakpoint(void);
+void __wfe(void);
+void __sev(void);
+void __dmb(void);
+#define spin_lock_blocking(x) 0
+#define spin_unlock(x,y)
+
+void gpio_set_outover(uint, uint);
+void gpio_init_mask(uint32_t);
+void pio_sm_set_pins_with_mask(PIO, uint, uint32_t, uint32_t);
+void pio_sm_set_pindirs_with_mask(PIO, uint, uint32_t, uint32_t);
+void sm_config_set_clkdiv_int_frac(pio_sm_config*, uint16_t, uint8_t);
+void sm_config_set_set_pins(pio_sm_config*, uint, uint);
+pio_sm_config abus_program_get_default_config(uint);
+void pio_interrupt_clear(PIO, uint);
+typedef struct { struct { volatile uint32_t x; } io[30]; volatile uint32_t gpio[30]; } padsbank0_hw_t;
+extern padsbank0_hw_t *padsbank0_hw;
+#define PADS_BANK0_GPIO0_IE_BITS 0x40
+#define PADS_BANK0_GPIO0_SLEWFAST_BITS 1
+#define PADS_BANK0_GPIO0_DRIVE_BITS 0x30
+#define PADS_BANK0_GPIO0_DRIVE_LSB 4
+#define GPIO_OVERRIDE_INVERT 1
+#define PHI0_GPIO 26
+
+typedef struct { uint32_t csr; } pwm_config;
+extern const pio_program_t dvi_serialiser_program;
+void dvi_serialiser_program_init(PIO, uint, uint, uint, bool);
+void pio_enable_sm_mask_in_sync(PIO, uint32_t);
+#define pis_interrupt0 8
+pwm_config pwm_get_default_config(void);
+void pwm_config_set_clkdiv_int(pwm_config*, uint);
+void pwm_config_set_wrap(pwm_config*, uint16_t);
+void pwm_init(uint, pwm_config*, bool);
+void pwm_set_enabled(uint, bool);
+void pwm_set_both_levels(uint, uint16_t, uint16_t);
+void pwm_set_gpio_level(uint, uint16_t);
+void pwm_set_chan_level(uint, uint, uint16_t);
+void pwm_set_output_polarity(uint, bool, bool);
+void pwm_set_mask_enabled(uint32_t);
+#define GPIO_FUNC_PWM 4
+void hw_set_bits(volatile void*, uint32_t);
+void hw_clear_bits(volatile void*, uint32_t);
+#define PIO_CTRL_SM_ENABLE_LSB 0
+void pwm_config_set_output_polarity(pwm_config*, bool, bool);
+absolute_time_t make_timeout_time_ms(uint32_t);
+absolute_time_t make_timeout_time_us(uint64_t);
+void sleep_until(absolute_time_t);
+void busy_wait_until(absolute_time_t);
+#define PIO_FDEBUG_RXSTALL_LSB 0
+
+//  libdvi: only what the renderers use of struct dvi_inst (see libraries/libdvi/dvi.h)
+struct dvi_inst {
+    uint32_t *tmds_pinned_start;
+    uint32_t *tmds_pinned_end;
+    uint32_t scanline_errors;
+    uint8_t scanline_emulation;
+    queue_t q_tmds_valid;
+    queue_t q_tmds_free;
+};
@@ -0,0 +1,854 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*  Host harness of tools/render_golden.py
+
+    Built twice by render_golden.py from the firmware sources: once for the slotted
+    firmware (with FEATURE_SHR) and once with FEATURE_A2C. Every render mode is set up with the test
+    patterns of firmware/test (for the A2C, the hires and double hires patterns converted
+    into SEROUT dots and VIDD7) and rendered into captured TMDS buffers:
+
+      render_golden <output directory> [repeat]
+
+    writes <mode>.tmds per mode (the captured scanlines, 3 channels of DVI_WORDS_PER_CHANNEL
+    words each, blue first) and prints "<mode> <lines> <host cycles per frame>" per mode.
+
+    Each mode is rendered without the line cache, and twice more with the cache enabled
+    (filling it, then sending the cached lines); all three frames must be identical.
+    The A2C setups also check the video bytes rebuilt from the dots against the test patterns.
+
+    The A2C build also replays recordings of the A2C video input (tools/a2c_record.py --replay):
+
+      render_golden_a2c --replay <frames> <output directory> [every]
+
+    renders each frame image of <frames> (the recording header page, then the images, see
+    a2c/a2c_record.h) with the settings of the recording, prints "frame_<n> <lines> <host
+    cycles>" per frame and writes frame_<n>.tmds for every <every>'th frame (none for 0).
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#if defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+#include "applebus/buffers.h"
+#include "config/config.h"
+#include "render/render.h"
+#include "render/render_cache.h"
+#include "videx/videx_vterm.h"
+#include "test/testpattern_hgr.h"
+#include "test/testpattern_dhgr.h"
+#ifdef FEATURE_A2C
+#include "a2c/a2c.h"
+#include "dvi/tmds_mono.h"
+#include "a2c/a2c_lut.h"
+#include "a2c/a2c_record.h"
+#include "a2c/a2c_osd.h"
+#endif
+
+#define DVI_X_RESOLUTION_GOLDEN 640
+#define GOLDEN_TMDS_BUFFERS     8
+#define GOLDEN_MAX_LINES        256
+
+struct dvi_inst dvi0;
+
+//  render.c (the render loop is replaced by render_frame)
+bool mono_rendering;
+bool color_support;
+
+//  flash areas of the linker script (config and custom fonts are never read, config_load_defaults is used)
+uint8_t __config_data_start[4096];
+uint8_t __font_dir_start[4096];
+uint8_t __font_roms_start[4096];
+
+static uint32_t* s_free[GOLDEN_TMDS_BUFFERS];
+static uint      s_free_count;
+static uint32_t* s_capture;
+static uint      s_capture_lines;
+static bool      s_capture_overflow;
+
+/*  pico-sdk stand-ins */
+
+void queue_init(queue_t* q, uint element_size, uint element_count)
+{
+    (void)element_size;
+    memset(q, 0, sizeof(*q));
+    q->element_count = element_count;
+}
+
+//  q_tmds_free
+void queue_remove_blocking(queue_t* q, void* data)
+{
+    (void)q;
+    if (s_free_count == 0)
+    {
+        fprintf(stderr, "render_golden: renderer holds more than %d TMDS buffers\n", GOLDEN_TMDS_BUFFERS);
+        exit(2);
+    }
+    *(uint32_t**)data = s_free[--s_free_count];
+}
+
+//  q_tmds_valid: capture the scanline and give the buffer back (unless it is a pinned cache buffer)
+void queue_add_blocking(queue_t* q, const void* data)
+{
+    (void)q;
+    uint32_t* tmdsbuf = *(uint32_t* const*)data;
+    uint32_t words = 3 * DVI_WORDS_PER_CHANNEL;
+
+    if (!s_capture)
+        ;   //  timed frame
+    else if (s_capture_lines < GOLDEN_MAX_LINES)
+        memcpy(&s_capture[s_capture_lines * words], tmdsbuf, words * sizeof(uint32_t));
+    else
+        s_capture_overflow = true;
+    s_capture_lines++;
+
+    if ((tmdsbuf < dvi0.tmds_pinned_start) || (tmdsbuf >= dvi0.tmds_pinned_end))
+        s_free[s_free_count++] = tmdsbuf;
+}
+
+bool queue_try_add(queue_t* q, const void* data)   { queue_add_blocking(q, data); return true; }
+bool queue_try_remove(queue_t* q, void* data)       { queue_remove_blocking(q, data); return true; }
+uint queue_get_level(queue_t* q)                    { (void)q; return 0; }
+
+//  time stands still, so text/cursor flashing and the A2C button are stable
+absolute_time_t get_absolute_time(void)             { return 0; }
+uint64_t time_us_64(void)                           { return 0; }
+uint32_t time_us_32(void)                           { return 0; }
+void sleep_ms(uint32_t ms)                          { (void)ms; }
+void sleep_us(uint64_t us)                          { (void)us; }
+
+bool gpio_get(uint gpio)                            { (void)gpio; return false; }
+void gpio_put(uint gpio, bool value)                { (void)gpio; (void)value; }
+void gpio_xor_mask(uint32_t mask)                   { (void)mask; }
+
+//  no DMA channel: the A2C LUT is copied with memcpy
+int  dma_claim_unused_channel(bool required)        { (void)required; return -1; }
+bool dma_channel_is_busy(uint channel)              { (void)channel; return false; }
+void dma_channel_abort(uint channel)                { (void)channel; }
+
+void memcpy32(void* dst, const void* src, uint32_t size)   { memcpy(dst, src, size); }
+
+uint32_t getFreeHeap(void)                          { return 128*1024; }
+
+uint32_t save_and_disable_interrupts(void)          { return 0; }
+void restore_interrupts(uint32_t status)            { (void)status; }
+void __dmb(void)                                    { }
+
+void panic(const char* fmt, ...)
+{
+    fprintf(stderr, "render_golden: panic %s\n", fmt);
+    exit(2);
+}
+
+//  linked, but never called by the harness
+void flash_range_erase(uint32_t offset, size_t count)                       { (void)offset; (void)count; panic("flash"); }
+void flash_range_program(uint32_t offset, const uint8_t* data, size_t count) { (void)offset; (void)data; (void)count; panic("flash"); }
+#ifdef FEATURE_A2C
+void watchdog_enable(uint32_t delay_ms, bool pause_on_debug)                 { (void)delay_ms; (void)pause_on_debug; panic("watchdog"); }
+dma_channel_config dma_channel_get_default_config(uint channel)             { (void)channel; panic("dma"); return (dma_channel_config){ 0 }; }
+void channel_config_set_transfer_data_size(dma_channel_config* c, int size) { (void)c; (void)size; }
+void channel_config_set_read_increment(dma_channel_config* c, bool incr)    { (void)c; (void)incr; }
+void channel_config_set_write_increment(dma_channel_config* c, bool incr)   { (void)c; (void)incr; }
+void dma_channel_configure(uint channel, const dma_channel_config* config, volatile void* write_addr,
+                           const volatile void* read_addr, uint transfer_count, bool trigger)
+{
+    (void)channel; (void)config; (void)write_addr; (void)read_addr; (void)transfer_count; (void)trigger;
+}
+
+void boot_milestone(const char* name)                                       { (void)name; }
+
+//  tmds_mono.c: the symbol pairs of libdvi's tmds_encode_1bpp program (tools/tmds_1bpp_check.py runs
+//  the program itself), written at once instead of by the state machine and the DMA channels
+bool tmds_mono_encode(const uint32_t* dots, uint32_t words, uint32_t* tmdsbuf_red, uint32_t* tmdsbuf_green, uint32_t* tmdsbuf_blue, uint8_t color_mode)
+{
+    if (color_mode > COLOR_MODE_GREEN)
+        return false;
+    for (uint32_t i = 0; i < words * 16; i++)
+    {
+        uint32_t first  = (dots[i / 16] >> (31 - 2 * (i % 16))) & 1;
+        uint32_t second = (dots[i / 16] >> (30 - 2 * (i % 16))) & 1;
+        tmdsbuf_green[i] = (first ? 0x200 : 0x100) | ((second ? 0x2ff : 0x1ff) << 10);
+        tmdsbuf_red[i]   = (color_mode == COLOR_MODE_BW) ? tmdsbuf_green[i] : TMDS_SYMBOL_0_0;
+        tmdsbuf_blue[i]  = tmdsbuf_red[i];
+    }
+    return true;
+}
+
+void tmds_mono_wait(void)                                                   { }
+#endif
+
+/*  test screens */
+
+static uint16_t text_address(uint row, uint column)
+{
+    return 0x400 + ((row & 0x7) << 7) + (((row >> 3) & 0x3) * 40) + column;
+}
+
+//  all 256 characters (normal, inverse, flashing, mousetext), on both 80 column pages
+static void setup_text(void)
+{
+    for (uint row = 0; row < 24; row++)
+    {
+        for (uint column = 0; column < 40; column++)
+        {
+            apple_memory[text_address(row, column)] = (row * 40 + column) & 0xff;
+            aux_memory[text_address(row, column)]   = (row * 40 + column + 0x80) & 0xff;
+        }
+    }
+}
+
+#ifndef FEATURE_A2C
+//  the diagonal color bars of tests.c
+static void setup_lores(void)
+{
+    for (uint y = 0; y < 48; y++)
+    {
+        for (uint x = 0; x < 40; x++)
+        {
+            uint16_t address = text_address(y >> 1, x);
+            uint8_t  color   = (x + y) & 0xf;
+            uint8_t  aux     = (x + 15 - y) & 0xf;
+            if (y & 1)
+            {
+                apple_memory[address] = (apple_memory[address] & 0x0f) | (color << 4);
+                aux_memory[address]   = (aux_memory[address]   & 0x0f) | (aux << 4);
+            }
+            else
+            {
+                apple_memory[address] = (apple_memory[address] & 0xf0) | color;
+                aux_memory[address]   = (aux_memory[address]   & 0xf0) | aux;
+            }
+        }
+    }
+}
+
+static void setup_hires(void)
+{
+    memcpy((void*)hgr_p1, TESTPATTERN_HGR_BIN, 0x2000);
+}
+
+//  the double hires test pattern holds the aux page first
+static void setup_dhgr(void)
+{
+    memcpy((void*)hgr_p3, TESTPATTERN_DHGR_BIN, 0x2000);
+    memcpy((void*)hgr_p1, &TESTPATTERN_DHGR_BIN[0x2000], 0x2000);
+    SET_IFLAG(0, IFLAGS_INTERP_DHGR);
+    SET_IFLAG(0, IFLAGS_NTSC_DHGR);
+}
+
+//  RENDERING: ENABLED (sliding window over the tmds_dhgr_* pixel pairs)
+static void setup_dhgr_interp(void)
+{
+    setup_dhgr();
+    SET_IFLAG(1, IFLAGS_INTERP_DHGR);
+}
+
+//  RENDERING: DOUBLE HIRES NTSC
+static void setup_dhgr_ntsc(void)
+{
+    setup_dhgr();
+    SET_IFLAG(1, IFLAGS_NTSC_DHGR);
+}
+
+//  Videx 80x24: all characters, cursor in the top left corner
+static void setup_videx(void)
+{
+    for (uint i = 0; i < sizeof(videx_vram); i++)
+        videx_vram[i] = i & 0xff;
+    videx_crtc_regs[12] = 0;
+    videx_crtc_regs[13] = 0;
+    videx_crtc_regs[14] = 0;
+    videx_crtc_regs[15] = 0;
+}
+
+//  IIgs super hires: 16 palettes of 16 colors (one ramp per channel and palette), the
+//  palette changing every 13 lines, and diagonal color bars. scb selects the 640 mode,
+//  in the 320 mode every other palette uses the color fill (color 0 repeats the previous one).
+static void setup_shr(uint8_t scb)
+{
+    for (uint line = 0; line < 200; line++)
+    {
+        for (uint i = 0; i < 160; i++)
+        {
+            uint8_t c = (i + line / 2) & 0xf;
+            shr_memory[line * 160 + i] = (c << 4) | ((i & 4) ? 0 : ((c + 8) & 0xf));
+        }
+        uint palette = (line / 13) & 0xf;
+        shr_memory[SHR_SCBS + line] = scb | palette | (((scb & 0x80) == 0) && (palette & 1) ? 0x20 : 0);
+    }
+    for (uint palette = 0; palette < 16; palette++)
+    {
+        for (uint c = 0; c < 16; c++)
+        {
+            //  color word $0RGB, low byte first
+            uint8_t* color = &shr_memory[SHR_PALETTES + palette * 32 + c * 2];
+            color[0] = (((c * palette) & 0xf) << 4) | ((15 - c) & 0xf);
+            color[1] = (c + palette) & 0xf;
+        }
+        shr_palette_dirty[palette] = 1;
+    }
+}
+
+static void setup_shr320(void)
+{
+    setup_shr(0);
+}
+
+static void setup_shr640(void)
+{
+    setup_shr(0x80);
+}
+
+//  The frame of render.c: the border lines take the place of the debug lines
+static void render_shr_frame(void)
+{
+    render_shr_border();
+    render_shr();
+    render_shr_border();
+}
+#else
+extern uint32_t s_screen_buffer[][192][19];
+extern uint32_t s_screen_GR_mask[][192];
+extern uint32_t s_screen_TEXT_mask[][192];
+extern uint64_t s_screen_D7_buffer[][192];
+extern bool     s_sync_found;
+extern bool     s_show_menu_screen;
+extern bool     s_menu_screen_init;
+
+static uint16_t hires_address(uint line)
+{
+    return 0x2000 + ((line & 0x7) << 10) + (((line >> 3) & 0x7) << 7) + ((line >> 6) * 40);
+}
+
+//  The SEROUT dots of 40 hires bytes (MSB first, 2 dots per hires pixel, the high bit delays
+//  the byte by one dot and stretches the previous dot)
+static void hires_dots(const uint8_t* bytes, uint32_t* dots)
+{
+    uint dot = A2C_FIRST_BYTE_DOT;              //  colour phase of the slotted hires renderer
+    bool last = false;
+
+    memset(dots, 0, 19 * sizeof(uint32_t));
+    for (uint column = 0; column < 40; column++)
+    {
+        uint8_t value = bytes[column];
+        uint shift = (value & 0x80) ? 1 : 0;
+        for (uint i = 0; i < 14; i++)
+        {
+            bool on = (i < shift) ? last : (value >> ((i - shift) >> 1)) & 1;
+            if (on)
+                dots[(dot + i) >> 5] |= 0x80000000u >> ((dot + i) & 31);
+        }
+        last = (value >> 6) & 1;
+        dot += 14;
+    }
+}
+
+//  The SEROUT dots of 40 double hires byte pairs (aux first, 1 dot per pixel)
+static void dhgr_dots(const uint8_t* aux, const uint8_t* main, uint32_t* dots)
+{
+    uint dot = A2C_FIRST_BYTE_DOT;
+
+    memset(dots, 0, 19 * sizeof(uint32_t));
+    for (uint column = 0; column < 40; column++)
+    {
+        uint16_t value = (aux[column] & 0x7f) | ((main[column] & 0x7f) << 7);
+        for (uint i = 0; i < 14; i++)
+        {
+            if ((value >> i) & 1)
+                dots[(dot + i) >> 5] |= 0x80000000u >> ((dot + i) & 31);
+        }
+        dot += 14;
+    }
+}
+
+//  The SEROUT dots of 40 lores bytes: the colour nibble (the low one on the upper 4 lines of the
+//  row) repeats every 4 dots, in the colour phase of hires_dots
+static void lores_dots(const uint8_t* bytes, uint line, uint32_t* dots)
+{
+    uint dot = A2C_FIRST_BYTE_DOT;
+
+    memset(dots, 0, 19 * sizeof(uint32_t));
+    for (uint column = 0; column < 40; column++)
+    {
+        uint8_t color = (line & 4) ? (bytes[column] >> 4) : (bytes[column] & 0xf);
+        for (uint i = 0; i < 14; i++)
+        {
+            if ((color >> ((14 * column + i) & 3)) & 1)
+                dots[(dot + i) >> 5] |= 0x80000000u >> ((dot + i) & 31);
+        }
+        dot += 14;
+    }
+}
+
+//  Replay of the video bytes rebuilt by a2c_line_bytes: with VIDD7 they must be the bytes of the
+//  test pattern, without VIDD7 (pin not connected) they must give the same dots
+static void check_a2c_bytes(bool dhgr)
+{
+    for (uint line = 0; line < 192; line++)
+    {
+        const uint8_t* pattern = dhgr ? &TESTPATTERN_DHGR_BIN[0x2000] : TESTPATTERN_HGR_BIN;
+        const uint8_t* expected = &pattern[hires_address(line) - 0x2000];
+        const uint8_t* expected_aux = &TESTPATTERN_DHGR_BIN[hires_address(line) - 0x2000];
+        uint8_t main[40], aux[40];
+        uint32_t dots[19];
+
+        if (!a2c_line_bytes(0, line, dhgr, main, aux))
+        {
+            fprintf(stderr, "a2c_line_bytes: line %u doesn't give the dots again\n", line);
+            return;
+        }
+        for (uint i = 0; i < 40; i++)
+        {
+            bool ok = dhgr ? ((main[i] == (expected[i] & 0x7f)) && (aux[i] == (expected_aux[i] & 0x7f))) : (main[i] == expected[i]);
+            if (!ok)
+            {
+                fprintf(stderr, "a2c_line_bytes: line %u byte %u is %02x, test pattern %02x\n", line, i, main[i], expected[i]);
+                return;
+            }
+        }
+
+        if (dhgr)
+            continue;
+        uint64_t d7 = s_screen_D7_buffer[0][line];
+        s_screen_D7_buffer[0][line] = 0;
+        a2c_line_bytes(0, line, false, main, aux);
+        s_screen_D7_buffer[0][line] = d7;
+        hires_dots(main, dots);
+        if (memcmp(dots, s_screen_buffer[0][line], sizeof(dots)) != 0)
+        {
+            fprintf(stderr, "a2c_line_bytes: line %u without VIDD7 gives other dots\n", line);
+            return;
+        }
+    }
+}
+
+//  Common setup of the A2C modes: the SEROUT dots of frame 0 are set up by the caller
+static void setup_a2c_frame(void)
+{
+    s_sync_found = true;
+    s_show_menu_screen = false;
+    SET_IFLAG(0, IFLAGS_INTERP_DHGR);
+    cfg_rendering_fx = FX_NONE;
+
+    //  The build time LUTs, loaded (or synthesized) before the frame like on the first frames of the device
+    cfg_ntsc_hue        = 0;
+    cfg_ntsc_saturation = 0;
+    cfg_ntsc_brightness = 0;
+    cfg_ntsc_sharpness  = 0;
+    while (!a2c_lut_update())
+        a2c_lut_synth_step();
+}
+
+//  The hires test pattern as SEROUT dots and VIDD7 (HGR: GR high, TEXT low)
+static void setup_a2c(void)
+{
+    for (uint line = 0; line < 192; line++)
+    {
+        const uint8_t* bytes = &TESTPATTERN_HGR_BIN[hires_address(line) - 0x2000];
+        hires_dots(bytes, s_screen_buffer[0][line]);
+
+        s_screen_D7_buffer[0][line] = 0;
+        for (uint i = 0; i < 40; i++)
+            s_screen_D7_buffer[0][line] |= (uint64_t)(bytes[i] >> 7) << i;
+        s_screen_GR_mask[0][line] = 0x3ffff;
+        s_screen_TEXT_mask[0][line] = 0;
+    }
+    check_a2c_bytes(false);
+    setup_a2c_frame();
+}
+
+//  The diagonal colour bars of the slotted lores mode as SEROUT dots and VIDD7. Lores has the
+//  pins of HGR (GR high, TEXT low), the lines must stay on the A2DVI LUT.
+static void setup_a2c_lores(void)
+{
+    for (uint line = 0; line < 192; line++)
+    {
+        uint8_t bytes[40];
+        for (uint x = 0; x < 40; x++)
+        {
+            uint y = (line / 8) * 2;
+            bytes[x] = ((x + y) & 0xf) | (((x + y + 1) & 0xf) << 4);
+        }
+        lores_dots(bytes, line, s_screen_buffer[0][line]);
+
+        s_screen_D7_buffer[0][line] = 0;
+        for (uint i = 0; i < 40; i++)
+            s_screen_D7_buffer[0][line] |= (uint64_t)(bytes[i] >> 7) << i;
+        s_screen_GR_mask[0][line] = 0x3ffff;
+        s_screen_TEXT_mask[0][line] = 0;
+
+        uint8_t main[40], aux[40];
+        if (a2c_line_bytes(0, line, false, main, aux))
+            fprintf(stderr, "a2c_line_bytes: lores line %u taken for hires\n", line);
+    }
+    setup_a2c_frame();
+}
+
+//  The double hires test pattern as SEROUT dots (DHGR: GR and TEXT high)
+static void setup_a2c_dhgr(void)
+{
+    for (uint line = 0; line < 192; line++)
+    {
+        uint16_t offset = hires_address(line) - 0x2000;
+        dhgr_dots(&TESTPATTERN_DHGR_BIN[offset], &TESTPATTERN_DHGR_BIN[0x2000 + offset], s_screen_buffer[0][line]);
+
+        s_screen_D7_buffer[0][line] = 0;
+        s_screen_GR_mask[0][line] = 0x3ffff;
+        s_screen_TEXT_mask[0][line] = 0x3ffff;
+    }
+    check_a2c_bytes(true);
+    setup_a2c_frame();
+}
+
+//  RENDERING: ENABLED, the default of the device: render_dhgr_bytes uses the tmds_dhgr_* pixel
+//  pairs, which tmds_color_load must load on the A2C as well
+static void setup_a2c_dhgr_interp(void)
+{
+    setup_a2c_dhgr();
+    SET_IFLAG(1, IFLAGS_INTERP_DHGR);
+}
+
+//  The NTSC LUT synthesized by a2c_lut.c, the capture core is the harness
+static void setup_a2c_adjusted(void)
+{
+    setup_a2c();
+    cfg_ntsc_hue        = 2;
+    cfg_ntsc_saturation = 3;
+    cfg_ntsc_brightness = -1;
+    cfg_ntsc_sharpness  = 1;
+    while (!a2c_lut_update())
+        a2c_lut_synth_step();
+}
+
+//  The menu as an OSD over the synced hires frame (a2c_osd.h): render_a2c draws it into the text
+//  page on the first frame, like after a long button press
+static void setup_a2c_osd(bool shade)
+{
+    setup_a2c();
+    s_show_menu_screen = true;
+    s_menu_screen_init = false;
+    a2c_osd_shade = shade;
+}
+
+static void setup_a2c_osd_shade(void)
+{
+    setup_a2c_osd(true);
+}
+
+static void setup_a2c_osd_solid(void)
+{
+    setup_a2c_osd(false);
+}
+
+//  Mixed text and graphics (FX on): the text window of the mixed modes from line 160, and
+//  from the middle of the line on the first 16 lines (TEXT switched on during the line)
+static void setup_a2c_mixed(void)
+{
+    setup_a2c();
+    for (uint line = 0; line < 192; line++)
+    {
+        if (line >= 160)
+            s_screen_GR_mask[0][line] = 0;
+        else if (line < 16)
+            s_screen_GR_mask[0][line] = 0x001ff;
+        s_screen_TEXT_mask[0][line] = ~s_screen_GR_mask[0][line] & 0x3ffff;
+    }
+    cfg_rendering_fx = FX_ENABLED;
+}
+#endif
+
+/*  render modes */
+
+typedef struct
+{
+    const char* name;
+    uint32_t    softsw;
+    bool        mono;
+    uint8_t     color_style;
+    void        (*setup)(void);
+    void        (*render)(void);
+} golden_mode_t;
+
+#ifndef FEATURE_A2C
+static const golden_mode_t golden_modes[] =
+{
+    { "text40",       SOFTSW_TEXT_MODE,                                                false, 2, setup_text,  render_text       },
+    { "text40_mono",  SOFTSW_TEXT_MODE,                                                true,  2, setup_text,  render_text       },
+    { "text80",       SOFTSW_TEXT_MODE | SOFTSW_80COL,                                 false, 2, setup_text,  render_text       },
+    { "text80_mono",  SOFTSW_TEXT_MODE | SOFTSW_80COL,                                 true,  2, setup_text,  render_text       },
+    { "lores",        0,                                                               false, 2, setup_lores, render_lores      },
+    { "lores_mono",   0,                                                               true,  2, setup_lores, render_lores      },
+    { "dgr",          SOFTSW_80COL | SOFTSW_DGR,                                       false, 2, setup_lores, render_dgr        },
+    { "dgr_mono",     SOFTSW_80COL | SOFTSW_DGR,                                       true,  2, setup_lores, render_dgr        },
+    { "hgr",          SOFTSW_HIRES_MODE,                                               false, 2, setup_hires, render_hires      },
+    { "hgr_mono",     SOFTSW_HIRES_MODE,                                               true,  2, setup_hires, render_hires      },
+    { "dhgr",         SOFTSW_HIRES_MODE | SOFTSW_80COL | SOFTSW_DGR,                   false, 2, setup_dhgr,  render_dhgr       },
+    { "dhgr_mono",    SOFTSW_HIRES_MODE | SOFTSW_80COL | SOFTSW_DGR,                   true,  2, setup_dhgr,  render_dhgr       },
+    { "dhgr_interp",  SOFTSW_HIRES_MODE | SOFTSW_80COL | SOFTSW_DGR,                   false, 2, setup_dhgr_interp, render_dhgr },
+    { "dhgr_ntsc",    SOFTSW_HIRES_MODE | SOFTSW_80COL | SOFTSW_DGR,                   false, 2, setup_dhgr_ntsc, render_dhgr   },
+    { "videx",        SOFTSW_TEXT_MODE | SOFTSW_VIDEX_80COL,                           false, 2, setup_videx, render_videx_text },
+    { "videx_mono",   SOFTSW_TEXT_MODE | SOFTSW_VIDEX_80COL,                           true,  2, setup_videx, render_videx_text },
+    { "shr320",       SOFTSW_SHR,                                                      false, 2, setup_shr320, render_shr_frame },
+    { "shr640",       SOFTSW_SHR,                                                      false, 2, setup_shr640, render_shr_frame },
+};
+#else
+static const golden_mode_t golden_modes[] =
+{
+    { "a2c_a2dvi",    SOFTSW_HIRES_MODE,                                               false, 2, setup_a2c,   render_a2c        },
+    { "a2c_lores",    0,                                                               false, 2, setup_a2c_lores, render_a2c    },
+    { "a2c_dhgr",     SOFTSW_HIRES_MODE,                                               false, 2, setup_a2c_dhgr, render_a2c     },
+    { "a2c_dhgr_interp", SOFTSW_HIRES_MODE,                                            false, 2, setup_a2c_dhgr_interp, render_a2c },
+    { "a2c_ntsc",     SOFTSW_HIRES_MODE,                                               false, 0, setup_a2c,   render_a2c        },
+    { "a2c_clamp",    SOFTSW_HIRES_MODE,                                               false, 1, setup_a2c,   render_a2c        },
+    { "a2c_ntsc_adj", SOFTSW_HIRES_MODE,                                               false, 0, setup_a2c_adjusted, render_a2c },
+    { "a2c_mixed",    SOFTSW_HIRES_MODE,                                               false, 2, setup_a2c_mixed, render_a2c    },
+    { "a2c_mix_ntsc", SOFTSW_HIRES_MODE,                                               false, 0, setup_a2c_mixed, render_a2c    },
+    { "a2c_bw",       SOFTSW_HIRES_MODE,                                               true,  2, setup_a2c,   render_a2c        },
+    { "a2c_text40",   SOFTSW_TEXT_MODE,                                                false, 2, setup_text,  render_text       },
+    { "a2c_osd_shade", SOFTSW_HIRES_MODE,                                              false, 2, setup_a2c_osd_shade, render_a2c },
+    { "a2c_osd_solid", SOFTSW_HIRES_MODE,                                              false, 2, setup_a2c_osd_solid, render_a2c },
+};
+#endif
+
+static uint64_t host_cycles(void)
+{
+#if defined(__i386__) || defined(__x86_64__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+#endif
+}
+
+//  One frame of the render loop for the mode, returns the number of scanlines sent
+static uint render_frame(const golden_mode_t* mode, uint32_t* capture)
+{
+    soft_switches  = mode->softsw | SOFTSW_V7_MODE3;  //  Video7 mode after a reset (mode 0 would be 560 dot monochrome)
+    mono_rendering = mode->mono;
+    color_support  = (soft_switches & SOFTSW_MONOCHROME) ? false : true;
+    SET_IFLAG(mode->mono, IFLAGS_FORCED_MONO);
+    color_mode     = mode->mono ? COLOR_MODE_GREEN : COLOR_MODE_BW;
+
+    render_cache_update(soft_switches);
+
+    s_capture = capture;
+    s_capture_lines = 0;
+    mode->render();
+    return s_capture_lines;
+}
+
+#ifdef FEATURE_A2C
+//  Renders the frames of an A2C recording, see the top of the file
+static int replay(const char* path, const char* outdir, uint every)
+{
+    FILE* file = fopen(path, "rb");
+    uint8_t page[A2C_RECORD_PAGE_SIZE];
+    a2c_record_header_t header;
+    if ((!file) || (fread(page, sizeof(page), 1, file) != 1))
+    {
+        fprintf(stderr, "render_golden: cannot read %s\n", path);
+        return 2;
+    }
+    memcpy(&header, page, sizeof(header));
+    if ((header.magic != A2C_RECORD_MAGIC) || (header.page_size != A2C_RECORD_PAGE_SIZE))
+    {
+        fprintf(stderr, "render_golden: %s is no A2C recording\n", path);
+        return 2;
+    }
+
+    DVI_INIT_RESOLUTION(DVI_X_RESOLUTION_GOLDEN);
+    uint32_t words = 3 * DVI_WORDS_PER_CHANNEL;
+    for (uint i = 0; i < GOLDEN_TMDS_BUFFERS; i++)
+        s_free[s_free_count++] = calloc(words, sizeof(uint32_t));
+    uint32_t* capture = calloc(GOLDEN_MAX_LINES * words, sizeof(uint32_t));
+
+    config_load_defaults();
+    cfg_video_mode      = Dvi640x480;
+    cfg_color_style     = header.color_style;
+    cfg_laser_enabled   = header.laser;
+    cfg_ntsc_hue        = header.adjust[0];
+    cfg_ntsc_saturation = header.adjust[1];
+    cfg_ntsc_brightness = header.adjust[2];
+    cfg_ntsc_sharpness  = header.adjust[3];
+    s_sync_found = true;
+    while (!a2c_lut_update())
+        a2c_lut_synth_step();
+    tmds_color_load();
+    render_cache_free();
+
+    static uint32_t image[A2C_RECORD_FRAME_WORDS];
+    for (uint frame = 0; fread(image, sizeof(image), 1, file) == 1; frame++)
+    {
+        for (uint line = 0; line < 192; line++)
+        {
+            const uint32_t* words = &image[line * A2C_RECORD_LINE_WORDS];
+            memcpy(s_screen_buffer[0][line], words, 18 * sizeof(uint32_t));
+            s_screen_buffer[0][line][18] = 0;
+            s_screen_GR_mask[0][line]   = words[18];
+            s_screen_TEXT_mask[0][line] = words[19];
+            s_screen_D7_buffer[0][line] = words[20] | ((uint64_t) words[21] << 32);
+        }
+
+        //  like render_frame, with the settings of the recording (render_a2c reads the others)
+        soft_switches    = SOFTSW_HIRES_MODE | SOFTSW_V7_MODE3;
+        cfg_rendering_fx = header.rendering_fx;
+        color_mode       = header.color_mode;
+        SET_IFLAG(header.internal_flags & IFLAGS_FORCED_MONO, IFLAGS_FORCED_MONO);
+        render_cache_update(soft_switches);
+
+        bool keep = (every != 0) && ((frame % every) == 0);
+        s_capture = keep ? capture : NULL;
+        s_capture_lines = 0;
+        uint64_t start = host_cycles();
+        render_a2c();
+        uint64_t cycles = host_cycles() - start;
+
+        char name[32];
+        snprintf(name, sizeof(name), "frame_%04u", frame);
+        if (keep)
+        {
+            char out[512];
+            snprintf(out, sizeof(out), "%s/%s.tmds", outdir, name);
+            FILE* tmds = fopen(out, "wb");
+            if ((!tmds) || (fwrite(capture, s_capture_lines * words * sizeof(uint32_t), 1, tmds) != 1))
+            {
+                fprintf(stderr, "render_golden: cannot write %s\n", out);
+                return 2;
+            }
+            fclose(tmds);
+        }
+        printf("%s %u %llu\n", name, s_capture_lines, (unsigned long long)cycles);
+    }
+    fclose(file);
+    return 0;
+}
+#endif
+
+int main(int argc, char* argv[])
+{
+#ifdef FEATURE_A2C
+    if ((argc >= 4) && (strcmp(argv[1], "--replay") == 0))
+        return replay(argv[2], argv[3], (argc > 4) ? atoi(argv[4]) : 0);
+#endif
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: render_golden <output directory> [repeat]\n");
+        return 2;
+    }
+    const char* outdir = argv[1];
+    uint repeat = (argc > 2) ? atoi(argv[2]) : 50;
+    int result = 0;
+
+    DVI_INIT_RESOLUTION(DVI_X_RESOLUTION_GOLDEN);
+    uint32_t words = 3 * DVI_WORDS_PER_CHANNEL;
+    for (uint i = 0; i < GOLDEN_TMDS_BUFFERS; i++)
+        s_free[s_free_count++] = calloc(words, sizeof(uint32_t));
+    uint32_t* frame[3];
+    for (uint i = 0; i < 3; i++)
+        frame[i] = calloc(GOLDEN_MAX_LINES * words, sizeof(uint32_t));
+
+    config_load_defaults();
+    cfg_video_mode = Dvi640x480;
+    cfg_rendering_fx = FX_NONE;
+    SET_IFLAG(0, IFLAGS_INTERP_DGR);
+    SET_IFLAG(0, IFLAGS_INTERP_DHGR);
+    cfg_videx_selection = 1;
+    reload_charsets = 7;
+    config_load_charsets();
+
+    for (uint m = 0; m < sizeof(golden_modes) / sizeof(golden_modes[0]); m++)
+    {
+        const golden_mode_t* mode = &golden_modes[m];
+
+        memset(apple_memory, 0, sizeof(apple_memory));
+        memset(aux_memory, 0, sizeof(aux_memory));
+        cfg_color_style = mode->color_style;
+        mode->setup();
+        tmds_color_load();
+
+        //  without the line cache, filling it, from it
+        render_cache_free();
+        uint lines = render_frame(mode, frame[0]);
+        render_cache_init();
+        render_frame(mode, frame[1]);
+        render_frame(mode, frame[2]);
+
+        if (s_capture_overflow)
+        {
+            fprintf(stderr, "%s: more than %d scanlines\n", mode->name, GOLDEN_MAX_LINES);
+            return 2;
+        }
+        for (uint i = 1; i < 3; i++)
+        {
+            if (memcmp(frame[0], frame[i], lines * words * sizeof(uint32_t)) != 0)
+            {
+                fprintf(stderr, "%s: frame %s the line cache differs\n", mode->name, (i == 1) ? "filling" : "sent from");
+                result = 1;
+            }
+        }
+
+        //  best of the repeated frames, without the line cache (every line encoded, the worst case)
+        render_cache_free();
+        uint64_t best = UINT64_MAX;
+        for (uint r = 0; r < repeat; r++)
+        {
+            uint64_t start = host_cycles();
+            render_frame(mode, NULL);
+            uint64_t cycles = host_cycles() - start;
+            if (cycles < best)
+                best = cycles;
+        }
+
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s.tmds", outdir, mode->name);
+        FILE* file = fopen(path, "wb");
+        if ((!file) || (fwrite(frame[0], lines * words * sizeof(uint32_t), 1, file) != 1))
+        {
+            fprintf(stderr, "render_golden: cannot write %s\n", path);
+            return 2;
+        }
+        fclose(file);
+#ifdef FEATURE_SHR
+        //  The super hires memory, for the reference renderer of tools/shr_render.py
+        if (mode->softsw & SOFTSW_SHR)
+        {
+            snprintf(path, sizeof(path), "%s/%s.shr", outdir, mode->name);
+            file = fopen(path, "wb");
+            if ((!file) || (fwrite(shr_memory, SHR_MEMORY_SIZE, 1, file) != 1))
+            {
+                fprintf(stderr, "render_golden: cannot write %s\n", path);
+                return 2;
+            }
+            fclose(file);
+        }
+#endif
+        printf("%s %u %llu\n", mode->name, lines, (unsigned long long)best);
+    }
+
+    return result;
+}
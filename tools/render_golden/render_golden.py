@@ -0,0 +1,293 @@
+#!/usr/bin/env python3
+
+# MIT License
+# Copyright (c) 2025 Michael Neil, Far Left Lane
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+
+# Golden image regression of the renderers.
+#
+# Builds the firmware renderers for the PC (pico_host.h stands in for the pico-sdk,
+# render_golden.c is the harness), once for the slotted firmware (text40/80, lores,
+# DGR, HGR, DHGR, Videx and, with FEATURE_SHR, IIgs super hires) and once with
+# FEATURE_A2C (A2DVI, NTSC, CLAMP and B&W rendering of SEROUT dots, lores kept off the
+# hires byte path, lines mixing text and graphics words, and the menu OSD over the
+# video), each mode in colour and monochrome. The captured TMDS
+# scanlines are decoded back to RGB and compared with the PPM images in golden/.
+# The harness also checks that the line cache does not change the output, and that
+# the A2C rebuilds the video bytes of the test patterns from the SEROUT dots: rendered
+# from those bytes, the A2C graphics modes must match the slotted ones (SAME_AS).
+# Alternative renderings (VARIANT_OF, e.g. the NTSC DHGR colours) are compared with
+# the mode they replace: cycles and number of different pixels.
+#
+# Host cycles per frame (best of --repeat frames, without the line cache) are
+# reported next to the ones recorded with the goldens. They are no RP2040 cycles,
+# but show whether a change made a renderer slower.
+#
+# The super hires frames are also checked with the reference renderer of
+# tools/shr_render.py, so that their goldens are not only snapshots of render_shr.c.
+#
+# The DC balance of the scanlines is checked with tools/tmds_check.py: a mode fails
+# when it sends more unbalanced symbol pairs than recorded with its golden.
+#
+# Usage: render_golden.py [--update] [--mode NAME] [--repeat N] [--keep DIR] [--cc CC]
+#   --update  write the current images (and cycles) as the new goldens
+#
+# Requires a host C compiler (gcc or clang).
+
+import argparse
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+import shr_render
+import tmds_check
+
+HERE     = os.path.dirname(os.path.abspath(__file__))
+REPO     = os.path.normpath(os.path.join(HERE, "..", ".."))
+FIRMWARE = os.path.join(REPO, "firmware")
+GOLDEN   = os.path.join(HERE, "golden")
+RECORDED = os.path.join(GOLDEN, "cycles.txt")
+
+X_RESOLUTION = 640
+
+# A2C modes rendered from the rebuilt video bytes, and the slotted mode they must match
+SAME_AS = {
+    "a2c_a2dvi" : "hgr",
+    "a2c_dhgr"  : "dhgr",
+}
+
+# Alternative renderings of a mode, reported with their cycles and pixels relative to it
+VARIANT_OF = {
+    "dhgr_ntsc" : "dhgr_interp",
+}
+
+SOURCES = [
+    "applebus/buffers.c",
+    "config/config.c",
+    "dvi/tmds.c",
+    "dvi/tmds_lores.c",
+    "dvi/tmds_hires.c",
+    "dvi/tmds_dhgr.c",
+    "render/render_cache.c",
+    "render/render_debug.c",
+    "render/render_text.c",
+    "render/render_lores.c",
+    "render/render_dgr.c",
+    "render/render_hires.c",
+    "render/render_dhgr.c",
+    "render/render_videx.c",
+    "videx/videx_vterm.c",
+    "fonts/textfont.c",
+]
+SOURCES_SLOTTED = [
+    "render/render_shr.c",
+]
+SOURCES_A2C = [
+    "a2c/a2c.c",
+    "a2c/a2c_lut.c",
+    "a2c/a2c_osd.c",
+    "menu/menu.c",
+]
+
+# pico-sdk and libdvi headers included by the firmware, all replaced by pico_host.h
+HOST_HEADERS = [
+    "pico.h", "pico/stdlib.h", "pico/time.h", "pico/multicore.h", "pico/bootrom.h", "pico/config.h",
+    "pico/util/queue.h", "hardware/pio.h", "hardware/dma.h", "hardware/irq.h", "hardware/gpio.h",
+    "hardware/adc.h", "hardware/pwm.h", "hardware/sync.h", "hardware/timer.h", "hardware/clocks.h",
+    "hardware/flash.h", "hardware/watchdog.h", "hardware/interp.h", "hardware/vreg.h",
+    "hardware/platform_defs.h", "hardware/regs/addressmap.h", "hardware/regs/sio.h",
+    "hardware/structs/sio.h", "hardware/structs/systick.h", "hardware/structs/ioqspi.h",
+    "hardware/structs/padsbank0.h", "dvi.h", "util_queue_u32_inline.h", "build/a2c_SEROUT.pio.h", "build/abus.pio.h",
+]
+
+def font_sources():
+    fonts = [f for f in os.listdir(os.path.join(FIRMWARE, "fonts")) if f.endswith(".c") and f != "textfont.c"]
+    fonts += ["videx/" + f for f in os.listdir(os.path.join(FIRMWARE, "fonts", "videx")) if f.endswith(".c")]
+    return sorted("fonts/" + f for f in fonts)
+
+def host_include(workdir):
+    """ Writes the pico-sdk and libdvi headers as one line files including pico_host.h, returns the directory. """
+    include = os.path.join(workdir, "include")
+    for header in HOST_HEADERS:
+        path = os.path.join(include, header)
+        os.makedirs(os.path.dirname(path), exist_ok=True)
+        with open(path, "w") as f:
+            f.write('#include "%s"\n' % os.path.join(HERE, "pico_host.h"))
+    return include
+
+def host_build(cc, workdir, name, sources, defines=()):
+    """ Builds firmware sources (relative to firmware/) and host files for the PC, returns the path of the executable. """
+    include = host_include(workdir)
+    exe = os.path.join(workdir, name)
+    sources = [s if os.path.isabs(s) else os.path.join(FIRMWARE, s) for s in sources]
+    command = [cc, "-std=gnu11", "-O2", "-w", "-fno-strict-aliasing",
+               "-fno-pie", "-no-pie", "-ffunction-sections", "-fdata-sections", "-Wl,--gc-sections", "-Wl,--defsym=__FLASH_CONFIG_LEN=0",
+               "-I" + include, "-I" + FIRMWARE, "-I" + REPO, "-I" + os.path.join(REPO, "libraries", "libdvi"),
+               "-DDVI_N_TMDS_BUFFERS=8", '-DFW_VERSION="golden"', '-DSRAM_LAYOUT="HOST"']
+    command += ["-D" + d for d in defines]
+    command += sources + ["-o", exe]
+    result = subprocess.run(command, capture_output=True, text=True)
+    if result.returncode != 0:
+        sys.exit("build failed (%s):\n%s" % (name, result.stderr))
+    return exe
+
+def build(cc, workdir, a2c):
+    """ Builds the harness, returns the path of the executable. """
+    if a2c:
+        # the A2C colour LUTs are generated by the build, with the default parameters here
+        include = host_include(workdir)
+        subprocess.run([sys.executable, os.path.join(REPO, "tools", "hgr_ntsc_lut.py"), os.path.join(include, "hgrdecode_LUT.h")], check=True)
+
+    name = "render_golden_a2c" if a2c else "render_golden"
+    sources = SOURCES + font_sources() + (SOURCES_A2C if a2c else SOURCES_SLOTTED) + [os.path.join(HERE, "render_golden.c")]
+    return host_build(cc, workdir, name, sources, ["FEATURE_A2C"] if a2c else ["FEATURE_SHR"])
+
+def read_ppm(path):
+    """ Returns (width, height, rgb) of a binary PPM without comments. """
+    with open(path, "rb") as f:
+        data = f.read()
+    fields = data.split(maxsplit=4)
+    if fields[0] != b"P6" or fields[3] != b"255":
+        sys.exit("%s: not a P6 PPM" % path)
+    return int(fields[1]), int(fields[2]), fields[4]
+
+def read_recorded():
+    """ Returns {mode: (cycles, unbalanced pairs)} recorded with the goldens. """
+    recorded = {}
+    if os.path.exists(RECORDED):
+        for line in open(RECORDED):
+            fields = line.split()
+            if len(fields) == 3 and not line.startswith("#"):
+                recorded[fields[0]] = (int(fields[1]), int(fields[2]))
+    return recorded
+
+def compare(name, rgb, lines):
+    """ Returns an error message, or None when the image matches its golden. """
+    path = os.path.join(GOLDEN, name + ".ppm")
+    if not os.path.exists(path):
+        return "no golden image (run with --update)"
+    width, height, golden = read_ppm(path)
+    if (width, height) != (X_RESOLUTION, lines):
+        return "size %dx%d, golden %dx%d" % (X_RESOLUTION, lines, width, height)
+    if golden == rgb:
+        return None
+    pixels = [i // 3 for i in range(0, len(rgb), 3) if rgb[i:i + 3] != golden[i:i + 3]]
+    first = pixels[0]
+    return "%d pixels differ, first at x=%d line=%d" % (len(pixels), first % X_RESOLUTION, first // X_RESOLUTION)
+
+def shr_reference(path, rgb, lines):
+    """ Returns an error message, or None when the super hires lines match the reference renderer. """
+    memory = open(path, "rb").read()
+    border = (lines - shr_render.SHR_LINES) // 2
+    image = []
+    for line in range(border, border + shr_render.SHR_LINES):
+        row = rgb[line * X_RESOLUTION * 3:(line + 1) * X_RESOLUTION * 3]
+        image.append([tuple(row[x:x + 3]) for x in range(0, len(row), 3)])
+    error = shr_render.reference_error(memory, image)
+    if error > shr_render.TOLERANCE:
+        return "max error %.1f from the shr_render.py reference" % error
+    return None
+
+def main():
+    parser = argparse.ArgumentParser(description="Golden image regression of the renderers")
+    parser.add_argument("--update", action="store_true", help="write the current images as the goldens")
+    parser.add_argument("--mode",   action="append",     help="only check this mode (repeatable)")
+    parser.add_argument("--repeat", default=50, type=int, help="frames rendered for the cycle count")
+    parser.add_argument("--keep",   help="keep the build and the rendered images in this directory")
+    parser.add_argument("--cc",     default=os.environ.get("CC", "gcc"), help="host C compiler")
+    args = parser.parse_args()
+
+    workdir = args.keep or tempfile.mkdtemp(prefix="render_golden")
+    os.makedirs(workdir, exist_ok=True)
+    recorded = read_recorded()
+    measured = {}
+    images = {}
+    failed = 0
+    try:
+        for a2c in (False, True):
+            exe = build(args.cc, os.path.join(workdir, "a2c" if a2c else "slotted"), a2c)
+            result = subprocess.run([exe, workdir, str(args.repeat)], capture_output=True, text=True)
+            if result.returncode not in (0, 1):
+                sys.exit("%s failed:\n%s" % (exe, result.stderr))
+            if result.stderr:
+                print(result.stderr, end="")
+                failed += 1
+
+            for line in result.stdout.splitlines():
+                name, lines, cycles = line.split()
+                lines, cycles = int(lines), int(cycles)
+                if args.mode and name not in args.mode:
+                    continue
+                scanlines = tmds_check.read_capture(os.path.join(workdir, name + ".tmds"), X_RESOLUTION)
+                rgb = tmds_check.decode_scanlines(scanlines)
+                unbalanced = sum(len(tmds_check.scanline_errors(s)) for s in scanlines)
+                measured[name] = (cycles, unbalanced)
+                images[name] = rgb
+                if args.keep:
+                    tmds_check.write_ppm(os.path.join(workdir, name + ".ppm"), rgb, X_RESOLUTION, lines)
+
+                shr = os.path.join(workdir, name + ".shr")
+                error = shr_reference(shr, rgb, lines) if os.path.exists(shr) else None
+                if args.update and error is None:
+                    tmds_check.write_ppm(os.path.join(GOLDEN, name + ".ppm"), rgb, X_RESOLUTION, lines)
+                    status = "updated"
+                elif args.update:
+                    status = "FAILED: " + error
+                    failed += 1
+                else:
+                    error = error or compare(name, rgb, lines)
+                    if error is None and unbalanced > recorded.get(name, (0, 0))[1]:
+                        error = "%d unbalanced TMDS pairs, %d recorded" % (unbalanced, recorded.get(name, (0, 0))[1])
+                    status = "ok" if error is None else "FAILED: " + error
+                    failed += error is not None
+
+                change = ""
+                if name in recorded and recorded[name][0]:
+                    change = " (%+.1f%%)" % ((cycles - recorded[name][0]) * 100.0 / recorded[name][0])
+                print("%-12s %3d lines %10d cycles/frame%-10s %6d unbalanced  %s" % (name, lines, cycles, change, unbalanced, status))
+
+        for name, slotted in sorted(SAME_AS.items()):
+            if name in images and slotted in images and images[name] != images[slotted]:
+                print("%-12s FAILED: differs from %s" % (name, slotted))
+                failed += 1
+        for name, base in sorted(VARIANT_OF.items()):
+            if name in images and base in images:
+                pixels = sum(1 for i in range(0, len(images[name]), 3) if images[name][i:i + 3] != images[base][i:i + 3])
+                print("%-12s %.2fx the cycles of %s, %d pixels differ" % (name, measured[name][0] / max(1, measured[base][0]), base, pixels))
+    finally:
+        if not args.keep:
+            shutil.rmtree(workdir)
+
+    if args.update:
+        recorded.update(measured)
+        with open(RECORDED, "w") as f:
+            f.write("# mode, host cycles per frame and unbalanced TMDS pairs when the goldens were recorded (see render_golden.py)\n")
+            for name in sorted(recorded):
+                f.write("%s %d %d\n" % ((name,) + recorded[name]))
+
+    if failed:
+        sys.exit("%d render mode(s) failed" % failed)
+
+if __name__ == "__main__":
+    main()
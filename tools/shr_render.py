@@ -0,0 +1,257 @@
+#!/usr/bin/env python3
+
+# MIT License
+# Copyright (c) 2025 Michael Neil, Far Left Lane
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+# Host check of the Apple IIgs super hires renderer (render/render_shr.c).
+#
+# Renders a 32KB super hires image ($2000-$9FFF of bank $E1: 200 lines of 160
+# bytes, the SCBs at $7D00 and the palettes at $7E00) the way the firmware does:
+# the TMDS double pixels of each palette are built like shr_palette_update()
+# from libdvi's tmds_table.h, and the scanlines are assembled like
+# render_shr_line(). The TMDS symbols are then decoded again and compared with
+# a straightforward renderer working on 12 bit RGB pixels. A difference of a
+# few LSBs is expected (6 bit channel table, 640 mode pixel pairs averaged).
+# render_golden.py checks the frames of the real render_shr.c with the same
+# reference renderer (reference_error).
+#
+# Usage: shr_render.py render IMAGE OUT.ppm
+#        shr_render.py selftest
+
+import argparse
+import os
+import re
+import sys
+
+SHR_MEMORY_SIZE    = 0x8000
+SHR_SCBS           = 0x7d00
+SHR_PALETTES       = 0x7e00
+SHR_LINES          = 200
+SHR_BYTES_PER_LINE = 160
+SHR_SCB_640        = 0x80
+SHR_SCB_FILL       = 0x20
+
+TOLERANCE          = 5          # 6 bit table (4 LSBs) plus the 1 LSB table error
+
+def load_tmds_table(repo):
+    path = os.path.join(repo, "libraries", "libdvi", "tmds_table.h")
+    values = [int(v, 16) for v in re.findall(r"^(0x[0-9a-fA-F]+)u?,", open(path).read(), re.M)]
+    if len(values) != 64:
+        raise ValueError("%s: expected 64 entries, found %d" % (path, len(values)))
+    return values
+
+def tmds_decode(symbol):
+    """ Decodes one 10 bit TMDS data symbol. """
+    if symbol & 0x200:
+        symbol ^= 0xff
+    q = symbol & 0xff
+    data = q & 1
+    for i in range(1, 8):
+        bit = ((q >> i) ^ (q >> (i - 1))) & 1
+        if not (symbol & 0x100):
+            bit ^= 1
+        data |= bit << i
+    return data
+
+def tmds_disparity(symbol):
+    ones = bin(symbol & 0x3ff).count("1")
+    return ones - (10 - ones)
+
+def palette_rgb(memory, palette):
+    """ 16 colors of a palette as (r, g, b) 4 bit values. """
+    colors = []
+    for c in range(16):
+        lo = memory[SHR_PALETTES + palette * 32 + c * 2]
+        hi = memory[SHR_PALETTES + palette * 32 + c * 2 + 1]
+        colors.append((hi & 0xf, lo >> 4, lo & 0xf))
+    return colors
+
+class FirmwareModel:
+    """ Mirrors shr_palette_update() and render_shr_line(). """
+    def __init__(self, table):
+        self.table = table
+
+    def channel(self, total):
+        return self.table[(total * 17) >> 3]
+
+    def palette(self, memory, palette):
+        rgb = palette_rgb(memory, palette)
+        tmds320 = [tuple(self.channel(2 * v) for v in rgb[c]) for c in range(16)]
+        tmds640 = []
+        for left in (8, 0):
+            pairs = []
+            for pair in range(16):
+                c1 = rgb[left + (pair >> 2)]
+                c2 = rgb[left + 4 + (pair & 3)]
+                pairs.append(tuple(self.channel(c1[i] + c2[i]) for i in range(3)))
+            tmds640.append(pairs)
+        return tmds320, tmds640
+
+    def line(self, memory, line):
+        """ 320 TMDS double pixels, each (r, g, b). """
+        scb = memory[SHR_SCBS + line]
+        tmds320, tmds640 = self.palette(memory, scb & 0xf)
+        pixels = memory[line * SHR_BYTES_PER_LINE:(line + 1) * SHR_BYTES_PER_LINE]
+        out = []
+        if scb & SHR_SCB_640:
+            for p in pixels:
+                out.append(tmds640[0][p >> 4])
+                out.append(tmds640[1][p & 0xf])
+        elif scb & SHR_SCB_FILL:
+            last = 0
+            for i in range(SHR_BYTES_PER_LINE * 2):
+                c = (pixels[i >> 1] & 0xf) if (i & 1) else (pixels[i >> 1] >> 4)
+                if c:
+                    last = c
+                out.append(tmds320[last])
+        else:
+            for p in pixels:
+                out.append(tmds320[p >> 4])
+                out.append(tmds320[p & 0xf])
+        return out
+
+def reference_line(memory, line):
+    """ 640 pixels of 8 bit (r, g, b), rendered from the super hires definition. """
+    scb = memory[SHR_SCBS + line]
+    rgb = palette_rgb(memory, scb & 0xf)
+    pixels = memory[line * SHR_BYTES_PER_LINE:(line + 1) * SHR_BYTES_PER_LINE]
+    out = []
+    if scb & SHR_SCB_640:
+        # 4 pixels per byte, pixel n uses colors (8, 12, 0, 4)[n] + its 2 bits
+        for p in pixels:
+            for n, base in enumerate((8, 12, 0, 4)):
+                out.append(rgb[base + ((p >> (6 - 2 * n)) & 3)])
+    else:
+        last = rgb[0]
+        for p in pixels:
+            for c in (p >> 4, p & 0xf):
+                if c or not (scb & SHR_SCB_FILL):
+                    last = rgb[c]
+                out += [last, last]
+    return [tuple(v * 17 for v in c) for c in out]
+
+def reference_error(memory, image):
+    """ Maximum difference of a decoded 640x200 image from the reference renderer. """
+    max_error = 0
+    for line in range(SHR_LINES):
+        decoded = image[line]
+        reference = reference_line(memory, line)
+        for x in range(0, 640, 2):
+            for i in range(3):
+                expected = (reference[x][i] + reference[x + 1][i]) / 2.0
+                for got in (decoded[x][i], decoded[x + 1][i]):
+                    max_error = max(max_error, abs(got - expected))
+    return max_error
+
+def render(memory, table):
+    """ Returns (640x200 decoded image, maximum error, unbalanced symbols). """
+    model = FirmwareModel(table)
+    image = []
+    unbalanced = 0
+    for line in range(SHR_LINES):
+        decoded = []
+        for pixel in model.line(memory, line):
+            left, right = [], []
+            for word in pixel:
+                s0, s1 = word & 0x3ff, (word >> 10) & 0x3ff
+                if tmds_disparity(s0) + tmds_disparity(s1) != 0:
+                    unbalanced += 1
+                left.append(tmds_decode(s0))
+                right.append(tmds_decode(s1))
+            decoded += [tuple(left), tuple(right)]
+        image.append(decoded)
+    return image, reference_error(memory, image), unbalanced
+
+def write_ppm(path, image):
+    with open(path, "wb") as f:
+        f.write(b"P6\n640 %d\n255\n" % len(image))
+        for row in image:
+            f.write(bytes(v for pixel in row for v in pixel))
+
+def set_color(memory, palette, color, r, g, b):
+    memory[SHR_PALETTES + palette * 32 + color * 2]     = (g << 4) | b
+    memory[SHR_PALETTES + palette * 32 + color * 2 + 1] = r
+
+def synthetic_images():
+    """ 320 mode color bars, a 640 mode dither and fill mode lines. """
+    images = {}
+
+    memory = bytearray(SHR_MEMORY_SIZE)
+    for palette in range(16):
+        for c in range(16):
+            set_color(memory, palette, c, c, (c + palette) & 0xf, (15 - c) ^ palette)
+    for line in range(SHR_LINES):
+        memory[SHR_SCBS + line] = line & 0xf
+        for i in range(SHR_BYTES_PER_LINE):
+            c = (i * 16) // SHR_BYTES_PER_LINE
+            memory[line * SHR_BYTES_PER_LINE + i] = (c << 4) | c
+    images["320 bars"] = memory
+
+    memory = bytearray(SHR_MEMORY_SIZE)
+    for c in range(16):
+        set_color(memory, 0, c, (c * 5) & 0xf, (c * 3) & 0xf, (c * 7) & 0xf)
+    for line in range(SHR_LINES):
+        memory[SHR_SCBS + line] = SHR_SCB_640
+        for i in range(SHR_BYTES_PER_LINE):
+            memory[line * SHR_BYTES_PER_LINE + i] = (line * 7 + i * 13) & 0xff
+    images["640 dither"] = memory
+
+    memory = bytearray(SHR_MEMORY_SIZE)
+    for c in range(16):
+        set_color(memory, 3, c, c, 15 - c, (c * 9) & 0xf)
+    for line in range(SHR_LINES):
+        memory[SHR_SCBS + line] = SHR_SCB_FILL | 3
+        for i in range(0, SHR_BYTES_PER_LINE, 10):
+            memory[line * SHR_BYTES_PER_LINE + i] = ((line + i) & 0xf) << 4
+    images["fill mode"] = memory
+
+    return images
+
+def main():
+    parser = argparse.ArgumentParser(description="Check the super hires renderer against a reference")
+    parser.add_argument("--repo", default=os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+    sub = parser.add_subparsers(dest="command", required=True)
+    p = sub.add_parser("render", help="render a 32KB super hires image")
+    p.add_argument("image")
+    p.add_argument("out", help="decoded output (PPM)")
+    sub.add_parser("selftest", help="check synthetic images")
+    args = parser.parse_args()
+
+    table = load_tmds_table(args.repo)
+    if args.command == "render":
+        memory = bytearray(open(args.image, "rb").read()[:SHR_MEMORY_SIZE])
+        if len(memory) != SHR_MEMORY_SIZE:
+            sys.exit("%s: expected %d bytes" % (args.image, SHR_MEMORY_SIZE))
+        image, max_error, unbalanced = render(memory, table)
+        write_ppm(args.out, image)
+        print("max error %.1f, unbalanced symbol pairs %d" % (max_error, unbalanced))
+        sys.exit(0 if max_error <= TOLERANCE and unbalanced == 0 else 1)
+
+    failed = False
+    for name, memory in synthetic_images().items():
+        image, max_error, unbalanced = render(memory, table)
+        ok = max_error <= TOLERANCE and unbalanced == 0
+        failed |= not ok
+        print("%-10s max error %.1f, unbalanced symbol pairs %d: %s" % (name, max_error, unbalanced, "OK" if ok else "FAIL"))
+    sys.exit(1 if failed else 0)
+
+if __name__ == "__main__":
+    main()
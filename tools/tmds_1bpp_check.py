@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+
+# MIT License
+# Copyright (c) 2025 Michael Neil, Far Left Lane
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+
+# Check of the PIO monochrome TMDS encoder (firmware/dvi/tmds_mono.c).
+#
+# Runs libdvi's tmds_encode_1bpp program with the shift configuration of
+# tmds_mono_init (OSR to the left, so the first dot is bit 31 of a SEROUT word,
+# autopull at 32; ISR to the right, autopush at 24) on lines of dots, and checks
+# every symbol pair it pushes:
+#  * it is a balanced pair of TMDS data symbols (tools/tmds_check.py),
+#  * it decodes to 0 or 255 (+-1, like TMDS_SYMBOL_0_0) for the two dots, first dot
+#    in bits 0-9,
+#  * it is the pair the render_golden harness writes in place of the PIO.
+# A line (18 words, 288 pairs) must leave the state machine where it started,
+# so the next line needs no reset.
+#
+# Usage: tmds_1bpp_check.py [--lines N] [--seed N]
+
+import argparse
+import os
+import random
+import re
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import tmds_check
+
+PROGRAM = os.path.join(tmds_check.REPO, "libraries", "libdvi", "tmds_encode_1bpp.pio")
+WORDS   = 18
+
+def read_program(path):
+    """ The instructions of the program as (opcode, destination/source, operand) tuples. """
+    program = []
+    for line in open(path):
+        line = line.split(";")[0].strip()
+        if line.startswith("%"):
+            break
+        if not line or line.startswith(".") or line.endswith(":"):
+            continue
+        m = re.match(r"(\w+)\s+(\w+)\s*,\s*(~?\w+)$", line)
+        if not m:
+            sys.exit("%s: cannot simulate '%s'" % (path, line))
+        program.append((m.group(1), m.group(2), m.group(3)))
+    return program
+
+class StateMachine:
+    def __init__(self, program):
+        self.program = program
+        self.pc = 0
+        self.x = self.y = 0
+        self.osr = 0
+        self.osr_count = 32             # empty, pulled by the first out
+        self.isr = 0
+        self.isr_count = 0
+        self.tx = []
+        self.rx = []
+
+    def source(self, name):
+        invert = name.startswith("~")
+        name = name.lstrip("~")
+        value = {"x": self.x, "y": self.y, "null": 0}[name]
+        return (~value & 0xffffffff) if invert else value
+
+    def step(self):
+        op, a, b = self.program[self.pc]
+        if op == "out" and self.osr_count == 32:
+            if not self.tx:
+                return False            # stalled on the autopull
+            self.osr, self.osr_count = self.tx.pop(0), 0
+        self.pc = (self.pc + 1) % len(self.program)
+        if op == "out":
+            n = int(b)
+            value = self.osr >> (32 - n)                    # shift to the left
+            self.osr = (self.osr << n) & 0xffffffff
+            self.osr_count += n
+            setattr(self, a, value)
+        elif op == "mov":
+            setattr(self, a, self.source(b))
+        elif op == "in":
+            n = int(a if a.isdigit() else b)
+            value = self.source(a if not a.isdigit() else b) & ((1 << n) - 1)
+            self.isr = ((self.isr >> n) | (value << (32 - n))) & 0xffffffff    # shift to the right
+            self.isr_count += n
+            if self.isr_count >= 24:
+                self.rx.append(self.isr)
+                self.isr, self.isr_count = 0, 0
+        else:
+            sys.exit("cannot simulate '%s'" % op)
+        return True
+
+def golden_pair(first, second):
+    """ The pair written by tmds_mono_encode of tools/render_golden/render_golden.c. """
+    return (0x200 if first else 0x100) | ((0x2ff if second else 0x1ff) << 10)
+
+def main():
+    parser = argparse.ArgumentParser(description="Check the PIO monochrome TMDS encoder")
+    parser.add_argument("--lines", default=200, type=int, help="random lines of dots")
+    parser.add_argument("--seed",  default=1,   type=int, help="random seed")
+    args = parser.parse_args()
+
+    rng = random.Random(args.seed)
+    sm = StateMachine(read_program(PROGRAM))
+    errors = 0
+    for line in range(args.lines):
+        if line < 2:
+            words = [(0xffffffff if line else 0)] * WORDS
+        else:
+            words = [rng.getrandbits(32) for i in range(WORDS)]
+        sm.tx = list(words)
+        while sm.step():
+            pass
+        if len(sm.rx) != WORDS * 16 or sm.pc != 0 or sm.isr_count:
+            print("line %d: %d pairs, stopped at pc %d with %d ISR bits" % (line, len(sm.rx), sm.pc, sm.isr_count))
+            return 1
+
+        for i, word in enumerate(sm.rx):
+            first  = (words[i // 16] >> (31 - 2 * (i % 16))) & 1
+            second = (words[i // 16] >> (30 - 2 * (i % 16))) & 1
+            problems = tmds_check.pair_errors(word)
+            values = tmds_check.decode_pair(word)
+            if abs(values[0] - 255 * first) > 1 or abs(values[1] - 255 * second) > 1:
+                problems.append("decodes to %d/%d" % tmds_check.decode_pair(word))
+            if word != golden_pair(first, second):
+                problems.append("render_golden writes 0x%05x" % golden_pair(first, second))
+            if problems:
+                print("line %d pair %d 0x%05x: %s" % (line, i, word, ", ".join(problems)))
+                errors += 1
+        sm.rx = []
+
+    print("%d lines of %d pixel pairs: %s" % (args.lines, WORDS * 16, "%d errors" % errors if errors else "ok"))
+    return 1 if errors else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
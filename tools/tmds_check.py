@@ -0,0 +1,276 @@
+#!/usr/bin/env python3
+
+# MIT License
+# Copyright (c) 2025 Michael Neil, Far Left Lane
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+
+# TMDS symbol decoder and DC balance checker for the render LUTs and rendered scanlines.
+#
+# The renderers copy pre-encoded TMDS data into the scanline buffers: every 32 bit
+# word holds two 10 bit symbols (first pixel in bits 0-9, second in bits 10-19) that
+# must be perfectly bit balanced (see dvi/tmds.h), as the stream is never re-encoded.
+# An unbalanced pair makes the DC level of the link drift.
+#
+# Checks per symbol pair:
+#  * both symbols are TMDS data symbols (DVI 1.0 section 3.2.2: bits 0-8 are the
+#    transition minimized q_m of the decoded value, bit 9 selects the inversion),
+#  * the pair has a disparity (ones - zeros) of 0.
+# With --strict, the inversion of each symbol must also be the one the DVI encoder
+# chooses when every pair starts at a running disparity of 0.
+#
+# Usage:
+#   tmds_check.py luts [FILE...]            check the LUTs (default: all firmware LUTs)
+#   tmds_check.py scanlines CAPTURE...      check captured scanlines (render_golden.py --keep)
+#   tmds_check.py image CAPTURE PPM         decode captured scanlines into an image
+#   tmds_check.py decode WORD...            show symbols, values and disparity of words
+#
+# A capture holds the scanline buffers as little endian 32 bit words: per line the
+# blue, green and red channels of --width / 2 words each.
+#
+# The functions are also used as a library (tools/render_golden/render_golden.py).
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+REPO = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+
+LUT_FILES = [
+    "firmware/dvi/tmds.c",
+    "firmware/dvi/tmds_lores.c",
+    "firmware/dvi/tmds_dhgr.c",
+    "firmware/dvi/tmds_hires.c",
+    "libraries/libdvi/tmds_table.h",
+]
+SYMBOL_HEADER = "firmware/dvi/tmds.h"
+
+def popcount(x):
+    return bin(x).count("1")
+
+def transition_minimize(d):
+    """ q_m (9 bits) of the DVI encoder for the 8 bit value d. """
+    xnor = popcount(d) > 4 or (popcount(d) == 4 and not d & 1)
+    q = d & 1
+    for i in range(1, 8):
+        bit = ((q >> (i - 1)) ^ (d >> i)) & 1
+        if xnor:
+            bit ^= 1
+        q |= bit << i
+    return q if xnor else q | 0x100
+
+def decode_symbol(symbol):
+    """ 8 bit value of a 10 bit TMDS data symbol. """
+    q = symbol & 0xff
+    if symbol & 0x200:
+        q ^= 0xff
+    value = q & 1
+    for i in range(1, 8):
+        bit = ((q >> i) ^ (q >> (i - 1))) & 1
+        if not symbol & 0x100:
+            bit ^= 1
+        value |= bit << i
+    return value
+
+def disparity(symbol, bits=10):
+    """ Ones minus zeros. """
+    return 2 * popcount(symbol & ((1 << bits) - 1)) - bits
+
+def symbol_errors(symbol, running, strict):
+    """ Problems of a symbol sent at the running disparity, as a list of strings. """
+    value = decode_symbol(symbol)
+    q_m = transition_minimize(value)
+    if (symbol & 0x1ff) ^ (0xff if symbol & 0x200 else 0) != q_m:
+        return ["0x%03x is no TMDS data symbol" % symbol]
+    if not strict:
+        return []
+    balanced = disparity(q_m & 0xff, 8) == 0
+    if running == 0 or balanced:
+        invert = not q_m & 0x100
+    else:
+        invert = (running > 0) == (disparity(q_m & 0xff, 8) > 0)
+    if bool(symbol & 0x200) != invert:
+        return ["0x%03x is inverted differently than by the DVI encoder" % symbol]
+    return []
+
+def pair_errors(word, strict=False):
+    """ Problems of a symbol pair (32 bit LUT/scanline word), as a list of strings. """
+    first, second = word & 0x3ff, (word >> 10) & 0x3ff
+    if not strict and word < (1 << 20) and VALID[first] and VALID[second] and DISPARITY[first] + DISPARITY[second] == 0:
+        return []
+    errors = symbol_errors(first, 0, strict) + symbol_errors(second, disparity(first), strict)
+    if word >> 20:
+        errors.append("bits 20-31 set")
+    balance = disparity(first) + disparity(second)
+    if balance:
+        errors.append("disparity %+d" % balance)
+    return errors
+
+DECODE    = [decode_symbol(s) for s in range(1024)]
+DISPARITY = [disparity(s) for s in range(1024)]
+VALID     = [not symbol_errors(s, 0, False) for s in range(1024)]
+
+def decode_pair(word):
+    return DECODE[word & 0x3ff], DECODE[(word >> 10) & 0x3ff]
+
+# --- LUTs in the C sources
+
+def symbol_defines():
+    """ The TMDS_SYMBOL_x_y macros of dvi/tmds.h. """
+    text = open(os.path.join(REPO, SYMBOL_HEADER)).read()
+    return {m.group(1): int(m.group(2), 16) for m in re.finditer(r"#define\s+(TMDS_SYMBOL_\w+)\s+0x([0-9a-fA-F]+)", text)}
+
+def strip_comments(text):
+    return re.sub(r"//[^\n]*|/\*.*?\*/", "", text, flags=re.S)
+
+def parse_luts(path):
+    """ Returns [(name, [words])] of the uint32_t arrays of a C file. A file holding only
+        a table body (libdvi/tmds_table.h) is one LUT named after the file. """
+    text = strip_comments(open(path).read())
+    defines = symbol_defines()
+
+    def values(body):
+        words = []
+        for token in body.replace("\n", " ").split(","):
+            token = token.strip()
+            if not token:
+                continue
+            if token in defines:
+                words.append(defines[token])
+            else:
+                words.append(int(token.rstrip("uUlL"), 0))
+        return words
+
+    luts = []
+    for m in re.finditer(r"uint32_t\b[^;{=]*?(\w+)\)?\s*\[[^\]]*\]\s*=\s*\{(.*?)\}\s*;", text, flags=re.S):
+        luts.append((m.group(1), values(m.group(2))))
+    if not luts and "=" not in text:
+        luts.append((os.path.splitext(os.path.basename(path))[0], values(text)))
+    return luts
+
+def check_luts(files, strict):
+    failed = 0
+    for path in files:
+        luts = parse_luts(path)
+        if not luts:
+            print("%s: no uint32_t tables" % os.path.relpath(path, REPO))
+        for name, words in luts:
+            errors = [(i, e) for i, w in enumerate(words) for e in pair_errors(w, strict)]
+            print("%-50s %5d entries  %s" % (name, len(words), "ok" if not errors else "%d errors" % len(errors)))
+            for i, e in errors[:8]:
+                print("    [%d] 0x%05x: %s" % (i, words[i], e))
+            failed += len(errors) > 0
+    return failed
+
+# --- captured scanlines
+
+def read_capture(path, width):
+    """ Returns a list of scanlines, each a (blue, green, red) tuple of word lists. """
+    data = open(path, "rb").read()
+    words_per_channel = width // 2
+    line_bytes = 3 * words_per_channel * 4
+    if len(data) % line_bytes:
+        sys.exit("%s: size is no multiple of a %d pixel scanline" % (path, width))
+    lines = []
+    for offset in range(0, len(data), line_bytes):
+        words = struct.unpack_from("<%dI" % (3 * words_per_channel), data, offset)
+        lines.append((words[:words_per_channel], words[words_per_channel:2 * words_per_channel], words[2 * words_per_channel:]))
+    return lines
+
+def scanline_errors(line, strict=False):
+    """ Problems of a scanline: (channel, word index, error) of every bad pair. """
+    errors = []
+    for channel, words in zip("BGR", line):
+        for i, word in enumerate(words):
+            for e in pair_errors(word, strict):
+                errors.append((channel, i, e))
+    return errors
+
+def decode_scanlines(lines):
+    """ Packed RGB bytes of the scanlines. """
+    rgb = bytearray()
+    for blue, green, red in lines:
+        for b, g, r in zip(blue, green, red):
+            rgb += bytes((DECODE[r & 0x3ff], DECODE[g & 0x3ff], DECODE[b & 0x3ff],
+                          DECODE[(r >> 10) & 0x3ff], DECODE[(g >> 10) & 0x3ff], DECODE[(b >> 10) & 0x3ff]))
+    return bytes(rgb)
+
+def write_ppm(path, rgb, width, height):
+    with open(path, "wb") as f:
+        f.write(b"P6\n%d %d\n255\n" % (width, height))
+        f.write(rgb)
+
+def check_scanlines(files, width, strict):
+    failed = 0
+    for path in files:
+        lines = read_capture(path, width)
+        bad = 0
+        for n, line in enumerate(lines):
+            errors = scanline_errors(line, strict)
+            if errors:
+                bad += 1
+                if bad <= 8:
+                    channel, i, e = errors[0]
+                    print("    line %d: %d bad pairs, first %s[%d] (x=%d): %s" % (n, len(errors), channel, i, 2 * i, e))
+        print("%-40s %4d lines  %s" % (os.path.basename(path), len(lines), "ok" if not bad else "%d bad lines" % bad))
+        failed += bad > 0
+    return failed
+
+def main():
+    parser = argparse.ArgumentParser(description="TMDS decoder and DC balance checker")
+    parser.add_argument("--strict", action="store_true", help="also check the inversion chosen by the DVI encoder")
+    parser.add_argument("--width", default=640, type=int, help="pixels per captured scanline")
+    sub = parser.add_subparsers(dest="command", required=True)
+    p = sub.add_parser("luts", help="check the LUTs of C sources")
+    p.add_argument("files", nargs="*")
+    p = sub.add_parser("scanlines", help="check captured scanlines")
+    p.add_argument("files", nargs="+")
+    p = sub.add_parser("image", help="decode captured scanlines into a PPM image")
+    p.add_argument("capture")
+    p.add_argument("ppm")
+    p = sub.add_parser("decode", help="decode symbol pairs")
+    p.add_argument("words", nargs="+")
+    args = parser.parse_args()
+
+    failed = 0
+    if args.command == "luts":
+        files = args.files or [os.path.join(REPO, f) for f in LUT_FILES]
+        failed = check_luts(files, args.strict)
+    elif args.command == "scanlines":
+        failed = check_scanlines(args.files, args.width, args.strict)
+    elif args.command == "image":
+        lines = read_capture(args.capture, args.width)
+        write_ppm(args.ppm, decode_scanlines(lines), args.width, len(lines))
+    elif args.command == "decode":
+        for token in args.words:
+            word = int(token, 16)
+            first, second = word & 0x3ff, (word >> 10) & 0x3ff
+            errors = pair_errors(word, args.strict)
+            print("0x%05x: 0x%03x 0x%03x -> %3d %3d, disparity %+d %+d  %s" %
+                  (word, first, second, DECODE[first], DECODE[second], disparity(first), disparity(second),
+                   "ok" if not errors else ", ".join(errors)))
+            failed += len(errors) > 0
+    if failed:
+        sys.exit(1)
+
+if __name__ == "__main__":
+    main()